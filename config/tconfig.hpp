@@ -47,7 +47,8 @@ namespace mfem
 {
 namespace internal
 {
-long long flop_count;
+// Defined in fem/tbilinearform.cpp
+extern long long flop_count;
 }
 }
 
@@ -24,6 +24,8 @@
 //               ex1 -m ../data/fichera-amr.mesh
 //               ex1 -m ../data/mobius-strip.mesh
 //               ex1 -m ../data/mobius-strip.mesh -o -1 -sc
+//               ex1 -m ../data/star.mesh -o 3 -pa
+//               ex1 -m ../data/fichera.mesh -o 3 -pa
 //
 // Description:  This example code demonstrates the use of MFEM to define a
 //               simple finite element discretization of the Laplace problem
@@ -37,8 +39,9 @@
 //               element grid functions, as well as linear and bilinear forms
 //               corresponding to the left-hand side and right-hand side of the
 //               discrete linear system. We also cover the explicit elimination
-//               of essential boundary conditions, static condensation, and the
-//               optional connection to the GLVis tool for visualization.
+//               of essential boundary conditions, static condensation, partial
+//               (matrix-free) assembly, and the optional connection to the
+//               GLVis tool for visualization.
 
 #include "mfem.hpp"
 #include <fstream>
@@ -53,6 +56,7 @@ int main(int argc, char *argv[])
    const char *mesh_file = "../data/star.mesh";
    int order = 1;
    bool static_cond = false;
+   bool pa = false;
    bool visualization = 1;
 
    OptionsParser args(argc, argv);
@@ -63,6 +67,8 @@ int main(int argc, char *argv[])
                   " isoparametric space.");
    args.AddOption(&static_cond, "-sc", "--static-condensation", "-no-sc",
                   "--no-static-condensation", "Enable static condensation.");
+   args.AddOption(&pa, "-pa", "--partial-assembly", "-no-pa",
+                  "--no-partial-assembly", "Enable Partial Assembly.");
    args.AddOption(&visualization, "-vis", "--visualization", "-no-vis",
                   "--no-visualization",
                   "Enable or disable GLVis visualization.");
@@ -149,28 +155,41 @@ int main(int argc, char *argv[])
    // 9. Assemble the bilinear form and the corresponding linear system,
    //    applying any necessary transformations such as: eliminating boundary
    //    conditions, applying conforming constraints for non-conforming AMR,
-   //    static condensation, etc.
+   //    static condensation, etc. With partial assembly, only the quadrature
+   //    point data is stored and the operator is applied matrix-free.
+   if (pa) { a->SetAssemblyLevel(AssemblyLevel::PARTIAL); }
    if (static_cond) { a->EnableStaticCondensation(); }
    a->Assemble();
 
-   SparseMatrix A;
+   OperatorHandle A;
    Vector B, X;
    a->FormLinearSystem(ess_tdof_list, x, *b, A, X, B);
 
-   cout << "Size of linear system: " << A.Height() << endl;
+   cout << "Size of linear system: " << A.Ptr()->Height() << endl;
 
+   if (pa)
+   {
+      // 10. With partial assembly, the matrix is not available, so solve the
+      //     system A X = B with unpreconditioned CG.
+      CG(*A.Ptr(), B, X, 1, 2000, 1e-12, 0.0);
+   }
+   else
+   {
+      SparseMatrix &A_sp = *A.As<SparseMatrix>();
 #ifndef MFEM_USE_SUITESPARSE
-   // 10. Define a simple symmetric Gauss-Seidel preconditioner and use it to
-   //     solve the system A X = B with PCG.
-   GSSmoother M(A);
-   PCG(A, M, B, X, 1, 200, 1e-12, 0.0);
+      // 10. Define a simple symmetric Gauss-Seidel preconditioner and use it to
+      //     solve the system A X = B with PCG.
+      GSSmoother M(A_sp);
+      PCG(A_sp, M, B, X, 1, 200, 1e-12, 0.0);
 #else
-   // 10. If MFEM was compiled with SuiteSparse, use UMFPACK to solve the system.
-   UMFPackSolver umf_solver;
-   umf_solver.Control[UMFPACK_ORDERING] = UMFPACK_ORDERING_METIS;
-   umf_solver.SetOperator(A);
-   umf_solver.Mult(B, X);
+      // 10. If MFEM was compiled with SuiteSparse, use UMFPACK to solve the
+      //     system.
+      UMFPackSolver umf_solver;
+      umf_solver.Control[UMFPACK_ORDERING] = UMFPACK_ORDERING_METIS;
+      umf_solver.SetOperator(A_sp);
+      umf_solver.Mult(B, X);
 #endif
+   }
 
    // 11. Recover the solution as a finite element grid function.
    a->RecoverFEMSolution(X, *b, x);
@@ -55,6 +55,9 @@ protected:
    BilinearForm *M;
    BilinearForm *K;
 
+   GridFunction u_alpha_gf; // the diffusivity kappa + alpha u in K
+   GridFunctionCoefficient u_coeff;
+
    SparseMatrix Mmat, Kmat;
    SparseMatrix *T; // T = M + dt K
    double current_dt;
@@ -293,7 +296,7 @@ int main(int argc, char *argv[])
 ConductionOperator::ConductionOperator(FiniteElementSpace &f, double al,
                                        double kap, const Vector &u)
    : TimeDependentOperator(f.GetTrueVSize(), 0.0), fespace(f), M(NULL), K(NULL),
-     T(NULL), current_dt(0.0), z(height)
+     u_alpha_gf(&f), u_coeff(&u_alpha_gf), T(NULL), current_dt(0.0), z(height)
 {
    const double rel_tol = 1e-8;
 
@@ -320,6 +323,11 @@ ConductionOperator::ConductionOperator(FiniteElementSpace &f, double al,
    T_solver.SetPrintLevel(0);
    T_solver.SetPreconditioner(T_prec);
 
+   // K is reassembled in every time step with the same sparsity pattern.
+   K = new BilinearForm(&fespace);
+   K->AddDomainIntegrator(new DiffusionIntegrator(u_coeff));
+   K->UseFixedSparsity();
+
    SetParameters(u);
 }
 
@@ -353,19 +361,13 @@ void ConductionOperator::ImplicitSolve(const double dt,
 
 void ConductionOperator::SetParameters(const Vector &u)
 {
-   GridFunction u_alpha_gf(&fespace);
    u_alpha_gf.SetFromTrueDofs(u);
    for (int i = 0; i < u_alpha_gf.Size(); i++)
    {
       u_alpha_gf(i) = kappa + alpha*u_alpha_gf(i);
    }
 
-   delete K;
-   K = new BilinearForm(&fespace);
-
-   GridFunctionCoefficient u_coeff(&u_alpha_gf);
-
-   K->AddDomainIntegrator(new DiffusionIntegrator(u_coeff));
+   *K = 0.0;
    K->Assemble();
    K->FormSystemMatrix(ess_tdof_list, Kmat);
    delete T;
@@ -9,6 +9,7 @@
 //       mpirun -np 4 ex18p -p 1 -rs 1 -rp 1 -o 5 -s 6
 //       mpirun -np 4 ex18p -p 2 -rs 1 -rp 1 -o 1 -s 3
 //       mpirun -np 4 ex18p -p 2 -rs 1 -rp 1 -o 3 -s 3
+//       mpirun -np 4 ex18p -p 1 -rs 2 -rp 1 -o 3 -s 4 -mf
 //
 // Description:  This example code solves the compressible Euler system of
 //               equations, a model nonlinear hyperbolic PDE, with a
@@ -33,7 +34,10 @@
 //               explicit time integrators. In this case the system also
 //               involves an external approximate Riemann solver for the DG
 //               interface flux. It also demonstrates how to use GLVis for
-//               in-situ visualization of vector grid functions.
+//               in-situ visualization of vector grid functions. With the
+//               -mf option, the same DG discretization is evaluated by the
+//               library's matrix-free DGHyperbolicOperator instead, which
+//               integrates the faces shared with other processors too.
 //
 //               We recommend viewing examples 9, 14 and 17 before viewing this
 //               example.
@@ -73,6 +77,7 @@ int main(int argc, char *argv[])
    double t_final = 2.0;
    double dt = -0.01;
    double cfl = 0.3;
+   bool matrix_free = false;
    bool visualization = true;
    int vis_steps = 50;
 
@@ -94,13 +99,17 @@ int main(int argc, char *argv[])
                   "Order (degree) of the finite elements.");
    args.AddOption(&ode_solver_type, "-s", "--ode-solver",
                   "ODE solver: 1 - Forward Euler,\n\t"
-                  "            2 - RK2 SSP, 3 - RK3 SSP, 4 - RK4, 6 - RK6.");
+                  "            2 - RK2 SSP, 3 - RK3 SSP, 4 - RK4, 6 - RK6,\n\t"
+                  "            7 - low-storage RK4, 8 - 10-stage RK4 SSP.");
    args.AddOption(&t_final, "-tf", "--t-final",
                   "Final time; start time is 0.");
    args.AddOption(&dt, "-dt", "--time-step",
                   "Time step. Positive number skips CFL timestep calculation.");
    args.AddOption(&cfl, "-c", "--cfl-number",
                   "CFL number for timestep calculation.");
+   args.AddOption(&matrix_free, "-mf", "--matrix-free", "-no-mf",
+                  "--no-matrix-free",
+                  "Use the matrix-free DGHyperbolicOperator.");
    args.AddOption(&visualization, "-vis", "--visualization", "-no-vis",
                   "--no-visualization",
                   "Enable or disable GLVis visualization.");
@@ -132,6 +141,8 @@ int main(int argc, char *argv[])
       case 3: ode_solver = new RK3SSPSolver; break;
       case 4: ode_solver = new RK4Solver; break;
       case 6: ode_solver = new RK6Solver; break;
+      case 7: ode_solver = new LowStorageRK4Solver; break;
+      case 8: ode_solver = new RK4SSPSolver; break;
       default:
          if (mpi.Root())
          {
@@ -226,6 +237,17 @@ int main(int argc, char *argv[])
    //     iterations, ti, with a time-step dt).
    FE_Evolution euler(vfes, A, Aflux.SpMat());
 
+   // The matrix-free alternative: Euler flux with a Rusanov numerical flux.
+   EulerFlux flux(dim, specific_heat_ratio);
+   RusanovFlux num_flux(flux);
+   DGHyperbolicOperator *dg_euler = NULL;
+   if (matrix_free)
+   {
+      dg_euler = new DGHyperbolicOperator(vfes, flux, num_flux);
+   }
+   TimeDependentOperator &evolution =
+      matrix_free ? static_cast<TimeDependentOperator&>(*dg_euler) : euler;
+
    // Visualize the density
    socketstream sout;
    if (visualization)
@@ -278,8 +300,8 @@ int main(int argc, char *argv[])
    tic_toc.Start();
 
    double t = 0.0;
-   euler.SetTime(t);
-   ode_solver->Init(euler);
+   evolution.SetTime(t);
+   ode_solver->Init(evolution);
 
    if (cfl > 0)
    {
@@ -287,7 +309,15 @@ int main(int argc, char *argv[])
       // maximum char speed at all quadrature points on all faces.
       max_char_speed = 0.;
       Vector z(sol.Size());
-      A.Mult(sol, z);
+      if (matrix_free)
+      {
+         dg_euler->Mult(sol, z);
+         max_char_speed = dg_euler->GetMaxCharSpeed();
+      }
+      else
+      {
+         A.Mult(sol, z);
+      }
       // Reduce to find the global maximum wave speed
       {
          double all_max_char_speed;
@@ -307,6 +337,7 @@ int main(int argc, char *argv[])
       ode_solver->Step(sol, t, dt_real);
       if (cfl > 0)
       {
+         if (matrix_free) { max_char_speed = dg_euler->GetMaxCharSpeed(); }
          // Reduce to find the global maximum wave speed
          {
             double all_max_char_speed;
@@ -358,6 +389,7 @@ int main(int argc, char *argv[])
    }
 
    // Free the used memory.
+   delete dg_euler;
    delete ode_solver;
 
    return 0;
@@ -24,6 +24,7 @@
 //               mpirun -np 4 ex1p -m ../data/amr-hex.mesh
 //               mpirun -np 4 ex1p -m ../data/mobius-strip.mesh
 //               mpirun -np 4 ex1p -m ../data/mobius-strip.mesh -o -1 -sc
+//               mpirun -np 4 ex1p -m ../data/fichera.mesh -o 3 -da
 //
 // Description:  This example code demonstrates the use of MFEM to define a
 //               simple finite element discretization of the Laplace problem
@@ -38,7 +39,10 @@
 //               corresponding to the left-hand side and right-hand side of the
 //               discrete linear system. We also cover the explicit elimination
 //               of essential boundary conditions, static condensation, and the
-//               optional connection to the GLVis tool for visualization.
+//               optional connection to the GLVis tool for visualization. With
+//               -da, the matrix is assembled directly on the true dofs, and
+//               the matrix and the solution are checked against the default
+//               assembly.
 
 #include "mfem.hpp"
 #include <fstream>
@@ -59,6 +63,7 @@ int main(int argc, char *argv[])
    const char *mesh_file = "../data/star.mesh";
    int order = 1;
    bool static_cond = false;
+   bool direct_assembly = false;
    bool visualization = 1;
 
    OptionsParser args(argc, argv);
@@ -69,6 +74,10 @@ int main(int argc, char *argv[])
                   " isoparametric space.");
    args.AddOption(&static_cond, "-sc", "--static-condensation", "-no-sc",
                   "--no-static-condensation", "Enable static condensation.");
+   args.AddOption(&direct_assembly, "-da", "--direct-assembly", "-no-da",
+                  "--no-direct-assembly",
+                  "Assemble the parallel matrix directly from the element"
+                  " matrices.");
    args.AddOption(&visualization, "-vis", "--visualization", "-no-vis",
                   "--no-visualization",
                   "Enable or disable GLVis visualization.");
@@ -183,6 +192,7 @@ int main(int argc, char *argv[])
    //     assembly, eliminating boundary conditions, applying conforming
    //     constraints for non-conforming AMR, static condensation, etc.
    if (static_cond) { a->EnableStaticCondensation(); }
+   if (direct_assembly) { a->EnableDirectAssembly(); }
    a->Assemble();
 
    HypreParMatrix A;
@@ -208,7 +218,45 @@ int main(int argc, char *argv[])
    //     local finite element solution on each processor.
    a->RecoverFEMSolution(X, *b, x);
 
-   // 14. Save the refined mesh and the solution in parallel. This output can
+   // 14. With direct assembly, check the matrix and the solution against the
+   //     default assembly: compare the products of both matrices with a random
+   //     vector, and compute the residual of the solution in the default
+   //     linear system.
+   bool da_ok = true;
+   if (direct_assembly)
+   {
+      ParBilinearForm a_ref(fespace);
+      a_ref.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a_ref.Assemble();
+
+      HypreParMatrix A_ref;
+      Vector B_ref, X_ref;
+      a_ref.FormLinearSystem(ess_tdof_list, x, *b, A_ref, X_ref, B_ref);
+
+      Vector v(A.Height()), Av(A.Height()), Rv(A.Height());
+      v.Randomize(myid + 1);
+      A.Mult(v, Av);
+      A_ref.Mult(v, Rv);
+      Av -= Rv;
+      const double A_diff = sqrt(InnerProduct(MPI_COMM_WORLD, Av, Av)/
+                                 InnerProduct(MPI_COMM_WORLD, Rv, Rv));
+
+      A_ref.Mult(X_ref, Rv);
+      Rv -= B_ref;
+      const double res = sqrt(InnerProduct(MPI_COMM_WORLD, Rv, Rv)/
+                              InnerProduct(MPI_COMM_WORLD, B_ref, B_ref));
+      da_ok = (A_diff < 1e-10 && res < 1e-8);
+      if (myid == 0)
+      {
+         cout << "\nDirect vs default assembly: relative difference of the"
+              << " products |(A-A_ref)v|/|A_ref v| = " << A_diff
+              << "\nRelative residual of the solution in the default system"
+              << " |A_ref X-B_ref|/|B_ref| = " << res << endl;
+         if (!da_ok) { cout << "Direct assembly check FAILED!" << endl; }
+      }
+   }
+
+   // 15. Save the refined mesh and the solution in parallel. This output can
    //     be viewed later using GLVis: "glvis -np <np> -m mesh -g sol".
    {
       ostringstream mesh_name, sol_name;
@@ -224,7 +272,7 @@ int main(int argc, char *argv[])
       x.Save(sol_ofs);
    }
 
-   // 15. Send the solution by socket to a GLVis server.
+   // 16. Send the solution by socket to a GLVis server.
    if (visualization)
    {
       char vishost[] = "localhost";
@@ -235,7 +283,7 @@ int main(int argc, char *argv[])
       sol_sock << "solution\n" << *pmesh << x << flush;
    }
 
-   // 16. Free the used memory.
+   // 17. Free the used memory.
    delete pcg;
    delete amg;
    delete a;
@@ -246,5 +294,5 @@ int main(int argc, char *argv[])
 
    MPI_Finalize();
 
-   return 0;
+   return da_ok ? 0 : 3;
 }
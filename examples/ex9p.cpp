@@ -114,7 +114,9 @@ int main(int argc, char *argv[])
                   "Order (degree) of the finite elements.");
    args.AddOption(&ode_solver_type, "-s", "--ode-solver",
                   "ODE solver: 1 - Forward Euler,\n\t"
-                  "            2 - RK2 SSP, 3 - RK3 SSP, 4 - RK4, 6 - RK6.");
+                  "            2 - RK2 SSP, 3 - RK3 SSP, 4 - RK4, 6 - RK6,\n\t"
+                  "            5 - adaptive Dormand-Prince 5(4), with the\n\t"
+                  "                time step size as maximum step.");
    args.AddOption(&t_final, "-tf", "--t-final",
                   "Final time; start time is 0.");
    args.AddOption(&dt, "-dt", "--time-step",
@@ -152,6 +154,8 @@ int main(int argc, char *argv[])
 
    // 4. Define the ODE solver used for time integration. Several explicit
    //    Runge-Kutta methods are available.
+   // The adaptive solvers need an error norm that is global over the ranks.
+   ODEWeightedRMSNorm ode_norm(MPI_COMM_WORLD);
    ODESolver *ode_solver = NULL;
    switch (ode_solver_type)
    {
@@ -159,6 +163,13 @@ int main(int argc, char *argv[])
       case 2: ode_solver = new RK2Solver(1.0); break;
       case 3: ode_solver = new RK3SSPSolver; break;
       case 4: ode_solver = new RK4Solver; break;
+      case 5:
+      {
+         DormandPrinceSolver *dp_solver = new DormandPrinceSolver;
+         dp_solver->SetErrorNorm(ode_norm);
+         ode_solver = dp_solver;
+         break;
+      }
       case 6: ode_solver = new RK6Solver; break;
       default:
          if (myid == 0)
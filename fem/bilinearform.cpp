@@ -13,22 +13,119 @@
 
 #include "fem.hpp"
 #include <cmath>
+#include <algorithm>
 
 namespace mfem
 {
 
+// Expand the scalar sparsity pattern 'dof_dof' to all components of the
+// vector space 'fes', assuming full vdim x vdim coupling between the
+// components. The returned arrays are allocated with new[].
+static void ExpandVDimPattern(const FiniteElementSpace &fes,
+                              const Table &dof_dof, int *&vI, int *&vJ)
+{
+   const int vdim = fes.GetVDim();
+   const int ndofs = fes.GetNDofs();
+   const bool by_vdim = (fes.GetOrdering() == Ordering::byVDIM);
+   const int *I = dof_dof.GetI();
+   const int *J = dof_dof.GetJ();
+
+   vI = new int[vdim*ndofs + 1];
+   vJ = new int[vdim*vdim*I[ndofs]];
+   vI[0] = 0;
+   for (int vi = 0; vi < vdim*ndofs; vi++)
+   {
+      const int i = by_vdim ? vi/vdim : vi%ndofs;
+      const int *row_J = J + I[i];
+      const int row_size = I[i+1] - I[i];
+      int *vrow_J = vJ + vI[vi];
+      // keep the columns of each row sorted
+      if (by_vdim)
+      {
+         for (int k = 0; k < row_size; k++)
+         {
+            for (int vd = 0; vd < vdim; vd++)
+            {
+               *(vrow_J++) = row_J[k]*vdim + vd;
+            }
+         }
+      }
+      else
+      {
+         for (int vd = 0; vd < vdim; vd++)
+         {
+            for (int k = 0; k < row_size; k++)
+            {
+               *(vrow_J++) = row_J[k] + vd*ndofs;
+            }
+         }
+      }
+      vI[vi+1] = vI[vi] + vdim*row_size;
+   }
+}
+
+// Copy the element-to-dof table of 'fes' to 'elem_dof', replacing the signed
+// dofs -1-dof of the ND and RT spaces with the dofs.
+static void GetUnsignedElementToDofTable(const FiniteElementSpace &fes,
+                                         Table &elem_dof)
+{
+   fes.GetElementToDofTable().Copy(elem_dof);
+   int *J = elem_dof.GetJ();
+   for (int k = 0; k < elem_dof.Size_of_connections(); k++)
+   {
+      if (J[k] < 0) { J[k] = -1-J[k]; }
+   }
+}
+
+// Add the element matrix 'elmat' with rows/columns 'vdofs' to the finalized
+// matrix 'A' with sorted columns. Unlike SparseMatrix::AddSubMatrix(), no work
+// arrays of 'A' are used, so concurrent calls are safe as long as they update
+// disjoint sets of rows.
+static void AddElementMatrixThreadSafe(SparseMatrix &A, const Array<int> &vdofs,
+                                       const DenseMatrix &elmat)
+{
+   const int *I = A.GetI();
+   const int *J = A.GetJ();
+   double *data = A.GetData();
+   const int n = vdofs.Size();
+
+   for (int r = 0; r < n; r++)
+   {
+      int row = vdofs[r];
+      double sr = 1.0;
+      if (row < 0) { row = -1-row; sr = -1.0; }
+      const int *row_J = J + I[row];
+      const int *row_end = J + I[row+1];
+      double *row_data = data + I[row];
+      for (int c = 0; c < n; c++)
+      {
+         int col = vdofs[c];
+         double s = sr;
+         if (col < 0) { col = -1-col; s = -s; }
+         const int *p = std::lower_bound(row_J, row_end, col);
+         MFEM_ASSERT(p != row_end && *p == col,
+                     "entry (" << row << ',' << col << ") is not in the "
+                     "sparsity pattern");
+         row_data[p - row_J] += s*elmat(r, c);
+      }
+   }
+}
+
 void BilinearForm::AllocMat()
 {
    if (static_cond) { return; }
 
-   if (precompute_sparsity == 0 || fes->GetVDim() > 1)
+   const bool threaded = UseThreadedAssembly();
+   if (!threaded && !fixed_sparsity &&
+       (precompute_sparsity == 0 || fes->GetVDim() > 1))
    {
       mat = new SparseMatrix(height);
       return;
    }
 
-   const Table &elem_dof = fes->GetElementToDofTable();
-   Table dof_dof;
+   Table elem_dof, dof_dof;
+   GetUnsignedElementToDofTable(*fes, elem_dof);
+   const int ndofs = fes->GetNDofs();
 
    if (fbfi.Size() > 0)
    {
@@ -39,27 +136,191 @@ void BilinearForm::AllocMat()
          mfem::Mult(*face_elem, elem_dof, face_dof);
          delete face_elem;
       }
-      Transpose(face_dof, dof_face, height);
+      Transpose(face_dof, dof_face, ndofs);
       mfem::Mult(dof_face, face_dof, dof_dof);
    }
    else
    {
       // the sparsity pattern is defined from the map: element->dof
       Table dof_elem;
-      Transpose(elem_dof, dof_elem, height);
+      Transpose(elem_dof, dof_elem, ndofs);
       mfem::Mult(dof_elem, elem_dof, dof_dof);
    }
 
    dof_dof.SortRows();
 
-   int *I = dof_dof.GetI();
-   int *J = dof_dof.GetJ();
+   int *I, *J;
+   if (fes->GetVDim() == 1)
+   {
+      I = dof_dof.GetI();
+      J = dof_dof.GetJ();
+      dof_dof.LoseData();
+   }
+   else
+   {
+      ExpandVDimPattern(*fes, dof_dof, I, J);
+   }
    double *data = new double[I[height]];
 
    mat = new SparseMatrix(I, J, data, height, height, true, true, true);
    *mat = 0.0;
+}
+
+bool BilinearForm::UseThreadedAssembly() const
+{
+#ifdef MFEM_USE_OPENMP
+   if (dbfi.Size() == 0 || static_cond || hybridization || element_matrices ||
+       fes->GetNURBSext())
+   {
+      return false;
+   }
+   for (int k = 0; k < dbfi.Size(); k++)
+   {
+      if (!dbfi[k]->IsThreadSafe()) { return false; }
+   }
+   return true;
+#else
+   return false;
+#endif
+}
+
+void BilinearForm::ComputeElementColoring()
+{
+   delete elem_colors;
+
+   const int ne = fes->GetNE();
+   Table elem_dof, dof_elem, elem_elem;
+   GetUnsignedElementToDofTable(*fes, elem_dof);
+   Transpose(elem_dof, dof_elem, fes->GetNDofs());
+   mfem::Mult(elem_dof, dof_elem, elem_elem);
+
+   // greedy coloring: use the smallest color not used by the neighbors;
+   // color_mark[c] == i means that color c is taken by a neighbor of i
+   Array<int> color(ne), color_mark;
+   color = -1;
+   for (int i = 0; i < ne; i++)
+   {
+      const int *nbr = elem_elem.GetRow(i);
+      const int num_nbr = elem_elem.RowSize(i);
+      for (int k = 0; k < num_nbr; k++)
+      {
+         if (color[nbr[k]] >= 0) { color_mark[color[nbr[k]]] = i; }
+      }
+      int c = 0;
+      while (c < color_mark.Size() && color_mark[c] == i) { c++; }
+      if (c == color_mark.Size()) { color_mark.Append(-1); }
+      color[i] = c;
+   }
+
+   elem_colors = new Table;
+   elem_colors->MakeI(color_mark.Size());
+   for (int i = 0; i < ne; i++) { elem_colors->AddAColumnInRow(color[i]); }
+   elem_colors->MakeJ();
+   for (int i = 0; i < ne; i++) { elem_colors->AddConnection(color[i], i); }
+   elem_colors->ShiftUpI();
+}
+
+void BilinearForm::BuildElementCaches(
+   const Array<BilinearFormIntegrator*> &integs)
+{
+   // One element of each finite element type, and so of each geometry: the
+   // rules of the integrators depend on the element and on the order of the
+   // transformation, which is the same for all elements of a geometry.
+   DenseMatrix elmat;
+   IsoparametricTransformation eltrans;
+   Array<const FiniteElement*> done;
+   for (int i = 0; i < fes->GetNE(); i++)
+   {
+      const FiniteElement *fe = fes->GetFE(i);
+      if (done.Find(fe) >= 0) { continue; }
+      done.Append(fe);
+      fes->GetElementTransformation(i, &eltrans);
+      for (int k = 0; k < integs.Size(); k++)
+      {
+         integs[k]->AssembleElementMatrix(*fe, eltrans, elmat);
+      }
+   }
+}
+
+void BilinearForm::AssembleDomainThreaded(
+   const Array<BilinearFormIntegrator*> &integs)
+{
+   if (elem_colors == NULL) { ComputeElementColoring(); }
+   const bool scatter = fixed_sparsity && mat_scatter.IsFrozen();
+   BuildElementCaches(integs);
+
+   for (int c = 0; c < elem_colors->Size(); c++)
+   {
+      const int *elems = elem_colors->GetRow(c);
+      const int num_elems = elem_colors->RowSize(c);
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel
+#endif
+      {
+         DenseMatrix elmat, elmat_k;
+         Array<int> el_vdofs;
+         IsoparametricTransformation eltrans;
+#ifdef MFEM_USE_OPENMP
+         #pragma omp for
+#endif
+         for (int j = 0; j < num_elems; j++)
+         {
+            const int i = elems[j];
+            const FiniteElement &fe = *fes->GetFE(i);
+            fes->GetElementVDofs(i, el_vdofs);
+            fes->GetElementTransformation(i, &eltrans);
+            integs[0]->AssembleElementMatrix(fe, eltrans, elmat);
+            for (int k = 1; k < integs.Size(); k++)
+            {
+               integs[k]->AssembleElementMatrix(fe, eltrans, elmat_k);
+               elmat += elmat_k;
+            }
+            if (scatter)
+            {
+               // element i is the call number i of the recorded assembly
+               mat_scatter.AddSubMatrix(*mat, i, elmat);
+            }
+            else
+            {
+               AddElementMatrixThreadSafe(*mat, el_vdofs, elmat);
+            }
+         }
+      }
+   }
+   if (scatter) { mat_scatter.SetCall(fes->GetNE()); }
+}
+
+void BilinearForm::AssembleDomainTemplated(
+   Array<BilinearFormIntegrator*> &integs)
+{
+   integs.SetSize(0);
+   if (dbfi_tforms.Size() != dbfi.Size())
+   {
+      DeleteTForms();
+      dbfi_tforms.SetSize(dbfi.Size());
+      dbfi_tforms = NULL;
+   }
+   for (int k = 0; k < dbfi.Size(); k++)
+   {
+      dbfi_tforms[k] = TFormRegistry::Update(dbfi_tforms[k], *dbfi[k], *fes);
+      if (dbfi_tforms[k])
+      {
+         dbfi_tforms[k]->AssembleBilinearForm(*this);
+      }
+      else
+      {
+         integs.Append(dbfi[k]);
+      }
+   }
+}
 
-   dof_dof.LoseData();
+void BilinearForm::DeleteTForms()
+{
+   for (int k = 0; k < dbfi_tforms.Size(); k++)
+   {
+      delete dbfi_tforms[k];
+   }
+   dbfi_tforms.SetSize(0);
 }
 
 BilinearForm::BilinearForm (FiniteElementSpace * f)
@@ -72,8 +333,14 @@ BilinearForm::BilinearForm (FiniteElementSpace * f)
    element_matrices = NULL;
    static_cond = NULL;
    hybridization = NULL;
+   ext = NULL;
    precompute_sparsity = 0;
+   elem_colors = NULL;
+   tkernels_enabled = true;
    diag_policy = DIAG_KEEP;
+   fixed_sparsity = false;
+   elim_policy = DIAG_KEEP;
+   elim_pending = false;
 }
 
 BilinearForm::BilinearForm (FiniteElementSpace * f, BilinearForm * bf, int ps)
@@ -89,8 +356,14 @@ BilinearForm::BilinearForm (FiniteElementSpace * f, BilinearForm * bf, int ps)
    element_matrices = NULL;
    static_cond = NULL;
    hybridization = NULL;
+   ext = NULL;
    precompute_sparsity = ps;
+   elem_colors = NULL;
+   tkernels_enabled = true;
    diag_policy = DIAG_KEEP;
+   fixed_sparsity = false;
+   elim_policy = DIAG_KEEP;
+   elim_pending = false;
 
    bfi = bf->GetDBFI();
    dbfi.SetSize (bfi->Size());
@@ -123,8 +396,28 @@ BilinearForm::BilinearForm (FiniteElementSpace * f, BilinearForm * bf, int ps)
    AllocMat();
 }
 
+void BilinearForm::SetAssemblyLevel(AssemblyLevel::Type assembly_level)
+{
+   delete ext;
+   ext = NULL;
+   switch (assembly_level)
+   {
+      case AssemblyLevel::FULL:
+         break;
+      case AssemblyLevel::PARTIAL:
+         MFEM_VERIFY(!static_cond && !hybridization, "static condensation and "
+                     "hybridization are not supported with partial assembly");
+         ext = new PABilinearFormExtension(this);
+         break;
+      default:
+         MFEM_ABORT("unknown assembly level");
+   }
+}
+
 void BilinearForm::EnableStaticCondensation()
 {
+   MFEM_VERIFY(!ext, "static condensation is not supported with partial "
+               "assembly");
    delete static_cond;
    static_cond = new StaticCondensation(fes);
    if (static_cond->ReducesTrueVSize())
@@ -144,6 +437,7 @@ void BilinearForm::EnableHybridization(FiniteElementSpace *constr_space,
                                        BilinearFormIntegrator *constr_integ,
                                        const Array<int> &ess_tdof_list)
 {
+   MFEM_VERIFY(!ext, "hybridization is not supported with partial assembly");
    delete hybridization;
    hybridization = new Hybridization(fes, constr_space);
    hybridization->SetConstraintIntegrator(constr_integ);
@@ -162,6 +456,7 @@ void BilinearForm::UseSparsity(int *I, int *J, bool isSorted)
       }
       delete mat;
    }
+   mat_scatter.Reset();
    height = width = fes->GetVSize();
    mat = new SparseMatrix(I, J, NULL, height, width, false, true, isSorted);
 }
@@ -193,7 +488,8 @@ MatrixInverse * BilinearForm::Inverse() const
 
 void BilinearForm::Finalize (int skip_zeros)
 {
-   if (!static_cond) { mat->Finalize(skip_zeros); }
+   if (ext) { return; }
+   if (!static_cond && mat) { mat->Finalize(skip_zeros); }
    if (mat_e) { mat_e->Finalize(skip_zeros); }
    if (static_cond) { static_cond->Finalize(); }
    if (hybridization) { hybridization->Finalize(); }
@@ -315,21 +611,40 @@ void BilinearForm::Assemble (int skip_zeros)
 
    int i;
 
+   if (ext)
+   {
+      ext->Assemble();
+      return;
+   }
+
    if (mat == NULL)
    {
       AllocMat();
    }
 
-#ifdef MFEM_USE_OPENMP
-   int free_element_matrices = 0;
-   if (!element_matrices)
+   // With a fixed sparsity pattern, the element matrices are added in the
+   // same order in every assembly, see AddElementMatrix().
+   const bool scatter = fixed_sparsity && mat && mat->Finalized();
+   if (scatter) { mat_scatter.Begin(); }
+
+   // Domain integrators to be assembled with the generic code
+   Array<BilinearFormIntegrator*> integs;
+   if (tkernels_enabled && dbfi.Size() && !element_matrices && !static_cond &&
+       !hybridization && !scatter)
    {
-      ComputeElementMatrices();
-      free_element_matrices = 1;
+      AssembleDomainTemplated(integs);
+   }
+   else
+   {
+      integs.MakeRef(dbfi);
    }
-#endif
 
-   if (dbfi.Size())
+   if (integs.Size() && UseThreadedAssembly() && mat->Finalized() &&
+       mat->areColumnsSorted() && (!scatter || mat_scatter.IsFrozen()))
+   {
+      AssembleDomainThreaded(integs);
+   }
+   else if (integs.Size())
    {
       for (i = 0; i < fes -> GetNE(); i++)
       {
@@ -342,10 +657,10 @@ void BilinearForm::Assemble (int skip_zeros)
          {
             const FiniteElement &fe = *fes->GetFE(i);
             eltrans = fes->GetElementTransformation(i);
-            dbfi[0]->AssembleElementMatrix(fe, *eltrans, elmat);
-            for (int k = 1; k < dbfi.Size(); k++)
+            integs[0]->AssembleElementMatrix(fe, *eltrans, elmat);
+            for (int k = 1; k < integs.Size(); k++)
             {
-               dbfi[k]->AssembleElementMatrix(fe, *eltrans, elemmat);
+               integs[k]->AssembleElementMatrix(fe, *eltrans, elemmat);
                elmat += elemmat;
             }
             elmat_p = &elmat;
@@ -356,7 +671,7 @@ void BilinearForm::Assemble (int skip_zeros)
          }
          else
          {
-            mat->AddSubMatrix(vdofs, vdofs, *elmat_p, skip_zeros);
+            AddElementMatrix(vdofs, *elmat_p, skip_zeros);
             if (hybridization)
             {
                hybridization->AssembleMatrix(i, *elmat_p);
@@ -407,7 +722,7 @@ void BilinearForm::Assemble (int skip_zeros)
          }
          if (!static_cond)
          {
-            mat->AddSubMatrix(vdofs, vdofs, elmat, skip_zeros);
+            AddElementMatrix(vdofs, elmat, skip_zeros);
             if (hybridization)
             {
                hybridization->AssembleBdrMatrix(i, elmat);
@@ -439,7 +754,7 @@ void BilinearForm::Assemble (int skip_zeros)
                fbfi[k] -> AssembleFaceMatrix (*fes -> GetFE (tr -> Elem1No),
                                               *fes -> GetFE (tr -> Elem2No),
                                               *tr, elemmat);
-               mat -> AddSubMatrix (vdofs, vdofs, elemmat, skip_zeros);
+               AddElementMatrix(vdofs, elemmat, skip_zeros);
             }
          }
       }
@@ -491,18 +806,86 @@ void BilinearForm::Assemble (int skip_zeros)
                    (*bfbfi_marker[k])[bdr_attr-1] == 0) { continue; }
 
                bfbfi[k] -> AssembleFaceMatrix (*fe1, *fe2, *tr, elemmat);
-               mat -> AddSubMatrix (vdofs, vdofs, elemmat, skip_zeros);
+               AddElementMatrix(vdofs, elemmat, skip_zeros);
             }
          }
       }
    }
 
-#ifdef MFEM_USE_OPENMP
-   if (free_element_matrices)
+   if (scatter)
    {
-      FreeElementMatrices();
+      mat_scatter.End();
+      elim_pending = true;
+   }
+}
+
+void BilinearForm::AddElementMatrix(const Array<int> &vdofs,
+                                    const DenseMatrix &elmat, int skip_zeros)
+{
+   if (fixed_sparsity && mat->Finalized())
+   {
+      mat_scatter.AddSubMatrix(*mat, vdofs, vdofs, elmat);
+   }
+   else
+   {
+      mat->AddSubMatrix(vdofs, vdofs, elmat, skip_zeros);
+   }
+}
+
+void BilinearForm::SetupEliminationMap(const Array<int> &ess_tdof_list)
+{
+   ess_tdof_list.Copy(elim_tdofs);
+   elim_policy = diag_policy;
+   elim_map.SetSize(0);
+   elim_diag.SetSize(0);
+
+   const int n = mat->Height();
+   Array<int> ess_marker(n), e_pos(n);
+   ess_marker = 0;
+   e_pos = -1;
+   for (int i = 0; i < ess_tdof_list.Size(); i++)
+   {
+      const int d = ess_tdof_list[i];
+      ess_marker[(d >= 0) ? d : -1-d] = 1;
+   }
+
+   // The entries of 'mat' in the eliminated rows and columns that were moved
+   // to 'mat_e'; entries missing from 'mat_e' were not eliminated.
+   const int *I = mat->GetI(), *J = mat->GetJ();
+   const int *Ie = mat_e->GetI(), *Je = mat_e->GetJ();
+   for (int i = 0; i < n; i++)
+   {
+      if (Ie[i] == Ie[i+1]) { continue; }
+      for (int k = Ie[i]; k < Ie[i+1]; k++) { e_pos[Je[k]] = k; }
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         const int j = J[k];
+         if ((!ess_marker[i] && !ess_marker[j]) || e_pos[j] < 0) { continue; }
+         Array<int> &pairs = (i == j) ? elim_diag : elim_map;
+         pairs.Append(k);
+         pairs.Append(e_pos[j]);
+      }
+      for (int k = Ie[i]; k < Ie[i+1]; k++) { e_pos[Je[k]] = -1; }
+   }
+}
+
+void BilinearForm::ReapplyElimination()
+{
+   double *A = mat->GetData();
+   double *Ae = mat_e->GetData();
+   *mat_e = 0.0;
+   for (int k = 0; k < elim_map.Size(); k += 2)
+   {
+      Ae[elim_map[k+1]] = A[elim_map[k]];
+      A[elim_map[k]] = 0.0;
+   }
+   // see SparseMatrix::EliminateRowCol(int, SparseMatrix &, DiagonalPolicy)
+   const double diag = (elim_policy == DIAG_ONE) ? 1.0 : 0.0;
+   for (int k = 0; k < elim_diag.Size(); k += 2)
+   {
+      Ae[elim_diag[k+1]] = A[elim_diag[k]] - diag;
+      A[elim_diag[k]] = diag;
    }
-#endif
 }
 
 void BilinearForm::ConformingAssemble()
@@ -609,6 +992,9 @@ void BilinearForm::FormLinearSystem(const Array<int> &ess_tdof_list,
 void BilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
                                     SparseMatrix &A)
 {
+   MFEM_VERIFY(!ext, "with partial assembly, use the OperatorHandle version "
+               "of this method");
+
    // Finish the matrix assembly and perform BC elimination, storing the
    // eliminated part of the matrix.
    if (static_cond)
@@ -627,11 +1013,39 @@ void BilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
       if (!mat_e)
       {
          const SparseMatrix *P = fes->GetConformingProlongation();
-         if (P) { ConformingAssemble(); }
+         if (P)
+         {
+            MFEM_VERIFY(!fixed_sparsity, "a fixed sparsity pattern requires "
+                        "a conforming space");
+            ConformingAssemble();
+         }
          EliminateVDofs(ess_tdof_list, diag_policy);
          const int remove_zeros = 0;
          Finalize(remove_zeros);
+         if (fixed_sparsity && mat->Finalized())
+         {
+            SetupEliminationMap(ess_tdof_list);
+         }
+      }
+      else if (elim_pending)
+      {
+         // 'mat' was reassembled with a fixed sparsity pattern: eliminate the
+         // essential dofs again, numerically if they have not changed.
+         if (ess_tdof_list == elim_tdofs && diag_policy == elim_policy)
+         {
+            ReapplyElimination();
+         }
+         else
+         {
+            delete mat_e;
+            mat_e = NULL;
+            EliminateVDofs(ess_tdof_list, diag_policy);
+            const int remove_zeros = 0;
+            Finalize(remove_zeros);
+            SetupEliminationMap(ess_tdof_list);
+         }
       }
+      elim_pending = false;
       if (hybridization)
       {
          A.MakeRef(hybridization->GetMatrix());
@@ -643,9 +1057,43 @@ void BilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
    }
 }
 
+void BilinearForm::FormLinearSystem(const Array<int> &ess_tdof_list,
+                                    Vector &x, Vector &b,
+                                    OperatorHandle &A, Vector &X, Vector &B,
+                                    int copy_interior)
+{
+   if (ext)
+   {
+      ext->FormLinearSystem(ess_tdof_list, x, b, A, X, B, copy_interior);
+      return;
+   }
+   SparseMatrix *A_ref = new SparseMatrix;
+   FormLinearSystem(ess_tdof_list, x, b, *A_ref, X, B, copy_interior);
+   A.Reset(A_ref);
+}
+
+void BilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
+                                    OperatorHandle &A)
+{
+   if (ext)
+   {
+      ext->FormSystemOperator(ess_tdof_list, A);
+      return;
+   }
+   SparseMatrix *A_ref = new SparseMatrix;
+   FormSystemMatrix(ess_tdof_list, *A_ref);
+   A.Reset(A_ref);
+}
+
 void BilinearForm::RecoverFEMSolution(const Vector &X,
                                       const Vector &b, Vector &x)
 {
+   if (ext)
+   {
+      ext->RecoverFEMSolution(X, b, x);
+      return;
+   }
+
    const SparseMatrix *P = fes->GetConformingProlongation();
    if (!P) // conforming space
    {
@@ -706,6 +1154,7 @@ void BilinearForm::ComputeElementMatrices()
 
    DenseMatrix tmp;
    IsoparametricTransformation eltrans;
+   BuildElementCaches(dbfi);
 
 #ifdef MFEM_USE_OPENMP
    #pragma omp parallel for private(tmp,eltrans)
@@ -889,6 +1338,8 @@ void BilinearForm::Update(FiniteElementSpace *nfes)
 
    delete mat_e;
    mat_e = NULL;
+   elim_tdofs.SetSize(0);
+   elim_pending = false;
    FreeElementMatrices();
    delete static_cond;
    static_cond = NULL;
@@ -897,8 +1348,12 @@ void BilinearForm::Update(FiniteElementSpace *nfes)
    {
       delete mat;
       mat = NULL;
+      mat_scatter.Reset();
+      delete elem_colors;
+      elem_colors = NULL;
       delete hybridization;
       hybridization = NULL;
+      DeleteTForms();
       sequence = fes->GetSequence();
    }
    else
@@ -908,6 +1363,8 @@ void BilinearForm::Update(FiniteElementSpace *nfes)
    }
 
    height = width = fes->GetVSize();
+
+   if (ext) { ext->Update(fes); }
 }
 
 void BilinearForm::SetDiagonalPolicy(DiagonalPolicy policy)
@@ -920,8 +1377,11 @@ BilinearForm::~BilinearForm()
    delete mat_e;
    delete mat;
    delete element_matrices;
+   delete elem_colors;
    delete static_cond;
    delete hybridization;
+   delete ext;
+   DeleteTForms();
 
    if (!extern_bfs)
    {
@@ -20,6 +20,7 @@
 #include "bilininteg.hpp"
 #include "staticcond.hpp"
 #include "hybridization.hpp"
+#include "bilinearform_ext.hpp"
 
 namespace mfem
 {
@@ -66,6 +67,9 @@ protected:
    StaticCondensation *static_cond;
    Hybridization *hybridization;
 
+   /// Partial assembly extension; NULL when the form is fully assembled.
+   PABilinearFormExtension *ext;
+
    /**
     * This member allows one to specify what should be done
     * to the diagonal matrix entries and corresponding RHS
@@ -74,19 +78,81 @@ protected:
    DiagonalPolicy diag_policy;
 
    int precompute_sparsity;
+
+   /** Greedy coloring of the elements used by the threaded assembly: row c of
+       the table lists the elements of color c; elements of the same color do
+       not share any dofs. Computed on demand, NULL when not available. */
+   Table *elem_colors;
+
+   /// Use the pre-instantiated templated kernels of TFormRegistry if possible.
+   bool tkernels_enabled;
+   /** Templated operators of the domain integrators, kept between assemblies,
+       see TFormRegistry::Update(); NULL entries use the generic code. */
+   Array<TFormOperator*> dbfi_tforms;
+
+   /** Reassembly with a fixed sparsity pattern: positions in 'mat' of the
+       element matrix entries, recorded by the first Assemble(). */
+   bool fixed_sparsity;
+   SparseScatterMap mat_scatter;
+   /** Positions in 'mat' and 'mat_e' of the entries moved by the elimination
+       of 'elim_tdofs' with 'elim_policy', as pairs; diagonal entries are kept
+       separately in 'elim_diag'. 'elim_pending' is set when 'mat' has been
+       reassembled since the last elimination. */
+   Array<int> elim_tdofs, elim_map, elim_diag;
+   DiagonalPolicy elim_policy;
+   bool elim_pending;
+
    // Allocate appropriate SparseMatrix and assign it to mat
    void AllocMat();
 
+   /** Return true if the domain integrators can be assembled concurrently by
+       multiple threads, directly into the finalized matrix (see
+       BilinearFormIntegrator::IsThreadSafe()). */
+   bool UseThreadedAssembly() const;
+
+   // Compute the table elem_colors.
+   void ComputeElementColoring();
+
+   // Assemble the given domain integrators into the finalized matrix 'mat',
+   // processing the elements of each color in parallel.
+   void AssembleDomainThreaded(const Array<BilinearFormIntegrator*> &integs);
+
+   // Compute the element matrices of the given integrators on one element of
+   // each type, outside of the parallel element loops, to build the cached
+   // geometric factors and basis tables that the loops only read.
+   void BuildElementCaches(const Array<BilinearFormIntegrator*> &integs);
+
+   /* Assemble the domain integrators that have a matching templated kernel in
+      the TFormRegistry; return the remaining integrators in 'integs'. */
+   void AssembleDomainTemplated(Array<BilinearFormIntegrator*> &integs);
+
+   // Delete the operators in 'dbfi_tforms'.
+   void DeleteTForms();
+
    void ConformingAssemble();
 
+   // Add the element matrix 'elmat' to 'mat', through 'mat_scatter' when the
+   // sparsity pattern is fixed.
+   void AddElementMatrix(const Array<int> &vdofs, const DenseMatrix &elmat,
+                         int skip_zeros);
+
+   // Record the positions of the entries moved by the elimination of
+   // 'ess_tdof_list' in elim_map and elim_diag.
+   void SetupEliminationMap(const Array<int> &ess_tdof_list);
+
+   // Redo the elimination of elim_tdofs in the reassembled 'mat', using the
+   // recorded positions.
+   void ReapplyElimination();
+
    // may be used in the construction of derived classes
    BilinearForm() : Matrix (0)
    {
       fes = NULL; sequence = -1;
       mat = mat_e = NULL; extern_bfs = 0; element_matrices = NULL;
-      static_cond = NULL; hybridization = NULL;
-      precompute_sparsity = 0;
+      static_cond = NULL; hybridization = NULL; ext = NULL;
+      precompute_sparsity = 0; elem_colors = NULL; tkernels_enabled = true;
       diag_policy = DIAG_KEEP;
+      fixed_sparsity = false; elim_policy = DIAG_KEEP; elim_pending = false;
    }
 
 public:
@@ -98,6 +164,33 @@ public:
    /// Get the size of the BilinearForm as a square matrix.
    int Size() const { return height; }
 
+   /// Set the desired assembly level; the default is AssemblyLevel::FULL.
+   /** With AssemblyLevel::PARTIAL, Assemble() stores only the quadrature point
+       data of the domain integrators and the operator is applied with Mult()
+       in a matrix-free fashion; the sparse matrix is never formed. In this
+       case, use the FormLinearSystem() and FormSystemMatrix() methods with an
+       OperatorHandle argument. This method should be called before
+       assembly. */
+   void SetAssemblyLevel(AssemblyLevel::Type assembly_level);
+
+   /// Return true if the form uses AssemblyLevel::PARTIAL.
+   bool UsesPartialAssembly() const { return ext; }
+
+   /** @brief Enable or disable the use of the pre-instantiated templated
+       (TBilinearForm) kernels for the domain integrators; enabled by
+       default.
+
+       When enabled, the domain integrators with a matching specialization in
+       the TFormRegistry are assembled with the templated kernels, both with
+       full and partial assembly, see TFormRegistry::Create(). The other
+       integrators use the generic code. The templated kernels are not used
+       with static condensation, hybridization or stored element matrices. */
+   void EnableTemplatedKernels(bool enable = true)
+   { tkernels_enabled = enable; }
+
+   /// Return true if the use of the templated kernels is enabled.
+   bool TemplatedKernelsEnabled() const { return tkernels_enabled; }
+
    /** Enable the use of static condensation. For details see the description
        for class StaticCondensation in fem/staticcond.hpp This method should be
        called before assembly. If the number of unknowns after static
@@ -124,6 +217,22 @@ public:
        present in the bilinear form. */
    void UsePrecomputedSparsity(int ps = 1) { precompute_sparsity = ps; }
 
+   /** @brief Keep the sparsity pattern of the matrix fixed, for forms that
+       are reassembled many times, e.g. in time-dependent problems.
+
+       The matrix is allocated in CSR format with the precomputed sparsity
+       pattern (see UsePrecomputedSparsity()). The first Assemble() records the
+       positions of the entries of the element matrices in the matrix, and
+       the later calls add the element matrices directly at these positions.
+       To reassemble, set the form to zero (*this = 0.0) and call Assemble()
+       again. FormLinearSystem() and FormSystemMatrix() then redo the
+       elimination of the essential dofs only numerically, at the recorded
+       positions, if the list of essential true dofs has not changed.
+
+       This method should be called before the first assembly. It is ignored
+       with static condensation and it requires a conforming space. */
+   void UseFixedSparsity(bool fs = true) { fixed_sparsity = fs; }
+
    /** @brief Use the given CSR sparsity pattern to allocate the internal
        SparseMatrix.
 
@@ -160,7 +269,11 @@ public:
    virtual const double &Elem(int i, int j) const;
 
    /// Matrix vector multiplication.
-   virtual void Mult(const Vector &x, Vector &y) const { mat->Mult(x, y); }
+   virtual void Mult(const Vector &x, Vector &y) const
+   {
+      if (ext) { ext->Mult(x, y); }
+      else { mat->Mult(x, y); }
+   }
 
    void FullMult(const Vector &x, Vector &y) const
    { mat->Mult(x, y); mat_e->AddMult(x, y); }
@@ -179,7 +292,10 @@ public:
    { mat->AddMultTranspose(x, y); mat_e->AddMultTranspose(x, y); }
 
    virtual void MultTranspose (const Vector & x, Vector & y) const
-   { y = 0.0; AddMultTranspose (x, y); }
+   {
+      if (ext) { ext->MultTranspose(x, y); }
+      else { y = 0.0; AddMultTranspose (x, y); }
+   }
 
    double InnerProduct(const Vector &x, const Vector &y) const
    { return mat->InnerProduct (x, y); }
@@ -201,7 +317,13 @@ public:
       MFEM_VERIFY(mat, "mat is NULL and can't be dereferenced");
       return *mat;
    }
-   SparseMatrix *LoseMat() { SparseMatrix *tmp = mat; mat = NULL; return tmp; }
+   SparseMatrix *LoseMat()
+   {
+      SparseMatrix *tmp = mat;
+      mat = NULL;
+      mat_scatter.Reset();
+      return tmp;
+   }
 
    /// Returns a reference to the sparse matrix of eliminated b.c.
    const SparseMatrix &SpMatElim() const
@@ -285,6 +407,19 @@ public:
    /// Form the linear system matrix A, see FormLinearSystem() for details.
    void FormSystemMatrix(const Array<int> &ess_tdof_list, SparseMatrix &A);
 
+   /** @brief Version of FormLinearSystem() where the system operator is
+       returned in the OperatorHandle @a A.
+
+       With AssemblyLevel::PARTIAL, @a A holds a ConstrainedOperator that
+       applies the partially assembled form on the true dofs; otherwise @a A
+       holds a SparseMatrix that references the assembled system matrix. */
+   void FormLinearSystem(const Array<int> &ess_tdof_list, Vector &x, Vector &b,
+                         OperatorHandle &A, Vector &X, Vector &B,
+                         int copy_interior = 0);
+
+   /// Form the linear system operator @a A, see FormLinearSystem() for details.
+   void FormSystemMatrix(const Array<int> &ess_tdof_list, OperatorHandle &A);
+
    /// Recover the solution of a linear system formed with FormLinearSystem().
    /** Call this method after solving a linear system constructed using the
        FormLinearSystem() method to recover the solution as a GridFunction-size
@@ -0,0 +1,549 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of the partial assembly extension of class BilinearForm and
+// of the registry of templated kernels, TFormRegistry
+
+#include "fem.hpp"
+#include <typeinfo>
+
+namespace mfem
+{
+
+ElementRestriction::ElementRestriction(const FiniteElementSpace &f)
+   : fes(f),
+     ne(f.GetNE()),
+     ndofs(ne > 0 ? f.GetFE(0)->GetDof() : 0)
+{
+   MFEM_VERIFY(fes.GetVDim() == 1, "only scalar spaces are supported");
+
+   height = ne*ndofs;
+   width = fes.GetVSize();
+
+   indices.SetSize(height);
+   Array<int> dofs;
+   for (int e = 0; e < ne; e++)
+   {
+      fes.GetElementDofs(e, dofs);
+      MFEM_VERIFY(dofs.Size() == ndofs,
+                  "all elements must have the same number of dofs");
+      const Array<int> &dof_map = GetDofMap(*fes.GetFE(e));
+      for (int j = 0; j < ndofs; j++)
+      {
+         const int d = dof_map.Size() ? dofs[dof_map[j]] : dofs[j];
+         MFEM_VERIFY(d >= 0, "dof sign changes are not supported");
+         indices[e*ndofs + j] = d;
+      }
+   }
+
+   // Build the transpose map, keeping the E-vector indices of each L-vector
+   // entry in increasing order, so that MultTranspose() is deterministic.
+   offsets.SetSize(width + 1);
+   offsets = 0;
+   for (int i = 0; i < height; i++) { offsets[indices[i] + 1]++; }
+   for (int i = 0; i < width; i++) { offsets[i + 1] += offsets[i]; }
+   gather_map.SetSize(height);
+   for (int i = 0; i < height; i++)
+   {
+      gather_map[offsets[indices[i]]++] = i;
+   }
+   for (int i = width; i > 0; i--) { offsets[i] = offsets[i - 1]; }
+   offsets[0] = 0;
+}
+
+const Array<int> &ElementRestriction::GetDofMap(const FiniteElement &fe)
+{
+   static const Array<int> native_map;
+   const TensorBasisElement *tfe = dynamic_cast<const TensorBasisElement*>(&fe);
+   return tfe ? tfe->GetDofMap() : native_map;
+}
+
+void ElementRestriction::Mult(const Vector &x, Vector &y) const
+{
+   y.SetSize(height);
+   const double *d_x = x.GetData();
+   double *d_y = y.GetData();
+   for (int i = 0; i < height; i++)
+   {
+      d_y[i] = d_x[indices[i]];
+   }
+}
+
+void ElementRestriction::MultTranspose(const Vector &x, Vector &y) const
+{
+   y.SetSize(width);
+   const double *d_x = x.GetData();
+   double *d_y = y.GetData();
+   for (int i = 0; i < width; i++)
+   {
+      double s = 0.0;
+      for (int k = offsets[i]; k < offsets[i + 1]; k++)
+      {
+         s += d_x[gather_map[k]];
+      }
+      d_y[i] = s;
+   }
+}
+
+void ElementRestriction::MultElements(const Array<int> &elems,
+                                      const Vector &x, Vector &y) const
+{
+   y.SetSize(height);
+   const double *d_x = x.GetData();
+   double *d_y = y.GetData();
+   for (int i = 0; i < elems.Size(); i++)
+   {
+      const int *e_ind = indices.GetData() + elems[i]*ndofs;
+      double *e_y = d_y + elems[i]*ndofs;
+      for (int j = 0; j < ndofs; j++)
+      {
+         e_y[j] = d_x[e_ind[j]];
+      }
+   }
+}
+
+
+PABilinearFormExtension::PABilinearFormExtension(BilinearForm *form)
+   : Operator(form->Size()), a(form), fes(form->FESpace()), elem_restrict(NULL),
+     overlap(false)
+{
+   Update(NULL);
+}
+
+void PABilinearFormExtension::DeleteTForms()
+{
+   for (int i = 0; i < tforms.Size(); i++)
+   {
+      delete tforms[i];
+   }
+   tforms.SetSize(0);
+}
+
+void PABilinearFormExtension::Assemble()
+{
+   MFEM_VERIFY(a->GetBBFI()->Size() == 0 && a->GetFBFI()->Size() == 0 &&
+               a->GetBFBFI()->Size() == 0, "partial assembly supports only "
+               "domain integrators");
+
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   if (tforms.Size() != integrators.Size() || !a->TemplatedKernelsEnabled())
+   {
+      DeleteTForms();
+      tforms.SetSize(integrators.Size());
+      tforms = NULL;
+   }
+   tforms_pa.SetSize(integrators.Size());
+   tforms_pa = false;
+   for (int i = 0; i < integrators.Size(); i++)
+   {
+      if (a->TemplatedKernelsEnabled())
+      {
+         tforms[i] = TFormRegistry::Update(tforms[i], *integrators[i], *fes);
+      }
+      if (tforms[i])
+      {
+         tforms[i]->Assemble();
+      }
+      else
+      {
+         integrators[i]->AssemblePA(*fes);
+      }
+   }
+}
+
+void PABilinearFormExtension::Mult(const Vector &x, Vector &y) const
+{
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   elem_restrict->Mult(x, localX);
+   localY = 0.0;
+   for (int i = 0; i < integrators.Size(); i++)
+   {
+      if (!tforms[i]) { integrators[i]->AddMultPA(localX, localY); }
+   }
+   elem_restrict->MultTranspose(localY, y);
+   for (int i = 0; i < integrators.Size(); i++)
+   {
+      if (tforms[i]) { tforms[i]->Mult(x, tformY); y += tformY; }
+   }
+}
+
+void PABilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
+{
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   elem_restrict->Mult(x, localX);
+   localY = 0.0;
+   for (int i = 0; i < integrators.Size(); i++)
+   {
+      if (tforms[i] && !tforms[i]->IsSymmetric() && !tforms_pa[i])
+      {
+         // the templated kernels only implement the forward action
+         integrators[i]->AssemblePA(*fes);
+         tforms_pa[i] = true;
+      }
+      if (!tforms[i] || tforms_pa[i])
+      {
+         integrators[i]->AddMultTransposePA(localX, localY);
+      }
+   }
+   elem_restrict->MultTranspose(localY, y);
+   for (int i = 0; i < integrators.Size(); i++)
+   {
+      if (tforms[i] && !tforms_pa[i])
+      {
+         tforms[i]->MultTranspose(x, tformY);
+         y += tformY;
+      }
+   }
+}
+
+void PABilinearFormExtension::AddMultElements(const Array<int> &elems,
+                                              const Vector &x) const
+{
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   elem_restrict->MultElements(elems, x, localX);
+   for (int i = 0; i < integrators.Size(); i++)
+   {
+      if (tforms[i]) { tforms[i]->AddMultElements(elems, x, tformY); }
+      else { integrators[i]->AddMultPAElements(elems, localX, localY); }
+   }
+}
+
+void PABilinearFormExtension::EndElementMult(Vector &y) const
+{
+   elem_restrict->MultTranspose(localY, y);
+   for (int i = 0; i < tforms.Size(); i++)
+   {
+      // the templated kernels add their results to tformY
+      if (tforms[i]) { y += tformY; break; }
+   }
+}
+
+void PABilinearFormExtension::FormSystemOperator(
+   const Array<int> &ess_tdof_list, OperatorHandle &A)
+{
+   const Operator *P = fes->GetProlongationMatrix();
+   Operator *rap = this;
+   if (P)
+   {
+#ifdef MFEM_USE_MPI
+      const ParFiniteElementSpace *pfes =
+         dynamic_cast<const ParFiniteElementSpace*>(fes);
+      if (overlap && pfes && pfes->Conforming())
+      {
+         rap = new ParPAOverlapOperator(*this, *pfes);
+      }
+#endif
+      if (rap == this) { rap = new RAPOperator(*P, *this, *P); }
+   }
+   A.Reset(new ConstrainedOperator(rap, ess_tdof_list, rap != this));
+}
+
+void PABilinearFormExtension::FormLinearSystem(const Array<int> &ess_tdof_list,
+                                               Vector &x, Vector &b,
+                                               OperatorHandle &A,
+                                               Vector &X, Vector &B,
+                                               int copy_interior)
+{
+   FormSystemOperator(ess_tdof_list, A);
+
+   const Operator *P = fes->GetProlongationMatrix();
+   if (!P)
+   {
+      // X and B point to the same data as x and b
+      X.NewDataAndSize(x.GetData(), x.Size());
+      B.NewDataAndSize(b.GetData(), b.Size());
+   }
+   else
+   {
+      // Variational restriction with P
+      const SparseMatrix *R = fes->GetRestrictionMatrix();
+      B.SetSize(P->Width());
+      P->MultTranspose(b, B);
+      X.SetSize(R->Height());
+      R->Mult(x, X);
+   }
+
+   ConstrainedOperator *A_c = A.As<ConstrainedOperator>();
+   A_c->EliminateRHS(X, B);
+   if (!copy_interior) { X.SetSubVectorComplement(ess_tdof_list, 0.0); }
+}
+
+void PABilinearFormExtension::RecoverFEMSolution(const Vector &X,
+                                                 const Vector &b, Vector &x)
+{
+   const Operator *P = fes->GetProlongationMatrix();
+   if (P)
+   {
+      // Apply conforming prolongation
+      x.SetSize(P->Height());
+      P->Mult(X, x);
+   }
+   // Otherwise, X and x point to the same data
+}
+
+void PABilinearFormExtension::Update(FiniteElementSpace *nfes)
+{
+   if (nfes) { fes = nfes; }
+   delete elem_restrict;
+   elem_restrict = new ElementRestriction(*fes);
+   height = width = fes->GetVSize();
+   localX.SetSize(elem_restrict->Height());
+   localY.SetSize(elem_restrict->Height());
+   tformY.SetSize(height);
+   // the templated operators are recreated by the next call to Assemble()
+   DeleteTForms();
+}
+
+PABilinearFormExtension::~PABilinearFormExtension()
+{
+   DeleteTForms();
+   delete elem_restrict;
+}
+
+#ifdef MFEM_USE_MPI
+
+ParPAOverlapOperator::ParPAOverlapOperator(const PABilinearFormExtension &pa_,
+                                           const ParFiniteElementSpace &pfes_)
+   : Operator(pfes_.GetTrueVSize()),
+     pa(pa_),
+     pfes(pfes_),
+     P(*static_cast<const ConformingProlongationOperator*>(
+          pfes_.GetProlongationMatrix())),
+     px(pfes_.GetVSize()),
+     py(pfes_.GetVSize())
+{
+   MFEM_VERIFY(pfes.Conforming(), "only conforming spaces are supported");
+}
+
+void ParPAOverlapOperator::Mult(const Vector &x, Vector &y) const
+{
+   // The owned dofs of px are set by MultBegin(): these are all the dofs of
+   // the interior elements.
+   P.MultBegin(x, px);
+   pa.BeginElementMult();
+   pa.AddMultElements(pfes.GetInteriorElements(), px);
+   P.MultEnd(px);
+   pa.AddMultElements(pfes.GetSharedElements(), px);
+   pa.EndElementMult(py);
+   P.MultTranspose(py, y);
+}
+
+void ParPAOverlapOperator::MultTranspose(const Vector &x, Vector &y) const
+{
+   P.Mult(x, px);
+   pa.MultTranspose(px, py);
+   P.MultTranspose(py, y);
+}
+
+#endif
+
+
+void TFormOperator::MultTranspose(const Vector &x, Vector &y) const
+{
+   MFEM_VERIFY(IsSymmetric(), "the transpose of a non-symmetric templated "
+               "operator is not supported");
+   Mult(x, y);
+}
+
+TFormOperator::~TFormOperator()
+{
+   delete own_nodes;
+}
+
+TFormRegistry::Key::Key(int geom_, int mesh_order_, int sol_order_,
+                        int ir_order_, int kernel_)
+   : geom(geom_), mesh_order(mesh_order_), sol_order(sol_order_),
+     ir_order(ir_order_), kernel(kernel_)
+{
+   if (geom == Geometry::SEGMENT || geom == Geometry::SQUARE ||
+       geom == Geometry::CUBE)
+   {
+      ir_order = 2*(ir_order/2) + 1;
+   }
+}
+
+bool TFormRegistry::Key::operator<(const Key &k) const
+{
+   if (geom != k.geom) { return geom < k.geom; }
+   if (mesh_order != k.mesh_order) { return mesh_order < k.mesh_order; }
+   if (sol_order != k.sol_order) { return sol_order < k.sol_order; }
+   if (ir_order != k.ir_order) { return ir_order < k.ir_order; }
+   return kernel < k.kernel;
+}
+
+TFormRegistry::MapType &TFormRegistry::GetMap()
+{
+   static MapType map;
+   static bool initialized = false;
+   if (!initialized)
+   {
+      initialized = true;
+      RegisterBuiltins();
+   }
+   return map;
+}
+
+void TFormRegistry::Register(const Key &key, Factory factory)
+{
+   GetMap()[key] = factory;
+}
+
+TFormRegistry::Factory TFormRegistry::Find(const BilinearFormIntegrator &integ,
+                                           const FiniteElementSpace &fes,
+                                           Vector &coeff)
+{
+   Mesh *mesh = fes.GetMesh();
+   const int ne = mesh->GetNE();
+   const int dim = mesh->Dimension();
+   if (ne == 0 || fes.GetVDim() != 1 || fes.GetNURBSext() ||
+       mesh->SpaceDimension() != dim) { return NULL; }
+
+   // Single element geometry and H1 solution space
+   if (mesh->GetNumGeometries(dim) != 1) { return NULL; }
+   const int geom = mesh->GetElementBaseGeometry(0);
+   if (!dynamic_cast<const H1_FECollection*>(fes.FEColl())) { return NULL; }
+   const FiniteElement &fe = *fes.GetFE(0);
+
+   // Mesh nodes: H1, or none (first order mesh)
+   const GridFunction *nodes = mesh->GetNodes();
+   int mesh_order = 1;
+   if (nodes)
+   {
+      const FiniteElementSpace *nfes = nodes->FESpace();
+      if (!dynamic_cast<const H1_FECollection*>(nfes->FEColl()) ||
+          nfes->GetNURBSext()) { return NULL; }
+      mesh_order = nfes->GetFE(0)->GetOrder();
+   }
+
+   // Integrator type, coefficient and quadrature order; the default orders
+   // are the same as in the AssembleElementMatrix() methods of the
+   // integrators.
+   int kernel, ir_order;
+   coeff.SetSize(1);
+   coeff(0) = 1.0;
+   const IntegrationRule *ir = integ.GetIntRule();
+   if (typeid(integ) == typeid(MassIntegrator))
+   {
+      const MassIntegrator &mass = static_cast<const MassIntegrator&>(integ);
+      if (mass.GetCoefficient())
+      {
+         const ConstantCoefficient *cQ =
+            dynamic_cast<const ConstantCoefficient*>(mass.GetCoefficient());
+         if (!cQ) { return NULL; }
+         coeff(0) = cQ->constant;
+      }
+      kernel = MASS;
+      ir_order = 2*fe.GetOrder() + fes.GetElementTransformation(0)->OrderW();
+   }
+   else if (typeid(integ) == typeid(DiffusionIntegrator))
+   {
+      const DiffusionIntegrator &diff =
+         static_cast<const DiffusionIntegrator&>(integ);
+      if (diff.GetMatrixCoefficient()) { return NULL; }
+      if (diff.GetCoefficient())
+      {
+         const ConstantCoefficient *cQ =
+            dynamic_cast<const ConstantCoefficient*>(diff.GetCoefficient());
+         if (!cQ) { return NULL; }
+         coeff(0) = cQ->constant;
+      }
+      kernel = DIFFUSION;
+      ir_order = (fe.Space() == FunctionSpace::Pk) ?
+                 2*fe.GetOrder() - 2 : 2*fe.GetOrder() + dim - 1;
+   }
+   else if (typeid(integ) == typeid(ConvectionIntegrator))
+   {
+      const ConvectionIntegrator &conv =
+         static_cast<const ConvectionIntegrator&>(integ);
+      const VectorConstantCoefficient *vQ =
+         dynamic_cast<const VectorConstantCoefficient*>(&conv.GetVelocity());
+      if (!vQ || vQ->GetVec().Size() != dim) { return NULL; }
+      coeff = vQ->GetVec();
+      coeff *= conv.GetAlpha();
+      kernel = CONVECTION;
+      ElementTransformation &T0 = *fes.GetElementTransformation(0);
+      ir_order = T0.OrderGrad(&fe) + T0.Order() + fe.GetOrder();
+   }
+   else
+   {
+      return NULL;
+   }
+   if (fe.Space() != FunctionSpace::Pk && fe.Space() != FunctionSpace::Qk)
+   {
+      return NULL;
+   }
+   if (ir)
+   {
+      // only the standard rules of IntRules are used by the templated forms
+      if (ir != &IntRules.Get(geom, ir->GetOrder())) { return NULL; }
+      ir_order = ir->GetOrder();
+   }
+
+   MapType &map = GetMap();
+   MapType::iterator it =
+      map.find(Key(geom, mesh_order, fe.GetOrder(), ir_order, kernel));
+   return (it == map.end()) ? NULL : it->second;
+}
+
+TFormOperator *TFormRegistry::Update(TFormOperator *op,
+                                     const BilinearFormIntegrator &integ,
+                                     const FiniteElementSpace &fes)
+{
+   Vector coeff;
+   Factory factory = Find(integ, fes, coeff);
+   Mesh *mesh = fes.GetMesh();
+   const GridFunction *nodes = mesh->GetNodes();
+
+   if (op && factory && op->factory == factory && op->fes == &fes &&
+       op->fes_sequence == fes.GetSequence() && op->mesh_nodes == nodes &&
+       op->coeff.Size() == coeff.Size())
+   {
+      bool same_coeff = true;
+      for (int i = 0; i < coeff.Size(); i++)
+      {
+         if (op->coeff(i) != coeff(i)) { same_coeff = false; break; }
+      }
+      if (same_coeff)
+      {
+         // the vertices or the nodes may have moved
+         if (op->own_nodes) { mesh->GetNodes(*op->own_nodes); }
+         return op;
+      }
+   }
+   delete op;
+   if (!factory) { return NULL; }
+
+   // The templated mesh uses H1 nodes ordered byNODES
+   GridFunction *own_nodes = NULL;
+   if (!nodes || nodes->FESpace()->GetOrdering() != Ordering::byNODES)
+   {
+      const int dim = mesh->Dimension();
+      const int mesh_order =
+         nodes ? nodes->FESpace()->GetFE(0)->GetOrder() : 1;
+      FiniteElementCollection *nfec = new H1_FECollection(mesh_order, dim);
+      FiniteElementSpace *nfes =
+         new FiniteElementSpace(mesh, nfec, dim, Ordering::byNODES);
+      own_nodes = new GridFunction(nfes);
+      own_nodes->MakeOwner(nfec);
+      mesh->GetNodes(*own_nodes);
+   }
+
+   op = factory(fes, own_nodes ? *own_nodes : *nodes, coeff);
+   op->own_nodes = own_nodes;
+   op->factory = factory;
+   op->fes = &fes;
+   op->fes_sequence = fes.GetSequence();
+   op->mesh_nodes = nodes;
+   op->coeff = coeff;
+   return op;
+}
+
+}
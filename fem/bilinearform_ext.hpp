@@ -0,0 +1,338 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_BILINEARFORM_EXT
+#define MFEM_BILINEARFORM_EXT
+
+#include "../config/config.hpp"
+#include "../linalg/linalg.hpp"
+#include "fespace.hpp"
+#include <map>
+
+namespace mfem
+{
+
+class BilinearForm;
+class BilinearFormIntegrator;
+class GridFunction;
+class TFormOperator;
+
+/// Enumeration defining the assembly level of a BilinearForm.
+class AssemblyLevel
+{
+public:
+   enum Type
+   {
+      /// Fully assembled form, i.e. a global sparse matrix (default).
+      FULL,
+      /** Partially assembled form: only the data at the quadrature points
+          (geometric factors times coefficient) is stored and the action of
+          the operator is computed element-by-element. */
+      PARTIAL
+   };
+};
+
+/** @brief Operator that extracts the element-local degrees of freedom (an
+    "E-vector") from a finite element vector (an "L-vector").
+
+    The E-vector stores the dofs of element @a e contiguously, at offset
+    e*ndofs, where ndofs is the (common) number of dofs per element. For
+    tensor-product elements (see TensorBasisElement), the local dofs are
+    ordered lexicographically; otherwise, the native element ordering is
+    used. The MultTranspose() method sums the element contributions back into
+    an L-vector. Only scalar spaces (vdim = 1) without dof sign changes are
+    supported. */
+class ElementRestriction : public Operator
+{
+protected:
+   const FiniteElementSpace &fes;
+   const int ne, ndofs;
+   /// E-vector index -> L-vector index map, of size ne*ndofs.
+   Array<int> indices;
+   /// CSR-type L-vector index -> E-vector indices map, used in MultTranspose.
+   Array<int> offsets, gather_map;
+
+public:
+   ElementRestriction(const FiniteElementSpace &f);
+
+   /// Extract the E-vector @a y from the L-vector @a x.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// Sum the E-vector @a x into the L-vector @a y.
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /** @brief Extract the blocks of the elements @a elems of the E-vector @a y
+       from the L-vector @a x; the other blocks of @a y are not changed. */
+   void MultElements(const Array<int> &elems, const Vector &x,
+                     Vector &y) const;
+
+   /// Return the number of dofs per element.
+   int GetNDofs() const { return ndofs; }
+
+   /** @brief Return the lexicographic-to-native dof map used for the
+       element @a fe; empty if the native ordering is used. */
+   static const Array<int> &GetDofMap(const FiniteElement &fe);
+};
+
+/** @brief Extension of a BilinearForm implementing the partial assembly
+    (matrix-free) level, see AssemblyLevel::PARTIAL.
+
+    Only domain integrators that implement the BilinearFormIntegrator methods
+    AssemblePA() and AddMultPA() are supported. Integrators with a matching
+    templated kernel in the TFormRegistry use that kernel instead, unless
+    disabled with BilinearForm::EnableTemplatedKernels(). */
+class PABilinearFormExtension : public Operator
+{
+protected:
+   BilinearForm *a;
+   const FiniteElementSpace *fes;
+   ElementRestriction *elem_restrict;
+   mutable Vector localX, localY;
+   /** Templated operators for the domain integrators; NULL entries use PA.
+       They are reused by subsequent assemblies, see TFormRegistry::Update(). */
+   Array<TFormOperator*> tforms;
+   mutable Vector tformY;
+   /** Set when the integrator of a non-symmetric templated operator has been
+       partially assembled for MultTranspose(). */
+   mutable Array<bool> tforms_pa;
+   /// Use ParPAOverlapOperator in FormSystemOperator(), when supported.
+   bool overlap;
+
+   void DeleteTForms();
+
+public:
+   PABilinearFormExtension(BilinearForm *form);
+
+   /// Partially assemble all domain integrators of the form.
+   void Assemble();
+
+   /** @brief Overlap communication with computation in the operator formed
+       by FormSystemOperator() for parallel conforming spaces, see
+       ParPAOverlapOperator. */
+   void EnableCommOverlap(bool enable = true) { overlap = enable; }
+
+   /// Operator action on L-vectors.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// Transpose operator action on L-vectors.
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /** @brief Start an operator action split by elements, see
+       AddMultElements(). */
+   /** The split action, BeginElementMult(), one or more AddMultElements() and
+       EndElementMult(), computes the same result as Mult(), but the input
+       only has to be set at the dofs of the elements being processed. This
+       is used to overlap the exchange of shared dofs in parallel with the
+       work on the interior elements, see ParPAOverlapOperator. */
+   void BeginElementMult() const { localY = 0.0; tformY = 0.0; }
+
+   /** @brief Add the action on the elements @a elems of the L-vector @a x,
+       which only has to be set at the dofs of these elements. */
+   void AddMultElements(const Array<int> &elems, const Vector &x) const;
+
+   /** @brief Finish the split action: sum the element results into the
+       L-vector @a y. */
+   void EndElementMult(Vector &y) const;
+
+   /** @brief Form the constrained operator on the true dofs, i.e.
+       P^t A P with the rows and columns of @a ess_tdof_list eliminated, see
+       ConstrainedOperator. The OperatorHandle @a A takes ownership of the
+       result. */
+   void FormSystemOperator(const Array<int> &ess_tdof_list, OperatorHandle &A);
+
+   /// Partial assembly version of BilinearForm::FormLinearSystem().
+   void FormLinearSystem(const Array<int> &ess_tdof_list, Vector &x, Vector &b,
+                         OperatorHandle &A, Vector &X, Vector &B,
+                         int copy_interior = 0);
+
+   /// Partial assembly version of BilinearForm::RecoverFEMSolution().
+   void RecoverFEMSolution(const Vector &X, const Vector &b, Vector &x);
+
+   /// Rebuild the element restriction, e.g. after the space was updated.
+   void Update(FiniteElementSpace *nfes);
+
+   virtual ~PABilinearFormExtension();
+};
+
+#ifdef MFEM_USE_MPI
+class ParFiniteElementSpace;
+class ConformingProlongationOperator;
+
+/** @brief The partially assembled operator P^t A P on the true dofs of a
+    conforming ParFiniteElementSpace, overlapping the exchange of shared dofs
+    with computation.
+
+    Mult() starts the exchange of the shared dofs of the input, applies A to
+    the elements without shared dofs while the messages are in flight, and
+    finishes with the elements that touch shared dofs, see
+    ParFiniteElementSpace::GetInteriorElements(). MultTranspose() does not
+    overlap. */
+class ParPAOverlapOperator : public Operator
+{
+protected:
+   const PABilinearFormExtension &pa;
+   const ParFiniteElementSpace &pfes;
+   const ConformingProlongationOperator &P;
+   mutable Vector px, py;
+
+public:
+   ParPAOverlapOperator(const PABilinearFormExtension &pa_,
+                        const ParFiniteElementSpace &pfes_);
+
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+};
+#endif
+
+/** @brief Registry of pre-instantiated TBilinearForm specializations, used by
+    BilinearForm to dispatch domain integrators to the templated kernels at
+    runtime.
+
+    Specializations are identified by a Key: element geometry, order of the
+    mesh nodes, order of the (scalar, H1) solution space, order of the
+    quadrature rule and integrator kernel. A set of specializations for the
+    mass, diffusion and convection integrators on low-order meshes is built
+    into the library, see fem/tbilinearform.cpp; more can be added with
+    Register() and the class template TFormOperatorH1 from tbilininteg.hpp. */
+class TFormRegistry
+{
+public:
+   /// Integrator kernels supported by the registry.
+   enum Kernel
+   {
+      MASS,       ///< MassIntegrator with a constant coefficient
+      DIFFUSION,  ///< DiffusionIntegrator with a constant scalar coefficient
+      CONVECTION  ///< ConvectionIntegrator with a constant velocity
+   };
+
+   struct Key
+   {
+      int geom, mesh_order, sol_order, ir_order, kernel;
+
+      /** @brief For tensor-product geometries, the Gauss-Legendre rules of
+          orders 2n-2 and 2n-1 are the same, so the quadrature order is
+          rounded up to an odd number. */
+      Key(int geom_, int mesh_order_, int sol_order_, int ir_order_,
+          int kernel_);
+
+      bool operator<(const Key &k) const;
+   };
+
+   /** @brief Factory function: construct the templated operator on the space
+       @a fes using the given H1 mesh nodes (ordered byNODES) and the constant
+       coefficient @a coeff. */
+   /** The coefficient has one entry for the MASS and DIFFUSION kernels and
+       the (scaled) velocity for the CONVECTION kernel. */
+   typedef TFormOperator *(*Factory)(const FiniteElementSpace &fes,
+                                     const GridFunction &nodes,
+                                     const Vector &coeff);
+
+   /// Add (or replace) the specialization for the given @a key.
+   static void Register(const Key &key, Factory factory);
+
+   /** @brief Return a new TFormOperator implementing the domain integrator
+       @a integ on the space @a fes, or NULL if there is no matching
+       specialization.
+
+       Matching requires a scalar H1 space on a mesh with a single element
+       geometry and an integrator type and coefficient supported by one of the
+       Kernel%s. Meshes without nodes are treated as first order meshes; when
+       the mesh nodes are not ordered byNODES, the returned operator uses (and
+       owns) a reordered copy of them. The copy is not updated when the mesh
+       moves; use Update() to reuse the operator after that. */
+   static TFormOperator *Create(const BilinearFormIntegrator &integ,
+                                const FiniteElementSpace &fes)
+   { return Update(NULL, integ, fes); }
+
+   /** @brief Same as Create(), but reuse the operator @a op returned by a
+       previous call, if it matches the same specialization, space (with the
+       same sequence number), mesh nodes and coefficient; otherwise @a op is
+       deleted. */
+   /** This caches the dispatch decision of a form between assemblies. A
+       reused operator refreshes its copy of the mesh nodes, if it owns one,
+       and has to be assembled again, see TFormOperator::Assemble(). */
+   static TFormOperator *Update(TFormOperator *op,
+                                const BilinearFormIntegrator &integ,
+                                const FiniteElementSpace &fes);
+
+private:
+   typedef std::map<Key,Factory> MapType;
+
+   /** Return the factory matching @a integ on @a fes, or NULL, and set the
+       constant coefficient @a coeff, see Create(). */
+   static Factory Find(const BilinearFormIntegrator &integ,
+                       const FiniteElementSpace &fes, Vector &coeff);
+
+   /// Return the registry, adding the built-in specializations on first use.
+   static MapType &GetMap();
+
+   /// Add the built-in specializations, defined in fem/tbilinearform.cpp.
+   static void RegisterBuiltins();
+};
+
+/** @brief Abstract interface to a pre-instantiated templated (compile-time
+    sized) implementation of a single domain integrator on a given finite
+    element space, see TBilinearForm and TFormRegistry.
+
+    The operator acts on L-vectors. It may own a copy of the mesh nodes, see
+    TFormRegistry::Create(). */
+class TFormOperator : public Operator
+{
+protected:
+   /// Mesh nodes used by the templated form when it owns them, or NULL.
+   GridFunction *own_nodes;
+
+   /** Dispatch data set by TFormRegistry::Create(): the factory, the space
+       and its sequence, the mesh nodes and the coefficient. They are compared
+       by TFormRegistry::Update() to decide if the operator can be reused. */
+   TFormRegistry::Factory factory;
+   const FiniteElementSpace *fes;
+   long fes_sequence;
+   const GridFunction *mesh_nodes;
+   Vector coeff;
+
+   friend class TFormRegistry;
+
+public:
+   TFormOperator(int s)
+      : Operator(s), own_nodes(NULL), factory(NULL), fes(NULL),
+        fes_sequence(-1), mesh_nodes(NULL) { }
+
+   /** @brief Add the element matrices to the BilinearForm @a a, using
+       BilinearForm::AssembleElementMatrix(). */
+   virtual void AssembleBilinearForm(BilinearForm &a) const = 0;
+
+   /** @brief Partial assembly: compute and store the quadrature point data
+       used by subsequent calls to Mult(). */
+   virtual void Assemble() = 0;
+
+   /// Operator action: y = A x.
+   virtual void Mult(const Vector &x, Vector &y) const = 0;
+
+   /** @brief Add the action on the elements @a elems to @a y; @a x only has
+       to be set at the dofs of these elements. Requires Assemble(). */
+   virtual void AddMultElements(const Array<int> &elems, const Vector &x,
+                                Vector &y) const = 0;
+
+   /** @brief Return true if the operator is symmetric, i.e. MultTranspose()
+       is the same as Mult(), e.g. for the mass and diffusion kernels. */
+   virtual bool IsSymmetric() const = 0;
+
+   /// Transpose action, supported only by symmetric operators.
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   virtual ~TFormOperator();
+};
+
+}
+
+#endif
@@ -361,6 +361,66 @@ void MixedScalarVectorIntegrator::AssembleElementMatrix2(
    }
 }
 
+// Add to elmat the matrix
+//    M(i,j) = sum_q D(q) prod_d A[d](i_d,q_d) C[d](j_d,q_d),
+// where A[d] and C[d] are 1D factors of a BasisTable (dofs x points), i, j and
+// q are lexicographic multi-indices and dof_map maps i and j to the element
+// dofs (see TensorBasisElement::GetDofMap()). The points are contracted one
+// direction at a time (sum factorization), with O(p^(2 dim+1)) operations
+// instead of the O(p^(3 dim)) of the point-by-point assembly. If
+// add_transpose is true, M^t is also added.
+static void AddSumFactorizedMatrix(int dim, const DenseMatrix *A[],
+                                   const DenseMatrix *C[], const double *D,
+                                   const Array<int> &dof_map,
+                                   bool add_transpose, DenseMatrix &K,
+                                   Vector &t0, Vector &t1, DenseMatrix &elmat)
+{
+   const int p = A[0]->Height(), nq = A[0]->Width();
+   // After the contraction in direction d the tensor has size
+   // (p^2)^(d+1) nq^(dim-d-1).
+   int n[3] = { 1, 1, 1 }, max_size = 0, size = 1;
+   for (int d = 0; d < dim; d++) { n[d] = nq; size *= nq; }
+   for (int d = 0; d < dim; d++)
+   {
+      size = (size / nq)*p*p;
+      max_size = std::max(max_size, size);
+   }
+   t0.SetSize(max_size);
+   t1.SetSize(max_size);
+
+   // K(i + p*j, q) = A[d](i,q) C[d](j,q)
+   K.SetSize(p*p, nq);
+   const double *src = D;
+   double *dst = t0.GetData();
+   for (int d = 0; d < dim; d++)
+   {
+      for (int q = 0; q < nq; q++)
+         for (int j = 0; j < p; j++)
+            for (int i = 0; i < p; i++)
+            {
+               K(i + p*j, q) = (*A[d])(i,q)*(*C[d])(j,q);
+            }
+      PABasis::Contract(K, false, d, n, src, dst);
+      src = dst;
+      dst = (dst == t0.GetData()) ? t1.GetData() : t0.GetData();
+   }
+
+   // src is indexed by (i_0, j_0, i_1, j_1, ...), i_0 fastest.
+   for (int r = 0; r < size; r++)
+   {
+      int s = r, i = 0, j = 0, stride = 1;
+      for (int d = 0; d < dim; d++)
+      {
+         i += (s % p)*stride; s /= p;
+         j += (s % p)*stride; s /= p;
+         stride *= p;
+      }
+      if (dof_map.Size()) { i = dof_map[i]; j = dof_map[j]; }
+      elmat(i,j) += src[r];
+      if (add_transpose) { elmat(j,i) += src[r]; }
+   }
+}
+
 void DiffusionIntegrator::AssembleElementMatrix
 ( const FiniteElement &el, ElementTransformation &Trans,
   DenseMatrix &elmat )
@@ -404,18 +464,95 @@ void DiffusionIntegrator::AssembleElementMatrix
       }
    }
 
+   const GeometricFactors *geom =
+      Trans.GetGeometricFactors(*ir, GeometricFactors::DETERMINANTS |
+                                GeometricFactors::ADJUGATES);
+   const BasisTable *basis = el.GetBasisTable(*ir);
+   DenseMatrix basis_dshape;
+
    elmat = 0.0;
+   if (basis && basis->IsTensor() && dim > 1 && square)
+   {
+      // Sum factorization: elmat = sum_{k,l} G_k^t D_kl G_l, where G_k is the
+      // tensor product of G1d in direction k and of B1d in the others, and
+      // D = w/det(J) adj(J) Q adj(J)^t at each point.
+      const int nq = ir->GetNPoints();
+      Vector D(dim*dim*nq);
+      DenseMatrix adj(dim), Dq(dim), mq_i(dim), adj_mq(dim), K;
+      Vector t0, t1;
+      for (int i = 0; i < nq; i++)
+      {
+         const IntegrationPoint &ip = ir->IntPoint(i);
+         Trans.SetIntPoint(&ip);
+         if (geom)
+         {
+            w = geom->GetDetJ(Trans.ElementNo, i);
+            geom->GetAdjugateJacobian(Trans.ElementNo, i, adj);
+         }
+         else
+         {
+            w = Trans.Weight();
+            adj = Trans.AdjugateJacobian();
+         }
+         w = ip.weight / w;
+         if (!MQ)
+         {
+            if (Q) { w *= Q->Eval(Trans, ip); }
+            MultAAt(adj, Dq);
+         }
+         else
+         {
+            MQ->Eval(mq_i, Trans, ip);
+            Mult(adj, mq_i, adj_mq);
+            MultABt(adj_mq, adj, Dq);
+         }
+         for (int l = 0; l < dim; l++)
+            for (int k = 0; k < dim; k++)
+            {
+               D((k + dim*l)*nq + i) = w*Dq(k,l);
+            }
+      }
+
+      const Array<int> &dof_map = ElementRestriction::GetDofMap(el);
+      const DenseMatrix *A[3], *C[3];
+      for (int k = 0; k < dim; k++)
+      {
+         // With a symmetric D, the (l,k) term is the transpose of (k,l).
+         for (int l = (MQ ? 0 : k); l < dim; l++)
+         {
+            for (int d = 0; d < dim; d++)
+            {
+               A[d] = (d == k) ? &basis->G1d : &basis->B1d;
+               C[d] = (d == l) ? &basis->G1d : &basis->B1d;
+            }
+            AddSumFactorizedMatrix(dim, A, C, D.GetData() + (k + dim*l)*nq,
+                                   dof_map, !MQ && k != l, K, t0, t1, elmat);
+         }
+      }
+      return;
+   }
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
-      el.CalcDShape(ip, dshape);
+      if (basis) { basis->GetDShape(i, basis_dshape); }
+      else { el.CalcDShape(ip, dshape); }
+      const DenseMatrix &dshape_i = basis ? basis_dshape : dshape;
 
       Trans.SetIntPoint(&ip);
-      w = Trans.Weight();
-      w = ip.weight / (square ? w : w*w*w);
       // AdjugateJacobian = / adj(J),         if J is square
       //                    \ adj(J^t.J).J^t, otherwise
-      Mult(dshape, Trans.AdjugateJacobian(), dshapedxt);
+      if (geom)
+      {
+         w = geom->GetDetJ(Trans.ElementNo, i);
+         geom->GetAdjugateJacobian(Trans.ElementNo, i, invdfdx);
+         Mult(dshape_i, invdfdx, dshapedxt);
+      }
+      else
+      {
+         w = Trans.Weight();
+         Mult(dshape_i, Trans.AdjugateJacobian(), dshapedxt);
+      }
+      w = ip.weight / (square ? w : w*w*w);
       if (!MQ)
       {
          if (Q)
@@ -747,20 +884,47 @@ void MassIntegrator::AssembleElementMatrix
       }
    }
 
+   const GeometricFactors *geom =
+      Trans.GetGeometricFactors(*ir, GeometricFactors::DETERMINANTS);
+   const BasisTable *basis = el.GetBasisTable(*ir);
+   Vector basis_shape;
+
    elmat = 0.0;
+   if (basis && basis->IsTensor() && basis->dim > 1)
+   {
+      // Sum factorization: elmat = B^t D B with B the tensor product of B1d.
+      const int nq = ir->GetNPoints();
+      Vector D(nq), t0, t1;
+      DenseMatrix K;
+      for (int i = 0; i < nq; i++)
+      {
+         const IntegrationPoint &ip = ir->IntPoint(i);
+         Trans.SetIntPoint(&ip);
+         D(i) = (geom ? geom->GetDetJ(Trans.ElementNo, i) : Trans.Weight()) *
+                ip.weight;
+         if (Q) { D(i) *= Q->Eval(Trans, ip); }
+      }
+      const DenseMatrix *B[3] = { &basis->B1d, &basis->B1d, &basis->B1d };
+      AddSumFactorizedMatrix(basis->dim, B, B, D.GetData(),
+                             ElementRestriction::GetDofMap(el), false, K, t0,
+                             t1, elmat);
+      return;
+   }
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
-      el.CalcShape(ip, shape);
+      if (basis) { basis->GetShape(i, basis_shape); }
+      else { el.CalcShape(ip, shape); }
 
       Trans.SetIntPoint (&ip);
-      w = Trans.Weight() * ip.weight;
+      w = (geom ? geom->GetDetJ(Trans.ElementNo, i) : Trans.Weight()) *
+          ip.weight;
       if (Q)
       {
          w *= Q -> Eval(Trans, ip);
       }
 
-      AddMult_a_VVt(w, shape, elmat);
+      AddMult_a_VVt(w, basis ? basis_shape : shape, elmat);
    }
 }
 
@@ -880,6 +1044,9 @@ void ConvectionIntegrator::AssembleElementMatrix(
 
    Q.Eval(Q_ir, Trans, *ir);
 
+   const GeometricFactors *geom =
+      Trans.GetGeometricFactors(*ir, GeometricFactors::ADJUGATES);
+
    elmat = 0.0;
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
@@ -887,8 +1054,12 @@ void ConvectionIntegrator::AssembleElementMatrix(
       el.CalcDShape(ip, dshape);
       el.CalcShape(ip, shape);
 
-      Trans.SetIntPoint(&ip);
-      CalcAdjugate(Trans.Jacobian(), adjJ);
+      if (geom) { geom->GetAdjugateJacobian(Trans.ElementNo, i, adjJ); }
+      else
+      {
+         Trans.SetIntPoint(&ip);
+         CalcAdjugate(Trans.Jacobian(), adjJ);
+      }
       Q_ir.GetColumnReference(i, vec1);
       vec1 *= alpha * ip.weight;
 
@@ -18,6 +18,80 @@
 namespace mfem
 {
 
+class FiniteElementSpace;
+
+/** @brief Basis functions and their reference gradients evaluated at the
+    points of an IntegrationRule, as used by the partial assembly kernels.
+
+    For tensor-product elements (see TensorBasisElement) integrated with the
+    default (tensor-product) rules only the 1D factors are stored and the
+    evaluation uses sum factorization; in that case the element dofs and the
+    quadrature points are ordered lexicographically. Otherwise the full
+    matrices are stored, with the columns following the dof ordering of
+    ElementRestriction. */
+class PABasis
+{
+protected:
+   bool tensor;
+   int dim, ndofs, nqpt, ndof1d, nqpt1d;
+   const IntegrationRule *ir;
+   /// Tensor case: B1d(q,i) and G1d(q,i), values and derivatives in 1D.
+   DenseMatrix B1d, G1d;
+   /// General case: B(q,i) and G(k)(q,i), values and k-th derivatives.
+   DenseMatrix B;
+   DenseTensor G;
+   mutable Vector t0, t1;
+
+   /** Apply the tensor-product matrix A[dim-1] x ... x A[0] (or its transpose)
+       to @a in; returns a pointer to @a work, or to internal storage if
+       @a work is NULL, holding the result. */
+   const double *TensorApply(const DenseMatrix *A[], bool trans,
+                             const double *in, double *work) const;
+
+public:
+   /** @brief Contract the tensor @a in of dimensions n[0] x n[1] x n[2] (the
+       first index is the fastest) with the matrix @a A along the direction
+       @a dir, i.e. out(..,i,..) = sum_j A(i,j) in(..,j,..), or with A^t if
+       @a trans is true. On exit, n[dir] is set to the new size in direction
+       @a dir. */
+   static void Contract(const DenseMatrix &A, bool trans, int dir, int n[3],
+                        const double *in, double *out);
+
+   PABasis() : tensor(false), dim(0), ndofs(0), nqpt(0), ndof1d(0), nqpt1d(0),
+      ir(NULL) { }
+
+   /** @brief Evaluate the basis of @a fe at the points of @a irule or, if
+       @a irule is NULL, at the points of the default rule of the given
+       @a order. */
+   void Setup(const FiniteElement &fe, const IntegrationRule *irule,
+              int order);
+
+   /// Return the IntegrationRule used in the last call to Setup().
+   const IntegrationRule &GetRule() const { return *ir; }
+
+   bool IsTensor() const { return tensor; }
+   int GetNDofs() const { return ndofs; }
+   int GetNPoints() const { return nqpt; }
+
+   /** @brief Size of the optional @a work array of the methods below: the
+       methods use internal work vectors when it is NULL, so threads calling
+       them at the same time must each pass their own array. */
+   int GetWorkSize() const { return t0.Size() + t1.Size(); }
+
+   /// Compute the values @a qx at the quadrature points from the dofs @a x.
+   void Values(const double *x, double *qx, double *work = NULL) const;
+
+   /// Add the transpose of Values() applied to @a qx to @a y.
+   void AddValuesT(const double *qx, double *y, double *work = NULL) const;
+
+   /** @brief Compute the reference gradients @a qg at the quadrature points
+       from the dofs @a x; qg[k*nqpt + q] is the k-th derivative at point q. */
+   void Gradients(const double *x, double *qg, double *work = NULL) const;
+
+   /// Add the transpose of Gradients() applied to @a qg to @a y.
+   void AddGradientsT(const double *qg, double *y, double *work = NULL) const;
+};
+
 /// Abstract base class BilinearFormIntegrator
 class BilinearFormIntegrator : public NonlinearFormIntegrator
 {
@@ -26,6 +100,29 @@ protected:
       NonlinearFormIntegrator(ir) { }
 
 public:
+   /// Method defining partial assembly.
+   /** The result of the partial assembly is stored internally so that it can
+       be used later in the methods AddMultPA() and AddMultTransposePA(). */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   /// Method for partially assembled action.
+   /** Perform the action of the integrator on the input @a x and add the
+       result to the output @a y. Both @a x and @a y are E-vectors, i.e. they
+       hold the element-local dofs as defined by ElementRestriction. */
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   /// Method for partially assembled transposed action, see AddMultPA().
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const;
+
+   /** @brief Partially assembled action on the elements @a elems only, see
+       AddMultPA(). */
+   /** Only the E-vector blocks of the listed elements are read from @a x and
+       updated in @a y. Used to split the operator action into the elements
+       with and without shared dofs, see ParFiniteElementSpace::
+       GetInteriorElements(). */
+   virtual void AddMultPAElements(const Array<int> &elems, const Vector &x,
+                                  Vector &y) const;
+
    /// Given a particular Finite Element computes the element matrix elmat.
    virtual void AssembleElementMatrix(const FiniteElement &el,
                                       ElementTransformation &Trans,
@@ -63,6 +160,15 @@ public:
                                     const Vector &elfun, DenseMatrix &elmat)
    { AssembleElementMatrix(el, Tr, elmat); }
 
+   /** @brief Return true if AssembleElementMatrix() can be called concurrently
+       from multiple threads, each thread using its own transformation. */
+   /** This is used by BilinearForm::Assemble() to enable the threaded
+       assembly. Integrators that store work arrays as members must return
+       false, unless the arrays are local when MFEM_THREAD_SAFE is defined.
+       The coefficients used by the integrator are assumed to be thread-safe as
+       well. */
+   virtual bool IsThreadSafe() const { return false; }
+
    virtual void AssembleFaceGrad(const FiniteElement &el1,
                                  const FiniteElement &el2,
                                  FaceElementTransformations &Tr,
@@ -1587,6 +1693,15 @@ private:
    Coefficient *Q;
    MatrixCoefficient *MQ;
 
+   // Partial assembly data: basis at the quadrature points and the matrices
+   // w/det(J) adj(J) Q adj(J)^t at all quadrature points of all elements.
+   PABasis pa_basis;
+   Vector pa_data;
+   mutable Vector pa_qg, pa_qv;
+
+   void AddMultPAElement(int e, bool transpose, const Vector &x,
+                         Vector &y) const;
+
 public:
    /// Construct a diffusion integrator with coefficient Q = 1
    DiffusionIntegrator() { Q = NULL; MQ = NULL; }
@@ -1597,11 +1712,20 @@ public:
    /// Construct a diffusion integrator with a matrix coefficient q
    DiffusionIntegrator (MatrixCoefficient &q) : MQ(&q) { Q = NULL; }
 
+   /// Return the scalar coefficient, or NULL if not set.
+   Coefficient *GetCoefficient() const { return Q; }
+
+   /// Return the matrix coefficient, or NULL if not set.
+   MatrixCoefficient *GetMatrixCoefficient() const { return MQ; }
+
    /** Given a particular Finite Element
        computes the element stiffness matrix elmat. */
    virtual void AssembleElementMatrix(const FiniteElement &el,
                                       ElementTransformation &Trans,
                                       DenseMatrix &elmat);
+#ifdef MFEM_THREAD_SAFE
+   virtual bool IsThreadSafe() const { return true; }
+#endif
    /** Given a trial and test Finite Element computes the element stiffness
        matrix elmat. */
    virtual void AssembleElementMatrix2(const FiniteElement &trial_fe,
@@ -1622,6 +1746,15 @@ public:
    virtual double ComputeFluxEnergy(const FiniteElement &fluxelem,
                                     ElementTransformation &Trans,
                                     Vector &flux, Vector *d_energy = NULL);
+
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultPAElements(const Array<int> &elems, const Vector &x,
+                                  Vector &y) const;
 };
 
 /** Class for local mass matrix assembling a(u,v) := (Q u, v) */
@@ -1633,6 +1766,14 @@ protected:
 #endif
    Coefficient *Q;
 
+   // Partial assembly data: basis at the quadrature points and the values
+   // w det(J) Q at all quadrature points of all elements.
+   PABasis pa_basis;
+   Vector pa_data;
+   mutable Vector pa_qx;
+
+   void AddMultPAElement(int e, const Vector &x, Vector &y) const;
+
 public:
    MassIntegrator(const IntegrationRule *ir = NULL)
       : BilinearFormIntegrator(ir) { Q = NULL; }
@@ -1640,15 +1781,31 @@ public:
    MassIntegrator(Coefficient &q, const IntegrationRule *ir = NULL)
       : BilinearFormIntegrator(ir), Q(&q) { }
 
+   /// Return the coefficient, or NULL if the coefficient is 1.
+   Coefficient *GetCoefficient() const { return Q; }
+
    /** Given a particular Finite Element
        computes the element mass matrix elmat. */
    virtual void AssembleElementMatrix(const FiniteElement &el,
                                       ElementTransformation &Trans,
                                       DenseMatrix &elmat);
+#ifdef MFEM_THREAD_SAFE
+   virtual bool IsThreadSafe() const { return true; }
+#endif
    virtual void AssembleElementMatrix2(const FiniteElement &trial_fe,
                                        const FiniteElement &test_fe,
                                        ElementTransformation &Trans,
                                        DenseMatrix &elmat);
+
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const
+   { AddMultPA(x, y); }
+
+   virtual void AddMultPAElements(const Array<int> &elems, const Vector &x,
+                                  Vector &y) const;
 };
 
 class BoundaryMassIntegrator : public MassIntegrator
@@ -1675,12 +1832,39 @@ private:
    VectorCoefficient &Q;
    double alpha;
 
+   // Partial assembly data: basis at the quadrature points and the vectors
+   // alpha w adj(J) Q at all quadrature points of all elements.
+   PABasis pa_basis;
+   Vector pa_data;
+   mutable Vector pa_qx, pa_qg;
+
+   void AddMultPAElement(int e, const Vector &x, Vector &y) const;
+
 public:
    ConvectionIntegrator(VectorCoefficient &q, double a = 1.0)
       : Q(q) { alpha = a; }
+
+   /// Return the velocity coefficient.
+   VectorCoefficient &GetVelocity() const { return Q; }
+
+   /// Return the scaling factor of the velocity.
+   double GetAlpha() const { return alpha; }
+
    virtual void AssembleElementMatrix(const FiniteElement &,
                                       ElementTransformation &,
                                       DenseMatrix &);
+#ifdef MFEM_THREAD_SAFE
+   virtual bool IsThreadSafe() const { return true; }
+#endif
+
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultPAElements(const Array<int> &elems, const Vector &x,
+                                  Vector &y) const;
 };
 
 /// alpha (q . grad u, v) using the "group" FE discretization
@@ -1863,6 +2047,9 @@ public:
    virtual void AssembleElementMatrix(const FiniteElement &el,
                                       ElementTransformation &Trans,
                                       DenseMatrix &elmat);
+#ifdef MFEM_THREAD_SAFE
+   virtual bool IsThreadSafe() const { return true; }
+#endif
 
    virtual void ComputeElementFlux(const FiniteElement &el,
                                    ElementTransformation &Trans,
@@ -1929,6 +2116,9 @@ public:
    virtual void AssembleElementMatrix(const FiniteElement &el,
                                       ElementTransformation &Trans,
                                       DenseMatrix &elmat);
+#ifdef MFEM_THREAD_SAFE
+   virtual bool IsThreadSafe() const { return true; }
+#endif
    virtual void AssembleElementMatrix2(const FiniteElement &trial_fe,
                                        const FiniteElement &test_fe,
                                        ElementTransformation &Trans,
@@ -1976,6 +2166,9 @@ public:
    virtual void AssembleElementMatrix(const FiniteElement &el,
                                       ElementTransformation &Trans,
                                       DenseMatrix &elmat);
+#ifdef MFEM_THREAD_SAFE
+   virtual bool IsThreadSafe() const { return true; }
+#endif
 };
 
 /** Integrator for
@@ -2033,6 +2226,9 @@ public:
    virtual void AssembleElementMatrix(const FiniteElement &,
                                       ElementTransformation &,
                                       DenseMatrix &);
+#ifdef MFEM_THREAD_SAFE
+   virtual bool IsThreadSafe() const { return true; }
+#endif
 };
 
 /** Integrator for the DG form:
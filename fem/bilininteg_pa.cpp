@@ -0,0 +1,530 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Partial assembly (matrix-free) methods of the bilinear form integrators
+
+#include "fem.hpp"
+
+namespace mfem
+{
+
+void PABasis::Contract(const DenseMatrix &A, bool trans, int dir, int n[3],
+                       const double *in, double *out)
+{
+   const int m_in = n[dir];
+   const int m_out = trans ? A.Width() : A.Height();
+   int inner = 1, outer = 1;
+   for (int d = 0; d < dir; d++) { inner *= n[d]; }
+   for (int d = dir + 1; d < 3; d++) { outer *= n[d]; }
+
+   // op(A)(i,j) = a[i*si + j*sj]
+   const double *a = A.Data();
+   const int si = trans ? A.Height() : 1, sj = trans ? 1 : A.Height();
+   if (inner == 1)
+   {
+      // Contiguous direction: one dot product per output entry.
+      for (int o = 0; o < outer; o++)
+      {
+         const double *in_o = in + o*m_in;
+         double *out_o = out + o*m_out;
+         for (int i = 0; i < m_out; i++)
+         {
+            double sum = 0.0;
+            for (int j = 0; j < m_in; j++) { sum += a[i*si + j*sj]*in_o[j]; }
+            out_o[i] = sum;
+         }
+      }
+   }
+   else
+   {
+      for (int o = 0; o < outer; o++)
+      {
+         const double *in_o = in + o*inner*m_in;
+         double *out_o = out + o*inner*m_out;
+         for (int i = 0; i < m_out; i++)
+         {
+            double *out_oi = out_o + i*inner;
+            for (int s = 0; s < inner; s++) { out_oi[s] = 0.0; }
+            for (int j = 0; j < m_in; j++)
+            {
+               const double a_ij = a[i*si + j*sj];
+               const double *in_oj = in_o + j*inner;
+               for (int s = 0; s < inner; s++)
+               {
+                  out_oi[s] += a_ij*in_oj[s];
+               }
+            }
+         }
+      }
+   }
+   n[dir] = m_out;
+}
+
+void PABasis::Setup(const FiniteElement &fe, const IntegrationRule *irule,
+                    int order)
+{
+   MFEM_VERIFY(fe.GetMapType() == FiniteElement::VALUE,
+               "only scalar elements of map type VALUE are supported");
+
+   const TensorBasisElement *tfe =
+      dynamic_cast<const TensorBasisElement*>(&fe);
+
+   dim = fe.GetDim();
+   ndofs = fe.GetDof();
+   tensor = (tfe != NULL && irule == NULL);
+   ir = irule ? irule : &IntRules.Get(fe.GetGeomType(), order);
+   nqpt = ir->GetNPoints();
+
+   if (tensor)
+   {
+      const IntegrationRule &ir1d = IntRules.Get(Geometry::SEGMENT, order);
+      const Poly_1D::Basis &basis1d = tfe->GetBasis1D();
+      ndof1d = fe.GetOrder() + 1;
+      nqpt1d = ir1d.GetNPoints();
+      MFEM_VERIFY(TensorBasisElement::Pow(ndof1d, dim) == ndofs &&
+                  TensorBasisElement::Pow(nqpt1d, dim) == nqpt,
+                  "incompatible tensor-product element or integration rule");
+
+      Vector u(ndof1d), d(ndof1d);
+      B1d.SetSize(nqpt1d, ndof1d);
+      G1d.SetSize(nqpt1d, ndof1d);
+      for (int q = 0; q < nqpt1d; q++)
+      {
+         basis1d.Eval(ir1d.IntPoint(q).x, u, d);
+         for (int i = 0; i < ndof1d; i++)
+         {
+            B1d(q,i) = u(i);
+            G1d(q,i) = d(i);
+         }
+      }
+      const int max_size =
+         TensorBasisElement::Pow(std::max(ndof1d, nqpt1d), dim);
+      t0.SetSize(max_size);
+      t1.SetSize(max_size);
+      B.SetSize(0);
+      G.SetSize(0, 0, 0);
+   }
+   else
+   {
+      const Array<int> &dof_map = ElementRestriction::GetDofMap(fe);
+      Vector shape(ndofs);
+      DenseMatrix dshape(ndofs, dim);
+      B.SetSize(nqpt, ndofs);
+      G.SetSize(nqpt, ndofs, dim);
+      for (int q = 0; q < nqpt; q++)
+      {
+         const IntegrationPoint &ip = ir->IntPoint(q);
+         fe.CalcShape(ip, shape);
+         fe.CalcDShape(ip, dshape);
+         for (int i = 0; i < ndofs; i++)
+         {
+            const int j = dof_map.Size() ? dof_map[i] : i;
+            B(q,i) = shape(j);
+            for (int k = 0; k < dim; k++)
+            {
+               G(q,i,k) = dshape(j,k);
+            }
+         }
+      }
+      ndof1d = nqpt1d = 0;
+      B1d.SetSize(0);
+      G1d.SetSize(0);
+   }
+}
+
+const double *PABasis::TensorApply(const DenseMatrix *A[], bool trans,
+                                   const double *in, double *work) const
+{
+   int n[3] = { 1, 1, 1 };
+   for (int d = 0; d < dim; d++) { n[d] = trans ? nqpt1d : ndof1d; }
+
+   double *w0 = work ? work : t0.GetData();
+   double *w1 = work ? work + t0.Size() : t1.GetData();
+   const double *src = in;
+   double *dst = w0;
+   for (int d = 0; d < dim; d++)
+   {
+      Contract(*A[d], trans, d, n, src, dst);
+      src = dst;
+      dst = (dst == w0) ? w1 : w0;
+   }
+   return src;
+}
+
+void PABasis::Values(const double *x, double *qx, double *work) const
+{
+   if (tensor)
+   {
+      const DenseMatrix *A[3] = { &B1d, &B1d, &B1d };
+      const double *r = TensorApply(A, false, x, work);
+      for (int q = 0; q < nqpt; q++) { qx[q] = r[q]; }
+   }
+   else
+   {
+      B.Mult(x, qx);
+   }
+}
+
+void PABasis::AddValuesT(const double *qx, double *y, double *work) const
+{
+   if (tensor)
+   {
+      const DenseMatrix *A[3] = { &B1d, &B1d, &B1d };
+      const double *r = TensorApply(A, true, qx, work);
+      for (int i = 0; i < ndofs; i++) { y[i] += r[i]; }
+   }
+   else
+   {
+      for (int i = 0; i < ndofs; i++)
+      {
+         const double *b_i = B.Data() + i*nqpt;
+         double s = 0.0;
+         for (int q = 0; q < nqpt; q++) { s += b_i[q]*qx[q]; }
+         y[i] += s;
+      }
+   }
+}
+
+void PABasis::Gradients(const double *x, double *qg, double *work) const
+{
+   for (int k = 0; k < dim; k++)
+   {
+      double *qg_k = qg + k*nqpt;
+      if (tensor)
+      {
+         const DenseMatrix *A[3] = { &B1d, &B1d, &B1d };
+         A[k] = &G1d;
+         const double *r = TensorApply(A, false, x, work);
+         for (int q = 0; q < nqpt; q++) { qg_k[q] = r[q]; }
+      }
+      else
+      {
+         G(k).Mult(x, qg_k);
+      }
+   }
+}
+
+void PABasis::AddGradientsT(const double *qg, double *y, double *work) const
+{
+   for (int k = 0; k < dim; k++)
+   {
+      const double *qg_k = qg + k*nqpt;
+      if (tensor)
+      {
+         const DenseMatrix *A[3] = { &B1d, &B1d, &B1d };
+         A[k] = &G1d;
+         const double *r = TensorApply(A, true, qg_k, work);
+         for (int i = 0; i < ndofs; i++) { y[i] += r[i]; }
+      }
+      else
+      {
+         const DenseMatrix &G_k = G(k);
+         for (int i = 0; i < ndofs; i++)
+         {
+            const double *g_i = G_k.Data() + i*nqpt;
+            double s = 0.0;
+            for (int q = 0; q < nqpt; q++) { s += g_i[q]*qg_k[q]; }
+            y[i] += s;
+         }
+      }
+   }
+}
+
+
+void BilinearFormIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   MFEM_ABORT("BilinearFormIntegrator::AssemblePA(...)\n"
+              "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   MFEM_ABORT("BilinearFormIntegrator::AddMultPA(...)\n"
+              "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AddMultTransposePA(const Vector &x,
+                                                Vector &y) const
+{
+   MFEM_ABORT("BilinearFormIntegrator::AddMultTransposePA(...)\n"
+              "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AddMultPAElements(const Array<int> &elems,
+                                               const Vector &x,
+                                               Vector &y) const
+{
+   MFEM_ABORT("BilinearFormIntegrator::AddMultPAElements(...)\n"
+              "   is not implemented for this class.");
+}
+
+
+void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   const int ne = fes.GetNE();
+   if (ne == 0) { pa_data.SetSize(0); return; }
+
+   const FiniteElement &el = *fes.GetFE(0);
+   ElementTransformation &T0 = *fes.GetElementTransformation(0);
+   pa_basis.Setup(el, IntRule, 2*el.GetOrder() + T0.OrderW());
+
+   const IntegrationRule &ir = pa_basis.GetRule();
+   const int nq = ir.GetNPoints();
+   const GeometricFactors *geom =
+      fes.GetMesh()->GetGeometricFactors(ir, GeometricFactors::DETERMINANTS);
+   pa_data.SetSize(ne*nq);
+   for (int e = 0; e < ne; e++)
+   {
+      ElementTransformation &T = *fes.GetElementTransformation(e);
+      for (int q = 0; q < nq; q++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         T.SetIntPoint(&ip);
+         double w = ip.weight*(geom ? geom->GetDetJ(e, q) : T.Weight());
+         if (Q) { w *= Q->Eval(T, ip); }
+         pa_data(e*nq + q) = w;
+      }
+   }
+   pa_qx.SetSize(nq);
+}
+
+void MassIntegrator::AddMultPAElement(int e, const Vector &x,
+                                      Vector &y) const
+{
+   const int nq = pa_basis.GetNPoints();
+   const int nd = pa_basis.GetNDofs();
+   const double *D = pa_data.GetData() + e*nq;
+   double *qx = pa_qx.GetData();
+   pa_basis.Values(x.GetData() + e*nd, qx);
+   for (int q = 0; q < nq; q++) { qx[q] *= D[q]; }
+   pa_basis.AddValuesT(qx, y.GetData() + e*nd);
+}
+
+void MassIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   const int ne = pa_data.Size()/std::max(pa_basis.GetNPoints(), 1);
+   for (int e = 0; e < ne; e++) { AddMultPAElement(e, x, y); }
+}
+
+void MassIntegrator::AddMultPAElements(const Array<int> &elems,
+                                       const Vector &x, Vector &y) const
+{
+   for (int i = 0; i < elems.Size(); i++) { AddMultPAElement(elems[i], x, y); }
+}
+
+
+void DiffusionIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   const int ne = fes.GetNE();
+   if (ne == 0) { pa_data.SetSize(0); return; }
+
+   const FiniteElement &el = *fes.GetFE(0);
+   const int dim = el.GetDim();
+   MFEM_VERIFY(fes.GetMesh()->SpaceDimension() == dim,
+               "surface meshes are not supported");
+
+   int order;
+   const IntegrationRule *ir = IntRule;
+   if (el.Space() == FunctionSpace::Pk)
+   {
+      order = 2*el.GetOrder() - 2;
+   }
+   else
+   {
+      order = 2*el.GetOrder() + dim - 1;
+   }
+   if (ir == NULL && el.Space() == FunctionSpace::rQk)
+   {
+      ir = &RefinedIntRules.Get(el.GetGeomType(), order);
+   }
+   pa_basis.Setup(el, ir, order);
+
+   const IntegrationRule &pa_ir = pa_basis.GetRule();
+   const int nq = pa_ir.GetNPoints();
+   const GeometricFactors *geom =
+      fes.GetMesh()->GetGeometricFactors(pa_ir,
+                                         GeometricFactors::DETERMINANTS |
+                                         GeometricFactors::ADJUGATES);
+   DenseMatrix C(dim), CAt(dim), D, adjJ_q(dim);
+   pa_data.SetSize(ne*nq*dim*dim);
+   for (int e = 0; e < ne; e++)
+   {
+      ElementTransformation &T = *fes.GetElementTransformation(e);
+      for (int q = 0; q < nq; q++)
+      {
+         const IntegrationPoint &ip = pa_ir.IntPoint(q);
+         T.SetIntPoint(&ip);
+         if (geom) { geom->GetAdjugateJacobian(e, q, adjJ_q); }
+         const DenseMatrix &adjJ = geom ? adjJ_q : T.AdjugateJacobian();
+         const double w = ip.weight/(geom ? geom->GetDetJ(e, q) : T.Weight());
+         if (MQ)
+         {
+            MQ->Eval(C, T, ip);
+         }
+         else
+         {
+            C.Diag(Q ? Q->Eval(T, ip) : 1.0, dim);
+         }
+         // D = w adj(J) C adj(J)^t, stored column-major
+         D.UseExternalData(pa_data.GetData() + (e*nq + q)*dim*dim, dim, dim);
+         MultABt(C, adjJ, CAt);
+         Mult(adjJ, CAt, D);
+         D *= w;
+      }
+   }
+   pa_qg.SetSize(dim*nq);
+   pa_qv.SetSize(dim*nq);
+}
+
+void DiffusionIntegrator::AddMultPAElement(int e, bool transpose,
+                                           const Vector &x, Vector &y) const
+{
+   const int nq = pa_basis.GetNPoints();
+   const int nd = pa_basis.GetNDofs();
+   const int dim = pa_qg.Size()/std::max(nq, 1);
+   // (k,l) entry of D, or of D^t when transposed
+   const int sk = transpose ? dim : 1, sl = transpose ? 1 : dim;
+   double *qg = pa_qg.GetData(), *qv = pa_qv.GetData();
+   pa_basis.Gradients(x.GetData() + e*nd, qg);
+   for (int q = 0; q < nq; q++)
+   {
+      const double *D = pa_data.GetData() + (e*nq + q)*dim*dim;
+      for (int k = 0; k < dim; k++)
+      {
+         double s = 0.0;
+         for (int l = 0; l < dim; l++) { s += D[k*sk + l*sl]*qg[l*nq + q]; }
+         qv[k*nq + q] = s;
+      }
+   }
+   pa_basis.AddGradientsT(qv, y.GetData() + e*nd);
+}
+
+void DiffusionIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   const int nq = pa_basis.GetNPoints();
+   const int dim = pa_qg.Size()/std::max(nq, 1);
+   const int ne = pa_data.Size()/std::max(nq*dim*dim, 1);
+   for (int e = 0; e < ne; e++) { AddMultPAElement(e, false, x, y); }
+}
+
+void DiffusionIntegrator::AddMultTransposePA(const Vector &x, Vector &y) const
+{
+   const int nq = pa_basis.GetNPoints();
+   const int dim = pa_qg.Size()/std::max(nq, 1);
+   const int ne = pa_data.Size()/std::max(nq*dim*dim, 1);
+   for (int e = 0; e < ne; e++) { AddMultPAElement(e, true, x, y); }
+}
+
+void DiffusionIntegrator::AddMultPAElements(const Array<int> &elems,
+                                            const Vector &x, Vector &y) const
+{
+   for (int i = 0; i < elems.Size(); i++)
+   {
+      AddMultPAElement(elems[i], false, x, y);
+   }
+}
+
+
+void ConvectionIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   const int ne = fes.GetNE();
+   if (ne == 0) { pa_data.SetSize(0); return; }
+
+   const FiniteElement &el = *fes.GetFE(0);
+   const int dim = el.GetDim();
+   MFEM_VERIFY(fes.GetMesh()->SpaceDimension() == dim,
+               "surface meshes are not supported");
+
+   ElementTransformation &T0 = *fes.GetElementTransformation(0);
+   pa_basis.Setup(el, IntRule,
+                  T0.OrderGrad(&el) + T0.Order() + el.GetOrder());
+
+   const IntegrationRule &ir = pa_basis.GetRule();
+   const int nq = ir.GetNPoints();
+   const GeometricFactors *geom =
+      fes.GetMesh()->GetGeometricFactors(ir, GeometricFactors::ADJUGATES);
+   Vector vel(dim);
+   DenseMatrix adjJ(dim);
+   pa_data.SetSize(ne*nq*dim);
+   for (int e = 0; e < ne; e++)
+   {
+      ElementTransformation &T = *fes.GetElementTransformation(e);
+      for (int q = 0; q < nq; q++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         T.SetIntPoint(&ip);
+         Q.Eval(vel, T, ip);
+         vel *= alpha*ip.weight;
+         Vector D(pa_data.GetData() + (e*nq + q)*dim, dim);
+         if (geom)
+         {
+            geom->GetAdjugateJacobian(e, q, adjJ);
+            adjJ.Mult(vel, D);
+         }
+         else { T.AdjugateJacobian().Mult(vel, D); }
+      }
+   }
+   pa_qx.SetSize(nq);
+   pa_qg.SetSize(dim*nq);
+}
+
+void ConvectionIntegrator::AddMultPAElement(int e, const Vector &x,
+                                            Vector &y) const
+{
+   const int nq = pa_basis.GetNPoints();
+   const int nd = pa_basis.GetNDofs();
+   const int dim = pa_qg.Size()/std::max(nq, 1);
+   double *qx = pa_qx.GetData(), *qg = pa_qg.GetData();
+   pa_basis.Gradients(x.GetData() + e*nd, qg);
+   for (int q = 0; q < nq; q++)
+   {
+      const double *D = pa_data.GetData() + (e*nq + q)*dim;
+      double s = 0.0;
+      for (int k = 0; k < dim; k++) { s += D[k]*qg[k*nq + q]; }
+      qx[q] = s;
+   }
+   pa_basis.AddValuesT(qx, y.GetData() + e*nd);
+}
+
+void ConvectionIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   const int nq = pa_basis.GetNPoints();
+   const int dim = pa_qg.Size()/std::max(nq, 1);
+   const int ne = pa_data.Size()/std::max(nq*dim, 1);
+   for (int e = 0; e < ne; e++) { AddMultPAElement(e, x, y); }
+}
+
+void ConvectionIntegrator::AddMultPAElements(const Array<int> &elems,
+                                             const Vector &x, Vector &y) const
+{
+   for (int i = 0; i < elems.Size(); i++) { AddMultPAElement(elems[i], x, y); }
+}
+
+void ConvectionIntegrator::AddMultTransposePA(const Vector &x, Vector &y) const
+{
+   const int nq = pa_basis.GetNPoints();
+   const int nd = pa_basis.GetNDofs();
+   const int dim = pa_qg.Size()/std::max(nq, 1);
+   const int ne = pa_data.Size()/std::max(nq*dim, 1);
+   double *qx = pa_qx.GetData(), *qg = pa_qg.GetData();
+   for (int e = 0; e < ne; e++)
+   {
+      pa_basis.Values(x.GetData() + e*nd, qx);
+      for (int q = 0; q < nq; q++)
+      {
+         const double *D = pa_data.GetData() + (e*nq + q)*dim;
+         for (int k = 0; k < dim; k++) { qg[k*nq + q] = D[k]*qx[q]; }
+      }
+      pa_basis.AddGradientsT(qg, y.GetData() + e*nd);
+   }
+}
+
+}
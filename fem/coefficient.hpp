@@ -299,6 +299,8 @@ public:
    VectorConstantCoefficient(const Vector &v)
       : VectorCoefficient(v.Size()), vec(v) { }
    using VectorCoefficient::Eval;
+   /// Return the constant vector.
+   const Vector &GetVec() const { return vec; }
    virtual void Eval(Vector &V, ElementTransformation &T,
                      const IntegrationPoint &ip) { V = vec; }
 };
@@ -108,6 +108,7 @@ DataCollection::DataCollection(const std::string& collection_name, Mesh *mesh_)
    precision = precision_default;
    pad_digits_cycle = pad_digits_rank = pad_digits_default;
    format = SERIAL_FORMAT; // use serial mesh format
+   compression = false;
    error = NO_ERROR;
 }
 
@@ -153,6 +154,7 @@ void DataCollection::SetFormat(int fmt)
    switch (fmt)
    {
       case SERIAL_FORMAT: break;
+      case BINARY_FORMAT: break;
 #ifdef MFEM_USE_MPI
       case PARALLEL_FORMAT: break;
 #endif
@@ -219,7 +221,7 @@ void DataCollection::SaveMesh()
    }
 
    std::string mesh_name = GetMeshFileName();
-   std::ofstream mesh_file(mesh_name.c_str());
+   ofgzstream mesh_file(mesh_name.c_str(), compression ? "zwb6" : "wb");
    mesh_file.precision(precision);
 #ifdef MFEM_USE_MPI
    const ParMesh *pmesh = dynamic_cast<const ParMesh*>(mesh);
@@ -229,6 +231,11 @@ void DataCollection::SaveMesh()
    }
    else
 #endif
+   if (format == BINARY_FORMAT)
+   {
+      mesh->PrintBinary(mesh_file);
+   }
+   else
    {
       mesh->Print(mesh_file);
    }
@@ -241,7 +248,7 @@ void DataCollection::SaveMesh()
 
 std::string DataCollection::GetMeshShortFileName() const
 {
-   return (serial || format == SERIAL_FORMAT) ? "mesh" : "pmesh";
+   return (serial || format != PARALLEL_FORMAT) ? "mesh" : "pmesh";
 }
 
 std::string DataCollection::GetMeshFileName() const
@@ -267,9 +274,17 @@ const
 
 void DataCollection::SaveOneField(const FieldMapIterator &it)
 {
-   std::ofstream field_file(GetFieldFileName(it->first).c_str());
+   ofgzstream field_file(GetFieldFileName(it->first).c_str(),
+                         compression ? "zwb6" : "wb");
    field_file.precision(precision);
-   (it->second)->Save(field_file);
+   if (format == BINARY_FORMAT)
+   {
+      (it->second)->SaveBinary(field_file);
+   }
+   else
+   {
+      (it->second)->Save(field_file);
+   }
    if (!field_file)
    {
       error = WRITE_ERROR;
@@ -433,10 +448,41 @@ void VisItDataCollection::SetMaxLevelsOfDetail(int max_levels_of_detail)
    visit_max_levels_of_detail = max_levels_of_detail;
 }
 
+void VisItDataCollection::DeleteMappedFiles()
+{
+   for (int i = 0; i < mapped_files.Size(); i++)
+   {
+      delete mapped_files[i];
+   }
+   mapped_files.SetSize(0);
+}
+
+MappedFile *VisItDataCollection::MapBinaryFile(const std::string &fname)
+{
+   const std::string id = "MFEM binary ";
+   MappedFile *file = new MappedFile;
+   if (!file->Open(fname) || file->Size() < id.size() ||
+       id.compare(0, id.size(), file->GetData(), id.size()) != 0)
+   {
+      delete file;
+      return NULL;
+   }
+   mapped_files.Append(file);
+   return file;
+}
+
 void VisItDataCollection::DeleteAll()
 {
    field_info_map.clear();
    DataCollection::DeleteAll();
+   DeleteMappedFiles();
+}
+
+VisItDataCollection::~VisItDataCollection()
+{
+   // Delete the data before the files it may be using
+   DeleteData();
+   DeleteMappedFiles();
 }
 
 void VisItDataCollection::Save()
@@ -471,7 +517,7 @@ void VisItDataCollection::Load(int cycle_)
                            to_padded_string(cycle, pad_digits_cycle) +
                            ".mfem_root";
    LoadVisItRootFile(root_name);
-   if (format != SERIAL_FORMAT || num_procs > 1)
+   if (format == PARALLEL_FORMAT || num_procs > 1)
    {
 #ifndef MFEM_USE_MPI
       MFEM_WARNING("Cannot load parallel VisIt root file in serial.");
@@ -535,6 +581,34 @@ void VisItDataCollection::LoadVisItRootFile(const std::string& root_name)
 void VisItDataCollection::LoadMesh()
 {
    std::string mesh_fname = GetMeshFileName();
+   if (format == BINARY_FORMAT)
+   {
+      // Each rank loads its local mesh as a serial Mesh, see BINARY_FORMAT;
+      // the number of ranks was checked by Load(). Uncompressed files are
+      // mapped into memory, compressed ones are read from a stream.
+      MappedFile *file = MapBinaryFile(mesh_fname);
+      if (file)
+      {
+         mesh = new Mesh(*file, 1, 0, false);
+      }
+      else
+      {
+         named_ifgzstream zfile(mesh_fname.c_str());
+         if (!zfile)
+         {
+            error = READ_ERROR;
+            MFEM_WARNING("Unable to open mesh file: " << mesh_fname);
+            return;
+         }
+         mesh = new Mesh(zfile, 1, 0, false);
+      }
+      serial = true;
+      spatial_dim = mesh->SpaceDimension();
+      topo_dim = mesh->Dimension();
+      own_data = true;
+      return;
+   }
+
    named_ifgzstream file(mesh_fname.c_str());
    // TODO: in parallel, check for errors on all processors
    if (!file)
@@ -576,7 +650,17 @@ void VisItDataCollection::LoadFields()
         it != field_info_map.end(); ++it)
    {
       std::string fname = path_left + it->first + path_right;
-      std::ifstream file(fname.c_str());
+      if (format == BINARY_FORMAT)
+      {
+         MappedFile *mfile = MapBinaryFile(fname);
+         if (mfile)
+         {
+            field_map.Register(it->first, new GridFunction(mesh, *mfile),
+                               own_data);
+            continue;
+         }
+      }
+      ifgzstream file(fname.c_str());
       // TODO: in parallel, check for errors on all processors
       if (!file)
       {
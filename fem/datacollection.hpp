@@ -148,9 +148,16 @@ public:
       SERIAL_FORMAT = 0, /**<
          MFEM's serial ascii format, using the methods Mesh::Print() /
          ParMesh::Print(), and GridFunction::Save() / ParGridFunction::Save().*/
-      PARALLEL_FORMAT = 1  /**<
+      PARALLEL_FORMAT = 1, /**<
          MFEM's parallel ascii format, using the methods ParMesh::ParPrint() and
          GridFunction::Save() / ParGridFunction::Save(). */
+      BINARY_FORMAT = 2    /**<
+         MFEM's binary format, using the methods Mesh::PrintBinary() and
+         GridFunction::SaveBinary(). In parallel, each rank writes its local
+         mesh, which is sufficient for visualization but cannot be loaded as a
+         ParMesh: when loaded on the same number of ranks, each rank gets its
+         local Mesh and GridFunction%s. QuadratureFunction%s are saved in ascii
+         format. */
    };
 
 protected:
@@ -206,6 +213,9 @@ protected:
    /// Output mesh format: see the #Format enumeration
    int format;
 
+   /// Write the mesh and field files compressed, see SetCompression()
+   bool compression;
+
    /// Should the collection delete its mesh and fields
    bool own_data;
 
@@ -346,6 +356,13 @@ public:
        validation. */
    virtual void SetFormat(int fmt);
 
+   /** @brief Set the flag for writing the mesh and field files in gzip
+       compressed format, see ofgzstream. Requires the build option
+       MFEM_USE_GZSTREAM, otherwise the files are written uncompressed. */
+   /** Compressed files of the #BINARY_FORMAT are loaded from a stream instead
+       of being mapped into memory. */
+   void SetCompression(bool comp) { compression = comp; }
+
    /// Set the path where the DataCollection will be saved.
    void SetPrefixPath(const std::string &prefix);
 
@@ -410,6 +427,16 @@ protected:
 
    void UpdateMeshInfo();
 
+   /// Files mapped into memory by Load() with the #BINARY_FORMAT.
+   Array<MappedFile*> mapped_files;
+
+   void DeleteMappedFiles();
+
+   /** Map the file @a fname into memory, adding it to #mapped_files. Returns
+       NULL if the file cannot be mapped or is not an uncompressed MFEM binary
+       file. */
+   MappedFile *MapBinaryFile(const std::string &fname);
+
    // Helper functions for Load()
    void LoadVisItRootFile(const std::string& root_name);
    void LoadMesh();
@@ -457,10 +484,15 @@ public:
    void SaveRootFile();
 
    /// Load the collection based on its VisIt data (described in its root file)
+   /** With the #BINARY_FORMAT, the mesh and the fields are loaded in serial
+       from files mapped into memory, using their data without copying. The
+       mapped files are released together with the data, so the loaded mesh
+       and fields should not be used after the collection is deleted or
+       reloaded, even if it does not own them. */
    virtual void Load(int cycle_ = 0);
 
    /// We will delete the mesh and fields if we own them
-   virtual ~VisItDataCollection() {}
+   virtual ~VisItDataCollection();
 };
 
 }
@@ -19,10 +19,22 @@ namespace mfem
 ElementTransformation::ElementTransformation()
    : IntPoint(static_cast<IntegrationPoint *>(NULL)),
      EvalState(0),
+     mesh(NULL),
      Attribute(-1),
      ElementNo(-1)
 { }
 
+const GeometricFactors *ElementTransformation::GetGeometricFactors(
+   const IntegrationRule &ir, int flags) const
+{
+   if (!mesh || ElementNo < 0 || ElementNo >= mesh->GetNE()) { return NULL; }
+   const IsoparametricTransformation *T =
+      dynamic_cast<const IsoparametricTransformation *>(this);
+   if (!T) { return NULL; }
+   return mesh->FindGeometricFactors(ir, false, flags, ElementNo,
+                                     &T->GetPointMat());
+}
+
 double ElementTransformation::EvalWeight()
 {
    MFEM_ASSERT((EvalState & WEIGHT_MASK) == 0, "");
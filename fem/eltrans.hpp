@@ -20,6 +20,9 @@
 namespace mfem
 {
 
+class Mesh;
+class GeometricFactors;
+
 class ElementTransformation
 {
 protected:
@@ -37,6 +40,12 @@ protected:
    Geometry::Type geom;
    int space_dim;
 
+   /** The mesh whose element ElementNo this transformation represents, set by
+       Mesh::GetElementTransformation(), or NULL. */
+   Mesh *mesh;
+   friend class Mesh;
+   friend class ParMesh;
+
    // Evaluate the Jacobian of the transformation at the IntPoint and store it
    // in dFdx.
    virtual const DenseMatrix &EvalJacobian() = 0;
@@ -50,6 +59,11 @@ public:
 
    ElementTransformation();
 
+   /** @brief Return the mesh whose element ElementNo this transformation
+       represents, or NULL if it was not set up by
+       Mesh::GetElementTransformation(). */
+   Mesh *GetMesh() const { return mesh; }
+
    void SetIntPoint(const IntegrationPoint *ip)
    { IntPoint = ip; EvalState = 0; }
    const IntegrationPoint &GetIntPoint() { return *IntPoint; }
@@ -93,6 +107,21 @@ public:
        return "3". */
    int GetSpaceDim() const { return space_dim; }
 
+   /** @brief Return the cached geometric factors of the mesh elements at the
+       points of @a ir (see Mesh::GetGeometricFactors()), or NULL if this is
+       not a mesh element transformation or the factors are not available. */
+   /** The factors of this element are the ones with index ElementNo. They
+       are checked against the point matrix of the transformation, so NULL is
+       returned if it was modified after being set up by the mesh.
+
+       Inside an OpenMP parallel region, the factors are only returned if they
+       are already cached, so the parallel element loops should call this
+       method for each geometry and rule before the loop, e.g. by assembling
+       one element of each geometry, see BilinearForm::BuildElementCaches().
+       Without the factors, the integrators use the transformation itself. */
+   const GeometricFactors *GetGeometricFactors(const IntegrationRule &ir,
+                                               int flags) const;
+
    /** @brief Transform a point @a pt from physical space to a point @a ip in
        reference space. */
    /** Attempt to find the IntegrationPoint that is transformed into the given
@@ -311,6 +340,7 @@ public:
        basis functions evaluated at xh. The columns of P represent the control
        points in physical space defining the transformation. */
    DenseMatrix &GetPointMat() { return PointMat; }
+   const DenseMatrix &GetPointMat() const { return PointMat; }
    void FinalizeTransformation() { space_dim = PointMat.Height(); }
 
    void SetIdentityTransformation(Geometry::Type GeomType);
@@ -35,6 +35,138 @@ FiniteElement::FiniteElement(int D, Geometry::Type G, int Do, int O, int F)
 #ifndef MFEM_THREAD_SAFE
    vshape.SetSize(Dof, Dim);
 #endif
+   num_basis_tables = 0;
+}
+
+FiniteElement::~FiniteElement()
+{
+   for (int i = 0; i < num_basis_tables; i++)
+   {
+      delete basis_tables[i];
+   }
+}
+
+const BasisTable *FiniteElement::GetBasisTable(const IntegrationRule &ir) const
+{
+   if (RangeType != SCALAR) { return NULL; }
+   // The entries below the count are never changed, so the lookups need no
+   // locking. A new table is set before the count is increased.
+   int num = num_basis_tables;
+   for (int i = 0; i < num; i++)
+   {
+      if (basis_tables[i]->Matches(ir)) { return basis_tables[i]; }
+   }
+
+   const BasisTable *table = NULL;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp critical
+#endif
+   {
+      // Another thread may have added the table, or filled the cache
+      for (int i = num; table == NULL && i < num_basis_tables; i++)
+      {
+         if (basis_tables[i]->Matches(ir)) { table = basis_tables[i]; }
+      }
+      num = num_basis_tables;
+      if (table == NULL && num < max_basis_tables)
+      {
+         basis_tables[num] = new BasisTable(*this, ir);
+         table = basis_tables[num];
+#ifdef MFEM_USE_OPENMP
+         #pragma omp flush
+#endif
+         num_basis_tables = num + 1;
+      }
+   }
+   return table;
+}
+
+BasisTable::BasisTable(const FiniteElement &fe, const IntegrationRule &ir)
+{
+   ndof = fe.GetDof();
+   nqpt = ir.GetNPoints();
+   dim = fe.GetDim();
+
+   points.SetSize(3*nqpt);
+   for (int q = 0; q < nqpt; q++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(q);
+      points(3*q+0) = ip.x;
+      points(3*q+1) = ip.y;
+      points(3*q+2) = ip.z;
+   }
+
+   Vector shape;
+   B.SetSize(ndof, nqpt);
+   for (int q = 0; q < nqpt; q++)
+   {
+      B.GetColumnReference(q, shape);
+      fe.CalcShape(ir.IntPoint(q), shape);
+   }
+   if (fe.GetDerivType() == FiniteElement::GRAD)
+   {
+      DenseMatrix dshape;
+      G.SetSize(ndof, dim*nqpt);
+      for (int q = 0; q < nqpt; q++)
+      {
+         GetDShape(q, dshape);
+         fe.CalcDShape(ir.IntPoint(q), dshape);
+      }
+   }
+
+   // The rule is a tensor product if its point q = i + n1*(j + n1*k) has the
+   // coordinates (x_i, x_j, x_k), where x_i is the x-coordinate of point i.
+   ndof1d = nqpt1d = 0;
+   const TensorBasisElement *tfe =
+      dynamic_cast<const TensorBasisElement*>(&fe);
+   if (tfe == NULL || dim == 0) { return; }
+   const int n1 = (int) floor(pow(double(nqpt), 1.0/dim) + 0.5);
+   const int p1 = fe.GetOrder() + 1;
+   bool tensor = (TensorBasisElement::Pow(n1, dim) == nqpt &&
+                  TensorBasisElement::Pow(p1, dim) == ndof);
+   for (int q = 0; tensor && q < nqpt; q++)
+   {
+      const int i = q % n1, j = (q / n1) % n1, k = q / (n1*n1);
+      const IntegrationPoint &ip = ir.IntPoint(q);
+      tensor = (ip.x == points(3*i) &&
+                (dim < 2 || ip.y == points(3*j)) &&
+                (dim < 3 || ip.z == points(3*k)));
+   }
+   if (!tensor) { return; }
+
+   ndof1d = p1;
+   nqpt1d = n1;
+   const Poly_1D::Basis &basis1d = tfe->GetBasis1D();
+   Vector u, d;
+   B1d.SetSize(ndof1d, nqpt1d);
+   G1d.SetSize(ndof1d, nqpt1d);
+   for (int q = 0; q < nqpt1d; q++)
+   {
+      B1d.GetColumnReference(q, u);
+      G1d.GetColumnReference(q, d);
+      basis1d.Eval(points(3*q), u, d);
+   }
+}
+
+bool BasisTable::Matches(const IntegrationRule &ir) const
+{
+   if (ir.GetNPoints() != nqpt) { return false; }
+   for (int q = 0; q < nqpt; q++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(q);
+      if (ip.x != points(3*q+0) || ip.y != points(3*q+1) ||
+          ip.z != points(3*q+2))
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+long BasisTable::MemoryUsage() const
+{
+   return (points.Size() + B.Height()*B.Width() + G.Height()*G.Width() +
+           B1d.Height()*B1d.Width() + G1d.Height()*G1d.Width())*sizeof(double);
 }
 
 void FiniteElement::CalcVShape (
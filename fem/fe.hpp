@@ -135,10 +135,62 @@ class Coefficient;
 class VectorCoefficient;
 class MatrixCoefficient;
 class KnotVector;
+class FiniteElement;
+
+/** @brief The basis functions of a FiniteElement and their reference
+    gradients evaluated at all points of an IntegrationRule, see
+    FiniteElement::GetBasisTable().
+
+    For tensor-product elements (see TensorBasisElement) and tensor-product
+    rules, e.g. the rules of IntRules for squares and cubes, the 1D factors are
+    stored too; the 1D dofs and points are ordered lexicographically, see
+    TensorBasisElement::GetDofMap(). */
+class BasisTable
+{
+protected:
+   /// Copy of the coordinates of the points, see Matches().
+   Vector points;
+
+public:
+   int ndof, nqpt, dim;
+   /// B(i,q) is the basis function i at the point q, see CalcShape().
+   DenseMatrix B;
+   /** @brief The columns q*dim, ..., q*dim+dim-1 of the ndof x (dim*nqpt)
+       matrix G are the reference gradients at the point q, see CalcDShape().
+       Empty if the element does not implement CalcDShape(). */
+   DenseMatrix G;
+   /// Number of 1D dofs and points, 0 if there are no 1D factors.
+   int ndof1d, nqpt1d;
+   /// B1d(i,q) and G1d(i,q) are the 1D basis function i and its derivative.
+   DenseMatrix B1d, G1d;
+
+   BasisTable(const FiniteElement &fe, const IntegrationRule &ir);
+
+   /// Return true if @a ir has the points the table was computed for.
+   bool Matches(const IntegrationRule &ir) const;
+
+   bool IsTensor() const { return (ndof1d > 0); }
+
+   /** @brief Make @a shape reference the basis functions at the point @a q;
+       the data is shared by all users of the table and must not be
+       modified. */
+   void GetShape(int q, Vector &shape) const
+   { shape.NewDataAndSize(B.Data() + q*ndof, ndof); }
+
+   /// Same as GetShape() for the reference gradients, see G.
+   void GetDShape(int q, DenseMatrix &dshape) const
+   { dshape.Reset(G.Data() + q*ndof*dim, ndof, dim); }
+
+   long MemoryUsage() const;
+};
 
 /// Abstract class for Finite Elements
 class FiniteElement
 {
+public:
+   /// Maximum number of tables cached by GetBasisTable().
+   static const int max_basis_tables = 16;
+
 protected:
    int Dim;      ///< Dimension of reference space
    Geometry::Type GeomType; ///< Geometry::Type of the reference element
@@ -152,6 +204,15 @@ protected:
 #ifndef MFEM_THREAD_SAFE
    mutable DenseMatrix vshape; // Dof x Dim
 #endif
+   /** @brief Cached tables of GetBasisTable(), owned by the element; the
+       first num_basis_tables entries are set. */
+   mutable BasisTable *basis_tables[max_basis_tables];
+   mutable int num_basis_tables;
+
+private:
+   // Not copyable: the element owns its cached basis tables.
+   FiniteElement(const FiniteElement &);
+   FiniteElement &operator=(const FiniteElement &);
 
 public:
    /// Enumeration for RangeType and DerivRangeType
@@ -399,7 +460,21 @@ public:
                            ElementTransformation &Trans,
                            DenseMatrix &div) const;
 
-   virtual ~FiniteElement () { }
+   /** @brief Return the basis functions, and their reference gradients,
+       evaluated at the points of @a ir; the table is computed on the first
+       call and cached for the lifetime of the element. */
+   /** Rules are identified by their points, not their address. Returns NULL
+       if the element is not a scalar element, if its basis is not fixed (see
+       NURBSFiniteElement), or if max_basis_tables tables are already cached.
+
+       The lookups need no locking; a new table is added by one thread at a
+       time, inside an OpenMP critical section, so the method can be called in
+       parallel regions. The parallel element loops still build their tables
+       before the loop, see BilinearForm::BuildElementCaches(), so that the
+       threads do not wait for each other. */
+   virtual const BasisTable *GetBasisTable(const IntegrationRule &ir) const;
+
+   virtual ~FiniteElement ();
 
    static bool IsClosedType(int b_type)
    {
@@ -2693,6 +2768,10 @@ public:
    Vector              &Weights    ()         const { return weights; }
    /// Update the NURBSFiniteElement according to the currently set knot vectors
    virtual void         SetOrder   ()         const { }
+
+   /// The basis depends on the current element, so it is not tabulated.
+   virtual const BasisTable *GetBasisTable(const IntegrationRule &ir) const
+   { return NULL; }
 };
 
 class NURBS1DFiniteElement : public NURBSFiniteElement
@@ -26,7 +26,9 @@
 #include "linearform.hpp"
 #include "nonlinearform.hpp"
 #include "bilinearform.hpp"
+#include "bilinearform_ext.hpp"
 #include "hybridization.hpp"
+#include "hyperbolic.hpp"
 #include "datacollection.hpp"
 #include "estimators.hpp"
 #include "staticcond.hpp"
@@ -38,6 +40,7 @@
 #include "plinearform.hpp"
 #include "pbilinearform.hpp"
 #include "pnonlinearform.hpp"
+#include "pcheckpoint.hpp"
 #endif
 
 #ifdef MFEM_USE_SIDRE
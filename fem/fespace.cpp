@@ -259,6 +259,63 @@ void FiniteElementSpace::ReorderElementToDofTable()
    }
 }
 
+void FiniteElementSpace::ReorderElementToDofTable(
+   const Array<int> &el_ordering)
+{
+   const int NE = elem_dof->Size();
+   MFEM_VERIFY(el_ordering.Size() == NE, "invalid element ordering");
+
+   Array<int> el_order(NE);
+   for (int i = 0; i < NE; i++) { el_order[el_ordering[i]] = i; }
+
+   Array<int> dof_marker(ndofs);
+   dof_marker = -1;
+
+   int *I = elem_dof->GetI(), *J = elem_dof->GetJ();
+   for (int i = 0, dof_counter = 0; i < NE; i++)
+   {
+      const int el = el_order[i];
+      for (int k = I[el]; k < I[el+1]; k++)
+      {
+         const int sdof = J[k];
+         const int dof = (sdof < 0) ? -1-sdof : sdof;
+         if (dof_marker[dof] < 0) { dof_marker[dof] = dof_counter++; }
+      }
+   }
+   RenumberElementToDofTable(dof_marker);
+}
+
+void FiniteElementSpace::ReorderElementToDofTableRCM()
+{
+   // element-to-dof connectivity without the dof signs
+   Table el_dof(*elem_dof);
+   int *J = el_dof.GetJ(), nnz = el_dof.Size_of_connections();
+   for (int k = 0; k < nnz; k++)
+   {
+      if (J[k] < 0) { J[k] = -1-J[k]; }
+   }
+
+   Table dof_el, dof_dof;
+   Transpose(el_dof, dof_el, ndofs);
+   Mult(dof_el, el_dof, dof_dof);
+
+   Array<int> dof_ordering;
+   ReverseCuthillMcKee(dof_dof, dof_ordering);
+   RenumberElementToDofTable(dof_ordering);
+}
+
+void FiniteElementSpace::RenumberElementToDofTable(
+   const Array<int> &dof_ordering)
+{
+   int *J = elem_dof->GetJ(), nnz = elem_dof->Size_of_connections();
+   for (int k = 0; k < nnz; k++)
+   {
+      const int sdof = J[k];
+      const int new_dof = dof_ordering[(sdof < 0) ? -1-sdof : sdof];
+      J[k] = (sdof < 0) ? -1-new_dof : new_dof; // preserve the sign of sdof
+   }
+}
+
 void FiniteElementSpace::BuildDofToArrays()
 {
    if (dof_elem_array.Size()) { return; }
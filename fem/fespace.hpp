@@ -114,6 +114,9 @@ protected:
 
    void BuildElementToDofTable() const;
 
+   /// Replace each DOF d in elem_dof by dof_ordering[d], preserving its sign.
+   void RenumberElementToDofTable(const Array<int> &dof_ordering);
+
    /// Helper to remove encoded sign from a DOF
    static inline int DecodeDof(int dof, double& sign)
    { return (dof >= 0) ? (sign = 1, dof) : (sign = -1, (-1 - dof)); }
@@ -385,6 +388,21 @@ public:
        is preserved. */
    void ReorderElementToDofTable();
 
+   /** @brief Same as ReorderElementToDofTable(), with the elements visited in
+       the order given by @a el_ordering instead of the Mesh order.
+
+       As in Mesh::ReorderElements(), el_ordering[i] is the new position of
+       element i, so the outputs of Mesh::GetRCMElementReordering(),
+       Mesh::GetHilbertElementReordering() and
+       Mesh::GetMortonElementReordering() can be used directly. */
+   void ReorderElementToDofTable(const Array<int> &el_ordering);
+
+   /** @brief Reorder the scalar DOFs with the reverse Cuthill-McKee ordering
+       of the DOF connectivity graph (two DOFs are connected if they share an
+       element). This reduces the bandwidth of the assembled matrices; the sign
+       of any signed DOFs is preserved. */
+   void ReorderElementToDofTableRCM();
+
    void BuildDofToArrays();
 
    const Table &GetElementToDofTable() const { return *elem_dof; }
@@ -20,6 +20,7 @@
 #include <string>
 #include <cmath>
 #include <iostream>
+#include <sstream>
 #include <algorithm>
 
 namespace mfem
@@ -30,6 +31,20 @@ using namespace std;
 GridFunction::GridFunction(Mesh *m, std::istream &input)
    : Vector()
 {
+   input >> ws;
+   if (input.peek() == 'M') // First letter of "MFEM binary GridFunction v1.0"
+   {
+      string buff;
+      getline(input, buff);
+      filter_dos(buff);
+      MFEM_VERIFY(buff == "MFEM binary GridFunction v1.0",
+                  "unknown GridFunction format: " << buff);
+      bin_io::SectionReader sections(input);
+      LoadBinarySections(m, sections, false);
+      sections.Finish();
+      return;
+   }
+
    fes = new FiniteElementSpace;
    fec = fes->Load(m, input);
 
@@ -58,6 +73,48 @@ GridFunction::GridFunction(Mesh *m, std::istream &input)
    sequence = fes->GetSequence();
 }
 
+GridFunction::GridFunction(Mesh *m, MappedFile &file)
+   : Vector()
+{
+   const string id = "MFEM binary GridFunction v1.0\n";
+   MFEM_VERIFY(file.Size() >= id.size() &&
+               id.compare(0, id.size(), file.GetData(), id.size()) == 0,
+               "the mapped file is not an MFEM binary GridFunction");
+   bin_io::SectionReader sections(file.GetData() + id.size(),
+                                  file.Size() - id.size(), id.size());
+   LoadBinarySections(m, sections, true);
+}
+
+void GridFunction::LoadBinarySections(Mesh *m,
+                                      bin_io::SectionReader &sections,
+                                      bool zerocopy)
+{
+   size_t size;
+   MFEM_VERIFY(sections.Find(BIN_SPACE, size), "invalid binary GridFunction: "
+               "missing space section");
+   string space(size, '\0');
+   sections.Read(BIN_SPACE, 0, size, &space[0]);
+   istringstream space_input(space);
+   fes = new FiniteElementSpace;
+   fec = fes->Load(m, space_input);
+
+   MFEM_VERIFY(sections.Find(BIN_DATA, size) &&
+               size == (size_t)fes->GetVSize()*sizeof(double),
+               "invalid binary GridFunction: missing or wrong data section");
+   if (zerocopy)
+   {
+      NewDataAndSize(reinterpret_cast<double*>(sections.GetData(BIN_DATA)),
+                     fes->GetVSize());
+   }
+   else
+   {
+      // read in place into the vector
+      SetSize(fes->GetVSize());
+      sections.Read(BIN_DATA, 0, size, GetData());
+   }
+   sequence = fes->GetSequence();
+}
+
 GridFunction::GridFunction(Mesh *m, GridFunction *gf_array[], int num_pieces)
 {
    // all GridFunctions must have the same FE collection, vdim, ordering
@@ -446,6 +503,12 @@ const
    int dof = FElem->GetDof();
    Vector DofVal(dof), loc_data(dof);
    GetSubVector(dofs, loc_data);
+   const BasisTable *basis = FElem->GetBasisTable(ir);
+   if (basis)
+   {
+      basis->B.MultTranspose(loc_data, vals);
+      return;
+   }
    for (int k = 0; k < n; k++)
    {
       FElem->CalcShape(ir.IntPoint(k), DofVal);
@@ -532,10 +595,12 @@ void GridFunction::GetVectorValues(ElementTransformation &T,
       Vector shape(dof);
       int vdim = fes->GetVDim();
       vals.SetSize(vdim, nip);
+      const BasisTable *basis = FElem->GetBasisTable(ir);
       for (int j = 0; j < nip; j++)
       {
          const IntegrationPoint &ip = ir.IntPoint(j);
-         FElem->CalcShape(ip, shape);
+         if (basis) { basis->GetShape(j, shape); }
+         else { FElem->CalcShape(ip, shape); }
          for (int k = 0; k < vdim; k++)
          {
             vals(k,j) = shape * ((const double *)loc_data + dof * k);
@@ -1025,14 +1090,26 @@ void GridFunction::GetGradients(const int elem, const IntegrationRule &ir,
    fes->GetElementDofs(elem, dofs);
    GetSubVector(dofs, lval);
    grad.SetSize(fe->GetDim(), ir.GetNPoints());
+   const GeometricFactors *geom = (fe->GetDim() != Tr->GetSpaceDim()) ? NULL :
+                                  Tr->GetGeometricFactors(
+                                     ir, GeometricFactors::DETERMINANTS |
+                                     GeometricFactors::ADJUGATES);
    for (int i = 0; i < ir.GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir.IntPoint(i);
       fe->CalcDShape(ip, dshape);
       dshape.MultTranspose(lval, gh);
-      Tr->SetIntPoint(&ip);
       grad.GetColumnReference(i, gcol);
-      CalcInverse(Tr->Jacobian(), Jinv);
+      if (geom)
+      {
+         geom->GetAdjugateJacobian(elem, i, Jinv);
+         Jinv *= 1.0/geom->GetDetJ(elem, i);
+      }
+      else
+      {
+         Tr->SetIntPoint(&ip);
+         CalcInverse(Tr->Jacobian(), Jinv);
+      }
       Jinv.MultTranspose(gh, gcol);
    }
 }
@@ -1850,7 +1927,7 @@ double GridFunction::ComputeL2Error(
    double error = 0.0, a;
    const FiniteElement *fe;
    ElementTransformation *transf;
-   Vector shape;
+   Vector shape, basis_shape;
    Array<int> vdofs;
    int fdof, d, i, intorder, j, k;
 
@@ -1871,25 +1948,31 @@ double GridFunction::ComputeL2Error(
          ir = &(IntRules.Get(fe->GetGeomType(), intorder));
       }
       fes->GetElementVDofs(i, vdofs);
+      const GeometricFactors *geom =
+         transf->GetGeometricFactors(*ir, GeometricFactors::DETERMINANTS);
+      const BasisTable *basis = fe->GetBasisTable(*ir);
       for (j = 0; j < ir->GetNPoints(); j++)
       {
          const IntegrationPoint &ip = ir->IntPoint(j);
-         fe->CalcShape(ip, shape);
+         if (basis) { basis->GetShape(j, basis_shape); }
+         else { fe->CalcShape(ip, shape); }
+         const Vector &shape_j = basis ? basis_shape : shape;
          for (d = 0; d < fes->GetVDim(); d++)
          {
             a = 0;
             for (k = 0; k < fdof; k++)
                if (vdofs[fdof*d+k] >= 0)
                {
-                  a += (*this)(vdofs[fdof*d+k]) * shape(k);
+                  a += (*this)(vdofs[fdof*d+k]) * shape_j(k);
                }
                else
                {
-                  a -= (*this)(-1-vdofs[fdof*d+k]) * shape(k);
+                  a -= (*this)(-1-vdofs[fdof*d+k]) * shape_j(k);
                }
             transf->SetIntPoint(&ip);
             a -= exsol[d]->Eval(*transf, ip);
-            error += ip.weight * transf->Weight() * a * a;
+            error += ip.weight *
+                     (geom ? geom->GetDetJ(i, j) : transf->Weight()) * a * a;
          }
       }
    }
@@ -1931,11 +2014,15 @@ double GridFunction::ComputeL2Error(
       vals -= exact_vals;
       loc_errs.SetSize(vals.Width());
       vals.Norm2(loc_errs);
+      const GeometricFactors *geom =
+         T->GetGeometricFactors(*ir, GeometricFactors::DETERMINANTS);
       for (int j = 0; j < ir->GetNPoints(); j++)
       {
          const IntegrationPoint &ip = ir->IntPoint(j);
-         T->SetIntPoint(&ip);
-         error += ip.weight * T->Weight() * (loc_errs(j) * loc_errs(j));
+         double w;
+         if (geom) { w = geom->GetDetJ(i, j); }
+         else { T->SetIntPoint(&ip); w = T->Weight(); }
+         error += ip.weight * w * (loc_errs(j) * loc_errs(j));
       }
    }
 
@@ -2604,6 +2691,23 @@ void GridFunction::Save(std::ostream &out) const
    out.flush();
 }
 
+void GridFunction::SaveBinary(std::ostream &out) const
+{
+   const string id = "MFEM binary GridFunction v1.0\n";
+   ostringstream space_output;
+   fes->Save(space_output);
+   const string space = space_output.str();
+
+   bin_io::SectionTable sections(id.size());
+   sections.Add(BIN_SPACE, space.size());
+   sections.Add(BIN_DATA, Size()*sizeof(double));
+   out << id;
+   sections.Write(out);
+   sections.WriteSection(out, 0, space.data());
+   sections.WriteSection(out, 1, GetData());
+   out.flush();
+}
+
 void GridFunction::SaveVTK(std::ostream &out, const std::string &field_name,
                            int ref)
 {
@@ -2994,6 +3098,139 @@ double ComputeElementLpDistance(double p, int i,
 }
 
 
+void InterpolateAtPoints(const Array<GridFunction*> &gfs,
+                         const Array<int> &elem_ids,
+                         const Array<IntegrationPoint> &ips,
+                         DenseMatrix &vals)
+{
+   const int npts = elem_ids.Size(), nf = gfs.Size();
+   MFEM_VERIFY(ips.Size() == npts, "invalid number of integration points");
+
+   Array<int> offsets(nf+1);
+   offsets[0] = 0;
+   for (int f = 0; f < nf; f++)
+   {
+      offsets[f+1] = offsets[f] + gfs[f]->VectorDim();
+   }
+   vals.SetSize(offsets[nf], npts);
+   vals = 0.0;
+   if (nf == 0 || npts == 0) { return; }
+
+   // Group the fields by FiniteElementSpace
+   Mesh *mesh = gfs[0]->FESpace()->GetMesh();
+   Array<FiniteElementSpace*> spaces;
+   Array<int> space_of(nf);
+   for (int f = 0; f < nf; f++)
+   {
+      FiniteElementSpace *fes = gfs[f]->FESpace();
+      MFEM_VERIFY(fes->GetMesh() == mesh, "all GridFunctions must be defined "
+                  "on the same mesh");
+      space_of[f] = spaces.Find(fes);
+      if (space_of[f] < 0) { space_of[f] = spaces.Append(fes) - 1; }
+   }
+
+   // Group the points by element
+   const int ne = mesh->GetNE();
+   Table elem_pts;
+   elem_pts.MakeI(ne);
+   for (int k = 0; k < npts; k++)
+   {
+      if (elem_ids[k] < 0) { continue; }
+      MFEM_ASSERT(elem_ids[k] < ne, "invalid element id: " << elem_ids[k]);
+      elem_pts.AddAColumnInRow(elem_ids[k]);
+   }
+   elem_pts.MakeJ();
+   for (int k = 0; k < npts; k++)
+   {
+      if (elem_ids[k] >= 0) { elem_pts.AddConnection(elem_ids[k], k); }
+   }
+   elem_pts.ShiftUpI();
+
+   Array<int> vdofs, fields;
+   Vector shape;
+   DenseMatrix vshape, loc_data;
+   for (int e = 0; e < ne; e++)
+   {
+      const int np = elem_pts.RowSize(e);
+      if (np == 0) { continue; }
+      const int *pts = elem_pts.GetRow(e);
+      ElementTransformation *T = mesh->GetElementTransformation(e);
+
+      for (int s = 0; s < spaces.Size(); s++)
+      {
+         const FiniteElementSpace *fes = spaces[s];
+         const FiniteElement *fe = fes->GetFE(e);
+         const int dof = fe->GetDof();
+
+         // Gather the element dofs of all fields in this space
+         fields.SetSize(0);
+         for (int f = 0; f < nf; f++)
+         {
+            if (space_of[f] == s) { fields.Append(f); }
+         }
+         fes->GetElementVDofs(e, vdofs);
+         loc_data.SetSize(vdofs.Size(), fields.Size());
+         for (int j = 0; j < fields.Size(); j++)
+         {
+            Vector loc(loc_data.GetColumn(j), vdofs.Size());
+            gfs[fields[j]]->GetSubVector(vdofs, loc);
+         }
+
+         if (fe->GetRangeType() == FiniteElement::SCALAR)
+         {
+            const int vdim = fes->GetVDim();
+            shape.SetSize(dof);
+            for (int i = 0; i < np; i++)
+            {
+               const int k = pts[i];
+               if (fe->GetMapType() == FiniteElement::VALUE)
+               {
+                  fe->CalcShape(ips[k], shape);
+               }
+               else
+               {
+                  T->SetIntPoint(&ips[k]);
+                  fe->CalcPhysShape(*T, shape);
+               }
+               for (int j = 0; j < fields.Size(); j++)
+               {
+                  const double *loc = loc_data.GetColumn(j);
+                  for (int c = 0; c < vdim; c++)
+                  {
+                     vals(offsets[fields[j]] + c, k) = shape * (loc + c*dof);
+                  }
+               }
+            }
+         }
+         else
+         {
+            const int sdim = mesh->SpaceDimension();
+            vshape.SetSize(dof, sdim);
+            for (int i = 0; i < np; i++)
+            {
+               const int k = pts[i];
+               T->SetIntPoint(&ips[k]);
+               fe->CalcVShape(*T, vshape);
+               for (int j = 0; j < fields.Size(); j++)
+               {
+                  const double *loc = loc_data.GetColumn(j);
+                  for (int c = 0; c < sdim; c++)
+                  {
+                     double val = 0.0;
+                     for (int d = 0; d < dof; d++)
+                     {
+                        val += vshape(d, c) * loc[d];
+                     }
+                     vals(offsets[fields[j]] + c, k) = val;
+                  }
+               }
+            }
+         }
+      }
+   }
+}
+
+
 double ExtrudeCoefficient::Eval(ElementTransformation &T,
                                 const IntegrationPoint &ip)
 {
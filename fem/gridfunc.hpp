@@ -42,6 +42,15 @@ protected:
 
    void SaveSTLTri(std::ostream &out, double p1[], double p2[], double p3[]);
 
+   /// Section ids of the MFEM binary GridFunction format, see SaveBinary().
+   enum BinarySection { BIN_SPACE = 1, BIN_DATA };
+
+   /** @brief Setup the space and the data from the sections of a binary
+       GridFunction file. With @a zerocopy, the data of the sections is used
+       directly, which requires sections in memory. */
+   void LoadBinarySections(Mesh *m, bin_io::SectionReader &sections,
+                           bool zerocopy);
+
    void GetVectorGradientHat(ElementTransformation &T, DenseMatrix &gh) const;
 
    // Project the delta coefficient without scaling and return the (local)
@@ -87,9 +96,17 @@ public:
    /// Construct a GridFunction on the given Mesh, using the data from @a input.
    /** The content of @a input should be in the format created by the method
        Save(). The reconstructed FiniteElementSpace and FiniteElementCollection
-       are owned by the GridFunction. */
+       are owned by the GridFunction. The binary format written by SaveBinary()
+       is also accepted. */
    GridFunction(Mesh *m, std::istream &input);
 
+   /** @brief Construct a GridFunction on the given Mesh from a file in the
+       binary format of SaveBinary() mapped into memory.
+
+       The GridFunction uses the mapped data directly, without copying, so
+       @a file must not be closed before the GridFunction is destroyed. */
+   GridFunction(Mesh *m, MappedFile &file);
+
    GridFunction(Mesh *m, GridFunction *gf_array[], int num_pieces);
 
    /// Make the GridFunction the owner of 'fec' and 'fes'
@@ -444,6 +461,13 @@ public:
    /// Save the GridFunction to an output stream.
    virtual void Save(std::ostream &out) const;
 
+   /** @brief Save the GridFunction in the MFEM binary format: the space, as
+       written by FiniteElementSpace::Save(), and the raw (little-endian) data
+       in separate sections, see bin_io::SectionTable. The format is read by
+       the GridFunction constructors taking a std::istream or a MappedFile.
+       NURBS spaces are supported through the full data vector. */
+   void SaveBinary(std::ostream &out) const;
+
    /** Write the GridFunction in VTK format. Note that Mesh::PrintVTK must be
        called first. The parameter ref > 0 must match the one used in
        Mesh::PrintVTK. */
@@ -609,6 +633,22 @@ double ZZErrorEstimator(BilinearFormIntegrator &blfi,
 double ComputeElementLpDistance(double p, int i,
                                 GridFunction& gf1, GridFunction& gf2);
 
+/** @brief Evaluate the GridFunction%s @a gfs at the points located with
+    Mesh::FindPoints(), given by their element ids @a elem_ids and reference
+    coordinates @a ips.
+
+    All GridFunction%s must be defined on the same Mesh. On return, column k of
+    @a vals holds the values of all fields at the k-th point, stacked in the
+    order of @a gfs with VectorDim() rows per field. The points are grouped by
+    element, so that the element transformation, the element dofs and the
+    shape functions are computed once per element, resp. once per point, for
+    all fields that share a FiniteElementSpace. Points with a negative element
+    id get zero values. */
+void InterpolateAtPoints(const Array<GridFunction*> &gfs,
+                         const Array<int> &elem_ids,
+                         const Array<IntegrationPoint> &ips,
+                         DenseMatrix &vals);
+
 
 /// Class used for extruding scalar GridFunctions
 class ExtrudeCoefficient : public Coefficient
@@ -581,6 +581,27 @@ void Hybridization::ComputeH()
    SparseMatrix *V = pC ? new SparseMatrix(Ct->Height(), Ct->Width()) : NULL;
 #endif
 
+   // Factor the element matrices in batches, see DenseBatch
+   {
+      Array<int> i_size(NE), b_size(NE);
+      Array<double*> A_ii(NE), A_ib(NE), A_bi(NE), A_bb(NE);
+      Array<int*> ipiv_ii(NE), ipiv_bb(NE);
+      for (int el = 0; el < NE; el++)
+      {
+         GetBDofs(el, i_size[el], b_dofs);
+         const int i_sz = i_size[el];
+         b_size[el] = b_dofs.Size();
+         A_ii[el] = Af_data + Af_offsets[el];
+         A_ib[el] = A_ii[el] + i_sz*i_sz;
+         A_bi[el] = A_ib[el] + i_sz*b_size[el];
+         A_bb[el] = A_bi[el] + i_sz*b_size[el];
+         ipiv_ii[el] = Af_ipiv + Af_f_offsets[el];
+         ipiv_bb[el] = ipiv_ii[el] + i_sz;
+      }
+      DenseBatch::LUBlockFactor(NE, i_size, b_size, A_ii, ipiv_ii,
+                                A_ib, A_bi, A_bb, ipiv_bb);
+   }
+
    c_dof_marker = -1;
    int c_mark_start = 0;
    for (int el = 0; el < NE; el++)
@@ -588,16 +609,9 @@ void Hybridization::ComputeH()
       int i_dofs_size;
       GetBDofs(el, i_dofs_size, b_dofs);
 
-      LUFactors LU_ii(Af_data + Af_offsets[el], Af_ipiv + Af_f_offsets[el]);
-      double *A_ib_data = LU_ii.data + i_dofs_size*i_dofs_size;
-      double *A_bi_data = A_ib_data + i_dofs_size*b_dofs.Size();
-      LUFactors LU_bb(A_bi_data + i_dofs_size*b_dofs.Size(),
-                      LU_ii.ipiv + i_dofs_size);
-
-      LU_ii.Factor(i_dofs_size);
-      LU_ii.BlockFactor(i_dofs_size, b_dofs.Size(),
-                        A_ib_data, A_bi_data, LU_bb.data);
-      LU_bb.Factor(b_dofs.Size());
+      const int b_offset = i_dofs_size*(i_dofs_size + 2*b_dofs.Size());
+      LUFactors LU_bb(Af_data + Af_offsets[el] + b_offset,
+                      Af_ipiv + Af_f_offsets[el] + i_dofs_size);
 
       // Extract Cb_t from Ct, define c_dofs
       c_dofs.SetSize(0);
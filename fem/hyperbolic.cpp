@@ -0,0 +1,716 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of the matrix-free DG operator for conservation laws
+
+#include "fem.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mfem
+{
+
+double FluxFunction::ComputeFluxDotN(const Vector &state, const Vector &nor,
+                                     Vector &fluxN) const
+{
+   DenseMatrix flux(num_equations, dim);
+   const double mcs = ComputeFlux(state, flux);
+   flux.Mult(nor, fluxN);
+   return mcs;
+}
+
+
+double EulerFlux::ComputeFlux(const Vector &state, DenseMatrix &flux) const
+{
+   const double den = state(0);
+   const double *den_vel = state.GetData() + 1;
+   const double den_energy = state(1 + dim);
+
+   double den_vel2 = 0.0;
+   for (int d = 0; d < dim; d++) { den_vel2 += den_vel[d]*den_vel[d]; }
+   den_vel2 /= den;
+
+   const double pres = (specific_heat_ratio - 1.0)*(den_energy - 0.5*den_vel2);
+   MFEM_ASSERT(den > 0.0 && pres > 0.0, "unphysical state");
+
+   for (int d = 0; d < dim; d++)
+   {
+      flux(0, d) = den_vel[d];
+      for (int i = 0; i < dim; i++)
+      {
+         flux(1+i, d) = den_vel[i]*den_vel[d]/den;
+      }
+      flux(1+d, d) += pres;
+   }
+
+   const double H = (den_energy + pres)/den;
+   for (int d = 0; d < dim; d++)
+   {
+      flux(1+dim, d) = den_vel[d]*H;
+   }
+
+   const double sound = std::sqrt(specific_heat_ratio*pres/den);
+   return std::sqrt(den_vel2/den) + sound;
+}
+
+double EulerFlux::ComputeFluxDotN(const Vector &state, const Vector &nor,
+                                  Vector &fluxN) const
+{
+   const double den = state(0);
+   const double *den_vel = state.GetData() + 1;
+   const double den_energy = state(1 + dim);
+
+   double den_vel2 = 0.0, den_velN = 0.0;
+   for (int d = 0; d < dim; d++)
+   {
+      den_vel2 += den_vel[d]*den_vel[d];
+      den_velN += den_vel[d]*nor(d);
+   }
+   den_vel2 /= den;
+
+   const double pres = (specific_heat_ratio - 1.0)*(den_energy - 0.5*den_vel2);
+   MFEM_ASSERT(den > 0.0 && pres > 0.0, "unphysical state");
+
+   fluxN(0) = den_velN;
+   for (int d = 0; d < dim; d++)
+   {
+      fluxN(1+d) = den_velN*den_vel[d]/den + pres*nor(d);
+   }
+   fluxN(1+dim) = den_velN*(den_energy + pres)/den;
+
+   const double sound = std::sqrt(specific_heat_ratio*pres/den);
+   return std::sqrt(den_vel2/den) + sound;
+}
+
+
+double RusanovFlux::Eval(const Vector &state1, const Vector &state2,
+                         const Vector &nor, Vector &flux, Vector &work) const
+{
+   // F(u1).n in flux, F(u2).n in work
+   work.SetSize(fluxFunction.num_equations);
+   const double maxE1 = fluxFunction.ComputeFluxDotN(state1, nor, flux);
+   const double maxE2 = fluxFunction.ComputeFluxDotN(state2, nor, work);
+   const double maxE = std::max(maxE1, maxE2);
+   const double normag = nor.Norml2();
+
+   for (int i = 0; i < fluxFunction.num_equations; i++)
+   {
+      flux(i) = 0.5*(flux(i) + work(i))
+                - 0.5*maxE*(state2(i) - state1(i))*normag;
+   }
+   return maxE;
+}
+
+
+DGHyperbolicOperator::DGHyperbolicOperator(const FiniteElementSpace &vfes_,
+                                           const FluxFunction &fluxFunction_,
+                                           const NumericalFlux &numFlux_,
+                                           int ir_order)
+   : TimeDependentOperator(vfes_.GetVSize()),
+     vfes(vfes_),
+     fluxFunction(fluxFunction_),
+     numFlux(numFlux_),
+     dim(vfes_.GetMesh()->Dimension()),
+     neq(vfes_.GetVDim()),
+     ne(vfes_.GetNE()),
+     nd(vfes_.GetNE() > 0 ? vfes_.GetFE(0)->GetDof() : 0),
+     tensor(false),
+     nqf(0),
+     trace_work_size(0),
+#ifdef MFEM_USE_MPI
+     pfes(dynamic_cast<ParFiniteElementSpace*>(
+             const_cast<FiniteElementSpace*>(&vfes_))),
+     x_gf(NULL),
+#endif
+     max_char_speed(0.0)
+{
+   Mesh *mesh = vfes.GetMesh();
+   MFEM_VERIFY(neq == fluxFunction.num_equations && dim == fluxFunction.dim,
+               "the space does not match the flux function");
+   MFEM_VERIFY(vfes.GetOrdering() == Ordering::byNODES,
+               "the space must use Ordering::byNODES");
+   MFEM_VERIFY(dim >= 2 && mesh->SpaceDimension() == dim,
+               "only 2D and 3D volume meshes are supported");
+   MFEM_VERIFY(!mesh->Nonconforming(), "nonconforming meshes are not supported");
+#ifdef MFEM_USE_MPI
+   if (pfes)
+   {
+      // Collective: the face-neighbor elements, their dofs and vertices.
+      pfes->ExchangeFaceNbrData();
+      x_gf = new ParGridFunction(pfes, (double *) NULL);
+   }
+#endif
+   if (ne == 0) { return; }
+
+   // Element dofs, in the order of the basis of PABasis.
+   const FiniteElement &fe = *vfes.GetFE(0);
+   const int order = (ir_order >= 0) ? ir_order : 2*fe.GetOrder() + 1;
+   vol_basis.Setup(fe, NULL, order);
+   tensor = vol_basis.IsTensor();
+
+   const Array<int> &dof_map = ElementRestriction::GetDofMap(fe);
+   Array<int> dofs, marker(vfes.GetNDofs());
+   marker = 0;
+   elem_dofs.SetSize(ne*nd);
+   for (int e = 0; e < ne; e++)
+   {
+      MFEM_VERIFY(vfes.GetFE(e)->GetGeomType() == fe.GetGeomType(),
+                  "mixed meshes are not supported");
+      vfes.GetElementDofs(e, dofs);
+      for (int i = 0; i < nd; i++)
+      {
+         const int d = dofs[dof_map.Size() ? dof_map[i] : i];
+         MFEM_VERIFY(d >= 0 && marker[d]++ == 0, "the space must be DG");
+         elem_dofs[e*nd + i] = d;
+      }
+   }
+
+   int nbr_ne = 0;
+#ifdef MFEM_USE_MPI
+   if (pfes)
+   {
+      // Face-neighbor element dofs, per component, in the order of elem_dofs
+      nbr_ne = pfes->GetParMesh()->face_nbr_elements.Size();
+      nbr_vdofs.SetSize(nbr_ne*neq*nd);
+      for (int i = 0; i < nbr_ne; i++)
+      {
+         MFEM_VERIFY(pfes->GetFaceNbrFE(i)->GetGeomType() == fe.GetGeomType(),
+                     "mixed meshes are not supported");
+         pfes->GetFaceNbrElementVDofs(i, dofs);
+         for (int k = 0; k < neq; k++)
+         {
+            for (int j = 0; j < nd; j++)
+            {
+               nbr_vdofs[(i*neq + k)*nd + j] =
+                  dofs[k*nd + (dof_map.Size() ? dof_map[j] : j)];
+            }
+         }
+      }
+   }
+#endif
+
+   SetupVolume();
+   SetupFaces(order);
+   SetupMass();
+
+   xe.SetSize((ne + nbr_ne)*neq*nd);
+   face_flux.SetSize(face_elem.Size()/2*neq*nqf);
+}
+
+void DGHyperbolicOperator::SetupVolume()
+{
+   // w adj(J)^t at the quadrature points, so that the volume term is
+   // sum_q sum_r d_r(w)(q) sum_d F(u(q))_d (w adj(J))_{rd}
+   const IntegrationRule &ir = vol_basis.GetRule();
+   const int nq = ir.GetNPoints();
+   vol_geom.SetSize(ne*nq*dim*dim);
+   for (int e = 0; e < ne; e++)
+   {
+      ElementTransformation &T = *vfes.GetElementTransformation(e);
+      for (int q = 0; q < nq; q++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         T.SetIntPoint(&ip);
+         const DenseMatrix &adjJ = T.AdjugateJacobian();
+         double *W = vol_geom.GetData() + (e*nq + q)*dim*dim;
+         for (int d = 0; d < dim; d++)
+         {
+            for (int r = 0; r < dim; r++)
+            {
+               W[r + d*dim] = ip.weight*adjJ(r,d);
+            }
+         }
+      }
+   }
+}
+
+void DGHyperbolicOperator::SetupFaces(int order)
+{
+   Mesh *mesh = vfes.GetMesh();
+   const FiniteElement &fe = *vfes.GetFE(0);
+
+   // The face quadrature rule; in the tensor case it is the tensor product of
+   // the 1D rule of the elements, so that the element traces are computed
+   // with 1D contractions.
+   IntegrationRule tensor_fir;
+   const IntegrationRule *fir;
+   int nq1 = 0, nd1 = 0;
+   if (tensor)
+   {
+      const IntegrationRule &ir1d = IntRules.Get(Geometry::SEGMENT, order);
+      nq1 = ir1d.GetNPoints();
+      nd1 = fe.GetOrder() + 1;
+      nqf = (dim == 2) ? nq1 : nq1*nq1;
+      tensor_fir.SetSize(nqf);
+      for (int q = 0; q < nqf; q++)
+      {
+         const IntegrationPoint &ipx = ir1d.IntPoint(q % nq1);
+         const IntegrationPoint &ipy = ir1d.IntPoint(q / nq1);
+         IntegrationPoint &ip = tensor_fir.IntPoint(q);
+         ip.x = ipx.x;
+         ip.y = (dim == 3) ? ipy.x : 0.0;
+         ip.weight = (dim == 3) ? ipx.weight*ipy.weight : ipx.weight;
+      }
+      fir = &tensor_fir;
+
+      const Poly_1D::Basis &basis1d =
+         dynamic_cast<const TensorBasisElement&>(fe).GetBasis1D();
+      Vector u(nd1), du(nd1);
+      B1d.SetSize(nq1, nd1);
+      for (int q = 0; q < nq1; q++)
+      {
+         basis1d.Eval(ir1d.IntPoint(q).x, u, du);
+         for (int i = 0; i < nd1; i++) { B1d(q,i) = u(i); }
+      }
+      for (int s = 0; s < 2; s++)
+      {
+         basis1d.Eval(double(s), u, du);
+         E1d[s].SetSize(1, nd1);
+         for (int i = 0; i < nd1; i++) { E1d[s](0,i) = u(i); }
+      }
+      trace_work_size = 2*TensorBasisElement::Pow(std::max(nd1, nq1), dim);
+   }
+   else
+   {
+      fir = &IntRules.Get(mesh->GetFaceBaseGeometry(0), order);
+      nqf = fir->GetNPoints();
+   }
+
+   face_weights.SetSize(nqf);
+   for (int q = 0; q < nqf; q++) { face_weights(q) = fir->IntPoint(q).weight; }
+
+   // The interior faces, then the faces shared with other ranks
+   Array<int> int_faces;
+   for (int i = 0; i < mesh->GetNumFaces(); i++)
+   {
+      int e1, e2;
+      mesh->GetFaceElements(i, &e1, &e2);
+      if (e2 >= 0) { int_faces.Append(i); }
+   }
+   const int nif = int_faces.Size();
+   int nsf = 0;
+#ifdef MFEM_USE_MPI
+   ParMesh *pmesh = pfes ? pfes->GetParMesh() : NULL;
+   if (pmesh) { nsf = pmesh->GetNSharedFaces(); }
+#endif
+   const int nf = nif + nsf;
+   face_elem.SetSize(2*nf);
+   face_side.SetSize(2*nf);
+   face_normals.SetSize(nf*nqf*dim);
+   if (tensor) { face_perm.SetSize(2*nf*nqf); }
+
+   const Array<int> &dof_map = ElementRestriction::GetDofMap(fe);
+   Array<int> table_keys;
+   Vector nor, shape(nd);
+   IntegrationPoint eip;
+   for (int f = 0; f < nf; f++)
+   {
+      FaceElementTransformations *Tr = NULL;
+      int i = -1;
+      if (f < nif)
+      {
+         i = int_faces[f];
+         Tr = mesh->GetInteriorFaceTransformations(i);
+         face_elem[2*f+1] = Tr->Elem2No;
+      }
+#ifdef MFEM_USE_MPI
+      else
+      {
+         // Elem2No is the face-neighbor element, stored after the local ones
+         i = pmesh->GetSharedFace(f - nif);
+         Tr = pmesh->GetSharedFaceTransformations(f - nif);
+         face_elem[2*f+1] = ne + Tr->Elem2No;
+      }
+#endif
+      face_elem[2*f] = Tr->Elem1No;
+      for (int q = 0; q < nqf; q++)
+      {
+         nor.SetDataAndSize(face_normals.GetData() + (f*nqf + q)*dim, dim);
+         Tr->Face->SetIntPoint(&fir->IntPoint(q));
+         CalcOrtho(Tr->Face->Jacobian(), nor);
+      }
+
+      int inf[2];
+      mesh->GetFaceInfos(i, &inf[0], &inf[1]);
+      for (int s = 0; s < 2; s++)
+      {
+         IntegrationPointTransformation &loc = s ? Tr->Loc2 : Tr->Loc1;
+         if (tensor)
+         {
+            // Find the reference face {x_d = 0 or 1} of the element, and the
+            // position of each face point in the lexicographic grid of the 1D
+            // points in the other directions.
+            int *perm = face_perm.GetData() + (2*f + s)*nqf;
+            for (int q = 0; q < nqf; q++)
+            {
+               loc.Transform(fir->IntPoint(q), eip);
+               const double c[3] = { eip.x, eip.y, eip.z };
+               int dir = -1, idx = 0, stride = 1;
+               for (int a = 0; a < dim; a++)
+               {
+                  if (c[a] < 1e-12 || c[a] > 1.0 - 1e-12)
+                  {
+                     dir = a;
+                     continue;
+                  }
+                  int k = 0;
+                  while (k < nq1 && std::abs(c[a] - tensor_fir.IntPoint(k).x)
+                         > 1e-10) { k++; }
+                  MFEM_VERIFY(k < nq1, "face point not on the element grid");
+                  idx += k*stride;
+                  stride *= nq1;
+               }
+               MFEM_VERIFY(dir >= 0, "face point not on the element boundary");
+               const int lf = 2*dir + (c[dir] > 0.5 ? 1 : 0);
+               MFEM_VERIFY(q == 0 || lf == face_side[2*f+s], "invalid face");
+               face_side[2*f+s] = lf;
+               perm[q] = idx;
+            }
+         }
+         else
+         {
+            // One trace table per (local face, orientation) pair.
+            int t = table_keys.Find(inf[s]);
+            if (t < 0)
+            {
+               t = table_keys.Size();
+               table_keys.Append(inf[s]);
+               DenseMatrix *B = new DenseMatrix(nqf, nd);
+               for (int q = 0; q < nqf; q++)
+               {
+                  loc.Transform(fir->IntPoint(q), eip);
+                  fe.CalcShape(eip, shape);
+                  for (int j = 0; j < nd; j++)
+                  {
+                     (*B)(q,j) = shape(dof_map.Size() ? dof_map[j] : j);
+                  }
+               }
+               trace_tables.Append(B);
+            }
+            face_side[2*f+s] = t;
+         }
+      }
+   }
+
+   // The sides of the faces in each local element
+   elem_faces.MakeI(ne);
+   for (int j = 0; j < 2*nf; j++)
+   {
+      if (face_elem[j] < ne) { elem_faces.AddAColumnInRow(face_elem[j]); }
+   }
+   elem_faces.MakeJ();
+   for (int j = 0; j < 2*nf; j++)
+   {
+      if (face_elem[j] < ne) { elem_faces.AddConnection(face_elem[j], j); }
+   }
+   elem_faces.ShiftUpI();
+}
+
+void DGHyperbolicOperator::SetupMass()
+{
+   const FiniteElement &fe = *vfes.GetFE(0);
+   const IntegrationRule &ir = vol_basis.GetRule();
+   const int nq = ir.GetNPoints();
+   const Array<int> &dof_map = ElementRestriction::GetDofMap(fe);
+
+   DenseMatrix Bt(nd, nq);
+   Vector shape(nd);
+   for (int q = 0; q < nq; q++)
+   {
+      fe.CalcShape(ir.IntPoint(q), shape);
+      for (int j = 0; j < nd; j++)
+      {
+         Bt(j,q) = shape(dof_map.Size() ? dof_map[j] : j);
+      }
+   }
+
+   // Jacobian determinants at the quadrature points; if they are constant in
+   // every element, the mass matrices are scaled reference mass matrices.
+   Vector detJ(ne*nq);
+   bool constant = true;
+   for (int e = 0; e < ne; e++)
+   {
+      ElementTransformation &T = *vfes.GetElementTransformation(e);
+      for (int q = 0; q < nq; q++)
+      {
+         T.SetIntPoint(&ir.IntPoint(q));
+         detJ(e*nq + q) = T.Weight();
+         if (std::abs(detJ(e*nq + q) - detJ(e*nq)) >
+             1e-12*std::abs(detJ(e*nq))) { constant = false; }
+      }
+   }
+
+   Vector w(nq);
+   if (constant)
+   {
+      DenseMatrix M(nd);
+      for (int q = 0; q < nq; q++) { w(q) = ir.IntPoint(q).weight; }
+      MultADAt(Bt, w, M);
+      DenseMatrixInverse inv(M);
+      inv.GetInverseMatrix(ref_mass_inv);
+      mass_scale.SetSize(ne);
+      for (int e = 0; e < ne; e++) { mass_scale(e) = 1.0/detJ(e*nq); }
+      return;
+   }
+
+   // Invert the element mass matrices with batched Cholesky factorizations
+   DenseTensor M(nd, nd, ne);
+   mass_inv.SetSize(nd, nd, ne);
+   Array<int> sizes(ne);
+   Array<double*> M_e(ne), M_inv_e(ne);
+   for (int e = 0; e < ne; e++)
+   {
+      for (int q = 0; q < nq; q++)
+      {
+         w(q) = ir.IntPoint(q).weight*detJ(e*nq + q);
+      }
+      MultADAt(Bt, w, M(e));
+      mass_inv(e) = 0.0;
+      for (int i = 0; i < nd; i++) { mass_inv(e)(i,i) = 1.0; }
+      sizes[e] = nd;
+      M_e[e] = M.GetData(e);
+      M_inv_e[e] = mass_inv.GetData(e);
+   }
+   DenseBatch::CholeskyFactor(ne, sizes, M_e);
+   DenseBatch::CholeskySolve(ne, sizes, sizes, M_e, M_inv_e);
+}
+
+void DGHyperbolicOperator::Trace(int f, int s, const double *ue,
+                                 double *tr, double *work) const
+{
+   const int lf = face_side[2*f+s];
+   if (tensor)
+   {
+      const int nd1 = B1d.Width(), dir = lf/2;
+      const int *perm = face_perm.GetData() + (2*f + s)*nqf;
+      for (int k = 0; k < neq; k++)
+      {
+         int n[3] = { 1, 1, 1 };
+         for (int a = 0; a < dim; a++) { n[a] = nd1; }
+         // value at the face in direction dir, then at the 1D points in the
+         // other directions
+         double *src = work, *dst = work + trace_work_size/2;
+         PABasis::Contract(E1d[lf%2], false, dir, n, ue + k*nd, src);
+         for (int a = 0; a < dim; a++)
+         {
+            if (a == dir) { continue; }
+            PABasis::Contract(B1d, false, a, n, src, dst);
+            std::swap(src, dst);
+         }
+         for (int q = 0; q < nqf; q++) { tr[q + k*nqf] = src[perm[q]]; }
+      }
+   }
+   else
+   {
+      const DenseMatrix &B = *trace_tables[lf];
+      for (int k = 0; k < neq; k++)
+      {
+         B.Mult(ue + k*nd, tr + k*nqf);
+      }
+   }
+}
+
+void DGHyperbolicOperator::AddTraceT(int f, int s, const double *tr,
+                                     double *ye, double *work) const
+{
+   const int lf = face_side[2*f+s];
+   if (tensor)
+   {
+      const int nq1 = B1d.Height(), dir = lf/2;
+      const int *perm = face_perm.GetData() + (2*f + s)*nqf;
+      for (int k = 0; k < neq; k++)
+      {
+         int n[3] = { 1, 1, 1 };
+         for (int a = 0; a < dim; a++) { n[a] = (a == dir) ? 1 : nq1; }
+         double *src = work, *dst = work + trace_work_size/2;
+         for (int q = 0; q < nqf; q++) { src[perm[q]] = tr[q + k*nqf]; }
+         for (int a = 0; a < dim; a++)
+         {
+            if (a == dir) { continue; }
+            PABasis::Contract(B1d, true, a, n, src, dst);
+            std::swap(src, dst);
+         }
+         PABasis::Contract(E1d[lf%2], true, dir, n, src, dst);
+         double *ye_k = ye + k*nd;
+         for (int i = 0; i < nd; i++) { ye_k[i] += dst[i]; }
+      }
+   }
+   else
+   {
+      const DenseMatrix &B = *trace_tables[lf];
+      for (int k = 0; k < neq; k++)
+      {
+         const double *tr_k = tr + k*nqf;
+         double *ye_k = ye + k*nd;
+         for (int i = 0; i < nd; i++)
+         {
+            const double *b_i = B.Data() + i*nqf;
+            double sum = 0.0;
+            for (int q = 0; q < nqf; q++) { sum += b_i[q]*tr_k[q]; }
+            ye_k[i] += sum;
+         }
+      }
+   }
+}
+
+void DGHyperbolicOperator::Mult(const Vector &x, Vector &y) const
+{
+   const int ndofs = vfes.GetNDofs();
+   const int nq = vol_basis.GetNPoints();
+   const int nf = face_elem.Size()/2;
+   const int work_size = std::max(trace_work_size, vol_basis.GetWorkSize());
+
+#ifdef MFEM_USE_MPI
+   if (pfes)
+   {
+      // The values of the face-neighbor elements, stored after the local ones
+      x_gf->SetData(const_cast<double*>(x.GetData()));
+      x_gf->ExchangeFaceNbrData();
+      const Vector &nbr_x = x_gf->FaceNbrData();
+      double *xe_nbr = xe.GetData() + ne*neq*nd;
+      for (int i = 0; i < nbr_vdofs.Size(); i++)
+      {
+         xe_nbr[i] = nbr_x(nbr_vdofs[i]);
+      }
+   }
+#endif
+
+   double mcs = 0.0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel reduction(max:mcs)
+#endif
+   {
+      // Work data of the thread
+      Vector state(neq), state2(neq), fluxN(neq), flux_work, nor;
+      Vector qx(neq*nq), qg(neq*dim*nq), tr(neq*nqf), ye_e(neq*nd);
+      DenseMatrix flux(neq, dim);
+      Array<double> work(work_size);
+
+      // 1. Extract the element dofs.
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int e = 0; e < ne; e++)
+      {
+         const int *dofs = elem_dofs.GetData() + e*nd;
+         for (int k = 0; k < neq; k++)
+         {
+            const double *x_k = x.GetData() + k*ndofs;
+            double *xe_ek = xe.GetData() + (e*neq + k)*nd;
+            for (int i = 0; i < nd; i++) { xe_ek[i] = x_k[dofs[i]]; }
+         }
+      }
+
+      // 2. Numerical fluxes F*(u).n on the faces, times the weights.
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int f = 0; f < nf; f++)
+      {
+         const int e1 = face_elem[2*f], e2 = face_elem[2*f+1];
+         double *ff = face_flux.GetData() + f*neq*nqf;
+         Trace(f, 0, xe.GetData() + e1*neq*nd, tr.GetData(), work);
+         Trace(f, 1, xe.GetData() + e2*neq*nd, ff, work);
+         for (int q = 0; q < nqf; q++)
+         {
+            for (int k = 0; k < neq; k++)
+            {
+               state(k) = tr(q + k*nqf);
+               state2(k) = ff[q + k*nqf];
+            }
+            nor.SetDataAndSize(face_normals.GetData() + (f*nqf + q)*dim, dim);
+            mcs = std::max(mcs, numFlux.Eval(state, state2, nor, fluxN,
+                                             flux_work));
+
+            const double w = face_weights(q);
+            for (int k = 0; k < neq; k++) { ff[q + k*nqf] = w*fluxN(k); }
+         }
+      }
+
+      // 3. For each element, the volume terms (F(u), grad w) and the face
+      //    terms -<F*(u).n, [w]>, then the inverse mass matrix.
+      const bool scaled = (mass_scale.Size() > 0);
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int e = 0; e < ne; e++)
+      {
+         const double *xe_e = xe.GetData() + e*neq*nd;
+         ye_e = 0.0;
+         for (int k = 0; k < neq; k++)
+         {
+            vol_basis.Values(xe_e + k*nd, qx.GetData() + k*nq, work);
+         }
+         for (int q = 0; q < nq; q++)
+         {
+            for (int k = 0; k < neq; k++) { state(k) = qx(k*nq + q); }
+            mcs = std::max(mcs, fluxFunction.ComputeFlux(state, flux));
+
+            const double *W = vol_geom.GetData() + (e*nq + q)*dim*dim;
+            for (int k = 0; k < neq; k++)
+            {
+               for (int r = 0; r < dim; r++)
+               {
+                  double s = 0.0;
+                  for (int d = 0; d < dim; d++) { s += flux(k,d)*W[r + d*dim]; }
+                  qg((k*dim + r)*nq + q) = s;
+               }
+            }
+         }
+         for (int k = 0; k < neq; k++)
+         {
+            vol_basis.AddGradientsT(qg.GetData() + k*dim*nq,
+                                    ye_e.GetData() + k*nd, work);
+         }
+
+         // The normals point from side 0 to side 1 of the faces.
+         const int *fs = elem_faces.GetRow(e);
+         for (int j = 0; j < elem_faces.RowSize(e); j++)
+         {
+            const int f = fs[j]/2, s = fs[j]%2;
+            const double *ff = face_flux.GetData() + f*neq*nqf;
+            const double sign = s ? 1.0 : -1.0;
+            for (int i = 0; i < neq*nqf; i++) { tr(i) = sign*ff[i]; }
+            AddTraceT(f, s, tr.GetData(), ye_e.GetData(), work);
+         }
+
+         const int *dofs = elem_dofs.GetData() + e*nd;
+         const DenseMatrix &Minv = scaled ? ref_mass_inv : mass_inv(e);
+         const double scale = scaled ? mass_scale(e) : 1.0;
+         for (int k = 0; k < neq; k++)
+         {
+            const double *ye_ek = ye_e.GetData() + k*nd;
+            double *y_k = y.GetData() + k*ndofs;
+            for (int i = 0; i < nd; i++)
+            {
+               double s = 0.0;
+               for (int j = 0; j < nd; j++) { s += Minv(i,j)*ye_ek[j]; }
+               y_k[dofs[i]] = scale*s;
+            }
+         }
+      }
+   }
+   max_char_speed = mcs;
+}
+
+DGHyperbolicOperator::~DGHyperbolicOperator()
+{
+   for (int i = 0; i < trace_tables.Size(); i++)
+   {
+      delete trace_tables[i];
+   }
+#ifdef MFEM_USE_MPI
+   delete x_gf;
+#endif
+}
+
+}
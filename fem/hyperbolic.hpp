@@ -0,0 +1,219 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_HYPERBOLIC
+#define MFEM_HYPERBOLIC
+
+#include "../config/config.hpp"
+#include "fespace.hpp"
+#include "bilininteg.hpp"
+
+namespace mfem
+{
+
+#ifdef MFEM_USE_MPI
+class ParFiniteElementSpace;
+class ParGridFunction;
+#endif
+
+/** @brief Abstract physical flux F(u) of a system of conservation laws
+    du/dt + div F(u) = 0 with @a num_equations unknowns in @a dim dimensions.
+
+    The methods are const and use no member work data, so that one object can
+    be evaluated by several threads at once. */
+class FluxFunction
+{
+public:
+   const int num_equations;
+   const int dim;
+
+   FluxFunction(const int num_equations_, const int dim_)
+      : num_equations(num_equations_), dim(dim_) { }
+
+   /** @brief Compute the flux F(@a state), a num_equations x dim matrix, and
+       return the maximum characteristic speed at @a state. */
+   virtual double ComputeFlux(const Vector &state, DenseMatrix &flux) const = 0;
+
+   /** @brief Compute the normal flux F(@a state) @a nor, where @a nor need not
+       be a unit vector, and return the maximum characteristic speed. The
+       default implementation calls ComputeFlux() with a temporary matrix;
+       override it when the normal flux is cheaper to compute directly. */
+   virtual double ComputeFluxDotN(const Vector &state, const Vector &nor,
+                                  Vector &fluxN) const;
+
+   virtual ~FluxFunction() { }
+};
+
+
+/** @brief Flux of the compressible Euler equations for an ideal gas, with
+    the state (density, momentum, energy). */
+class EulerFlux : public FluxFunction
+{
+protected:
+   const double specific_heat_ratio;
+
+public:
+   EulerFlux(const int dim_, const double specific_heat_ratio_ = 1.4)
+      : FluxFunction(dim_ + 2, dim_),
+        specific_heat_ratio(specific_heat_ratio_) { }
+
+   virtual double ComputeFlux(const Vector &state, DenseMatrix &flux) const;
+
+   virtual double ComputeFluxDotN(const Vector &state, const Vector &nor,
+                                  Vector &fluxN) const;
+};
+
+
+/** @brief Abstract numerical flux (approximate Riemann solver) on the faces
+    of a DG discretization. Like FluxFunction, it keeps no work data. */
+class NumericalFlux
+{
+public:
+   /** @brief Compute the numerical normal flux between @a state1 and
+       @a state2 for the normal @a nor, pointing from side 1 to side 2, whose
+       length is the face area element. Return the maximum characteristic
+       speed. */
+   /** The vector @a work belongs to the caller and is resized as needed by
+       the implementation; threads calling Eval() at the same time must pass
+       different work vectors. */
+   virtual double Eval(const Vector &state1, const Vector &state2,
+                       const Vector &nor, Vector &flux,
+                       Vector &work) const = 0;
+
+   virtual ~NumericalFlux() { }
+};
+
+
+/// The local Lax-Friedrichs (Rusanov) numerical flux of a FluxFunction.
+class RusanovFlux : public NumericalFlux
+{
+protected:
+   const FluxFunction &fluxFunction;
+
+public:
+   RusanovFlux(const FluxFunction &fluxFunction_)
+      : fluxFunction(fluxFunction_) { }
+
+   virtual double Eval(const Vector &state1, const Vector &state2,
+                       const Vector &nor, Vector &flux, Vector &work) const;
+};
+
+
+/** @brief Matrix-free DG semi-discretization of a system of conservation
+    laws: y = M^{-1} [ (F(x), grad w) - <F*(x).n, [w]> ].
+
+    The space must be a DG (e.g. L2_FECollection) space with vdim equal to the
+    number of equations and Ordering::byNODES, on a conforming mesh with one
+    element type. Only the interior faces (including periodic faces) are
+    integrated; boundary faces are skipped. With a ParFiniteElementSpace, the
+    faces shared with other ranks are integrated too: Mult() exchanges the
+    values of the face-neighbor elements (see
+    ParGridFunction::ExchangeFaceNbrData()) and each rank adds the flux to its
+    own side of the face.
+
+    The constructor precomputes the quadrature weights times the adjugate
+    Jacobians in the elements, the normals on the faces, the maps from the
+    face quadrature points to the element traces, and the inverse mass
+    matrices (one reference inverse scaled per element when the Jacobian
+    determinants are constant in the elements). The Mult() method then loops
+    over the faces and the elements with no geometric computations. For
+    tensor-product elements, the values at the quadrature points, the face
+    traces and their transposes are computed with sum factorization (see
+    PABasis); otherwise dense basis matrices are used.
+
+    With MFEM_USE_OPENMP, both loops are threaded: the numerical fluxes of all
+    faces are first computed and stored, then each element adds its volume
+    term and the fluxes of its faces, and applies its inverse mass matrix.
+    Every element and face is written by one thread, so the result does not
+    depend on the number of threads. */
+class DGHyperbolicOperator : public TimeDependentOperator
+{
+protected:
+   const FiniteElementSpace &vfes;
+   const FluxFunction &fluxFunction;
+   const NumericalFlux &numFlux;
+   const int dim, neq, ne, nd;
+   bool tensor;
+
+   /// Element dofs (E-vector to L-vector index map), lexicographic if tensor.
+   Array<int> elem_dofs;
+
+   /// Volume basis and w adj(J)^t at the quadrature points (dim x dim each).
+   PABasis vol_basis;
+   Vector vol_geom;
+
+   /// Face quadrature weights, and the normals at the face points.
+   Vector face_weights, face_normals;
+   /** Faces: elements and local face (tensor) or trace table index of both
+       sides; the elements of the other ranks are numbered from @a ne. */
+   Array<int> face_elem, face_side;
+   /// The faces of each element, as 2*face + side.
+   Table elem_faces;
+   int nqf;
+   /** Tensor case: the face point -> trace point maps of both sides, and the
+       1D basis values at the quadrature points and at the end points 0, 1. */
+   Array<int> face_perm;
+   DenseMatrix B1d, E1d[2];
+   /// General case: the trace tables B(q,i) for the face/orientation pairs.
+   Array<DenseMatrix*> trace_tables;
+   /// Size of the work array of Trace() and AddTraceT().
+   int trace_work_size;
+
+   /** Inverse mass matrices: reference inverse and scaling, or per element,
+       computed with batched Cholesky factorizations (see DenseBatch). */
+   DenseMatrix ref_mass_inv;
+   Vector mass_scale;
+   DenseTensor mass_inv;
+
+#ifdef MFEM_USE_MPI
+   /** The parallel space, or NULL; not const, since its face-neighbor data
+       are built by ParFiniteElementSpace::ExchangeFaceNbrData(). */
+   ParFiniteElementSpace *pfes;
+   /// Face-neighbor element dofs, per component, in the face-neighbor data.
+   Array<int> nbr_vdofs;
+   /// Used to exchange the face-neighbor values of the input of Mult().
+   ParGridFunction *x_gf;
+#endif
+
+   mutable double max_char_speed;
+   /// Element values (local and face-neighbor elements) and face fluxes.
+   mutable Vector xe, face_flux;
+
+   void SetupVolume();
+   void SetupFaces(int order);
+   void SetupMass();
+
+   /** @brief Trace of the element vector @a ue (nd x neq) on side @a s of
+       face @a f; @a work holds trace_work_size entries. */
+   void Trace(int f, int s, const double *ue, double *tr, double *work) const;
+   /// Add the transpose of Trace() applied to @a tr to @a ye.
+   void AddTraceT(int f, int s, const double *tr, double *ye,
+                  double *work) const;
+
+public:
+   /** @brief Construct the operator on the space @a vfes_; the integration
+       rules have order @a ir_order, by default 2p+1. */
+   DGHyperbolicOperator(const FiniteElementSpace &vfes_,
+                        const FluxFunction &fluxFunction_,
+                        const NumericalFlux &numFlux_, int ir_order = -1);
+
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /** @brief Maximum characteristic speed seen in the last call to Mult(), on
+       this rank; parallel codes reduce it over the ranks (MPI_MAX). */
+   double GetMaxCharSpeed() const { return max_char_speed; }
+
+   virtual ~DGHyperbolicOperator();
+};
+
+}
+
+#endif
@@ -107,22 +107,20 @@ const Vector &NonlinearForm::Prolongate(const Vector &x) const
    return x;
 }
 
-void NonlinearForm::Mult(const Vector &x, Vector &y) const
+void NonlinearForm::AddDomainVectors(const Array<int> *elems,
+                                     const Vector &px, Vector &py) const
 {
    Array<int> vdofs;
    Vector el_x, el_y;
    const FiniteElement *fe;
    ElementTransformation *T;
-   Mesh *mesh = fes->GetMesh();
-   const Vector &px = Prolongate(x);
-   Vector &py = P ? aux2.SetSize(P->Height()), aux2 : y;
-
-   py = 0.0;
 
    if (dnfi.Size())
    {
-      for (int i = 0; i < fes->GetNE(); i++)
+      const int n = elems ? elems->Size() : fes->GetNE();
+      for (int j = 0; j < n; j++)
       {
+         const int i = elems ? (*elems)[j] : j;
          fe = fes->GetFE(i);
          fes->GetElementVDofs(i, vdofs);
          T = fes->GetElementTransformation(i);
@@ -134,6 +132,13 @@ void NonlinearForm::Mult(const Vector &x, Vector &y) const
          }
       }
    }
+}
+
+void NonlinearForm::AddFaceVectors(const Vector &px, Vector &py) const
+{
+   Array<int> vdofs;
+   Vector el_x, el_y;
+   Mesh *mesh = fes->GetMesh();
 
    if (fnfi.Size())
    {
@@ -217,6 +222,16 @@ void NonlinearForm::Mult(const Vector &x, Vector &y) const
          }
       }
    }
+}
+
+void NonlinearForm::Mult(const Vector &x, Vector &y) const
+{
+   const Vector &px = Prolongate(x);
+   Vector &py = P ? aux2.SetSize(P->Height()), aux2 : y;
+
+   py = 0.0;
+   AddDomainVectors(NULL, px, py);
+   AddFaceVectors(px, py);
 
    if (Serial())
    {
@@ -250,6 +265,9 @@ Operator &NonlinearForm::GetGradient(const Vector &x) const
       *Grad = 0.0;
    }
 
+   const bool scatter = fixed_sparsity && Grad->Finalized();
+   if (scatter) { grad_scatter.Begin(); }
+
    if (dnfi.Size())
    {
       for (int i = 0; i < fes->GetNE(); i++)
@@ -261,8 +279,7 @@ Operator &NonlinearForm::GetGradient(const Vector &x) const
          for (int k = 0; k < dnfi.Size(); k++)
          {
             dnfi[k]->AssembleElementGrad(*fe, *T, el_x, elmat);
-            Grad->AddSubMatrix(vdofs, vdofs, elmat, skip_zeros);
-            // Grad->AddSubMatrix(vdofs, vdofs, elmat, 1);
+            AddElementGrad(vdofs, elmat, scatter);
          }
       }
    }
@@ -290,7 +307,7 @@ Operator &NonlinearForm::GetGradient(const Vector &x) const
             for (int k = 0; k < fnfi.Size(); k++)
             {
                fnfi[k]->AssembleFaceGrad(*fe1, *fe2, *tr, el_x, elmat);
-               Grad->AddSubMatrix(vdofs, vdofs, elmat, skip_zeros);
+               AddElementGrad(vdofs, elmat, scatter);
             }
          }
       }
@@ -344,13 +361,17 @@ Operator &NonlinearForm::GetGradient(const Vector &x) const
                    (*bfnfi_marker[k])[bdr_attr-1] == 0) { continue; }
 
                bfnfi[k]->AssembleFaceGrad(*fe1, *fe2, *tr, el_x, elmat);
-               Grad->AddSubMatrix(vdofs, vdofs, elmat, skip_zeros);
+               AddElementGrad(vdofs, elmat, scatter);
             }
          }
       }
    }
 
-   if (!Grad->Finalized())
+   if (scatter)
+   {
+      grad_scatter.End();
+   }
+   else if (!Grad->Finalized())
    {
       Grad->Finalize(skip_zeros);
    }
@@ -364,15 +385,76 @@ Operator &NonlinearForm::GetGradient(const Vector &x) const
          cGrad = RAP(*cP, *Grad, *cP);
          mGrad = cGrad;
       }
-      for (int i = 0; i < ess_tdof_list.Size(); i++)
+      if (scatter && !cP)
       {
-         mGrad->EliminateRowCol(ess_tdof_list[i]);
+         EliminateGrad();
+      }
+      else
+      {
+         for (int i = 0; i < ess_tdof_list.Size(); i++)
+         {
+            mGrad->EliminateRowCol(ess_tdof_list[i]);
+         }
       }
    }
 
    return *mGrad;
 }
 
+void NonlinearForm::AddElementGrad(const Array<int> &vdofs,
+                                   const DenseMatrix &elmat,
+                                   bool scatter) const
+{
+   if (scatter)
+   {
+      grad_scatter.AddSubMatrix(*Grad, vdofs, vdofs, elmat);
+   }
+   else
+   {
+      const int skip_zeros = 0;
+      Grad->AddSubMatrix(vdofs, vdofs, elmat, skip_zeros);
+   }
+}
+
+void NonlinearForm::EliminateGrad() const
+{
+   if (ess_tdof_list != grad_elim_tdofs)
+   {
+      // The entries in the eliminated rows and columns, see
+      // SparseMatrix::EliminateRowCol(int, DiagonalPolicy).
+      ess_tdof_list.Copy(grad_elim_tdofs);
+      grad_elim_zero.SetSize(0);
+      grad_elim_diag.SetSize(0);
+      const int n = Grad->Height();
+      Array<int> ess_marker(n);
+      ess_marker = 0;
+      for (int i = 0; i < ess_tdof_list.Size(); i++)
+      {
+         ess_marker[ess_tdof_list[i]] = 1;
+      }
+      const int *I = Grad->GetI(), *J = Grad->GetJ();
+      for (int i = 0; i < n; i++)
+      {
+         for (int k = I[i]; k < I[i+1]; k++)
+         {
+            const int j = J[k];
+            if (!ess_marker[i] && !ess_marker[j]) { continue; }
+            ((i == j) ? grad_elim_diag : grad_elim_zero).Append(k);
+         }
+      }
+   }
+
+   double *data = Grad->GetData();
+   for (int k = 0; k < grad_elim_zero.Size(); k++)
+   {
+      data[grad_elim_zero[k]] = 0.0;
+   }
+   for (int k = 0; k < grad_elim_diag.Size(); k++)
+   {
+      data[grad_elim_diag[k]] = 1.0;
+   }
+}
+
 void NonlinearForm::Update()
 {
    if (sequence == fes->GetSequence()) { return; }
@@ -380,6 +462,8 @@ void NonlinearForm::Update()
    height = width = fes->GetTrueVSize();
    delete cGrad; cGrad = NULL;
    delete Grad; Grad = NULL;
+   grad_scatter.Reset();
+   grad_elim_tdofs.SetSize(0);
    ess_tdof_list.SetSize(0); // essential b.c. will need to be set again
    sequence = fes->GetSequence();
    // Do not modify aux1 and aux2, their size will be set before use.
@@ -37,6 +37,21 @@ protected:
 
    mutable SparseMatrix *Grad, *cGrad; // owned
 
+   /** Reassembly of Grad with a fixed sparsity pattern: positions in Grad of
+       the element gradient entries, and of the entries in the rows and columns
+       of 'grad_elim_tdofs' that are zeroed (pairs 'grad_elim_zero') or set to
+       one (diagonal, 'grad_elim_diag') by the elimination. */
+   bool fixed_sparsity;
+   mutable SparseScatterMap grad_scatter;
+   mutable Array<int> grad_elim_tdofs, grad_elim_zero, grad_elim_diag;
+
+   // Add the element gradient 'elmat' to Grad.
+   void AddElementGrad(const Array<int> &vdofs, const DenseMatrix &elmat,
+                       bool scatter) const;
+
+   // Eliminate ess_tdof_list from Grad using the recorded positions.
+   void EliminateGrad() const;
+
    /// A list of all essential true dofs
    Array<int> ess_tdof_list;
 
@@ -54,12 +69,22 @@ protected:
    bool Serial() const { return (!P || cP); }
    const Vector &Prolongate(const Vector &x) const;
 
+   /** @brief Add the contributions of the domain integrators on the elements
+       @a elems (all elements, if NULL) to the L-vector @a py. */
+   void AddDomainVectors(const Array<int> *elems, const Vector &px,
+                         Vector &py) const;
+
+   /** @brief Add the contributions of the interior and boundary face
+       integrators to the L-vector @a py. */
+   void AddFaceVectors(const Vector &px, Vector &py) const;
+
 public:
    /// Construct a NonlinearForm on the given FiniteElementSpace, @a f.
    /** As an Operator, the NonlinearForm has input and output size equal to the
        number of true degrees of freedom, i.e. f->GetTrueVSize(). */
    NonlinearForm(FiniteElementSpace *f)
       : Operator(f->GetTrueVSize()), fes(f), Grad(NULL), cGrad(NULL),
+        fixed_sparsity(false),
         sequence(f->GetSequence()), P(f->GetProlongationMatrix()),
         cP(dynamic_cast<const SparseMatrix*>(P))
    { }
@@ -118,6 +143,16 @@ public:
    virtual double GetEnergy(const Vector &x) const
    { return GetGridFunctionEnergy(Prolongate(x)); }
 
+   /** @brief Keep the sparsity pattern of the gradient matrix fixed after its
+       first assembly.
+
+       The second call to GetGradient() records the positions of the entries
+       of the element gradients in the finalized matrix, and the later calls
+       add the element gradients directly at these positions. On a conforming
+       space, the elimination of the essential true dofs also uses recorded
+       positions. The integrators must not change between the calls. */
+   void UseFixedSparsity(bool fs = true) { fixed_sparsity = fs; }
+
    /// Evaluate the action of the NonlinearForm.
    /** The input essential dofs in @a x will, generally, be non-zero. However,
        the output essential dofs in @a y will always be set to zero.
@@ -15,6 +15,7 @@
 
 #include "fem.hpp"
 #include "../general/sort_pairs.hpp"
+#include <algorithm>
 
 namespace mfem
 {
@@ -187,6 +188,328 @@ HypreParMatrix *ParBilinearForm::ParallelAssemble(SparseMatrix *m)
    return Mh.As<HypreParMatrix>();
 }
 
+// Add the element matrix with (signed) local dofs vdofs to the rows of the
+// owned true dofs in diag (owned columns, by local true dof) and offd_l
+// (other columns, by local dof), or to the rows of shared, by local dof, if
+// the row is owned by another processor. Zero off-diagonal entries are
+// skipped, as with skip_zeros = 1.
+static void AddElementMatrixDirect(const Array<int> &vdofs,
+                                   const DenseMatrix &elmat,
+                                   const Array<int> &ldof_ltdof,
+                                   SparseMatrix &diag, SparseMatrix &offd_l,
+                                   SparseMatrix &shared)
+{
+   for (int i = 0; i < vdofs.Size(); i++)
+   {
+      const int ii = (vdofs[i] >= 0) ? vdofs[i] : -1-vdofs[i];
+      const int r = ldof_ltdof[ii];
+      for (int j = 0; j < vdofs.Size(); j++)
+      {
+         double a = elmat(i,j);
+         const int jj = (vdofs[j] >= 0) ? vdofs[j] : -1-vdofs[j];
+         if (a == 0.0 && ii != jj) { continue; }
+         if ((vdofs[i] >= 0) != (vdofs[j] >= 0)) { a = -a; }
+         if (r < 0) { shared.Add(ii, jj, a); }
+         else if (ldof_ltdof[jj] >= 0) { diag.Add(r, ldof_ltdof[jj], a); }
+         else { offd_l.Add(r, jj, a); }
+      }
+   }
+}
+
+HypreParMatrix *ParBilinearForm::ParallelAssembleDirect()
+{
+   MFEM_VERIFY(pfes->Conforming() && !pfes->GetNURBSext(),
+               "direct assembly requires a conforming, non-NURBS space");
+   MFEM_VERIFY(fbfi.Size() == 0 && bfbfi.Size() == 0 && !static_cond &&
+               !hybridization && !ext,
+               "direct assembly supports only domain and boundary integrators");
+
+   MPI_Comm comm = pfes->GetComm();
+   const int vsize = pfes->GetVSize();
+   const int ntdofs = pfes->TrueVSize();
+   const HYPRE_Int my_offset = pfes->GetMyTDofOffset();
+   Mesh *mesh = pfes->GetMesh();
+
+   // Global true dof of each local dof, its local true dof (-1 if another
+   // processor owns it) and the neighbor index of its owner (0 = this one).
+   const GroupCommunicator &gcomm = pfes->GroupComm();
+   const GroupTopology &gtopo = gcomm.GetGroupTopology();
+   const Table &group_ldof = gcomm.GroupLDofTable();
+   Array<HYPRE_Int> ldof_gtdof(vsize);
+   Array<int> ldof_ltdof(vsize), ldof_master(vsize);
+   ldof_master = 0;
+   for (int g = 1; g < group_ldof.Size(); g++)
+   {
+      if (gtopo.IAmMaster(g)) { continue; }
+      const int *ldofs = group_ldof.GetRow(g);
+      for (int j = 0; j < group_ldof.RowSize(g); j++)
+      {
+         ldof_master[ldofs[j]] = gtopo.GetGroupMaster(g);
+      }
+   }
+   for (int i = 0; i < vsize; i++)
+   {
+      ldof_gtdof[i] = pfes->GetGlobalTDofNumber(i);
+      ldof_ltdof[i] = ldof_master[i] ? -1 : pfes->GetLocalTDofNumber(i);
+   }
+
+   // Owned rows: diag columns are local true dofs, offd columns are local
+   // dofs (converted below). Rows owned by other processors go in 'shared'.
+   SparseMatrix diag(ntdofs, ntdofs), offd_l(ntdofs, vsize);
+   SparseMatrix shared(vsize, vsize);
+   Array<int> vdofs;
+   DenseMatrix elmat, elemmat;
+
+   if (dbfi.Size())
+   {
+      for (int i = 0; i < pfes->GetNE(); i++)
+      {
+         pfes->GetElementVDofs(i, vdofs);
+         if (element_matrices)
+         {
+            AddElementMatrixDirect(vdofs, (*element_matrices)(i), ldof_ltdof,
+                                   diag, offd_l, shared);
+            continue;
+         }
+         const FiniteElement &fe = *pfes->GetFE(i);
+         ElementTransformation *eltrans = pfes->GetElementTransformation(i);
+         dbfi[0]->AssembleElementMatrix(fe, *eltrans, elmat);
+         for (int k = 1; k < dbfi.Size(); k++)
+         {
+            dbfi[k]->AssembleElementMatrix(fe, *eltrans, elemmat);
+            elmat += elemmat;
+         }
+         AddElementMatrixDirect(vdofs, elmat, ldof_ltdof, diag, offd_l, shared);
+      }
+   }
+
+   if (bbfi.Size())
+   {
+      for (int i = 0; i < pfes->GetNBE(); i++)
+      {
+         const int bdr_attr = mesh->GetBdrAttribute(i);
+         bool first = true;
+         const FiniteElement &be = *pfes->GetBE(i);
+         ElementTransformation *eltrans = pfes->GetBdrElementTransformation(i);
+         for (int k = 0; k < bbfi.Size(); k++)
+         {
+            if (bbfi_marker[k] && (*bbfi_marker[k])[bdr_attr-1] == 0)
+            {
+               continue;
+            }
+            bbfi[k]->AssembleElementMatrix(be, *eltrans, first ? elmat :
+                                           elemmat);
+            if (!first) { elmat += elemmat; }
+            first = false;
+         }
+         if (first) { continue; }
+         pfes->GetBdrElementVDofs(i, vdofs);
+         AddElementMatrixDirect(vdofs, elmat, ldof_ltdof, diag, offd_l, shared);
+      }
+   }
+
+   // Send the shared rows to their owners: for each row, the global row, the
+   // row size and the global columns, plus the values.
+   shared.Finalize(0);
+   const int num_nbrs = gtopo.GetNumNeighbors();
+   Array<int> send_size(2*num_nbrs), recv_size(2*num_nbrs);
+   send_size = 0;
+   const int *sI = shared.GetI(), *sJ = shared.GetJ();
+   const double *sA = shared.GetData();
+   for (int i = 0; i < vsize; i++)
+   {
+      const int rs = sI[i+1] - sI[i];
+      if (rs == 0) { continue; }
+      send_size[2*ldof_master[i]] += 2 + rs;
+      send_size[2*ldof_master[i]+1] += rs;
+   }
+   Array<int> send_ioff(num_nbrs+1), send_doff(num_nbrs+1);
+   send_ioff[0] = send_doff[0] = 0;
+   for (int n = 0; n < num_nbrs; n++)
+   {
+      send_ioff[n+1] = send_ioff[n] + send_size[2*n];
+      send_doff[n+1] = send_doff[n] + send_size[2*n+1];
+   }
+   Array<HYPRE_Int> send_ibuf(send_ioff[num_nbrs]);
+   Array<double> send_dbuf(send_doff[num_nbrs]);
+   {
+      Array<int> ipos(num_nbrs), dpos(num_nbrs);
+      for (int n = 0; n < num_nbrs; n++)
+      {
+         ipos[n] = send_ioff[n];
+         dpos[n] = send_doff[n];
+      }
+      for (int i = 0; i < vsize; i++)
+      {
+         const int rs = sI[i+1] - sI[i], n = ldof_master[i];
+         if (rs == 0) { continue; }
+         send_ibuf[ipos[n]++] = ldof_gtdof[i];
+         send_ibuf[ipos[n]++] = rs;
+         for (int k = sI[i]; k < sI[i+1]; k++)
+         {
+            send_ibuf[ipos[n]++] = ldof_gtdof[sJ[k]];
+            send_dbuf[dpos[n]++] = sA[k];
+         }
+      }
+   }
+   shared.Clear();
+
+   const int tag = 46801;
+   MPI_Request *requests = new MPI_Request[4*num_nbrs];
+   MPI_Status  *statuses = new MPI_Status[4*num_nbrs];
+   int request_counter = 0;
+   for (int n = 1; n < num_nbrs; n++)
+   {
+      MPI_Irecv(&recv_size[2*n], 2, MPI_INT, gtopo.GetNeighborRank(n), tag,
+                comm, &requests[request_counter++]);
+      MPI_Isend(&send_size[2*n], 2, MPI_INT, gtopo.GetNeighborRank(n), tag,
+                comm, &requests[request_counter++]);
+   }
+   MPI_Waitall(request_counter, requests, statuses);
+
+   Array<int> recv_ioff(num_nbrs+1), recv_doff(num_nbrs+1);
+   recv_ioff[0] = recv_ioff[1] = recv_doff[0] = recv_doff[1] = 0;
+   for (int n = 1; n < num_nbrs; n++)
+   {
+      recv_ioff[n+1] = recv_ioff[n] + recv_size[2*n];
+      recv_doff[n+1] = recv_doff[n] + recv_size[2*n+1];
+   }
+   Array<HYPRE_Int> recv_ibuf(recv_ioff[num_nbrs]);
+   Array<double> recv_dbuf(recv_doff[num_nbrs]);
+   request_counter = 0;
+   for (int n = 1; n < num_nbrs; n++)
+   {
+      const int rank = gtopo.GetNeighborRank(n);
+      if (recv_size[2*n])
+      {
+         MPI_Irecv(recv_ibuf.GetData() + recv_ioff[n], recv_size[2*n],
+                   HYPRE_MPI_INT, rank, tag+1, comm,
+                   &requests[request_counter++]);
+         MPI_Irecv(recv_dbuf.GetData() + recv_doff[n], recv_size[2*n+1],
+                   MPI_DOUBLE, rank, tag+2, comm,
+                   &requests[request_counter++]);
+      }
+      if (send_size[2*n])
+      {
+         MPI_Isend(send_ibuf.GetData() + send_ioff[n], send_size[2*n],
+                   HYPRE_MPI_INT, rank, tag+1, comm,
+                   &requests[request_counter++]);
+         MPI_Isend(send_dbuf.GetData() + send_doff[n], send_size[2*n+1],
+                   MPI_DOUBLE, rank, tag+2, comm,
+                   &requests[request_counter++]);
+      }
+   }
+   MPI_Waitall(request_counter, requests, statuses);
+   delete [] statuses;
+   delete [] requests;
+   send_ibuf.DeleteAll();
+   send_dbuf.DeleteAll();
+
+   // Add the received rows; columns owned by other processors are kept in
+   // (row, global column, value) form until the column map is known.
+   Array<int> ext_row;
+   Array<HYPRE_Int> ext_col;
+   Array<double> ext_val;
+   for (int p = 0, d = 0; p < recv_ibuf.Size(); )
+   {
+      const int r = recv_ibuf[p++] - my_offset, rs = recv_ibuf[p++];
+      MFEM_ASSERT(0 <= r && r < ntdofs, "received a row not owned by me");
+      for (int k = 0; k < rs; k++, p++, d++)
+      {
+         const HYPRE_Int c = recv_ibuf[p] - my_offset;
+         if (0 <= c && c < ntdofs) { diag.Add(r, c, recv_dbuf[d]); }
+         else
+         {
+            ext_row.Append(r);
+            ext_col.Append(recv_ibuf[p]);
+            ext_val.Append(recv_dbuf[d]);
+         }
+      }
+   }
+   recv_ibuf.DeleteAll();
+   recv_dbuf.DeleteAll();
+
+   // The column map of the offd block: the sorted global columns in use.
+   offd_l.Finalize(0);
+   Array<HYPRE_Int> cmap(ext_col.Size());
+   for (int k = 0; k < ext_col.Size(); k++) { cmap[k] = ext_col[k]; }
+   for (int k = 0; k < offd_l.NumNonZeroElems(); k++)
+   {
+      cmap.Append(ldof_gtdof[offd_l.GetJ()[k]]);
+   }
+   cmap.Sort();
+   cmap.Unique();
+
+   SparseMatrix offd(ntdofs, cmap.Size());
+   for (int r = 0; r < ntdofs; r++)
+   {
+      for (int k = offd_l.GetI()[r]; k < offd_l.GetI()[r+1]; k++)
+      {
+         const HYPRE_Int c = ldof_gtdof[offd_l.GetJ()[k]];
+         offd.Add(r, std::lower_bound(cmap.begin(), cmap.end(), c) -
+                  cmap.begin(), offd_l.GetData()[k]);
+      }
+   }
+   offd_l.Clear();
+   for (int k = 0; k < ext_col.Size(); k++)
+   {
+      offd.Add(ext_row[k], std::lower_bound(cmap.begin(), cmap.end(),
+                                            ext_col[k]) - cmap.begin(),
+               ext_val[k]);
+   }
+   diag.Finalize(0);
+   offd.Finalize(0);
+
+   // The 13-argument constructor takes ownership of the CSR arrays.
+   HYPRE_Int *diag_i, *diag_j, *offd_i, *offd_j, *col_map;
+   double *diag_data, *offd_data;
+   SparseMatrix *blocks[2] = { &diag, &offd };
+   HYPRE_Int **block_i[2] = { &diag_i, &offd_i };
+   HYPRE_Int **block_j[2] = { &diag_j, &offd_j };
+   double **block_data[2] = { &diag_data, &offd_data };
+   for (int b = 0; b < 2; b++)
+   {
+      const int nnz = blocks[b]->NumNonZeroElems();
+      HYPRE_Int *I = *block_i[b] = new HYPRE_Int[ntdofs+1];
+      HYPRE_Int *J = *block_j[b] = new HYPRE_Int[nnz];
+      double *A = *block_data[b] = new double[nnz];
+      for (int i = 0; i <= ntdofs; i++) { I[i] = blocks[b]->GetI()[i]; }
+      for (int k = 0; k < nnz; k++)
+      {
+         J[k] = blocks[b]->GetJ()[k];
+         A[k] = blocks[b]->GetData()[k];
+      }
+      blocks[b]->Clear();
+   }
+   col_map = new HYPRE_Int[cmap.Size()];
+   for (int k = 0; k < cmap.Size(); k++) { col_map[k] = cmap[k]; }
+
+   return new HypreParMatrix(comm, pfes->GlobalTrueVSize(),
+                             pfes->GlobalTrueVSize(),
+                             pfes->GetTrueDofOffsets(),
+                             pfes->GetTrueDofOffsets(),
+                             diag_i, diag_j, diag_data,
+                             offd_i, offd_j, offd_data,
+                             cmap.Size(), col_map);
+}
+
+void ParBilinearForm::ParallelAssembleDirect(OperatorHandle &A)
+{
+   HypreParMatrix *hA = ParallelAssembleDirect();
+   if (A.Type() == Operator::Hypre_ParCSR || A.Type() == Operator::ANY_TYPE)
+   {
+      A.Reset(hA);
+      return;
+   }
+   OperatorHandle hAh(hA);
+   A.ConvertFrom(hAh);
+   if (A.Ptr() == hAh.Ptr())
+   {
+      hAh.SetOperatorOwner(false);
+      A.SetOperatorOwner(true);
+   }
+}
+
 void ParBilinearForm::AssembleSharedFaces(int skip_zeros)
 {
    ParMesh *pmesh = pfes->GetParMesh();
@@ -225,6 +548,16 @@ void ParBilinearForm::AssembleSharedFaces(int skip_zeros)
 
 void ParBilinearForm::Assemble(int skip_zeros)
 {
+   if (direct_assembly)
+   {
+      // The matrix is assembled on the true dofs when first needed, see
+      // ParallelAssembleDirect() and FormSystemMatrix().
+      MFEM_VERIFY(p_mat.Ptr() == NULL && p_mat_e.Ptr() == NULL,
+                  "The ParBilinearForm must be updated with Update() before "
+                  "re-assembling the ParBilinearForm.");
+      return;
+   }
+
    if (mat == NULL && fbfi.Size() > 0)
    {
       pfes->ExchangeFaceNbrData();
@@ -284,6 +617,13 @@ void ParBilinearForm::FormLinearSystem(
    const Array<int> &ess_tdof_list, Vector &x, Vector &b,
    OperatorHandle &A, Vector &X, Vector &B, int copy_interior)
 {
+   if (ext)
+   {
+      ext->EnableCommOverlap(comm_overlap);
+      ext->FormLinearSystem(ess_tdof_list, x, b, A, X, B, copy_interior);
+      return;
+   }
+
    // Finish the matrix assembly and perform BC elimination, storing the
    // eliminated part of the matrix.
    FormSystemMatrix(ess_tdof_list, A);
@@ -327,6 +667,13 @@ void ParBilinearForm::FormLinearSystem(
 void ParBilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
                                        OperatorHandle &A)
 {
+   if (ext)
+   {
+      ext->EnableCommOverlap(comm_overlap);
+      ext->FormSystemOperator(ess_tdof_list, A);
+      return;
+   }
+
    // Finish the matrix assembly and perform BC elimination, storing the
    // eliminated part of the matrix.
    if (static_cond)
@@ -355,6 +702,11 @@ void ParBilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
          mat_e = NULL;
          p_mat_e.EliminateRowsCols(p_mat, ess_tdof_list);
       }
+      else if (direct_assembly && p_mat.Ptr() == NULL)
+      {
+         ParallelAssembleDirect(p_mat);
+         p_mat_e.EliminateRowsCols(p_mat, ess_tdof_list);
+      }
       if (hybridization)
       {
          hybridization->GetParallelMatrix(A);
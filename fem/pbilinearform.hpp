@@ -35,6 +35,10 @@ protected:
 
    bool keep_nbr_block;
 
+   bool direct_assembly;
+
+   bool comm_overlap;
+
    // Allocate mat - called when (mat == NULL && fbfi.Size() > 0)
    void pAllocMat();
 
@@ -44,12 +48,12 @@ public:
    ParBilinearForm(ParFiniteElementSpace *pf)
       : BilinearForm(pf), pfes(pf),
         p_mat(Operator::Hypre_ParCSR), p_mat_e(Operator::Hypre_ParCSR)
-   { keep_nbr_block = false; }
+   { keep_nbr_block = false; direct_assembly = false; comm_overlap = false; }
 
    ParBilinearForm(ParFiniteElementSpace *pf, ParBilinearForm *bf)
       : BilinearForm(pf, bf), pfes(pf),
         p_mat(Operator::Hypre_ParCSR), p_mat_e(Operator::Hypre_ParCSR)
-   { keep_nbr_block = false; }
+   { keep_nbr_block = false; direct_assembly = false; comm_overlap = false; }
 
    /** When set to true and the ParBilinearForm has interior face integrators,
        the local SparseMatrix will include the rows (in addition to the columns)
@@ -57,6 +61,28 @@ public:
        those rows. Must be called before the first Assemble call. */
    void KeepNbrBlock(bool knb = true) { keep_nbr_block = knb; }
 
+   /** @brief When set to true, the matrix on the true dofs is assembled
+       directly from the element matrices, without the local SparseMatrix and
+       the triple product P^t A P. */
+   /** The element matrices are added to the diagonal and off-diagonal blocks
+       of a HypreParMatrix; the rows of shared dofs owned by other processors
+       are sent to their owners. Assemble() does not build the local matrix;
+       the assembly is done by ParallelAssemble() and FormSystemMatrix().
+       Supported for conforming meshes with domain and boundary integrators,
+       without face integrators, static condensation or hybridization. Must be
+       called before the first Assemble call. */
+   void EnableDirectAssembly(bool enable = true) { direct_assembly = enable; }
+
+   /// Return true if direct assembly is enabled, see EnableDirectAssembly().
+   bool UsesDirectAssembly() const { return direct_assembly; }
+
+   /** @brief When set to true, the partially assembled operator on the true
+       dofs overlaps the exchange of the shared dofs with the work on the
+       elements without shared dofs, see ParPAOverlapOperator. */
+   /** Used by FormSystemMatrix() and FormLinearSystem() with
+       AssemblyLevel::PARTIAL on conforming meshes; ignored otherwise. */
+   void EnableCommOverlap(bool enable = true) { comm_overlap = enable; }
+
    /// Set the operator type id for the parallel matrix/operator.
    /** If using static condensation or hybridization, call this method *after*
        enabling it. */
@@ -72,7 +98,11 @@ public:
 
    /// Returns the matrix assembled on the true dofs, i.e. P^t A P.
    /** The returned matrix has to be deleted by the caller. */
-   HypreParMatrix *ParallelAssemble() { return ParallelAssemble(mat); }
+   HypreParMatrix *ParallelAssemble()
+   {
+      return direct_assembly ? ParallelAssembleDirect()
+             : ParallelAssemble(mat);
+   }
 
    /// Returns the eliminated matrix assembled on the true dofs, i.e. P^t A_e P.
    /** The returned matrix has to be deleted by the caller. */
@@ -84,7 +114,11 @@ public:
 
    /** @brief Returns the matrix assembled on the true dofs, i.e.
        @a A = P^t A_local P, in the format (type id) specified by @a A. */
-   void ParallelAssemble(OperatorHandle &A) { ParallelAssemble(A, mat); }
+   void ParallelAssemble(OperatorHandle &A)
+   {
+      if (direct_assembly) { ParallelAssembleDirect(A); }
+      else { ParallelAssemble(A, mat); }
+   }
 
    /** Returns the eliminated matrix assembled on the true dofs, i.e.
        @a A_elim = P^t A_elim_local P in the format (type id) specified by @a A.
@@ -96,6 +130,15 @@ public:
        @a A = P^t A_local P in the format (type id) specified by @a A. */
    void ParallelAssemble(OperatorHandle &A, SparseMatrix *A_local);
 
+   /** @brief Returns the matrix assembled on the true dofs directly from the
+       element matrices, see EnableDirectAssembly(). */
+   /** The returned matrix has to be deleted by the caller. */
+   HypreParMatrix *ParallelAssembleDirect();
+
+   /** @brief Returns the matrix assembled on the true dofs directly from the
+       element matrices in the format (type id) specified by @a A. */
+   void ParallelAssembleDirect(OperatorHandle &A);
+
    /// Eliminate essential boundary DOFs from a parallel assembled system.
    /** The array @a bdr_attr_is_ess marks boundary attributes that constitute
        the essential part of the boundary. */
@@ -0,0 +1,1411 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "../config/config.hpp"
+
+#ifdef MFEM_USE_MPI
+
+#include "fem.hpp"
+#include "pcheckpoint.hpp"
+#include "../mesh/mesh_headers.hpp"
+#include "../general/binaryio.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace mfem
+{
+
+static const char checkpoint_id[] = "MFEM parallel checkpoint v1.0\n";
+
+// Chunks start at multiples of 8 bytes in the file, so the alignment of the
+// sections within a chunk (see bin_io::SectionTable) holds in the file too.
+static inline uint64_t align8(uint64_t pos) { return (pos + 7)/8*8; }
+
+// Size of the identification line, the fixed header and the rank offset table
+// for a file written by n ranks, padded for the alignment of the first chunk.
+static inline uint64_t checkpoint_header_size(int n)
+{
+   return align8(sizeof(checkpoint_id) - 1 + 16 + 16*(uint64_t)n);
+}
+
+// The first of the chunks read by @a rank: every rank reads a contiguous range
+// of the @a nchunks chunks, its own chunk when @a nranks == @a nchunks.
+static inline int first_chunk(int rank, int nranks, int nchunks)
+{
+   return (int)(((int64_t)rank*nchunks + nranks - 1)/nranks);
+}
+
+// Number of bytes transferred by a single MPI-IO call, below the int limit of
+// the MPI count arguments.
+static const uint64_t max_io_block = 1 << 30;
+
+// Collectively read or write @a size bytes at @a offset in blocks of at most
+// max_io_block bytes. All ranks make the same number of calls, with empty
+// blocks on the ranks that are done.
+static int TransferAll(MPI_File fh, MPI_Comm comm, bool write,
+                       MPI_Offset offset, char *data, uint64_t size)
+{
+   uint64_t my_blocks = (size + max_io_block - 1)/max_io_block, num_blocks;
+   MPI_Allreduce(&my_blocks, &num_blocks, 1, MPI_UINT64_T, MPI_MAX, comm);
+
+   int err = MPI_SUCCESS;
+   for (uint64_t b = 0; b < num_blocks; b++)
+   {
+      const uint64_t pos = std::min(b*max_io_block, size);
+      const int count = (int) std::min(max_io_block, size - pos);
+      const MPI_Offset at = offset + (MPI_Offset) pos;
+      const int e = write ?
+                    MPI_File_write_at_all(fh, at, data + pos, count, MPI_BYTE,
+                                          MPI_STATUS_IGNORE) :
+                    MPI_File_read_at_all(fh, at, data + pos, count, MPI_BYTE,
+                                         MPI_STATUS_IGNORE);
+      if (e != MPI_SUCCESS) { err = e; }
+   }
+   return err;
+}
+
+// Stable sort of the entries by their destination rank: @a perm lists the
+// entries grouped by rank and @a counts gives the number of entries per rank.
+static void GroupByRank(const Array<int> &dest, int nranks, Array<int> &counts,
+                        Array<int> &perm)
+{
+   counts.SetSize(nranks);
+   counts = 0;
+   for (int i = 0; i < dest.Size(); i++) { counts[dest[i]]++; }
+   Array<int> pos(nranks);
+   for (int r = 0, p = 0; r < nranks; r++) { pos[r] = p; p += counts[r]; }
+   perm.SetSize(dest.Size());
+   for (int i = 0; i < dest.Size(); i++) { perm[pos[dest[i]]++] = i; }
+}
+
+// Send the entries of @a send, grouped by destination rank with @a scounts
+// entries for every rank, and receive the entries sent to this rank, grouped
+// by source rank, in @a recv with the counts in @a rcounts.
+template <typename T>
+static void AllToAll(MPI_Comm comm, MPI_Datatype type, const Array<int> &scounts,
+                     const Array<T> &send, Array<int> &rcounts, Array<T> &recv)
+{
+   const int nranks = scounts.Size();
+   rcounts.SetSize(nranks);
+   MPI_Alltoall(const_cast<int*>(scounts.GetData()), 1, MPI_INT,
+                rcounts.GetData(), 1, MPI_INT, comm);
+
+   Array<int> sdispl(nranks), rdispl(nranks);
+   long long stotal = 0, rtotal = 0;
+   for (int r = 0; r < nranks; r++)
+   {
+      sdispl[r] = (int) stotal;
+      rdispl[r] = (int) rtotal;
+      stotal += scounts[r];
+      rtotal += rcounts[r];
+   }
+   MFEM_VERIFY(stotal <= INT_MAX && rtotal <= INT_MAX, "too many entries for "
+               "the redistribution of the checkpoint data");
+   recv.SetSize((int) rtotal);
+   MPI_Alltoallv(const_cast<T*>(send.GetData()),
+                 const_cast<int*>(scounts.GetData()), sdispl.GetData(), type,
+                 recv.GetData(), rcounts.GetData(), rdispl.GetData(), type,
+                 comm);
+}
+
+// Order of the keys of width w in k, and then of their source ranks s.
+struct SharerKeyLess
+{
+   const int64_t *k;
+   int w;
+   const int *s;
+   bool operator()(int a, int b) const
+   {
+      for (int i = 0; i < w; i++)
+      {
+         if (k[w*a+i] != k[w*b+i]) { return k[w*a+i] < k[w*b+i]; }
+      }
+      return s[a] < s[b];
+   }
+};
+
+// Order of the edges by their (sorted) vertices in the edge-vertex table ev.
+struct SharedEdgeLess
+{
+   const Table *ev;
+   bool operator()(int a, int b) const
+   {
+      const int *va = ev->GetRow(a), *vb = ev->GetRow(b);
+      const int a0 = std::min(va[0], va[1]), b0 = std::min(vb[0], vb[1]);
+      if (a0 != b0) { return a0 < b0; }
+      return std::max(va[0], va[1]) < std::max(vb[0], vb[1]);
+   }
+};
+
+// Determine, for each of the keys of @a width global ids in @a keys, the ranks
+// with the same key, including this rank, returned in the rows of @a sharers.
+// The first id of a key must be its smallest one: it selects the rank where
+// the keys are matched.
+static void FindSharers(MPI_Comm comm, int width, const Array<int64_t> &keys,
+                        Table &sharers)
+{
+   int nranks;
+   MPI_Comm_size(comm, &nranks);
+
+   const int n = keys.Size()/width;
+   Array<int> dest(n), counts, perm;
+   for (int i = 0; i < n; i++) { dest[i] = (int)(keys[width*i] % nranks); }
+   GroupByRank(dest, nranks, counts, perm);
+
+   Array<int64_t> send(n*width), recv;
+   for (int j = 0; j < n; j++)
+   {
+      for (int w = 0; w < width; w++)
+      {
+         send[width*j + w] = keys[width*perm[j] + w];
+      }
+   }
+   for (int r = 0; r < nranks; r++) { counts[r] *= width; }
+   Array<int> rcounts;
+   AllToAll(comm, MPI_INT64_T, counts, send, rcounts, recv);
+
+   // Match the received keys, sorted together with their source rank
+   const int m = recv.Size()/width;
+   Array<int> src(m), order(m);
+   for (int r = 0, j = 0; r < nranks; r++)
+   {
+      for (int i = 0; i < rcounts[r]/width; i++, j++) { src[j] = r; }
+   }
+   for (int j = 0; j < m; j++) { order[j] = j; }
+   SharerKeyLess less = { recv.GetData(), width, src.GetData() };
+   order.Sort(less);
+
+   // Reply to every key, in the order received: the number of ranks with the
+   // key, followed by the ranks
+   Array<int> run_begin(m), run_size(m);
+   for (int b = 0, e; b < m; b = e)
+   {
+      for (e = b + 1; e < m && std::equal(&recv[width*order[e]],
+                                          &recv[width*order[e]] + width,
+                                          &recv[width*order[b]]); e++) { }
+      for (int j = b; j < e; j++)
+      {
+         run_begin[order[j]] = b;
+         run_size[order[j]] = e - b;
+      }
+   }
+   Array<int> reply, reply_counts(nranks), answer, answer_counts;
+   reply_counts = 0;
+   for (int j = 0; j < m; j++)
+   {
+      reply.Append(run_size[j]);
+      for (int i = 0; i < run_size[j]; i++)
+      {
+         reply.Append(src[order[run_begin[j] + i]]);
+      }
+      reply_counts[src[j]] += 1 + run_size[j];
+   }
+   AllToAll(comm, MPI_INT, reply_counts, reply, answer_counts, answer);
+
+   // The answers come in the order in which the keys were sent
+   sharers.MakeI(n);
+   for (int j = 0, p = 0; j < n; j++)
+   {
+      sharers.AddColumnsInRow(perm[j], answer[p]);
+      p += 1 + answer[p];
+   }
+   sharers.MakeJ();
+   for (int j = 0, p = 0; j < n; j++)
+   {
+      sharers.AddConnections(perm[j], &answer[p+1], answer[p]);
+      p += 1 + answer[p];
+   }
+   sharers.ShiftUpI();
+}
+
+// Get the coordinates of the vertices @a gids from the ranks that read them:
+// the vertices in @a owned_ids, @a owned_coords are first sent to the rank
+// selected by their global id.
+static void FetchVertices(MPI_Comm comm, const Array<int64_t> &owned_ids,
+                          const Array<double> &owned_coords,
+                          const Array<int64_t> &gids, Array<double> &coords)
+{
+   int nranks;
+   MPI_Comm_size(comm, &nranks);
+
+   Array<int> dest(owned_ids.Size()), counts, perm, rcounts;
+   for (int i = 0; i < dest.Size(); i++)
+   {
+      dest[i] = (int)(owned_ids[i] % nranks);
+   }
+   GroupByRank(dest, nranks, counts, perm);
+   Array<int64_t> send_ids(perm.Size()), dir_ids;
+   Array<double> send_coords(3*perm.Size()), dir_coords;
+   for (int j = 0; j < perm.Size(); j++)
+   {
+      send_ids[j] = owned_ids[perm[j]];
+      std::copy(&owned_coords[3*perm[j]], &owned_coords[3*perm[j]] + 3,
+                &send_coords[3*j]);
+   }
+   AllToAll(comm, MPI_INT64_T, counts, send_ids, rcounts, dir_ids);
+   for (int r = 0; r < nranks; r++) { counts[r] *= 3; }
+   AllToAll(comm, MPI_DOUBLE, counts, send_coords, rcounts, dir_coords);
+
+   std::vector<std::pair<int64_t, int> > dir(dir_ids.Size());
+   for (int i = 0; i < dir_ids.Size(); i++)
+   {
+      dir[i] = std::make_pair(dir_ids[i], i);
+   }
+   std::sort(dir.begin(), dir.end());
+
+   // Requests for the vertex coordinates
+   dest.SetSize(gids.Size());
+   for (int i = 0; i < gids.Size(); i++)
+   {
+      dest[i] = (int)(gids[i] % nranks);
+   }
+   GroupByRank(dest, nranks, counts, perm);
+   Array<int64_t> requests(perm.Size()), received;
+   for (int j = 0; j < perm.Size(); j++) { requests[j] = gids[perm[j]]; }
+   AllToAll(comm, MPI_INT64_T, counts, requests, rcounts, received);
+
+   Array<double> reply(3*received.Size()), answer;
+   for (int j = 0; j < received.Size(); j++)
+   {
+      std::vector<std::pair<int64_t, int> >::const_iterator it =
+         std::lower_bound(dir.begin(), dir.end(),
+                          std::make_pair(received[j], INT_MIN));
+      MFEM_VERIFY(it != dir.end() && it->first == received[j],
+                  "invalid checkpoint: missing vertex " << received[j]);
+      std::copy(&dir_coords[3*it->second], &dir_coords[3*it->second] + 3,
+                &reply[3*j]);
+   }
+   for (int r = 0; r < nranks; r++) { rcounts[r] *= 3; }
+   AllToAll(comm, MPI_DOUBLE, rcounts, reply, counts, answer);
+
+   coords.SetSize(3*gids.Size());
+   for (int j = 0; j < perm.Size(); j++)
+   {
+      std::copy(&answer[3*j], &answer[3*j] + 3, &coords[3*perm[j]]);
+   }
+}
+
+// Make the attribute list @a attr the union of the lists of all ranks.
+static void GlobalAttributes(MPI_Comm comm, Array<int> &attr)
+{
+   int nranks, size = attr.Size();
+   MPI_Comm_size(comm, &nranks);
+   Array<int> sizes(nranks), displ(nranks), all;
+   MPI_Allgather(&size, 1, MPI_INT, sizes.GetData(), 1, MPI_INT, comm);
+   int total = 0;
+   for (int r = 0; r < nranks; r++) { displ[r] = total; total += sizes[r]; }
+   all.SetSize(total);
+   MPI_Allgatherv(attr.GetData(), size, MPI_INT, all.GetData(),
+                  sizes.GetData(), displ.GetData(), MPI_INT, comm);
+   all.Sort();
+   all.Unique();
+   all.Copy(attr);
+}
+
+static void AppendElementData(const Element *el, const Array<int64_t> &gvert,
+                              Array<int64_t> &data)
+{
+   const int *v = el->GetVertices();
+   data.Append(el->GetAttribute());
+   data.Append(el->GetGeometryType());
+   for (int j = 0; j < el->GetNVertices(); j++)
+   {
+      data.Append(gvert[v[j]]);
+   }
+}
+
+// Offsets of the element records (attribute, geometry, global vertex ids) in
+// @a data, followed by the size of the data.
+static void RecordOffsets(const Array<int64_t> &data, Array<int> &offsets)
+{
+   offsets.SetSize(0);
+   int p = 0;
+   while (p < data.Size())
+   {
+      offsets.Append(p);
+      MFEM_VERIFY(p + 2 <= data.Size(), "invalid checkpoint: truncated "
+                  "element data");
+      const int64_t geom = data[p+1];
+      MFEM_VERIFY(geom >= 0 && geom < Geometry::NumGeom,
+                  "invalid checkpoint: unknown geometry " << geom);
+      p += 2 + Geometry::NumVerts[geom];
+   }
+   MFEM_VERIFY(p == data.Size(), "invalid checkpoint: truncated element "
+               "data");
+   offsets.Append(p);
+}
+
+template <typename T>
+static void AppendSection(Array<T> &a, const char *data, size_t size)
+{
+   const size_t n = size/sizeof(T);
+   MFEM_VERIFY(a.Size() + n <= INT_MAX, "checkpoint section is too large: "
+               << size << " bytes");
+   const int old_size = a.Size();
+   a.SetSize(old_size + (int) n);
+   std::memcpy(a.GetData() + old_size, data, n*sizeof(T));
+}
+
+// The collection, vector dimension and ordering of a space written by
+// FiniteElementSpace::Save().
+static FiniteElementCollection *ParseSpace(const std::string &space,
+                                           int &vdim, int &ordering)
+{
+   std::istringstream input(space);
+   std::string buff;
+   getline(input, buff);
+   MFEM_VERIFY(buff == "FiniteElementSpace", "invalid checkpoint: unsupported "
+               "space:\n" << space);
+   getline(input, buff, ' '); // 'FiniteElementCollection:'
+   input >> std::ws;
+   getline(input, buff);
+   FiniteElementCollection *fec = FiniteElementCollection::New(buff.c_str());
+   getline(input, buff, ' '); // 'VDim:'
+   input >> vdim;
+   getline(input, buff, ' '); // 'Ordering:'
+   input >> ordering;
+   return fec;
+}
+
+// Number of values of a field in the space of @a fec and @a vdim on an element
+// of geometry @a geom.
+static inline int ElementValues(const FiniteElementCollection *fec, int vdim,
+                                int64_t geom)
+{
+   const FiniteElement *fe =
+      fec->FiniteElementForGeometry((Geometry::Type) geom);
+   MFEM_VERIFY(fe, "invalid checkpoint: no finite element for geometry "
+               << geom);
+   return fe->GetDof()*vdim;
+}
+
+/// The part of the checkpoint read or received by one rank in Load().
+struct ParCheckpoint::LocalData
+{
+   int dim, sdim;
+   /// Element and boundary element records: attribute, geometry and global
+   /// vertex ids.
+   Array<int64_t> elements, boundary;
+   Array<int> elem_offsets, bdr_offsets;
+   /// Global ids and coordinates of the vertices owned by the chunks read by
+   /// this rank; independent of the elements of the rank.
+   Array<int64_t> vertex_ids;
+   Array<double> vertices;
+   /// Element-wise values of the fields, in the order of the elements.
+   std::vector<Array<double> > values;
+   /// Non-conforming meshes: the coarse mesh, on all ranks, and the encoded
+   /// refinement trees of the chunks read by this rank.
+   std::string coarse;
+   Array<char> trees;
+};
+
+ParMesh *ParCheckpoint::MakeParMesh(MPI_Comm comm, const LocalData &local)
+{
+   const int dim = local.dim;
+   const int ne = local.elem_offsets.Size() - 1;
+   const int nbe = local.bdr_offsets.Size() - 1;
+
+   // Local vertices: the vertices of the local elements, numbered in the order
+   // of their global ids, so the local orientation of the shared edges and
+   // faces agrees on all ranks
+   Array<int64_t> gids;
+   for (int i = 0; i < ne; i++)
+   {
+      for (int p = local.elem_offsets[i] + 2; p < local.elem_offsets[i+1]; p++)
+      {
+         gids.Append(local.elements[p]);
+      }
+   }
+   gids.Sort();
+   gids.Unique();
+   const int nv = gids.Size();
+
+   Array<double> coords;
+   FetchVertices(comm, local.vertex_ids, local.vertices, gids, coords);
+   Table vsharers;
+   FindSharers(comm, 1, gids, vsharers);
+
+   ParMesh *pmesh = new ParMesh;
+   pmesh->MyComm = comm;
+   MPI_Comm_size(comm, &pmesh->NRanks);
+   MPI_Comm_rank(comm, &pmesh->MyRank);
+   pmesh->gtopo.SetComm(comm);
+
+   pmesh->InitMesh(dim, local.sdim, nv, ne, nbe);
+   for (int v = 0; v < nv; v++) { pmesh->AddVertex(&coords[3*v]); }
+   for (int b = 0; b < 2; b++)
+   {
+      const Array<int64_t> &data = b ? local.boundary : local.elements;
+      const Array<int> &offsets = b ? local.bdr_offsets : local.elem_offsets;
+      for (int i = 0; i < offsets.Size() - 1; i++)
+      {
+         const int64_t *rec = data + offsets[i];
+         Element *el = pmesh->NewElement((int) rec[1]);
+         int *v = el->GetVertices();
+         for (int j = 0; j < el->GetNVertices(); j++)
+         {
+            const int64_t *it = std::lower_bound(gids.GetData(),
+                                                 gids.GetData() + nv, rec[2+j]);
+            MFEM_VERIFY(it != gids.GetData() + nv && *it == rec[2+j],
+                        "invalid checkpoint: boundary vertex " << rec[2+j]
+                        << " is not a vertex of the local elements");
+            v[j] = (int)(it - gids.GetData());
+         }
+         el->SetAttribute((int) rec[0]);
+         if (b) { pmesh->AddBdrElement(el); }
+         else { pmesh->AddElement(el); }
+      }
+   }
+
+   // Local topology, as in ParMesh(MPI_Comm, Mesh &, int *)
+   pmesh->SetMeshGen();
+   pmesh->ReduceMeshGen();
+   pmesh->NumOfEdges = pmesh->NumOfFaces = 0;
+   if (dim > 1)
+   {
+      pmesh->el_to_edge = new Table;
+      pmesh->NumOfEdges = pmesh->GetElementToEdgeTable(*pmesh->el_to_edge,
+                                                       pmesh->be_to_edge);
+   }
+   if (dim == 3) { pmesh->GetElementToFaceTable(); }
+   pmesh->GenerateFaces();
+   pmesh->SetAttributes();
+   GlobalAttributes(comm, pmesh->attributes);
+   GlobalAttributes(comm, pmesh->bdr_attributes);
+
+   // Communication groups of the shared vertices, edges and faces. The shared
+   // entities of each group are listed in the order of their global ids, which
+   // is the same on all ranks of the group.
+   ListOfIntegerSets groups;
+   {
+      // the first group is the local one
+      IntegerSet group;
+      group.Recreate(1, &pmesh->MyRank);
+      groups.Insert(group);
+   }
+   Array<int> vgroup(nv);
+   for (int v = 0; v < nv; v++)
+   {
+      vgroup[v] = 0;
+      if (vsharers.RowSize(v) > 1)
+      {
+         IntegerSet group(vsharers.RowSize(v), vsharers.GetRow(v));
+         vgroup[v] = groups.Insert(group);
+      }
+   }
+
+   // Candidate shared edges: the edges with shared vertices, sorted by their
+   // global vertex ids
+   Array<int> sedges, segroup;
+   if (dim > 1)
+   {
+      Table *edge_vertex = pmesh->GetEdgeVertexTable();
+      Array<int64_t> keys;
+      for (int e = 0; e < pmesh->GetNEdges(); e++)
+      {
+         const int *v = edge_vertex->GetRow(e);
+         if (vgroup[v[0]] && vgroup[v[1]]) { sedges.Append(e); }
+      }
+      SharedEdgeLess less = { edge_vertex };
+      sedges.Sort(less);
+      for (int i = 0; i < sedges.Size(); i++)
+      {
+         const int *v = edge_vertex->GetRow(sedges[i]);
+         keys.Append(gids[std::min(v[0], v[1])]);
+         keys.Append(gids[std::max(v[0], v[1])]);
+      }
+      Table esharers;
+      FindSharers(comm, 2, keys, esharers);
+      segroup.SetSize(sedges.Size());
+      for (int i = 0; i < sedges.Size(); i++)
+      {
+         segroup[i] = 0;
+         if (esharers.RowSize(i) > 1)
+         {
+            IntegerSet group(esharers.RowSize(i), esharers.GetRow(i));
+            segroup[i] = groups.Insert(group);
+         }
+      }
+   }
+
+   // Candidate shared faces: the faces of one local element with shared
+   // vertices, sorted by their global vertex ids. The vertices of a shared
+   // face are listed in the order of the face on the lower rank, as the order
+   // of the serial face in ParMesh(MPI_Comm, Mesh &, int *); this keeps the
+   // face orientations of meshes prepared with Mesh::ReorientTetMesh().
+   Array<int> sfaces, sfgroup;
+   std::vector<Array<int> > sface_verts;
+   if (dim == 3)
+   {
+      Array<int64_t> keys;
+      std::vector<std::pair<std::vector<int64_t>, int> > cand;
+      for (int f = 0; f < pmesh->GetNumFaces(); f++)
+      {
+         if (pmesh->faces_info[f].Elem2No >= 0) { continue; }
+         const int *v = pmesh->faces[f]->GetVertices();
+         const int n = pmesh->faces[f]->GetNVertices();
+         bool shared = true;
+         for (int j = 0; j < n; j++) { shared = shared && vgroup[v[j]]; }
+         if (!shared) { continue; }
+         std::vector<int64_t> key(4, -1);
+         for (int j = 0; j < n; j++) { key[j] = v[j]; }
+         std::sort(key.begin(), key.begin() + n);
+         cand.push_back(std::make_pair(key, f));
+      }
+      std::sort(cand.begin(), cand.end());
+      for (size_t i = 0; i < cand.size(); i++)
+      {
+         sfaces.Append(cand[i].second);
+         for (int j = 0; j < 4; j++)
+         {
+            const int64_t v = cand[i].first[j];
+            keys.Append(v < 0 ? -1 : gids[(int) v]);
+         }
+      }
+      Table fsharers;
+      FindSharers(comm, 4, keys, fsharers);
+      sfgroup.SetSize(sfaces.Size());
+      sface_verts.resize(sfaces.Size());
+      Array<int> sf, fdest;
+      for (int i = 0; i < sfaces.Size(); i++)
+      {
+         sfgroup[i] = 0;
+         if (fsharers.RowSize(i) != 2) { continue; }
+         const int *row = fsharers.GetRow(i);
+         IntegerSet group(2, row);
+         sfgroup[i] = groups.Insert(group);
+         sf.Append(i);
+         fdest.Append(row[0] == pmesh->MyRank ? row[1] : row[0]);
+      }
+
+      // Exchange the face vertices with the other rank of each face; both
+      // ranks list their common faces in the same (global id) order
+      Array<int> scounts, rcounts, perm;
+      GroupByRank(fdest, pmesh->NRanks, scounts, perm);
+      Array<int64_t> sverts(4*sf.Size()), rverts;
+      for (int p = 0; p < perm.Size(); p++)
+      {
+         const Element *face = pmesh->faces[sfaces[sf[perm[p]]]];
+         const int *v = face->GetVertices();
+         for (int j = 0; j < 4; j++)
+         {
+            sverts[4*p+j] = (j < face->GetNVertices()) ? gids[v[j]] : -1;
+         }
+      }
+      for (int r = 0; r < scounts.Size(); r++) { scounts[r] *= 4; }
+      AllToAll(comm, MPI_INT64_T, scounts, sverts, rcounts, rverts);
+      for (int r = 0; r < scounts.Size(); r++)
+      {
+         MFEM_VERIFY(rcounts[r] == scounts[r], "inconsistent shared faces "
+                     "with rank " << r);
+      }
+      for (int p = 0; p < perm.Size(); p++)
+      {
+         const int i = sf[perm[p]];
+         const int n = pmesh->faces[sfaces[i]]->GetNVertices();
+         const bool own = (pmesh->MyRank < fdest[perm[p]]);
+         sface_verts[i].SetSize(n);
+         for (int j = 0; j < n; j++)
+         {
+            const int64_t g = own ? sverts[4*p+j] : rverts[4*p+j];
+            const int64_t *it = std::lower_bound(gids.GetData(),
+                                                 gids.GetData() + nv, g);
+            MFEM_VERIFY(it != gids.GetData() + nv && *it == g,
+                        "inconsistent shared face vertex " << g);
+            sface_verts[i][j] = (int)(it - gids.GetData());
+         }
+      }
+   }
+
+   pmesh->gtopo.Create(groups, 822);
+   const int ngroups = groups.Size()-1;
+
+   // group_svert, svert_lvert
+   pmesh->group_svert.MakeI(ngroups);
+   for (int v = 0; v < nv; v++)
+   {
+      if (vgroup[v]) { pmesh->group_svert.AddColumnsInRow(vgroup[v]-1, 1); }
+   }
+   pmesh->group_svert.MakeJ();
+   for (int v = 0; v < nv; v++)
+   {
+      if (vgroup[v])
+      {
+         pmesh->group_svert.AddConnection(vgroup[v]-1,
+                                          pmesh->svert_lvert.Size());
+         pmesh->svert_lvert.Append(v);
+      }
+   }
+   pmesh->group_svert.ShiftUpI();
+
+   // group_sedge, shared_edges
+   pmesh->group_sedge.MakeI(ngroups);
+   for (int i = 0; i < segroup.Size(); i++)
+   {
+      if (segroup[i]) { pmesh->group_sedge.AddColumnsInRow(segroup[i]-1, 1); }
+   }
+   pmesh->group_sedge.MakeJ();
+   for (int i = 0; i < segroup.Size(); i++)
+   {
+      if (segroup[i])
+      {
+         const int *v = pmesh->GetEdgeVertexTable()->GetRow(sedges[i]);
+         pmesh->group_sedge.AddConnection(segroup[i]-1,
+                                          pmesh->shared_edges.Size());
+         pmesh->shared_edges.Append(new Segment(std::min(v[0], v[1]),
+                                                std::max(v[0], v[1]), 1));
+      }
+   }
+   pmesh->group_sedge.ShiftUpI();
+
+   // group_stria, group_squad, shared_trias, shared_quads
+   pmesh->group_stria.MakeI(ngroups);
+   pmesh->group_squad.MakeI(ngroups);
+   for (int i = 0; i < sfgroup.Size(); i++)
+   {
+      if (!sfgroup[i]) { continue; }
+      Table &group_sface = (sface_verts[i].Size() == 3) ?
+                           pmesh->group_stria : pmesh->group_squad;
+      group_sface.AddColumnsInRow(sfgroup[i]-1, 1);
+   }
+   pmesh->group_stria.MakeJ();
+   pmesh->group_squad.MakeJ();
+   for (int i = 0; i < sfgroup.Size(); i++)
+   {
+      if (!sfgroup[i]) { continue; }
+      if (sface_verts[i].Size() == 3)
+      {
+         pmesh->group_stria.AddConnection(sfgroup[i]-1,
+                                          pmesh->shared_trias.Size());
+         pmesh->shared_trias.Append(ParMesh::Vert3());
+         pmesh->shared_trias.Last().Set(sface_verts[i]);
+      }
+      else
+      {
+         pmesh->group_squad.AddConnection(sfgroup[i]-1,
+                                          pmesh->shared_quads.Size());
+         pmesh->shared_quads.Append(ParMesh::Vert4());
+         pmesh->shared_quads.Last().Set(sface_verts[i]);
+      }
+   }
+   pmesh->group_stria.ShiftUpI();
+   pmesh->group_squad.ShiftUpI();
+
+   // sedge_ledge, sface_lface
+   pmesh->FinalizeParTopo();
+
+   return pmesh;
+}
+
+ParMesh *ParCheckpoint::MakeParNCMesh(MPI_Comm comm, const LocalData &local,
+                                      int nchunks, Array<int> &read_geoms,
+                                      Array<int> &elem_order)
+{
+   int nranks, myrank;
+   MPI_Comm_size(comm, &nranks);
+   MPI_Comm_rank(comm, &myrank);
+
+   // The coarse mesh must keep the vertex order of its elements, which
+   // determines the numbering of the children in the refinement trees
+   std::istringstream coarse_in(local.coarse);
+   Mesh coarse(coarse_in, 1, 0, false);
+   NCMesh roots(&coarse);
+   ParNCMesh *pncmesh = new ParNCMesh(comm, roots);
+
+   // The refinement trees of all chunks, in the order of the chunks
+   int size = local.trees.Size(), total = 0;
+   Array<int> sizes(nranks), displ(nranks);
+   MPI_Allgather(&size, 1, MPI_INT, sizes.GetData(), 1, MPI_INT, comm);
+   for (int r = 0; r < nranks; r++)
+   {
+      displ[r] = total;
+      MFEM_VERIFY((int64_t) total + sizes[r] <= INT_MAX, "the refinement "
+                  "trees of the checkpoint are too large");
+      total += sizes[r];
+   }
+   std::string trees(total, '\0');
+   MPI_Allgatherv(const_cast<char*>(local.trees.GetData()), size, MPI_CHAR,
+                  &trees[0], sizes.GetData(), displ.GetData(), MPI_CHAR, comm);
+
+   // Recreate the refinements on every rank. With the number of ranks of the
+   // file, the leaves of a chunk go to the rank that read it, otherwise the
+   // leaves are split in contiguous blocks of the saved order, as in Load().
+   std::istringstream trees_in(trees);
+   ParNCMesh::ElementSet eset(pncmesh, true);
+   Array<int> leaves, leaf_rank;
+   read_geoms.SetSize(0);
+   for (int r = 0; r < nranks; r++)
+   {
+      for (int c = first_chunk(r, nranks, nchunks);
+           c < first_chunk(r + 1, nranks, nchunks); c++)
+      {
+         eset.Load(trees_in);
+         MFEM_VERIFY(trees_in, "invalid checkpoint: truncated refinement "
+                     "trees in chunk " << c);
+         const int n0 = leaves.Size();
+         eset.Decode(leaves);
+         for (int i = n0; i < leaves.Size(); i++)
+         {
+            leaf_rank.Append(r);
+            if (r == myrank)
+            {
+               read_geoms.Append(pncmesh->elements[leaves[i]].geom);
+            }
+         }
+      }
+   }
+   const int64_t num_leaves = leaves.Size();
+   MFEM_VERIFY(num_leaves >= nranks, "the checkpoint has fewer elements than "
+               "the number of ranks");
+   for (int i = 0; i < leaves.Size(); i++)
+   {
+      if (nranks != nchunks) { leaf_rank[i] = (int)(i*nranks/num_leaves); }
+      pncmesh->elements[leaves[i]].rank = leaf_rank[i];
+   }
+   pncmesh->Update();
+   MFEM_VERIFY(pncmesh->leaf_elements.Size() == leaves.Size(), "invalid "
+               "checkpoint: the refinement trees do not match the coarse "
+               "mesh");
+   pncmesh->Prune();
+
+   // As in the ParMesh constructor from a serial non-conforming mesh
+   ParMesh *pmesh = new ParMesh(*pncmesh);
+   pmesh->pncmesh = pncmesh;
+   pmesh->ncmesh = pncmesh;
+   pncmesh->OnMeshUpdated(pmesh);
+   pncmesh->GetConformingSharedStructures(*pmesh);
+   coarse.attributes.Copy(pmesh->attributes);
+   coarse.bdr_attributes.Copy(pmesh->bdr_attributes);
+   pmesh->GenerateNCFaceInfo();
+
+   elem_order.SetSize(0);
+   for (int i = 0; i < leaves.Size(); i++)
+   {
+      if (leaf_rank[i] == myrank)
+      {
+         elem_order.Append(pncmesh->elements[leaves[i]].index);
+      }
+   }
+   return pmesh;
+}
+
+void ParCheckpoint::WriteChunk(ParMesh &pmesh,
+                               const Array<ParGridFunction*> &fields,
+                               std::string &chunk)
+{
+   MFEM_VERIFY(!pmesh.NURBSext, "checkpoints of NURBS meshes are not "
+               "supported");
+
+   Array<int64_t> owned_ids, elem_data, bdr_data;
+   Array<double> owned_coords;
+   int64_t glob_nv = 0;
+   // The local elements in the order of their values in the chunk
+   Array<int> elem_order;
+   std::string coarse, trees;
+   ParNCMesh *pncmesh = pmesh.pncmesh;
+   if (!pncmesh)
+   {
+      // Global vertex numbers: the true dofs of the lowest order H1 space
+      H1_FECollection vfec(1, pmesh.Dimension());
+      ParFiniteElementSpace vfes(&pmesh, &vfec);
+      glob_nv = vfes.GlobalTrueVSize();
+
+      const int nv = pmesh.GetNV();
+      Array<int64_t> gvert(nv);
+      for (int v = 0; v < nv; v++)
+      {
+         // the order 1 H1 space has exactly one dof per vertex, numbered as
+         // the vertices
+         gvert[v] = vfes.GetGlobalTDofNumber(v);
+         if (vfes.GetLocalTDofNumber(v) >= 0)
+         {
+            owned_ids.Append(gvert[v]);
+            owned_coords.Append(pmesh.GetVertex(v), 3);
+         }
+      }
+
+      for (int i = 0; i < pmesh.GetNE(); i++)
+      {
+         AppendElementData(pmesh.GetElement(i), gvert, elem_data);
+         elem_order.Append(i);
+      }
+      for (int i = 0; i < pmesh.GetNBE(); i++)
+      {
+         AppendElementData(pmesh.GetBdrElement(i), gvert, bdr_data);
+      }
+   }
+   else
+   {
+      // The refinement trees of the local leaves, with the refinement types,
+      // so that Load() can recreate them from the coarse mesh. The decoded
+      // set gives the order of the element values.
+      MFEM_ASSERT(pncmesh->GetNElements() == pmesh.GetNE(), "");
+      Array<int> leaves, decoded;
+      pncmesh->leaf_elements.GetSubArray(0, pmesh.GetNE(), leaves);
+      ParNCMesh::ElementSet eset(pncmesh, true);
+      eset.Encode(leaves);
+      eset.Decode(decoded);
+      for (int j = 0; j < decoded.Size(); j++)
+      {
+         elem_order.Append(pncmesh->elements[decoded[j]].index);
+      }
+      std::ostringstream os;
+      eset.Dump(os);
+      trees = os.str();
+
+      if (pmesh.GetMyRank() == 0)
+      {
+         // The coarse mesh is the same on all ranks: take the roots of a
+         // serial copy of the local refinement trees, whose face attributes
+         // are restored by the derefinement.
+         NCMesh roots(*pncmesh);
+         for (int i = 0; i < roots.root_count; i++)
+         {
+            roots.DerefineElement(i);
+            roots.elements[i].rank = 0; // also the roots beyond the ghosts
+         }
+         roots.Update();
+         Mesh coarse_mesh(roots);
+         if (!roots.top_vertex_pos.Size())
+         {
+            // curved mesh: the vertices are not used, the nodes are a field
+            for (int v = 0; v < coarse_mesh.GetNV(); v++)
+            {
+               std::fill(coarse_mesh.GetVertex(v), coarse_mesh.GetVertex(v) + 3,
+                         0.0);
+            }
+         }
+         std::ostringstream cs;
+         cs.precision(17);
+         coarse_mesh.Print(cs);
+         coarse = cs.str();
+      }
+   }
+
+   // The mesh nodes are stored as the first field
+   Array<const GridFunction*> all_fields;
+   if (pmesh.GetNodes()) { all_fields.Append(pmesh.GetNodes()); }
+   for (int k = 0; k < fields.Size(); k++)
+   {
+      MFEM_VERIFY(fields[k]->FESpace()->GetMesh() == &pmesh,
+                  "field " << k << " is not defined on the given mesh");
+      all_fields.Append(fields[k]);
+   }
+
+   const int nf = all_fields.Size();
+   std::vector<std::string> spaces(nf);
+   std::vector<Vector> values(nf);
+   Array<int> vdofs;
+   Vector el_vals;
+   for (int k = 0; k < nf; k++)
+   {
+      const GridFunction &gf = *all_fields[k];
+      const FiniteElementSpace *fes = gf.FESpace();
+      std::ostringstream os;
+      fes->Save(os);
+      spaces[k] = os.str();
+
+      // The values of the local dofs of every element, in the order of the
+      // element dofs, including the sign changes of the vdofs
+      int size = 0;
+      for (int i = 0; i < pmesh.GetNE(); i++)
+      {
+         size += fes->GetFE(i)->GetDof()*fes->GetVDim();
+      }
+      values[k].SetSize(size);
+      int pos = 0;
+      for (int j = 0; j < elem_order.Size(); j++)
+      {
+         fes->GetElementVDofs(elem_order[j], vdofs);
+         gf.GetSubVector(vdofs, el_vals);
+         std::memcpy(values[k].GetData() + pos, el_vals.GetData(),
+                     el_vals.Size()*sizeof(double));
+         pos += el_vals.Size();
+      }
+   }
+
+   int64_t info[9] = { pmesh.Dimension(), pmesh.SpaceDimension(),
+                       pmesh.GetNE(), pncmesh ? 0 : pmesh.GetNBE(),
+                       owned_ids.Size(), glob_nv, nf,
+                       pmesh.GetNodes() ? 1 : 0, pncmesh ? 1 : 0
+                     };
+
+   bin_io::SectionTable sections;
+   sections.Add(CHK_INFO, sizeof(info));
+   sections.Add(CHK_VERTEX_IDS, owned_ids.Size()*sizeof(int64_t));
+   sections.Add(CHK_VERTICES, owned_coords.Size()*sizeof(double));
+   sections.Add(CHK_ELEMENTS, elem_data.Size()*sizeof(int64_t));
+   sections.Add(CHK_BOUNDARY, bdr_data.Size()*sizeof(int64_t));
+   sections.Add(CHK_NC_COARSE, coarse.size());
+   sections.Add(CHK_NC_TREES, trees.size());
+   for (int k = 0; k < nf; k++)
+   {
+      sections.Add(CHK_FIELDS + 2*k, spaces[k].size());
+      sections.Add(CHK_FIELDS + 2*k + 1, values[k].Size()*sizeof(double));
+   }
+
+   std::ostringstream out;
+   sections.Write(out);
+   sections.WriteSection(out, 0, info);
+   sections.WriteSection(out, 1, owned_ids.GetData());
+   sections.WriteSection(out, 2, owned_coords.GetData());
+   sections.WriteSection(out, 3, elem_data.GetData());
+   sections.WriteSection(out, 4, bdr_data.GetData());
+   sections.WriteSection(out, 5, coarse.data());
+   sections.WriteSection(out, 6, trees.data());
+   for (int k = 0; k < nf; k++)
+   {
+      sections.WriteSection(out, 7 + 2*k, spaces[k].data());
+      sections.WriteSection(out, 8 + 2*k, values[k].GetData());
+   }
+   chunk = out.str();
+}
+
+void ParCheckpoint::Save(const std::string &filename, ParMesh &pmesh,
+                         const Array<ParGridFunction*> &fields)
+{
+   MPI_Comm comm = pmesh.GetComm();
+   const int nranks = pmesh.GetNRanks(), myrank = pmesh.GetMyRank();
+
+   std::string chunk;
+   WriteChunk(pmesh, fields, chunk);
+
+   // Offset of the chunk of this rank in the file
+   uint64_t my_entry[2], padded_size = align8(chunk.size()), offset = 0;
+   MPI_Exscan(&padded_size, &offset, 1, MPI_UINT64_T, MPI_SUM, comm);
+   if (myrank == 0) { offset = 0; }
+   my_entry[0] = offset + checkpoint_header_size(nranks);
+   my_entry[1] = chunk.size();
+
+   Array<uint64_t> table(myrank == 0 ? 2*nranks : 0);
+   MPI_Gather(my_entry, 2, MPI_UINT64_T, table.GetData(), 2, MPI_UINT64_T, 0,
+              comm);
+
+   MPI_File fh;
+   int err = MPI_File_open(comm, const_cast<char*>(filename.c_str()),
+                           MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL,
+                           &fh);
+   MFEM_VERIFY(err == MPI_SUCCESS, "unable to open file: " << filename);
+   MPI_File_set_size(fh, 0);
+
+   if (myrank == 0)
+   {
+      std::ostringstream os;
+      os << checkpoint_id;
+      bin_io::write<uint32_t>(os, bin_io::SectionTable::byte_order_mark);
+      bin_io::write<uint32_t>(os, 1);
+      bin_io::write<uint32_t>(os, nranks);
+      bin_io::write<uint32_t>(os, fields.Size());
+      for (int i = 0; i < 2*nranks; i++)
+      {
+         bin_io::write<uint64_t>(os, table[i]);
+      }
+      const std::string header = os.str();
+      for (uint64_t pos = 0; pos < header.size(); pos += max_io_block)
+      {
+         const int count = (int) std::min(max_io_block, header.size() - pos);
+         MPI_File_write_at(fh, (MPI_Offset) pos,
+                           const_cast<char*>(header.data() + pos), count,
+                           MPI_BYTE, MPI_STATUS_IGNORE);
+      }
+   }
+   err = TransferAll(fh, comm, true, (MPI_Offset) my_entry[0],
+                     const_cast<char*>(chunk.data()), chunk.size());
+   MPI_File_close(&fh);
+   MFEM_VERIFY(err == MPI_SUCCESS, "error writing file: " << filename);
+}
+
+ParMesh *ParCheckpoint::Load(MPI_Comm comm, const std::string &filename,
+                             Array<ParGridFunction*> &fields)
+{
+   MFEM_VERIFY(bin_io::is_little_endian(), "the MFEM binary formats require a "
+               "little-endian host");
+
+   int nranks, myrank;
+   MPI_Comm_size(comm, &nranks);
+   MPI_Comm_rank(comm, &myrank);
+
+   MPI_File fh;
+   int err = MPI_File_open(comm, const_cast<char*>(filename.c_str()),
+                           MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+   MFEM_VERIFY(err == MPI_SUCCESS, "unable to open file: " << filename);
+
+   // Identification line and fixed header
+   const int id_size = sizeof(checkpoint_id) - 1;
+   char head[sizeof(checkpoint_id) - 1 + 16];
+   MPI_File_read_at_all(fh, 0, head, id_size + 16, MPI_BYTE,
+                        MPI_STATUS_IGNORE);
+   MFEM_VERIFY(std::memcmp(head, checkpoint_id, id_size) == 0,
+               "not an MFEM parallel checkpoint: " << filename);
+   uint32_t fixed[4];
+   std::memcpy(fixed, head + id_size, sizeof(fixed));
+   MFEM_VERIFY(fixed[0] == bin_io::SectionTable::byte_order_mark,
+               "invalid checkpoint: wrong byte order mark");
+   MFEM_VERIFY(fixed[1] == 1, "unsupported checkpoint version: " << fixed[1]);
+   const int nchunks = fixed[2], nfields = fixed[3];
+   MFEM_VERIFY(nchunks > 0, "invalid checkpoint: no chunks");
+
+   // Rank offset table
+   Array<uint64_t> table(2*nchunks);
+   err = TransferAll(fh, comm, false, id_size + 16, (char*) table.GetData(),
+                     16*(uint64_t)nchunks);
+   MFEM_VERIFY(err == MPI_SUCCESS, "error reading file: " << filename);
+
+   // This rank reads the chunks c0 <= c < c1, which are contiguous in the
+   // file: its own chunk when the number of ranks matches the file
+   const int c0 = first_chunk(myrank, nranks, nchunks);
+   const int c1 = first_chunk(myrank + 1, nranks, nchunks);
+   const uint64_t begin = (c0 < c1) ? table[2*c0] : 0;
+   uint64_t end = begin;
+   for (int c = c0; c < c1; c++)
+   {
+      MFEM_VERIFY(table[2*c] >= checkpoint_header_size(nchunks) &&
+                  table[2*c] >= end, "invalid checkpoint: misplaced chunk "
+                  << c);
+      end = table[2*c] + table[2*c+1];
+   }
+   std::vector<char> data(end - begin);
+   err = TransferAll(fh, comm, false, (MPI_Offset) begin,
+                     data.empty() ? NULL : &data[0], end - begin);
+   MFEM_VERIFY(err == MPI_SUCCESS, "error reading file: " << filename);
+   MPI_File_close(&fh);
+
+   // The global mesh info is taken from chunk 0, read by rank 0
+   std::vector<bin_io::SectionTable> chunks(c1 - c0);
+   int64_t info[9], info0[9] = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+   for (int c = c0; c < c1; c++)
+   {
+      char *buf = &data[table[2*c] - begin];
+      size_t size;
+      chunks[c-c0].Load(buf, table[2*c+1]);
+      const char *p = chunks[c-c0].GetSection(buf, CHK_INFO, size);
+      MFEM_VERIFY(p && size == sizeof(info), "invalid checkpoint: missing "
+                  "info section in chunk " << c);
+      if (c == 0) { std::memcpy(info0, p, sizeof(info0)); }
+   }
+   MPI_Bcast(info0, 9, MPI_INT64_T, 0, comm);
+   const int nf = (int) info0[6];
+   const bool has_nodes = info0[7];
+   const bool nonconforming = info0[8];
+   MFEM_VERIFY(nf == nfields + (has_nodes ? 1 : 0), "invalid checkpoint: "
+               "wrong number of fields");
+
+   // The spaces of the fields, from chunk 0
+   std::vector<std::string> spaces(nf);
+   for (int k = 0; k < nf; k++)
+   {
+      uint64_t size = 0;
+      const char *p = NULL;
+      if (myrank == 0)
+      {
+         size_t s;
+         p = chunks[0].GetSection(&data[0], CHK_FIELDS + 2*k, s);
+         MFEM_VERIFY(p, "invalid checkpoint: missing space of field " << k);
+         size = s;
+      }
+      MPI_Bcast(&size, 1, MPI_UINT64_T, 0, comm);
+      spaces[k].resize(size);
+      if (myrank == 0) { spaces[k].assign(p, size); }
+      MPI_Bcast(&spaces[k][0], (int) size, MPI_CHAR, 0, comm);
+   }
+   std::vector<FiniteElementCollection*> fecs(nf);
+   Array<int> vdim(nf), ordering(nf);
+   for (int k = 0; k < nf; k++)
+   {
+      fecs[k] = ParseSpace(spaces[k], vdim[k], ordering[k]);
+   }
+
+   LocalData local;
+   local.dim = (int) info0[0];
+   local.sdim = (int) info0[1];
+   local.values.resize(nf);
+   if (nonconforming)
+   {
+      // The coarse mesh, from chunk 0
+      uint64_t size = 0;
+      const char *p = NULL;
+      if (myrank == 0)
+      {
+         size_t s;
+         p = chunks[0].GetSection(&data[0], CHK_NC_COARSE, s);
+         MFEM_VERIFY(p && s, "invalid checkpoint: missing coarse mesh");
+         size = s;
+      }
+      MPI_Bcast(&size, 1, MPI_UINT64_T, 0, comm);
+      local.coarse.resize(size);
+      if (myrank == 0) { local.coarse.assign(p, size); }
+      MPI_Bcast(&local.coarse[0], (int) size, MPI_CHAR, 0, comm);
+   }
+   int64_t nv = 0;
+   for (int c = c0; c < c1; c++)
+   {
+      char *buf = &data[table[2*c] - begin];
+      size_t size;
+      std::memcpy(info, chunks[c-c0].GetSection(buf, CHK_INFO, size),
+                  sizeof(info));
+      MFEM_VERIFY(info[0] == info0[0] && info[1] == info0[1] &&
+                  info[5] == info0[5] && info[6] == info0[6] &&
+                  info[7] == info0[7] && info[8] == info0[8], "invalid "
+                  "checkpoint: inconsistent chunk " << c);
+      nv += info[4];
+
+      if (nonconforming)
+      {
+         // The field data is checked against the decoded elements
+         const char *p = chunks[c-c0].GetSection(buf, CHK_NC_TREES, size);
+         MFEM_VERIFY(p && size, "invalid checkpoint: missing refinement "
+                     "trees in chunk " << c);
+         AppendSection(local.trees, p, size);
+         for (int k = 0; k < nf; k++)
+         {
+            p = chunks[c-c0].GetSection(buf, CHK_FIELDS + 2*k + 1, size);
+            MFEM_VERIFY(p, "invalid checkpoint: missing data of field " << k
+                        << " in chunk " << c);
+            AppendSection(local.values[k], p, size);
+         }
+         continue;
+      }
+
+      const char *ids = chunks[c-c0].GetSection(buf, CHK_VERTEX_IDS, size);
+      MFEM_VERIFY(ids && size == info[4]*sizeof(int64_t), "invalid "
+                  "checkpoint: missing vertex ids in chunk " << c);
+      AppendSection(local.vertex_ids, ids, size);
+      const char *x = chunks[c-c0].GetSection(buf, CHK_VERTICES, size);
+      MFEM_VERIFY(x && size == 3*info[4]*sizeof(double), "invalid "
+                  "checkpoint: missing vertices in chunk " << c);
+      AppendSection(local.vertices, x, size);
+
+      const int ne0 = local.elements.Size(), nbe0 = local.boundary.Size();
+      const char *p = chunks[c-c0].GetSection(buf, CHK_ELEMENTS, size);
+      MFEM_VERIFY(p, "invalid checkpoint: missing elements in chunk " << c);
+      AppendSection(local.elements, p, size);
+      p = chunks[c-c0].GetSection(buf, CHK_BOUNDARY, size);
+      MFEM_VERIFY(p, "invalid checkpoint: missing boundary in chunk " << c);
+      AppendSection(local.boundary, p, size);
+
+      // Check the number of elements and the size of the field data
+      Array<int64_t> elems(local.elements.GetData() + ne0,
+                           local.elements.Size() - ne0);
+      Array<int64_t> bdr(local.boundary.GetData() + nbe0,
+                         local.boundary.Size() - nbe0);
+      Array<int> offsets, bdr_offsets;
+      RecordOffsets(elems, offsets);
+      RecordOffsets(bdr, bdr_offsets);
+      MFEM_VERIFY(offsets.Size() - 1 == info[2] &&
+                  bdr_offsets.Size() - 1 == info[3], "invalid checkpoint: "
+                  "wrong number of elements in chunk " << c);
+      for (int k = 0; k < nf; k++)
+      {
+         p = chunks[c-c0].GetSection(buf, CHK_FIELDS + 2*k + 1, size);
+         size_t expected = 0;
+         for (int i = 0; i < info[2]; i++)
+         {
+            expected += ElementValues(fecs[k], vdim[k], elems[offsets[i]+1])*
+                        sizeof(double);
+         }
+         MFEM_VERIFY(p && size == expected, "invalid checkpoint: missing or "
+                     "wrong data of field " << k << " in chunk " << c);
+         AppendSection(local.values[k], p, size);
+      }
+   }
+   std::vector<char>().swap(data);
+
+   int64_t glob_nv;
+   MPI_Allreduce(&nv, &glob_nv, 1, MPI_INT64_T, MPI_SUM, comm);
+   MFEM_VERIFY(glob_nv == info0[5], "invalid checkpoint: wrong number of "
+               "vertices");
+
+   RecordOffsets(local.elements, local.elem_offsets);
+   RecordOffsets(local.boundary, local.bdr_offsets);
+
+   ParMesh *pmesh = NULL;
+   Array<int> elem_order, read_geoms;
+   if (nonconforming)
+   {
+      pmesh = MakeParNCMesh(comm, local, nchunks, read_geoms, elem_order);
+   }
+
+   if (nranks != nchunks && nonconforming)
+   {
+      // The leaves of the chunks read by this rank, in the saved order, go to
+      // the ranks chosen in MakeParNCMesh()
+      const int ne = read_geoms.Size();
+      int64_t my_ne = ne, first = 0, glob_ne;
+      MPI_Exscan(&my_ne, &first, 1, MPI_INT64_T, MPI_SUM, comm);
+      if (myrank == 0) { first = 0; }
+      MPI_Allreduce(&my_ne, &glob_ne, 1, MPI_INT64_T, MPI_SUM, comm);
+
+      Array<int> counts(nranks), rcounts;
+      for (int k = 0; k < nf; k++)
+      {
+         counts = 0;
+         for (int i = 0; i < ne; i++)
+         {
+            counts[(int)((first + i)*nranks/glob_ne)] +=
+               ElementValues(fecs[k], vdim[k], read_geoms[i]);
+         }
+         Array<double> values;
+         AllToAll(comm, MPI_DOUBLE, counts, local.values[k], rcounts, values);
+         values.Copy(local.values[k]);
+      }
+   }
+   else if (nranks != nchunks)
+   {
+      // Redistribute the elements in contiguous blocks of the saved element
+      // order, which keeps the locality of the saved partitioning. Since the
+      // destination rank increases with the element index, the element data
+      // is already grouped by rank.
+      const int ne = local.elem_offsets.Size() - 1;
+      int64_t my_ne = ne, first = 0, glob_ne;
+      MPI_Exscan(&my_ne, &first, 1, MPI_INT64_T, MPI_SUM, comm);
+      if (myrank == 0) { first = 0; }
+      MPI_Allreduce(&my_ne, &glob_ne, 1, MPI_INT64_T, MPI_SUM, comm);
+
+      Array<int> edest(ne), counts(nranks), rcounts;
+      for (int i = 0; i < ne; i++)
+      {
+         edest[i] = (int)((first + i)*nranks/glob_ne);
+      }
+
+      counts = 0;
+      for (int i = 0; i < ne; i++)
+      {
+         counts[edest[i]] += local.elem_offsets[i+1] - local.elem_offsets[i];
+      }
+      Array<int64_t> recv;
+      AllToAll(comm, MPI_INT64_T, counts, local.elements, rcounts, recv);
+      for (int k = 0; k < nf; k++)
+      {
+         counts = 0;
+         for (int i = 0; i < ne; i++)
+         {
+            counts[edest[i]] +=
+               ElementValues(fecs[k], vdim[k],
+                             local.elements[local.elem_offsets[i]+1]);
+         }
+         Array<double> values;
+         AllToAll(comm, MPI_DOUBLE, counts, local.values[k], rcounts, values);
+         values.Copy(local.values[k]);
+      }
+
+      // A boundary element goes to the rank of an element containing all of
+      // its vertices
+      std::vector<std::pair<int64_t, int> > vert_elem;
+      for (int i = 0; i < ne; i++)
+      {
+         for (int p = local.elem_offsets[i]+2; p < local.elem_offsets[i+1]; p++)
+         {
+            vert_elem.push_back(std::make_pair(local.elements[p], i));
+         }
+      }
+      std::sort(vert_elem.begin(), vert_elem.end());
+      const int nbe = local.bdr_offsets.Size() - 1;
+      Array<int> bdest(nbe), perm;
+      for (int i = 0; i < nbe; i++)
+      {
+         const int64_t *rec = local.boundary + local.bdr_offsets[i];
+         const int bnv = local.bdr_offsets[i+1] - local.bdr_offsets[i] - 2;
+         bdest[i] = -1;
+         std::vector<std::pair<int64_t, int> >::const_iterator it =
+            std::lower_bound(vert_elem.begin(), vert_elem.end(),
+                             std::make_pair(rec[2], INT_MIN));
+         for ( ; it != vert_elem.end() && it->first == rec[2]; ++it)
+         {
+            const int64_t *el_v = local.elements + local.elem_offsets[it->second];
+            const int el_nv = local.elem_offsets[it->second+1] -
+                              local.elem_offsets[it->second] - 2;
+            int found = 0;
+            for (int j = 0; j < bnv; j++)
+            {
+               found += std::find(el_v + 2, el_v + 2 + el_nv, rec[2+j]) !=
+                        el_v + 2 + el_nv;
+            }
+            if (found == bnv) { bdest[i] = edest[it->second]; break; }
+         }
+         MFEM_VERIFY(bdest[i] >= 0, "invalid checkpoint: boundary element "
+                     "without an element");
+      }
+      GroupByRank(bdest, nranks, counts, perm);
+      Array<int64_t> bsend;
+      counts = 0;
+      for (int j = 0; j < nbe; j++)
+      {
+         const int i = perm[j], size = local.bdr_offsets[i+1] -
+                                       local.bdr_offsets[i];
+         bsend.Append(local.boundary + local.bdr_offsets[i], size);
+         counts[bdest[i]] += size;
+      }
+      AllToAll(comm, MPI_INT64_T, counts, bsend, rcounts, local.boundary);
+
+      recv.Copy(local.elements);
+      RecordOffsets(local.elements, local.elem_offsets);
+      RecordOffsets(local.boundary, local.bdr_offsets);
+   }
+
+   if (!nonconforming)
+   {
+      pmesh = MakeParMesh(comm, local);
+      elem_order.SetSize(pmesh->GetNE());
+      for (int i = 0; i < pmesh->GetNE(); i++) { elem_order[i] = i; }
+   }
+
+   // The fields, from the element-wise values
+   Array<ParGridFunction*> all_fields(nf);
+   Array<int> vdofs;
+   for (int k = 0; k < nf; k++)
+   {
+      ParFiniteElementSpace *pfes =
+         new ParFiniteElementSpace(pmesh, fecs[k], vdim[k], ordering[k]);
+      ParGridFunction *gf = new ParGridFunction(pfes);
+      gf->MakeOwner(fecs[k]);
+      int pos = 0;
+      for (int j = 0; j < elem_order.Size(); j++)
+      {
+         pfes->GetElementVDofs(elem_order[j], vdofs);
+         MFEM_VERIFY(pos + vdofs.Size() <= local.values[k].Size(),
+                     "invalid checkpoint: truncated data of field " << k);
+         Vector el_vals(local.values[k].GetData() + pos, vdofs.Size());
+         gf->SetSubVector(vdofs, el_vals);
+         pos += vdofs.Size();
+      }
+      MFEM_VERIFY(pos == local.values[k].Size(), "invalid checkpoint: wrong "
+                  "data of field " << k);
+      all_fields[k] = gf;
+   }
+   if (has_nodes) { pmesh->NewNodes(*all_fields[0], true); }
+
+   if (nonconforming && nranks != nchunks)
+   {
+      // Partition the leaves along the space-filling curve of ParNCMesh. The
+      // mesh nodes are updated by ParMesh::Rebalance().
+      pmesh->Rebalance();
+      for (int k = has_nodes ? 1 : 0; k < nf; k++)
+      {
+         all_fields[k]->ParFESpace()->Update();
+         all_fields[k]->Update();
+      }
+   }
+
+   const int first = has_nodes ? 1 : 0;
+   fields.SetSize(nfields);
+   for (int k = 0; k < nfields; k++) { fields[k] = all_fields[first + k]; }
+
+   return pmesh;
+}
+
+}
+
+#endif // MFEM_USE_MPI
@@ -0,0 +1,125 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_PCHECKPOINT
+#define MFEM_PCHECKPOINT
+
+#include "../config/config.hpp"
+
+#ifdef MFEM_USE_MPI
+
+#include "../mesh/pmesh.hpp"
+#include "pgridfunc.hpp"
+#include <string>
+
+namespace mfem
+{
+
+/** @brief Collective checkpoint of a ParMesh and a set of ParGridFunctions in
+    a single shared file, written and read with MPI-IO.
+
+    Unlike ParMesh::ParPrint(), which requires one file per rank, and
+    ParMesh::PrintAsOne(), which sends all data through rank 0, every rank
+    writes its own chunk of the file with one collective call. The file
+    starts with the text line "MFEM parallel checkpoint v1.0", followed by a
+    header (all values are in little-endian byte order):
+    - uint32: byte order mark 0x01020304,
+    - uint32: format version, 1,
+    - uint32: number of ranks that wrote the file, n,
+    - uint32: number of fields,
+    - n entries of: uint64 offset, uint64 size of the chunk of each rank.
+
+    Every chunk is a bin_io::SectionTable with the local elements and boundary
+    elements (using 64-bit global vertex numbers), the coordinates of the
+    vertices owned by the rank and, for the mesh nodes and every field, the
+    space (as written by FiniteElementSpace::Save()) and the element-wise
+    values of the local elements. Since the element values do not depend on
+    the local dof numbering, the fields can be restored on any partitioning of
+    the mesh.
+
+    Load() never assembles the global mesh: every rank reads a contiguous range
+    of chunks, its own chunk when the number of ranks matches the file, so it
+    gets back exactly its old elements, in the same order. Otherwise the
+    elements are redistributed in contiguous blocks of the saved element order;
+    no graph partitioner is called. The shared vertices, edges and faces are
+    then matched by their global vertex numbers, with data exchanges
+    proportional to the local mesh size.
+
+    For a non-conforming mesh (ParNCMesh), the chunk of rank 0 also holds the
+    coarse mesh, i.e. the roots of the refinement trees, and every chunk holds
+    the ParNCMesh::ElementSet encoding of the refinement trees of the local
+    leaf elements, with the refinement types, instead of the element and
+    vertex sections. The element values follow the order of the decoded
+    element set. Load() refines the coarse mesh by decoding the sets of all
+    chunks, so every rank holds the full refinement tree until the ParNCMesh
+    is pruned, as in the ParMesh constructor from a serial non-conforming
+    mesh. A rank gets the leaves of the chunks it read when the number of ranks
+    matches the file. Otherwise the leaves are first split in contiguous blocks
+    of the saved order, as the conforming elements, and the mesh is then
+    balanced with ParMesh::Rebalance().
+
+    NURBS meshes are not supported. */
+class ParCheckpoint
+{
+protected:
+   enum ChunkSection
+   {
+      CHK_INFO = 1,
+      CHK_VERTEX_IDS,
+      CHK_VERTICES,
+      CHK_ELEMENTS,
+      CHK_BOUNDARY,
+      /// Non-conforming meshes: the coarse mesh (chunk 0 only), as written by
+      /// Mesh::Print(), and the encoded refinement trees of the local leaves.
+      CHK_NC_COARSE,
+      CHK_NC_TREES,
+      /// Space and data of field k are sections CHK_FIELDS + 2k and + 2k+1,
+      /// the mesh nodes (if any) are field 0.
+      CHK_FIELDS
+   };
+
+   /// Serialize the local part of @a pmesh and the @a fields into @a chunk.
+   static void WriteChunk(ParMesh &pmesh, const Array<ParGridFunction*> &fields,
+                          std::string &chunk);
+
+   struct LocalData;
+
+   /// Build the ParMesh of the local elements in @a local, finding the shared
+   /// entities by their global vertex numbers.
+   static ParMesh *MakeParMesh(MPI_Comm comm, const LocalData &local);
+
+   /** @brief Build the non-conforming ParMesh of the refinement trees in
+       @a local, read from @a nchunks chunks. Returns in @a read_geoms the
+       geometries of the leaves of the chunks read by this rank, and in
+       @a elem_order the local elements of the rank, in the saved order. */
+   static ParMesh *MakeParNCMesh(MPI_Comm comm, const LocalData &local,
+                                 int nchunks, Array<int> &read_geoms,
+                                 Array<int> &elem_order);
+
+public:
+   /** @brief Collectively write @a pmesh and the @a fields, which must be
+       defined on @a pmesh, to the file @a filename. */
+   static void Save(const std::string &filename, ParMesh &pmesh,
+                    const Array<ParGridFunction*> &fields);
+
+   /** @brief Collectively read a checkpoint written by Save() on any number
+       of ranks, returning a new ParMesh on @a comm. The fields are returned in
+       @a fields, in the order in which they were saved; they are owned by the
+       caller, and each one owns its space (see GridFunction::MakeOwner). */
+   static ParMesh *Load(MPI_Comm comm, const std::string &filename,
+                        Array<ParGridFunction*> &fields);
+};
+
+}
+
+#endif // MFEM_USE_MPI
+
+#endif
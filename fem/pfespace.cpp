@@ -681,6 +681,27 @@ void ParFiniteElementSpace::Synchronize(Array<int> &ldof_marker) const
    gcomm->Bcast(ldof_marker);
 }
 
+void ParFiniteElementSpace::SplitElements() const
+{
+   if (interior_elems.Size() + shared_elems.Size() == GetNE()) { return; }
+   MFEM_VERIFY(Conforming(), "only conforming spaces are supported");
+
+   interior_elems.SetSize(0);
+   shared_elems.SetSize(0);
+   Array<int> vdofs;
+   for (int i = 0; i < GetNE(); i++)
+   {
+      GetElementVDofs(i, vdofs);
+      bool shared = false;
+      for (int j = 0; j < vdofs.Size() && !shared; j++)
+      {
+         const int d = (vdofs[j] >= 0) ? vdofs[j] : -1-vdofs[j];
+         shared = (ldof_group[d] != 0);
+      }
+      (shared ? shared_elems : interior_elems).Append(i);
+   }
+}
+
 void ParFiniteElementSpace::GetEssentialVDofs(const Array<int> &bdr_attr_is_ess,
                                               Array<int> &ess_dofs,
                                               int component) const
@@ -2279,6 +2300,10 @@ ParFiniteElementSpace::RebalanceMatrix(int old_ndofs,
                "Mesh::Rebalance was not called before "
                "ParFiniteElementSpace::RebalanceMatrix");
 
+   // the sign of each row: -1 where the orientation of the DOF changed, e.g.
+   // for the edge DOFs of Nedelec spaces
+   Array<double> row_sign(vsize);
+
    // prepare the local (diagonal) part of the matrix
    HYPRE_Int* i_diag = make_i_array(vsize);
    for (int i = 0; i < pmesh->GetNE(); i++)
@@ -2293,12 +2318,13 @@ ParFiniteElementSpace::RebalanceMatrix(int old_ndofs,
             for (int j = 0; j < dofs.Size(); j++)
             {
                int row = DofToVDof(dofs[j], vd);
-               if (row < 0) { row = -1 - row; }
-
                int col = DofToVDof(old_dofs[j], vd, old_ndofs);
+               const bool flip = ((row < 0) != (col < 0));
+               if (row < 0) { row = -1 - row; }
                if (col < 0) { col = -1 - col; }
 
                i_diag[row] = col;
+               row_sign[row] = flip ? -1.0 : 1.0;
             }
          }
       }
@@ -2322,11 +2348,15 @@ ParFiniteElementSpace::RebalanceMatrix(int old_ndofs,
          for (int j = 0; j < dofs.Size(); j++)
          {
             int row = DofToVDof(dofs[j], vd);
+            long col = old_dofs[j + vd * dofs.Size()];
+            const bool flip = ((row < 0) != (col < 0));
             if (row < 0) { row = -1 - row; }
+            if (col < 0) { col = -1 - col; }
 
             if (i_diag[row] == i_diag[row+1]) // diag row empty?
             {
-               i_offd[row] = old_dofs[j + vd * dofs.Size()];
+               i_offd[row] = col;
+               row_sign[row] = flip ? -1.0 : 1.0;
             }
          }
       }
@@ -2350,9 +2380,21 @@ ParFiniteElementSpace::RebalanceMatrix(int old_ndofs,
       j_offd[cmap_offd[i].two] = i;
    }
 
+   // the matrix has at most one entry per row: +1 or -1
+   double *a_diag = new double[i_diag[vsize]];
+   double *a_offd = new double[i_offd[vsize]];
+   for (int i = 0; i < vsize; i++)
+   {
+      if (i_diag[i+1] > i_diag[i]) { a_diag[i_diag[i]] = row_sign[i]; }
+      if (i_offd[i+1] > i_offd[i]) { a_offd[i_offd[i]] = row_sign[i]; }
+   }
+
+   const int last = HYPRE_AssumedPartitionCheck() ? 2 : NRanks;
    HypreParMatrix *M;
-   M = new HypreParMatrix(MyComm, MyRank, NRanks, dof_offsets, old_dof_offsets,
-                          i_diag, j_diag, i_offd, j_offd, cmap, offd_cols);
+   M = new HypreParMatrix(MyComm, dof_offsets[last], old_dof_offsets[last],
+                          dof_offsets, old_dof_offsets,
+                          i_diag, j_diag, a_diag, i_offd, j_offd, a_offd,
+                          offd_cols, cmap);
    return M;
 }
 
@@ -2609,6 +2651,9 @@ void ParFiniteElementSpace::Destroy()
 
    delete gcomm; gcomm = NULL;
 
+   interior_elems.DeleteAll();
+   shared_elems.DeleteAll();
+
    num_face_nbr_dofs = -1;
    face_nbr_element_dof.Clear();
    face_nbr_ldof.Clear();
@@ -2775,6 +2820,13 @@ ConformingProlongationOperator::ConformingProlongationOperator(
 }
 
 void ConformingProlongationOperator::Mult(const Vector &x, Vector &y) const
+{
+   MultBegin(x, y);
+   MultEnd(y);
+}
+
+void ConformingProlongationOperator::MultBegin(const Vector &x,
+                                               Vector &y) const
 {
    MFEM_ASSERT(x.Size() == Width(), "");
    MFEM_ASSERT(y.Size() == Height(), "");
@@ -2794,9 +2846,12 @@ void ConformingProlongationOperator::Mult(const Vector &x, Vector &y) const
       j = end+1;
    }
    std::copy(xdata+j-m, xdata+Width(), ydata+j);
+}
 
+void ConformingProlongationOperator::MultEnd(Vector &y) const
+{
    const int out_layout = 0; // 0 - output is ldofs array
-   gc.BcastEnd(ydata, out_layout);
+   gc.BcastEnd(y.GetData(), out_layout);
 }
 
 void ConformingProlongationOperator::MultTranspose(
@@ -76,6 +76,9 @@ private:
    /// The (block-diagonal) matrix R (restriction of dof to true dof). Owned.
    mutable SparseMatrix *R;
 
+   /// Local elements without/with shared dofs, see GetInteriorElements().
+   mutable Array<int> interior_elems, shared_elems;
+
    ParNURBSExtension *pNURBSext() const
    { return dynamic_cast<ParNURBSExtension *>(NURBSext); }
 
@@ -91,6 +94,9 @@ private:
    void Construct();
    void Destroy();
 
+   /// Build the lists #interior_elems and #shared_elems.
+   void SplitElements() const;
+
    // ldof_type = 0 : DOFs communicator, otherwise VDOFs communicator
    void GetGroupComm(GroupCommunicator &gcomm, int ldof_type,
                      Array<int> *ldof_sign = NULL);
@@ -155,8 +161,9 @@ private:
                                             bool partial = false) const;
 
    /** Calculate a GridFunction migration matrix after mesh load balancing.
-       The result is a parallel permutation matrix that can be used to update
-       all grid functions defined on this space. */
+       The result is a parallel signed permutation matrix, with -1 for the DOFs
+       whose orientation changed, that can be used to update all grid functions
+       defined on this space. */
    HypreParMatrix* RebalanceMatrix(int old_ndofs,
                                    const Table* old_elem_dof);
 
@@ -296,6 +303,21 @@ public:
        "partially conforming") space. */
    void Synchronize(Array<int> &ldof_marker) const;
 
+   /** @brief Return the local elements without shared dofs, i.e. the elements
+       whose dofs are not exchanged with other processors. */
+   /** Together with GetSharedElements(), this splits the local elements so
+       that an operator on the true dofs can work on the interior elements
+       while the shared dofs are in flight, see ConformingProlongationOperator
+       ::MultBegin(). The lists are built on first use. Conforming spaces
+       only. */
+   const Array<int> &GetInteriorElements() const
+   { SplitElements(); return interior_elems; }
+
+   /** @brief Return the local elements with at least one shared dof, see
+       GetInteriorElements(). */
+   const Array<int> &GetSharedElements() const
+   { SplitElements(); return shared_elems; }
+
    /// Determine the boundary degrees of freedom
    virtual void GetEssentialVDofs(const Array<int> &bdr_attr_is_ess,
                                   Array<int> &ess_dofs,
@@ -378,6 +400,17 @@ public:
    virtual void Mult(const Vector &x, Vector &y) const;
 
    virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /** @brief First part of Mult(): start the exchange of the shared dofs of
+       @a x and copy the dofs owned by this processor into @a y. */
+   /** Until the call to MultEnd(), only the entries of @a y that are not
+       shared with other processors are set, e.g. the dofs of the elements
+       returned by ParFiniteElementSpace::GetInteriorElements(); @a x must not
+       be modified. */
+   void MultBegin(const Vector &x, Vector &y) const;
+
+   /// Second part of Mult(): receive the remaining shared dofs of @a y.
+   void MultEnd(Vector &y) const;
 };
 
 }
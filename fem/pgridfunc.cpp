@@ -814,6 +814,22 @@ double L2ZZErrorEstimator(BilinearFormIntegrator &flux_integrator,
    return pow(glob_error, 1.0/norm_p);
 }
 
+
+void InterpolateAtPoints(const Array<ParGridFunction*> &gfs,
+                         const Array<int> &elem_ids,
+                         const Array<IntegrationPoint> &ips,
+                         DenseMatrix &vals)
+{
+   Array<GridFunction*> sgfs(gfs.Size());
+   for (int f = 0; f < gfs.Size(); f++) { sgfs[f] = gfs[f]; }
+   InterpolateAtPoints(sgfs, elem_ids, ips, vals);
+   if (gfs.Size() == 0) { return; }
+
+   MPI_Comm comm = gfs[0]->ParFESpace()->GetComm();
+   MPI_Allreduce(MPI_IN_PLACE, vals.Data(), vals.Height()*vals.Width(),
+                 MPI_DOUBLE, MPI_SUM, comm);
+}
+
 }
 
 #endif // MFEM_USE_MPI
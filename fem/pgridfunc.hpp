@@ -308,6 +308,18 @@ double L2ZZErrorEstimator(BilinearFormIntegrator &flux_integrator,
                           Vector &errors, int norm_p = 2, double solver_tol = 1e-12,
                           int solver_max_it = 200);
 
+/** @brief Parallel version of InterpolateAtPoints() for points located with
+    ParMesh::FindPoints(), i.e. the same points on all ranks.
+
+    Each point is evaluated on the rank that owns it (non-negative element id)
+    and the values are summed over all ranks, so that on return @a vals holds
+    the values at all found points on every rank. Points that were not found
+    on any rank get zero values. */
+void InterpolateAtPoints(const Array<ParGridFunction*> &gfs,
+                         const Array<int> &elem_ids,
+                         const Array<IntegrationPoint> &ips,
+                         DenseMatrix &vals);
+
 }
 
 #endif // MFEM_USE_MPI
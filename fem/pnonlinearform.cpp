@@ -19,7 +19,7 @@ namespace mfem
 {
 
 ParNonlinearForm::ParNonlinearForm(ParFiniteElementSpace *pf)
-   : NonlinearForm(pf), pGrad(Operator::Hypre_ParCSR)
+   : NonlinearForm(pf), pGrad(Operator::Hypre_ParCSR), comm_overlap(false)
 {
    X.MakeRef(pf, NULL);
    Y.MakeRef(pf, NULL);
@@ -45,7 +45,26 @@ double ParNonlinearForm::GetParGridFunctionEnergy(const Vector &x) const
 
 void ParNonlinearForm::Mult(const Vector &x, Vector &y) const
 {
-   NonlinearForm::Mult(x, y); // x --(P)--> aux1 --(A_local)--> aux2
+   if (comm_overlap && ParFESpace()->Conforming())
+   {
+      // Same as NonlinearForm::Mult(), with the domain integrators on the
+      // interior elements computed while the shared dofs are exchanged.
+      const ConformingProlongationOperator *cfP =
+         static_cast<const ConformingProlongationOperator*>(P);
+      const ParFiniteElementSpace *pfes = ParFESpace();
+      aux1.SetSize(P->Height());
+      aux2.SetSize(P->Height());
+      aux2 = 0.0;
+      cfP->MultBegin(x, aux1);
+      AddDomainVectors(&pfes->GetInteriorElements(), aux1, aux2);
+      cfP->MultEnd(aux1);
+      AddDomainVectors(&pfes->GetSharedElements(), aux1, aux2);
+      AddFaceVectors(aux1, aux2);
+   }
+   else
+   {
+      NonlinearForm::Mult(x, y); // x --(P)--> aux1 --(A_local)--> aux2
+   }
    Y.SetData(aux2.GetData()); // aux2 contains A_local.P.x
 
    if (fnfi.Size())
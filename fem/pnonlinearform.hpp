@@ -29,9 +29,17 @@ protected:
    mutable ParGridFunction X, Y;
    mutable OperatorHandle pGrad;
 
+   bool comm_overlap;
+
 public:
    ParNonlinearForm(ParFiniteElementSpace *pf);
 
+   /** @brief When set to true, Mult() overlaps the exchange of the shared dofs
+       of the input with the work on the elements without shared dofs, see
+       ParFiniteElementSpace::GetInteriorElements(). */
+   /** Used on conforming meshes; ignored otherwise. */
+   void EnableCommOverlap(bool enable = true) { comm_overlap = enable; }
+
    ParFiniteElementSpace *ParFESpace() const
    { return (ParFiniteElementSpace *)fes; }
 
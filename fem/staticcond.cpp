@@ -193,12 +193,14 @@ void StaticCondensation::AssembleMatrix(int el, const DenseMatrix &elmat)
    const int vdim = fes->GetVDim();
    const int nvpd = elem_pdof.RowSize(el);
    const int nved = rvdofs.Size();
+   const int Aee_offset = Aee_data.Size();
+   Aee_data.SetSize(Aee_offset + nved*(nved + (symm ? nvpd : 0)));
    DenseMatrix A_pp(A_data + A_offsets[el], nvpd, nvpd);
    DenseMatrix A_pe(A_pp.Data() + nvpd*nvpd, nvpd, nved);
+   DenseMatrix A_ee(Aee_data.GetData() + Aee_offset, nved, nved);
    DenseMatrix A_ep;
-   if (symm) { A_ep.SetSize(nved, nvpd); }
+   if (symm) { A_ep.UseExternalData(A_ee.Data() + nved*nved, nved, nvpd); }
    else      { A_ep.UseExternalData(A_pe.Data() + nvpd*nved, nved, nvpd); }
-   DenseMatrix A_ee(nved, nved);
 
    const int npd = nvpd/vdim;
    const int ned = nved/vdim;
@@ -214,14 +216,49 @@ void StaticCondensation::AssembleMatrix(int el, const DenseMatrix &elmat)
          A_ee.CopyMN(elmat, ned, ned, i*nd,     j*nd,     i*ned, j*ned);
       }
    }
-   // Compute the Schur complement
-   LUFactors lu(A_pp.Data(), A_ipiv + A_ipiv_offsets[el]);
-   lu.Factor(nvpd);
-   lu.BlockFactor(nvpd, nved, A_pe.Data(), A_ep.Data(), A_ee.Data());
+   // The Schur complement is computed and assembled by FactorElements(), for
+   // groups of fact_group_size elements
+   fact_elems.Append(el);
+   Aee_offsets.Append(Aee_offset);
+   if (fact_elems.Size() == fact_group_size) { FactorElements(); }
+}
+
+void StaticCondensation::FactorElements()
+{
+   const int nfact = fact_elems.Size();
+   if (nfact == 0) { return; }
+   Array<int> rvdofs, npd(nfact), ned(nfact);
+   Array<double*> A_pp(nfact), A_pe(nfact), A_ep(nfact), A_ee(nfact);
+   Array<int*> ipiv(nfact);
+   for (int k = 0; k < nfact; k++)
+   {
+      const int el = fact_elems[k];
+      tr_fes->GetElementVDofs(el, rvdofs);
+      npd[k] = elem_pdof.RowSize(el);
+      ned[k] = rvdofs.Size();
+      A_pp[k] = A_data + A_offsets[el];
+      A_pe[k] = A_pp[k] + npd[k]*npd[k];
+      A_ee[k] = Aee_data.GetData() + Aee_offsets[k];
+      A_ep[k] = symm ? A_ee[k] + ned[k]*ned[k] : A_pe[k] + npd[k]*ned[k];
+      ipiv[k] = A_ipiv + A_ipiv_offsets[el];
+   }
+   // Compute the Schur complements
+   DenseBatch::LUBlockFactor(nfact, npd, ned, A_pp, ipiv, A_pe, A_ep, A_ee);
 
-   // Assemble the Schur complement
+   // Assemble the Schur complements
    const int skip_zeros = 0;
-   S->AddSubMatrix(rvdofs, rvdofs, A_ee, skip_zeros);
+   DenseMatrix S_el;
+   for (int k = 0; k < nfact; k++)
+   {
+      tr_fes->GetElementVDofs(fact_elems[k], rvdofs);
+      S_el.UseExternalData(A_ee[k], ned[k], ned[k]);
+      S->AddSubMatrix(rvdofs, rvdofs, S_el, skip_zeros);
+   }
+   S_el.ClearExternalData();
+   // keep the memory for the next group
+   fact_elems.SetSize(0);
+   Aee_offsets.SetSize(0);
+   Aee_data.SetSize(0);
 }
 
 void StaticCondensation::AssembleBdrMatrix(int el, const DenseMatrix &elmat)
@@ -237,6 +274,8 @@ void StaticCondensation::Finalize()
    const int skip_zeros = 0;
    if (!Parallel())
    {
+      FactorElements();
+      Aee_data.DeleteAll();
       S->Finalize(skip_zeros);
       if (S_e) { S_e->Finalize(skip_zeros); }
       const SparseMatrix *cP = tr_fes->GetConformingProlongation();
@@ -260,6 +299,8 @@ void StaticCondensation::Finalize()
    {
 #ifdef MFEM_USE_MPI
       if (!S) { return; } // already finalized
+      FactorElements();
+      Aee_data.DeleteAll();
       S->Finalize(skip_zeros);
       if (S_e) { S_e->Finalize(skip_zeros); }
       OperatorHandle dS(pS.Type()), pP(pS.Type());
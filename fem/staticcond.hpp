@@ -85,8 +85,23 @@ class StaticCondensation
    double *A_data;
    int *A_ipiv;
 
+   /** The elements assembled by AssembleMatrix() and not yet factored, and
+       the offsets of their A_ee blocks (followed by A_ep, if symm) in
+       Aee_data. */
+   Array<int> fact_elems, Aee_offsets;
+   Array<double> Aee_data;
+
+   /** Number of elements factored together: AssembleMatrix() calls
+       FactorElements() when it has collected this many elements, so Aee_data
+       holds the blocks of at most one group. */
+   static const int fact_group_size = 32*DenseBatch::batch_size;
+
    Array<int> ess_rtdof_list;
 
+   /** Factor the A_pp blocks of the elements in fact_elems, compute their
+       Schur complements in batches (see DenseBatch) and add them to S. */
+   void FactorElements();
+
 public:
    /// Construct a StaticCondensation object.
    StaticCondensation(FiniteElementSpace *fespace);
@@ -114,7 +129,8 @@ public:
 #endif
    /** Assemble the contribution to the Schur complement from the given
        element matrix 'elmat'; save the other blocks internally: A_pp_inv, A_pe,
-       and A_ep. */
+       and A_ep. The factorizations are computed, for all elements at once, by
+       Finalize(). */
    void AssembleMatrix(int el, const DenseMatrix &elmat);
 
    /** Assemble the contribution to the Schur complement from the given boundary
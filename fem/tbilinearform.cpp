@@ -0,0 +1,114 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Pre-instantiated TBilinearForm specializations, see class TFormRegistry.
+
+#include "fem.hpp"
+#include "tbilininteg.hpp"
+
+namespace mfem
+{
+
+namespace internal
+{
+long long flop_count = 0; // see MFEM_FLOPS_ADD in config/tconfig.hpp
+}
+
+// Default quadrature orders of MassIntegrator, DiffusionIntegrator and
+// ConvectionIntegrator for meshes of order MeshP and solution spaces of order
+// SolP, cf. the methods AssembleElementMatrix() of the integrators.
+template <Geometry::Type G, int MeshP, int SolP>
+struct TFormDefaultOrders
+{
+   static const int dim = Geometry::Constants<G>::Dimension;
+   static const bool tensor = (G == Geometry::SQUARE || G == Geometry::CUBE);
+   // Trans.OrderW() is MeshP*dim-1 for Qk and (MeshP-1)*dim for Pk elements
+   static const int mass =
+      2*SolP + (tensor ? MeshP*dim - 1 : (MeshP - 1)*dim);
+   static const int diffusion = tensor ? 2*SolP + dim - 1 : 2*SolP - 2;
+   // Trans.OrderGrad(&el) + Trans.Order() + el.GetOrder()
+   static const int convection =
+      (tensor ? MeshP*(dim - 1) : (MeshP - 1)*(dim - 1)) + MeshP + 2*SolP - 1;
+};
+
+template <Geometry::Type G, int MeshP, int SolP>
+static void RegisterMassAndDiffusion()
+{
+   typedef TFormDefaultOrders<G,MeshP,SolP> orders;
+   const int mass_order = orders::mass, diff_order = orders::diffusion;
+
+   TFormRegistry::Register(
+      TFormRegistry::Key(G, MeshP, SolP, mass_order, TFormRegistry::MASS),
+      TFormOperatorH1<G,MeshP,SolP,mass_order,TMassKernel>::New);
+   TFormRegistry::Register(
+      TFormRegistry::Key(G, MeshP, SolP, diff_order, TFormRegistry::DIFFUSION),
+      TFormOperatorH1<G,MeshP,SolP,diff_order,TDiffusionKernel>::New);
+}
+
+template <Geometry::Type G, int MeshP, int SolP>
+static void RegisterConvection()
+{
+   typedef TFormDefaultOrders<G,MeshP,SolP> orders;
+   typedef TConstantVectorCoefficient<orders::dim> velocity_t;
+   const int conv_order = orders::convection;
+
+   TFormRegistry::Register(
+      TFormRegistry::Key(G, MeshP, SolP, conv_order, TFormRegistry::CONVECTION),
+      TFormOperatorH1<G,MeshP,SolP,conv_order,TConvectionKernel,
+      velocity_t>::New);
+}
+
+void TFormRegistry::RegisterBuiltins()
+{
+   // Quadrilaterals and hexahedra: first and second order meshes
+   RegisterMassAndDiffusion<Geometry::SQUARE,1,1>();
+   RegisterMassAndDiffusion<Geometry::SQUARE,1,2>();
+   RegisterMassAndDiffusion<Geometry::SQUARE,1,3>();
+   RegisterMassAndDiffusion<Geometry::SQUARE,1,4>();
+   RegisterMassAndDiffusion<Geometry::SQUARE,2,1>();
+   RegisterMassAndDiffusion<Geometry::SQUARE,2,2>();
+   RegisterMassAndDiffusion<Geometry::SQUARE,2,3>();
+   RegisterMassAndDiffusion<Geometry::SQUARE,2,4>();
+
+   RegisterMassAndDiffusion<Geometry::CUBE,1,1>();
+   RegisterMassAndDiffusion<Geometry::CUBE,1,2>();
+   RegisterMassAndDiffusion<Geometry::CUBE,1,3>();
+   RegisterMassAndDiffusion<Geometry::CUBE,2,1>();
+   RegisterMassAndDiffusion<Geometry::CUBE,2,2>();
+   RegisterMassAndDiffusion<Geometry::CUBE,2,3>();
+
+   // Triangles and tetrahedra: first order meshes (the templated simplex
+   // quadrature rules are available only up to order 7)
+   RegisterMassAndDiffusion<Geometry::TRIANGLE,1,1>();
+   RegisterMassAndDiffusion<Geometry::TRIANGLE,1,2>();
+   RegisterMassAndDiffusion<Geometry::TRIANGLE,1,3>();
+
+   RegisterMassAndDiffusion<Geometry::TETRAHEDRON,1,1>();
+   RegisterMassAndDiffusion<Geometry::TETRAHEDRON,1,2>();
+   RegisterMassAndDiffusion<Geometry::TETRAHEDRON,1,3>();
+
+   // Convection: first order meshes
+   RegisterConvection<Geometry::SQUARE,1,1>();
+   RegisterConvection<Geometry::SQUARE,1,2>();
+   RegisterConvection<Geometry::SQUARE,1,3>();
+   RegisterConvection<Geometry::SQUARE,1,4>();
+   RegisterConvection<Geometry::CUBE,1,1>();
+   RegisterConvection<Geometry::CUBE,1,2>();
+   RegisterConvection<Geometry::CUBE,1,3>();
+   RegisterConvection<Geometry::TRIANGLE,1,1>();
+   RegisterConvection<Geometry::TRIANGLE,1,2>();
+   RegisterConvection<Geometry::TRIANGLE,1,3>();
+   RegisterConvection<Geometry::TETRAHEDRON,1,1>();
+   RegisterConvection<Geometry::TETRAHEDRON,1,2>();
+   RegisterConvection<Geometry::TETRAHEDRON,1,3>();
+}
+
+} // namespace mfem
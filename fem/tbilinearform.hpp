@@ -72,6 +72,72 @@ protected:
       typedef typename Spec::ElementMatrix ElementMatrix;
    };
 
+   // Auxiliary struct for the computation of the element matrices: Compute()
+   // returns in M the (bi,bj) block of the element matrix, corresponding to
+   // the test component bi and the trial component bj, given the quadrature
+   // point data A; the return value is false if the block is zero.
+   template <bool coupled, bool dummy> struct ElementBlock;
+
+   // Kernels that do not couple the vector components: block-diagonal element
+   // matrix with the same diagonal block for all components. The block is
+   // computed only for bi = bj = 0 and M is unchanged for bi = bj > 0.
+   template <bool dummy> struct ElementBlock<false,dummy>
+   {
+      // number of blocks per dimension in AssembleMatrix(DenseTensor&)
+      static const int num_blocks = 1;
+
+      static inline MFEM_ALWAYS_INLINE
+      bool Compute(int bi, int bj, const f_assembled_t &A,
+                   TMatrix<dofs,dofs> &M, solShapeEval &ev)
+      {
+         if (bi != bj) { return false; }
+         if (bi == 0)
+         {
+            S_spec<1>::ElementMatrix::Compute(A.layout, A, M.layout, M, ev);
+         }
+         return true;
+      }
+
+      // y = M x, where M is (dofs x dofs), x and y are (dofs x vdim).
+      template <typename vdof_data_t>
+      static inline MFEM_ALWAYS_INLINE
+      void Mult(const complex_t *M, const vdof_data_t &x, vdof_data_t &y)
+      {
+         Mult_AB<false>(TMatrix<dofs,dofs>::layout, M,
+                        x.layout.merge_23(), x, y.layout.merge_23(), y);
+      }
+   };
+
+   // Kernels that couple the vector components (vdim == dim): the data A is
+   // (qpts x dim x dim x vdim*vdim), see e.g. TElasticityKernel.
+   template <bool dummy> struct ElementBlock<true,dummy>
+   {
+      static const int num_blocks = vdim;
+
+      static inline MFEM_ALWAYS_INLINE
+      bool Compute(int bi, int bj, const f_assembled_t &A,
+                   TMatrix<dofs,dofs> &M, solShapeEval &ev)
+      {
+         MFEM_STATIC_ASSERT(vdim == dim, "invalid number of components");
+         TTensor3<qpts,dim,dim,complex_t> A_b;
+         TAssign<AssignOp::Set>(A_b.layout, A_b,
+                                A.layout.ind4(bi+vdim*bj), A);
+         S_spec<1>::ElementMatrix::Compute(A_b.layout, A_b, M.layout, M, ev);
+         return true;
+      }
+
+      // y = M x, where M is (vdim*dofs x vdim*dofs), x and y are (dofs x vdim).
+      template <typename vdof_data_t>
+      static inline MFEM_ALWAYS_INLINE
+      void Mult(const complex_t *M, const vdof_data_t &x, vdof_data_t &y)
+      {
+         Mult_AB<false>(TMatrix<vdim*dofs,vdim*dofs>::layout, M,
+                        x.layout.merge_12(), x, y.layout.merge_12(), y);
+      }
+   };
+
+   typedef ElementBlock<kernel_t::coupled_components,true> ElementBlock_t;
+
    // Data members
 
    meshType      mesh;
@@ -105,6 +171,22 @@ public:
         in_fes(sol_fes)
    { }
 
+   // Construct the form using the given mesh nodes, see TMesh.
+   TBilinearForm(const IntegratorType &integ, const FiniteElementSpace &sol_fes,
+                 const GridFunction &mesh_nodes)
+      : Operator(sol_fes.GetNDofs()*vdim),
+        mesh(*sol_fes.GetMesh(), mesh_nodes),
+        meshEval(mesh.fe),
+        sol_fe(*sol_fes.FEColl()),
+        solEval(sol_fe),
+        solFES(sol_fe, sol_fes),
+        solVecLayout(sol_fes),
+        int_rule(),
+        coeff(integ.coeff),
+        assembled_data(NULL),
+        in_fes(sol_fes)
+   { }
+
    virtual ~TBilinearForm()
    {
       delete [] assembled_data;
@@ -240,6 +322,23 @@ public:
       }
    }
 
+   // Add the action on the elements 'elems' to y; x only has to be set at the
+   // dofs of these elements. Requires Assemble().
+   // complex_t = double
+   void AddMultElements(const Array<int> &elems, const Vector &x,
+                        Vector &y) const
+   {
+      MFEM_VERIFY(assembled_data, "the form is not assembled");
+
+      solFieldEval solFEval(solFES, solEval, solVecLayout,
+                            x.GetData(), y.GetData());
+
+      for (int i = 0; i < elems.Size(); i++)
+      {
+         ElementAddMultAssembled<1>(elems[i], solFEval);
+      }
+   }
+
 #ifdef MFEM_TEMPLATE_ENABLE_SERIALIZE
    // complex_t = double
    void TestElementwiseExtractAssemble(const Vector &x, Vector &y) const
@@ -378,16 +477,18 @@ public:
             kernel_t::Assemble(0, F, wQ, res, asm_qpt_data);
          }
 
-         // For now, when vdim > 1, assume block-diagonal matrix with the same
-         // diagonal block for all components.
          TMatrix<dofs,dofs> M_loc;
-         S_spec<BE>::ElementMatrix::Compute(
-            asm_qpt_data.layout, asm_qpt_data, M_loc.layout, M_loc, solEval);
-
          solFES.SetElement(el);
          for (int bi = 0; bi < vdim; bi++)
          {
-            solFES.AssembleBlock(bi, bi, solVecLayout, M_loc, M);
+            for (int bj = 0; bj < vdim; bj++)
+            {
+               if (ElementBlock_t::Compute(bi, bj, asm_qpt_data, M_loc,
+                                           solEval))
+               {
+                  solFES.AssembleBlock(bi, bj, solVecLayout, M_loc, M);
+               }
+            }
          }
       }
    }
@@ -418,15 +519,27 @@ public:
             kernel_t::Assemble(0, F, wQ, res, asm_qpt_data);
          }
 
-         // For now, when vdim > 1, assume block-diagonal matrix with the same
-         // diagonal block for all components.
-         // M is assumed to be (dof x dof x NE).
+         // For kernels that do not couple the vector components, M is assumed
+         // to be (dof x dof x NE): the same diagonal block is used for all
+         // components. Otherwise, M is (vdim*dof x vdim*dof x NE).
+         const int nb = ElementBlock_t::num_blocks;
          TMatrix<dofs,dofs> M_loc;
-         S_spec<BE>::ElementMatrix::Compute(
-            asm_qpt_data.layout, asm_qpt_data, M_loc.layout, M_loc, solEval);
-
          complex_t *M_data = M.GetData(el);
-         M_loc.template AssignTo<AssignOp::Set>(M_data);
+         for (int bi = 0; bi < nb; bi++)
+         {
+            for (int bj = 0; bj < nb; bj++)
+            {
+               ElementBlock_t::Compute(bi, bj, asm_qpt_data, M_loc, solEval);
+               complex_t *M_block = M_data + (bi + bj*nb*dofs)*dofs;
+               for (int j = 0; j < dofs; j++)
+               {
+                  for (int i = 0; i < dofs; i++)
+                  {
+                     M_block[i+j*nb*dofs] = M_loc(i,j);
+                  }
+               }
+            }
+         }
       }
    }
 
@@ -444,7 +557,7 @@ public:
 
       Array<int> vdofs;
       const Array<int> *dof_map = sol_fe.GetDofMap();
-      const int *dof_map_ = dof_map->GetData();
+      const int *dof_map_ = dof_map ? dof_map->GetData() : NULL;
       DenseMatrix M_loc_perm(dofs*vdim,dofs*vdim); // initialized with zeros
 
       const int NE = mesh.GetNE();
@@ -461,44 +574,29 @@ public:
             kernel_t::Assemble(0, F, wQ, res, asm_qpt_data);
          }
 
-         // For now, when vdim > 1, assume block-diagonal matrix with the same
-         // diagonal block for all components.
          TMatrix<dofs,dofs> M_loc;
-         S_spec<BE>::ElementMatrix::Compute(
-            asm_qpt_data.layout, asm_qpt_data, M_loc.layout, M_loc, solEval);
-
-         if (dof_map) // switch from tensor-product ordering
+         for (int bi = 0; bi < vdim; bi++)
          {
-            for (int i = 0; i < dofs; i++)
+            for (int bj = 0; bj < vdim; bj++)
             {
-               for (int j = 0; j < dofs; j++)
+               if (!ElementBlock_t::Compute(bi, bj, asm_qpt_data, M_loc,
+                                            solEval))
                {
-                  M_loc_perm(dof_map_[i],dof_map_[j]) = M_loc(i,j);
+                  continue;
                }
-            }
-            for (int bi = 1; bi < vdim; bi++)
-            {
-               M_loc_perm.CopyMN(M_loc_perm, dofs, dofs, 0, 0,
-                                 bi*dofs, bi*dofs);
-            }
-            a.AssembleElementMatrix(el, M_loc_perm, vdofs);
-         }
-         else
-         {
-            DenseMatrix DM(M_loc.data, dofs, dofs);
-            if (vdim == 1)
-            {
-               a.AssembleElementMatrix(el, DM, vdofs);
-            }
-            else
-            {
-               for (int bi = 0; bi < vdim; bi++)
+               // switch from tensor-product ordering, if necessary
+               for (int j = 0; j < dofs; j++)
                {
-                  M_loc_perm.CopyMN(DM, dofs, dofs, 0, 0, bi*dofs, bi*dofs);
+                  const int pj = bj*dofs + (dof_map_ ? dof_map_[j] : j);
+                  for (int i = 0; i < dofs; i++)
+                  {
+                     const int pi = bi*dofs + (dof_map_ ? dof_map_[i] : i);
+                     M_loc_perm(pi,pj) = M_loc(i,j);
+                  }
                }
-               a.AssembleElementMatrix(el, M_loc_perm, vdofs);
             }
          }
+         a.AssembleElementMatrix(el, M_loc_perm, vdofs);
       }
    }
 
@@ -506,9 +604,8 @@ public:
    // complex_t = double
    void AddMult(DenseTensor &M, const Vector &x, Vector &y) const
    {
-      // For now, when vdim > 1, assume block-diagonal matrix with the same
-      // diagonal block for all components.
-      // M is assumed to be (dof x dof x NE).
+      // M is assumed to be (dof x dof x NE) or (vdim*dof x vdim*dof x NE), as
+      // computed by AssembleMatrix(DenseTensor&).
       solVecLayout_t solVecLayout(this->solVecLayout);
       const int NE = mesh.GetNE();
       for (int el = 0; el < NE; el++)
@@ -517,10 +614,7 @@ public:
 
          solFES.SetElement(el);
          solFES.VectorExtract(solVecLayout, x, x_dof.layout, x_dof);
-         Mult_AB<false>(TMatrix<dofs,dofs>::layout,
-                        M(el).Data(),
-                        x_dof.layout.merge_23(), x_dof,
-                        y_dof.layout.merge_23(), y_dof);
+         ElementBlock_t::Mult(M(el).Data(), x_dof, y_dof);
          solFES.VectorAssemble(y_dof.layout, y_dof, solVecLayout, y);
       }
    }
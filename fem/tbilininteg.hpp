@@ -15,6 +15,9 @@
 #include "../config/tconfig.hpp"
 #include "tcoefficient.hpp"
 #include "tbilinearform.hpp"
+#include "tintrules.hpp"
+#include "tfespace.hpp"
+#include "../mesh/tmesh.hpp"
 
 namespace mfem
 {
@@ -54,6 +57,13 @@ struct TMassKernel
    static const bool out_values    = true;
    static const bool out_gradients = false;
 
+   // needed for the element matrix assembly in TBilinearForm: true if the
+   // kernel couples the components of vector fields
+   static const bool coupled_components = false;
+
+   // true if the bilinear form is symmetric, see TFormOperator::IsSymmetric()
+   static const bool symmetric = true;
+
    // Partially assembled data type for one element with the given number of
    // quadrature points. This type is used in partial assembly, and partially
    // assembled action.
@@ -169,6 +179,13 @@ struct TDiffusionKernel<1,1,complex_t>
    static const bool out_values    = false;
    static const bool out_gradients = true;
 
+   // needed for the element matrix assembly in TBilinearForm: true if the
+   // kernel couples the components of vector fields
+   static const bool coupled_components = false;
+
+   // true if the bilinear form is symmetric, see TFormOperator::IsSymmetric()
+   static const bool symmetric = true;
+
    // Partially assembled data type for one element with the given number of
    // quadrature points. This type is used in partial assembly, and partially
    // assembled action.
@@ -281,6 +298,13 @@ struct TDiffusionKernel<2,2,complex_t>
    static const bool out_values    = false;
    static const bool out_gradients = true;
 
+   // needed for the element matrix assembly in TBilinearForm: true if the
+   // kernel couples the components of vector fields
+   static const bool coupled_components = false;
+
+   // true if the bilinear form is symmetric, see TFormOperator::IsSymmetric()
+   static const bool symmetric = true;
+
    // Partially assembled data type for one element with the given number of
    // quadrature points. This type is used in partial assembly, and partially
    // assembled action. Stores one symmetric 2 x 2 matrix per point.
@@ -422,6 +446,13 @@ struct TDiffusionKernel<3,3,complex_t>
    static const bool out_values    = false;
    static const bool out_gradients = true;
 
+   // needed for the element matrix assembly in TBilinearForm: true if the
+   // kernel couples the components of vector fields
+   static const bool coupled_components = false;
+
+   // true if the bilinear form is symmetric, see TFormOperator::IsSymmetric()
+   static const bool symmetric = true;
+
    // Partially assembled data type for one element with the given number of
    // quadrature points. This type is used in partial assembly, and partially
    // assembled action. Stores one symmetric 3 x 3 matrix per point.
@@ -554,6 +585,803 @@ struct TDiffusionKernel<3,3,complex_t>
    }
 };
 
+
+// Convection kernel: (v . grad(u), w), cf. ConvectionIntegrator. The
+// coefficient v is a vector coefficient with SDim components, e.g.
+// TConstantVectorCoefficient<SDim>. For vector fields, every component is
+// convected independently. Only the case SDim == Dim is supported.
+template <int SDim, int Dim, typename complex_t>
+struct TConvectionKernel
+{
+   typedef complex_t complex_type;
+
+   // needed for the TElementTransformation::Result class
+   static const bool uses_Jacobians = true;
+
+   // needed for the FieldEvaluator::Data class
+   static const bool in_values     = false;
+   static const bool in_gradients  = true;
+   static const bool out_values    = true;
+   static const bool out_gradients = false;
+
+   // needed for the element matrix assembly in TBilinearForm: true if the
+   // kernel couples the components of vector fields
+   static const bool coupled_components = false;
+
+   // true if the bilinear form is symmetric, see TFormOperator::IsSymmetric()
+   static const bool symmetric = false;
+
+   // Partially assembled data type for one element with the given number of
+   // quadrature points. This type is used in partial assembly, and partially
+   // assembled action. Stores one Dim-vector per point.
+   template <int qpts>
+   struct p_asm_data { typedef TMatrix<qpts,Dim,complex_t> type; };
+
+   // Partially assembled data type for one element with the given number of
+   // quadrature points. This type is used in full element matrix assembly.
+   template <int qpts>
+   struct f_asm_data { typedef TMatrix<qpts,Dim,complex_t> type; };
+
+   template <typename IR, typename coeff_t, int NE>
+   struct CoefficientEval
+   {
+      typedef typename IntRuleVectorCoefficient<IR,coeff_t,NE>::Type Type;
+   };
+
+   // Compute the vector a = w adj(J) v at the quadrature point i of element k.
+   template <typename T_result_t, typename Q_t, typename q_t>
+   static inline MFEM_ALWAYS_INLINE
+   void EvalPoint(const int i, const int k, const T_result_t &F,
+                  const Q_t &Q, const q_t &q, complex_t *a)
+   {
+      typedef typename T_result_t::Jt_type::data_type real_t;
+      MFEM_STATIC_ASSERT(SDim == Dim, "SDim != Dim is not supported");
+      MFEM_FLOPS_ADD(2*Dim*Dim);
+      TMatrix<Dim,Dim,real_t> adj_J;
+      TAdjugate<real_t>(F.Jt.layout.ind14(i,k).transpose_12(), F.Jt,
+                        adj_J.layout, adj_J);
+      for (int d = 0; d < Dim; d++)
+      {
+         a[d] = 0.0;
+         for (int e = 0; e < SDim; e++)
+         {
+            a[d] += adj_J(d,e) * Q.get(q,i,e,k);
+         }
+      }
+   }
+
+   // Method used for un-assembled (matrix free) action.
+   // Jt        [M x Dim x SDim x NE] - Jacobian transposed, data member in F
+   // Q                               - CoefficientEval<>::Type
+   // q                               - CoefficientEval<>::Type::result_t
+   // grad_qpts [M x Dim x NC x NE]   - in data member in R
+   // val_qpts  [M x NC x NE]         - out data member in R
+   //
+   // val_qpts = (w adj(J) v) . grad_qpts
+   template <typename T_result_t, typename Q_t, typename q_t,
+             typename S_data_t>
+   static inline MFEM_ALWAYS_INLINE
+   void Action(const int k, const T_result_t &F,
+               const Q_t &Q, const q_t &q, S_data_t &R)
+   {
+      const int M = S_data_t::eval_type::qpts;
+      const int NC = S_data_t::eval_type::vdim;
+      MFEM_STATIC_ASSERT(T_result_t::Jt_type::layout_type::dim_1 == M,
+                         "incompatible dimensions");
+      MFEM_FLOPS_ADD(2*M*NC*Dim);
+      for (int i = 0; i < M; i++)
+      {
+         complex_t a[Dim];
+         EvalPoint(i, k, F, Q, q, a);
+         for (int j = 0; j < NC; j++)
+         {
+            complex_t u = 0.0;
+            for (int d = 0; d < Dim; d++)
+            {
+               u += a[d] * R.grad_qpts(i,d,j,k);
+            }
+            R.val_qpts(i,j,k) = u;
+         }
+      }
+   }
+
+   // Method defining partial assembly.
+   // Jt   [M x Dim x SDim x NE] - Jacobian transposed, data member in F
+   // Q                          - CoefficientEval<>::Type
+   // q                          - CoefficientEval<>::Type::result_t
+   // A    [M x Dim]             - partially assembled vectors
+   //
+   // A = w adj(J) v
+   template <typename T_result_t, typename Q_t, typename q_t, int qpts>
+   static inline MFEM_ALWAYS_INLINE
+   void Assemble(const int k, const T_result_t &F,
+                 const Q_t &Q, const q_t &q, TMatrix<qpts,Dim,complex_t> &A)
+   {
+      const int M = T_result_t::Jt_type::layout_type::dim_1;
+      MFEM_STATIC_ASSERT(qpts == M, "incompatible dimensions");
+      for (int i = 0; i < M; i++)
+      {
+         complex_t a[Dim];
+         EvalPoint(i, k, F, Q, q, a);
+         for (int d = 0; d < Dim; d++)
+         {
+            A(i,d) = a[d];
+         }
+      }
+   }
+
+   // Method for partially assembled action.
+   // A         [M x Dim]        - partially assembled vectors
+   // grad_qpts [M x Dim x NC x NE] - in data member in R
+   // val_qpts  [M x NC x NE]       - out data member in R
+   //
+   // val_qpts = A . grad_qpts
+   template <int qpts, typename S_data_t>
+   static inline MFEM_ALWAYS_INLINE
+   void MultAssembled(const int k, const TMatrix<qpts,Dim,complex_t> &A,
+                      S_data_t &R)
+   {
+      const int M = S_data_t::eval_type::qpts;
+      const int NC = S_data_t::eval_type::vdim;
+      MFEM_STATIC_ASSERT(qpts == M, "incompatible dimensions");
+      MFEM_FLOPS_ADD(2*M*NC*Dim);
+      for (int i = 0; i < M; i++)
+      {
+         for (int j = 0; j < NC; j++)
+         {
+            complex_t u = 0.0;
+            for (int d = 0; d < Dim; d++)
+            {
+               u += A(i,d) * R.grad_qpts(i,d,j,k);
+            }
+            R.val_qpts(i,j,k) = u;
+         }
+      }
+   }
+};
+
+
+namespace internal
+{
+
+// Pointwise operations of the kernels acting on the gradients of vector fields
+// with Dim components, e.g. TElasticityKernel. With B = adj(J) and the (scaled)
+// physical gradient H = grad_qpts^t B, these kernels compute the flux
+//    S = a tr(H) I + b H + c H^t,
+// and return grad_qpts = B S^t. The scalars a, b, c include the factor
+// w/det(J) and the coefficients.
+template <int Dim, typename complex_t>
+struct VectorGradientOps
+{
+   // Size of the partially assembled data at one point: B, a, b, c.
+   static const int p_size = Dim*Dim + 3;
+
+   // x_layout_t is (Dim x Dim): derivative index x component index.
+   template <typename B_data_t, typename x_layout_t, typename x_data_t>
+   static inline MFEM_ALWAYS_INLINE
+   void Apply(const B_data_t &B, const complex_t a, const complex_t b,
+              const complex_t c, const x_layout_t &xl, x_data_t &x)
+   {
+      typedef TMatrix<Dim,Dim> B_type;
+      MFEM_FLOPS_ADD(4*Dim*Dim*Dim+4*Dim*Dim);
+      // H(j,e) = sum_d x(d,j) B(d,e)
+      TMatrix<Dim,Dim,complex_t> H;
+      for (int e = 0; e < Dim; e++)
+      {
+         for (int j = 0; j < Dim; j++)
+         {
+            complex_t h = 0.0;
+            for (int d = 0; d < Dim; d++)
+            {
+               h += x[xl.ind(d,j)] * B[B_type::ind(d,e)];
+            }
+            H(j,e) = h;
+         }
+      }
+      complex_t tr = 0.0;
+      for (int j = 0; j < Dim; j++) { tr += H(j,j); }
+      tr *= a;
+      // x(d,j) = sum_e S(j,e) B(d,e)
+      for (int j = 0; j < Dim; j++)
+      {
+         for (int d = 0; d < Dim; d++)
+         {
+            complex_t y = tr * B[B_type::ind(d,j)];
+            for (int e = 0; e < Dim; e++)
+            {
+               y += (b * H(j,e) + c * H(e,j)) * B[B_type::ind(d,e)];
+            }
+            x[xl.ind(d,j)] = y;
+         }
+      }
+   }
+
+   // Compute the full (coupled) matrices at point i:
+   // A(i,d1,d2,j1+Dim*j2) = a B(d1,j1) B(d2,j2) + c B(d1,j2) B(d2,j1)
+   //                        + b delta_{j1,j2} (B B^t)(d1,d2)
+   template <typename B_data_t, typename A_layout_t, typename A_data_t>
+   static inline MFEM_ALWAYS_INLINE
+   void AssembleFull(const B_data_t &B, const complex_t a, const complex_t b,
+                     const complex_t c, const int i,
+                     const A_layout_t &Al, A_data_t &A)
+   {
+      typedef TMatrix<Dim,Dim> B_type;
+      MFEM_FLOPS_ADD(Dim*Dim*Dim*Dim*(6+2*Dim));
+      for (int j2 = 0; j2 < Dim; j2++)
+      {
+         for (int j1 = 0; j1 < Dim; j1++)
+         {
+            for (int d2 = 0; d2 < Dim; d2++)
+            {
+               for (int d1 = 0; d1 < Dim; d1++)
+               {
+                  complex_t v = (a * B[B_type::ind(d1,j1)] *
+                                 B[B_type::ind(d2,j2)] +
+                                 c * B[B_type::ind(d1,j2)] *
+                                 B[B_type::ind(d2,j1)]);
+                  if (j1 == j2)
+                  {
+                     complex_t BBt = 0.0;
+                     for (int e = 0; e < Dim; e++)
+                     {
+                        BBt += B[B_type::ind(d1,e)] * B[B_type::ind(d2,e)];
+                     }
+                     v += b * BBt;
+                  }
+                  A[Al.ind(i,d1,d2,j1+Dim*j2)] = v;
+               }
+            }
+         }
+      }
+   }
+};
+
+// Common implementation of the kernels based on VectorGradientOps. The class
+// kernel_t must define the method
+//    void Coefficients(int i, int k, const Q_t &Q, const q_t &q,
+//                      complex_t &a, complex_t &b, complex_t &c),
+// returning the (weighted) coefficients in the flux S at the point i of the
+// element k, see VectorGradientOps.
+template <int SDim, int Dim, typename complex_t, typename kernel_t>
+struct TVectorGradientKernel
+{
+   typedef complex_t complex_type;
+   typedef VectorGradientOps<Dim,complex_t> ops_t;
+
+   // needed for the TElementTransformation::Result class
+   static const bool uses_Jacobians = true;
+
+   // needed for the FieldEvaluator::Data class
+   static const bool in_values     = false;
+   static const bool in_gradients  = true;
+   static const bool out_values    = false;
+   static const bool out_gradients = true;
+
+   // needed for the element matrix assembly in TBilinearForm: true if the
+   // kernel couples the components of vector fields
+   static const bool coupled_components = true;
+
+   // true if the bilinear form is symmetric, see TFormOperator::IsSymmetric()
+   static const bool symmetric = true;
+
+   // Partially assembled data type for one element with the given number of
+   // quadrature points. This type is used in partial assembly, and partially
+   // assembled action. Stores adj(J) and the scalars a, b, c, contiguously for
+   // each point.
+   template <int qpts>
+   struct p_asm_data { typedef TMatrix<ops_t::p_size,qpts,complex_t> type; };
+
+   // Partially assembled data type for one element with the given number of
+   // quadrature points. This type is used in full element matrix assembly.
+   // Stores Dim x Dim blocks of Dim x Dim matrices per point.
+   template <int qpts>
+   struct f_asm_data { typedef TTensor4<qpts,Dim,Dim,Dim*Dim,complex_t> type; };
+
+   // Compute B = adj(J) and the scalars a, b, c at point i of element k.
+   template <typename T_result_t, typename Q_t, typename q_t>
+   static inline MFEM_ALWAYS_INLINE
+   void EvalPoint(const int i, const int k, const T_result_t &F,
+                  const Q_t &Q, const q_t &q,
+                  TMatrix<Dim,Dim,complex_t> &B,
+                  complex_t &a, complex_t &b, complex_t &c)
+   {
+      typedef typename T_result_t::Jt_type::data_type real_t;
+      MFEM_STATIC_ASSERT(SDim == Dim, "SDim != Dim is not supported");
+      MFEM_FLOPS_ADD(4);
+      TMatrix<Dim,Dim,real_t> adj_J;
+      const real_t det_J =
+         TAdjDet<real_t>(F.Jt.layout.ind14(i,k).transpose_12(), F.Jt,
+                         adj_J.layout, adj_J);
+      B.Set(adj_J.data);
+      kernel_t::Coefficients(i, k, Q, q, a, b, c);
+      a /= det_J;
+      b /= det_J;
+      c /= det_J;
+   }
+
+   // Method used for un-assembled (matrix free) action.
+   // Jt        [M x Dim x SDim x NE] - Jacobian transposed, data member in F
+   // Q                               - CoefficientEval<>::Type
+   // q                               - CoefficientEval<>::Type::result_t
+   // grad_qpts [M x Dim x NC x NE]   - in/out data member in R, NC = Dim
+   //
+   // grad_qpts = B S^t, see VectorGradientOps
+   template <typename T_result_t, typename Q_t, typename q_t,
+             typename S_data_t>
+   static inline MFEM_ALWAYS_INLINE
+   void Action(const int k, const T_result_t &F,
+               const Q_t &Q, const q_t &q, S_data_t &R)
+   {
+      const int M = S_data_t::eval_type::qpts;
+      const int NC = S_data_t::eval_type::vdim;
+      MFEM_STATIC_ASSERT(T_result_t::Jt_type::layout_type::dim_1 == M,
+                         "incompatible dimensions");
+      MFEM_STATIC_ASSERT(NC == Dim, "the number of components must be Dim");
+      for (int i = 0; i < M; i++)
+      {
+         TMatrix<Dim,Dim,complex_t> B;
+         complex_t a, b, c;
+         EvalPoint(i, k, F, Q, q, B, a, b, c);
+         ops_t::Apply(B, a, b, c, R.grad_qpts.layout.ind14(i,k), R.grad_qpts);
+      }
+   }
+
+   // Method defining partial assembly.
+   // Jt   [M x Dim x SDim x NE]      - Jacobian transposed, data member in F
+   // Q                               - CoefficientEval<>::Type
+   // q                               - CoefficientEval<>::Type::result_t
+   // A    [(Dim*Dim+3) x M]          - partially assembled B, a, b, c
+   template <typename T_result_t, typename Q_t, typename q_t, int qpts>
+   static inline MFEM_ALWAYS_INLINE
+   void Assemble(const int k, const T_result_t &F,
+                 const Q_t &Q, const q_t &q,
+                 TMatrix<ops_t::p_size,qpts,complex_t> &A)
+   {
+      const int M = T_result_t::Jt_type::layout_type::dim_1;
+      MFEM_STATIC_ASSERT(qpts == M, "incompatible dimensions");
+      for (int i = 0; i < M; i++)
+      {
+         TMatrix<Dim,Dim,complex_t> B;
+         complex_t a, b, c;
+         EvalPoint(i, k, F, Q, q, B, a, b, c);
+         for (int j = 0; j < Dim*Dim; j++) { A(j,i) = B[j]; }
+         A(Dim*Dim,i) = a;
+         A(Dim*Dim+1,i) = b;
+         A(Dim*Dim+2,i) = c;
+      }
+   }
+
+   // Method defining full element matrix assembly data.
+   // A    [M x Dim x Dim x Dim*Dim]  - partially assembled matrices: for the
+   //                                   test and trial components j1 and j2,
+   //                                   A(i,*,*,j1+Dim*j2) is the Dim x Dim
+   //                                   matrix acting on the gradients
+   template <typename T_result_t, typename Q_t, typename q_t, int qpts>
+   static inline MFEM_ALWAYS_INLINE
+   void Assemble(const int k, const T_result_t &F,
+                 const Q_t &Q, const q_t &q,
+                 TTensor4<qpts,Dim,Dim,Dim*Dim,complex_t> &A)
+   {
+      const int M = T_result_t::Jt_type::layout_type::dim_1;
+      MFEM_STATIC_ASSERT(qpts == M, "incompatible dimensions");
+      for (int i = 0; i < M; i++)
+      {
+         TMatrix<Dim,Dim,complex_t> B;
+         complex_t a, b, c;
+         EvalPoint(i, k, F, Q, q, B, a, b, c);
+         ops_t::AssembleFull(B, a, b, c, i, A.layout, A);
+      }
+   }
+
+   // Method for partially assembled action.
+   // A         [(Dim*Dim+3) x M]      - partially assembled B, a, b, c
+   // grad_qpts [M x Dim x NC x NE]    - in/out data member in R, NC = Dim
+   template <int qpts, typename S_data_t>
+   static inline MFEM_ALWAYS_INLINE
+   void MultAssembled(const int k,
+                      const TMatrix<ops_t::p_size,qpts,complex_t> &A,
+                      S_data_t &R)
+   {
+      const int M = S_data_t::eval_type::qpts;
+      const int NC = S_data_t::eval_type::vdim;
+      MFEM_STATIC_ASSERT(qpts == M, "incompatible dimensions");
+      MFEM_STATIC_ASSERT(NC == Dim, "the number of components must be Dim");
+      for (int i = 0; i < M; i++)
+      {
+         const complex_t *A_i = A.data + A.layout.ind(0,i);
+         ops_t::Apply(A_i, A_i[Dim*Dim], A_i[Dim*Dim+1], A_i[Dim*Dim+2],
+                      R.grad_qpts.layout.ind14(i,k), R.grad_qpts);
+      }
+   }
+};
+
+} // namespace mfem::internal
+
+
+// Elasticity kernel: (lambda div(u), div(v)) + (2 mu eps(u), eps(v)), cf.
+// ElasticityIntegrator. The coefficient is a TCoefficientPair of the scalar
+// Lame parameters (lambda, mu). The solution space must be a vector space with
+// Dim components, e.g. using VectorLayout<Ordering::byNODES,Dim>.
+template <int SDim, int Dim, typename complex_t>
+struct TElasticityKernel
+   : public internal::TVectorGradientKernel<
+     SDim,Dim,complex_t,TElasticityKernel<SDim,Dim,complex_t> >
+{
+   template <typename IR, typename coeff_t, int NE>
+   struct CoefficientEval
+   {
+      typedef typename IntRuleCoefficientPair<IR,coeff_t,NE>::Type Type;
+   };
+
+   // S = lambda tr(H) I + mu (H + H^t)
+   template <typename Q_t, typename q_t>
+   static inline MFEM_ALWAYS_INLINE
+   void Coefficients(const int i, const int k, const Q_t &Q, const q_t &q,
+                     complex_t &a, complex_t &b, complex_t &c)
+   {
+      a = Q.get_first(q,i,k);
+      b = c = Q.get_second(q,i,k);
+   }
+};
+
+
+namespace internal
+{
+
+// Pointwise operations of the kernels on H(curl) and H(div) spaces, e.g.
+// TCurlCurlKernel. At each quadrature point, these kernels act on the N
+// components of the basis functions on the reference element (Values == true,
+// N = Dim), or of their curls (N = 3 in 3D, N = 1 in 2D) or divergences
+// (N = 1), see VectorShapeEvaluator. The reference quantities are mapped with
+// - J^{-t} (Map == Covariant: ND basis functions), giving the matrix
+//   A = (w/det(J)) adj(J) adj(J)^t,
+// - J/det(J) (Map == Contravariant: RT basis functions and 3D curls), giving
+//   A = (w/det(J)) J^t J,
+// - 1/det(J) (N == 1: 2D curls and divergences), giving A = w/det(J).
+struct PiolaMap { enum Type { Covariant, Contravariant }; };
+
+template <bool Values> struct PiolaKernelData;
+
+template <> struct PiolaKernelData<true>
+{
+   template <typename S_data_t>
+   static inline MFEM_ALWAYS_INLINE
+   typename S_data_t::eval_type::complex_type &
+   Get(S_data_t &R, const int i, const int c, const int k)
+   { return R.val_qpts(i,c,k); }
+};
+
+template <> struct PiolaKernelData<false>
+{
+   template <typename S_data_t>
+   static inline MFEM_ALWAYS_INLINE
+   typename S_data_t::eval_type::complex_type &
+   Get(S_data_t &R, const int i, const int c, const int k)
+   { return R.grad_qpts(i,c,0,k); }
+};
+
+template <int SDim, int Dim, typename complex_t, int N, int Map, bool Values>
+struct TPiolaKernel
+{
+   typedef complex_t complex_type;
+   typedef PiolaKernelData<Values> data_t;
+
+   // needed for the TElementTransformation::Result class
+   static const bool uses_Jacobians = true;
+
+   // needed for the FieldEvaluator::Data class
+   static const bool in_values     = Values;
+   static const bool in_gradients  = !Values;
+   static const bool out_values    = Values;
+   static const bool out_gradients = !Values;
+
+   // needed for the element matrix assembly in TBilinearForm: true if the
+   // kernel couples the components of vector fields
+   static const bool coupled_components = false;
+
+   // true if the bilinear form is symmetric, see TFormOperator::IsSymmetric()
+   static const bool symmetric = true;
+
+   // Number of entries stored for one symmetric N x N matrix.
+   static const int s_size = (N*(N+1))/2;
+
+   // Partially assembled data type for one element with the given number of
+   // quadrature points. This type is used in partial assembly, and partially
+   // assembled action. Stores the lower triangle (by columns) of one
+   // symmetric N x N matrix per point.
+   template <int qpts>
+   struct p_asm_data { typedef TMatrix<qpts,s_size,complex_t> type; };
+
+   // Partially assembled data type for one element with the given number of
+   // quadrature points. This type is used in full element matrix assembly.
+   // Stores one N x N matrix per point.
+   template <int qpts>
+   struct f_asm_data { typedef TTensor3<qpts,N,N,complex_t> type; };
+
+   template <typename IR, typename coeff_t, int NE>
+   struct CoefficientEval
+   {
+      typedef typename IntRuleCoefficient<IR,coeff_t,NE>::Type Type;
+   };
+
+   // Compute the matrix A at point i of element k.
+   template <typename T_result_t, typename Q_t, typename q_t>
+   static inline MFEM_ALWAYS_INLINE
+   void EvalPoint(const int i, const int k, const T_result_t &F,
+                  const Q_t &Q, const q_t &q, TMatrix<N,N,complex_t> &A)
+   {
+      typedef typename T_result_t::Jt_type::data_type real_t;
+      MFEM_STATIC_ASSERT(SDim == Dim, "SDim != Dim is not supported");
+      MFEM_STATIC_ASSERT(N == 1 || N == Dim, "invalid number of components");
+      if (N == 1)
+      {
+         A(0,0) = Q.get(q,i,k) / TDet<real_t>(F.Jt.layout.ind14(i,k), F.Jt);
+      }
+      else if (Map == PiolaMap::Covariant)
+      {
+         MFEM_FLOPS_ADD(1+2*N*N*Dim);
+         TMatrix<Dim,Dim,real_t> B; // = adj(J)
+         const complex_t u =
+            (Q.get(q,i,k) /
+             TAdjDet<real_t>(F.Jt.layout.ind14(i,k).transpose_12(), F.Jt,
+                             B.layout, B));
+         for (int c = 0; c < N; c++)
+         {
+            for (int r = 0; r < N; r++)
+            {
+               complex_t BBt = 0.0;
+               for (int d = 0; d < Dim; d++) { BBt += B(r,d) * B(c,d); }
+               A(r,c) = u * BBt;
+            }
+         }
+      }
+      else
+      {
+         MFEM_FLOPS_ADD(1+2*N*N*SDim);
+         const complex_t u =
+            Q.get(q,i,k) / TDet<real_t>(F.Jt.layout.ind14(i,k), F.Jt);
+         for (int c = 0; c < N; c++)
+         {
+            for (int r = 0; r < N; r++)
+            {
+               complex_t JtJ = 0.0;
+               for (int s = 0; s < SDim; s++)
+               {
+                  JtJ += F.Jt(i,r,s,k) * F.Jt(i,c,s,k);
+               }
+               A(r,c) = u * JtJ;
+            }
+         }
+      }
+   }
+
+   // Method used for un-assembled (matrix free) action.
+   // Jt        [M x Dim x SDim x NE] - Jacobian transposed, data member in F
+   // Q                               - CoefficientEval<>::Type
+   // q                               - CoefficientEval<>::Type::result_t
+   // val_qpts  [M x N x NE]          - in/out data member in R (Values)
+   // grad_qpts [M x N x 1 x NE]      - in/out data member in R (!Values)
+   //
+   // x = A x, where x are the N components at the point
+   template <typename T_result_t, typename Q_t, typename q_t,
+             typename S_data_t>
+   static inline MFEM_ALWAYS_INLINE
+   void Action(const int k, const T_result_t &F,
+               const Q_t &Q, const q_t &q, S_data_t &R)
+   {
+      const int M = S_data_t::eval_type::qpts;
+      MFEM_STATIC_ASSERT(S_data_t::eval_type::vdim == 1,
+                         "the number of components must be 1");
+      MFEM_STATIC_ASSERT(T_result_t::Jt_type::layout_type::dim_1 == M,
+                         "incompatible dimensions");
+      MFEM_FLOPS_ADD(2*M*N*N);
+      for (int i = 0; i < M; i++)
+      {
+         TMatrix<N,N,complex_t> A;
+         EvalPoint(i, k, F, Q, q, A);
+         TVector<N,complex_t> x;
+         for (int c = 0; c < N; c++) { x[c] = data_t::Get(R,i,c,k); }
+         for (int r = 0; r < N; r++)
+         {
+            complex_t y = 0.0;
+            for (int c = 0; c < N; c++) { y += A(r,c) * x[c]; }
+            data_t::Get(R,i,r,k) = y;
+         }
+      }
+   }
+
+   // Method defining partial assembly.
+   // A    [M x N*(N+1)/2]   - partially assembled N x N symmetric matrices
+   template <typename T_result_t, typename Q_t, typename q_t, int qpts>
+   static inline MFEM_ALWAYS_INLINE
+   void Assemble(const int k, const T_result_t &F,
+                 const Q_t &Q, const q_t &q,
+                 TMatrix<qpts,s_size,complex_t> &A)
+   {
+      const int M = T_result_t::Jt_type::layout_type::dim_1;
+      MFEM_STATIC_ASSERT(qpts == M, "incompatible dimensions");
+      for (int i = 0; i < M; i++)
+      {
+         TMatrix<N,N,complex_t> A_i;
+         EvalPoint(i, k, F, Q, q, A_i);
+         for (int c = 0, l = 0; c < N; c++)
+         {
+            for (int r = c; r < N; r++, l++) { A(i,l) = A_i(r,c); }
+         }
+      }
+   }
+
+   // Method defining full element matrix assembly data.
+   // A    [M x N x N]       - partially assembled N x N matrices
+   template <typename T_result_t, typename Q_t, typename q_t, int qpts>
+   static inline MFEM_ALWAYS_INLINE
+   void Assemble(const int k, const T_result_t &F,
+                 const Q_t &Q, const q_t &q,
+                 TTensor3<qpts,N,N,complex_t> &A)
+   {
+      const int M = T_result_t::Jt_type::layout_type::dim_1;
+      MFEM_STATIC_ASSERT(qpts == M, "incompatible dimensions");
+      for (int i = 0; i < M; i++)
+      {
+         TMatrix<N,N,complex_t> A_i;
+         EvalPoint(i, k, F, Q, q, A_i);
+         for (int c = 0; c < N; c++)
+         {
+            for (int r = 0; r < N; r++) { A(i,r,c) = A_i(r,c); }
+         }
+      }
+   }
+
+   // Method for partially assembled action.
+   // A    [M x N*(N+1)/2]   - partially assembled N x N symmetric matrices
+   //
+   // x = A x, where x are the N components at the point
+   template <int qpts, typename S_data_t>
+   static inline MFEM_ALWAYS_INLINE
+   void MultAssembled(const int k, const TMatrix<qpts,s_size,complex_t> &A,
+                      S_data_t &R)
+   {
+      const int M = S_data_t::eval_type::qpts;
+      MFEM_STATIC_ASSERT(qpts == M, "incompatible dimensions");
+      MFEM_STATIC_ASSERT(S_data_t::eval_type::vdim == 1,
+                         "the number of components must be 1");
+      MFEM_FLOPS_ADD(2*M*N*N);
+      for (int i = 0; i < M; i++)
+      {
+         TMatrix<N,N,complex_t> A_i;
+         for (int c = 0, l = 0; c < N; c++)
+         {
+            for (int r = c; r < N; r++, l++)
+            {
+               A_i(r,c) = A_i(c,r) = A(i,l);
+            }
+         }
+         TVector<N,complex_t> x;
+         for (int c = 0; c < N; c++) { x[c] = data_t::Get(R,i,c,k); }
+         for (int r = 0; r < N; r++)
+         {
+            complex_t y = 0.0;
+            for (int c = 0; c < N; c++) { y += A_i(r,c) * x[c]; }
+            data_t::Get(R,i,r,k) = y;
+         }
+      }
+   }
+};
+
+} // namespace mfem::internal
+
+
+// Mass kernel for H(curl) spaces: (u, v), cf. VectorFEMassIntegrator. The
+// solution space must be a ND_FiniteElementSpace.
+template <int SDim, int Dim, typename complex_t>
+struct TNDMassKernel
+   : public internal::TPiolaKernel<SDim,Dim,complex_t,Dim,
+     internal::PiolaMap::Covariant,true> { };
+
+// Mass kernel for H(div) spaces: (u, v), cf. VectorFEMassIntegrator. The
+// solution space must be a RT_FiniteElementSpace.
+template <int SDim, int Dim, typename complex_t>
+struct TRTMassKernel
+   : public internal::TPiolaKernel<SDim,Dim,complex_t,Dim,
+     internal::PiolaMap::Contravariant,true> { };
+
+// Curl-curl kernel: (curl(u), curl(v)), cf. CurlCurlIntegrator. The solution
+// space must be a ND_FiniteElementSpace.
+template <int SDim, int Dim, typename complex_t>
+struct TCurlCurlKernel
+   : public internal::TPiolaKernel<SDim,Dim,complex_t,(Dim == 3) ? 3 : 1,
+     internal::PiolaMap::Contravariant,false> { };
+
+// Div-div kernel: (div(u), div(v)), cf. DivDivIntegrator. The solution space
+// must be a RT_FiniteElementSpace.
+template <int SDim, int Dim, typename complex_t>
+struct TDivDivKernel
+   : public internal::TPiolaKernel<SDim,Dim,complex_t,1,
+     internal::PiolaMap::Contravariant,false> { };
+
+
+namespace internal
+{
+
+// Construct the constant coefficient of TFormOperatorH1 from the values passed
+// to TFormRegistry::Factory.
+inline TConstantCoefficient<> MakeTFormCoefficient(
+   const Vector &c, const TConstantCoefficient<> *)
+{
+   return TConstantCoefficient<>(c(0));
+}
+
+template <int vdim>
+inline TConstantVectorCoefficient<vdim> MakeTFormCoefficient(
+   const Vector &c, const TConstantVectorCoefficient<vdim> *)
+{
+   return TConstantVectorCoefficient<vdim>(c);
+}
+
+} // namespace mfem::internal
+
+// Implementation of TFormOperator using a TBilinearForm with a constant
+// coefficient on a scalar H1 space. The mesh nodes must be H1 of order MeshP,
+// ordered byNODES. The coefficient type is TConstantCoefficient<> or, e.g. for
+// TConvectionKernel, TConstantVectorCoefficient<dim>. Specializations can be
+// added to the TFormRegistry, e.g.
+//    TFormRegistry::Register(
+//       TFormRegistry::Key(Geometry::SQUARE, 1, 5, 11, TFormRegistry::MASS),
+//       TFormOperatorH1<Geometry::SQUARE,1,5,11,TMassKernel>::New);
+template <Geometry::Type G, int MeshP, int SolP, int IROrder,
+          template<int,int,typename> class kernel_t,
+          typename coeff_t = TConstantCoefficient<> >
+class TFormOperatorH1 : public TFormOperator
+{
+protected:
+   typedef H1_FiniteElement<G,MeshP>              mesh_fe_t;
+   typedef H1_FiniteElementSpace<mesh_fe_t>       mesh_fes_t;
+   typedef TMesh<mesh_fes_t>                      mesh_t;
+   typedef H1_FiniteElement<G,SolP>               sol_fe_t;
+   typedef H1_FiniteElementSpace<sol_fe_t>        sol_fes_t;
+   typedef TIntegrationRule<G,IROrder>            int_rule_t;
+   typedef TIntegrator<coeff_t,kernel_t>          integ_t;
+   typedef TBilinearForm<mesh_t,sol_fes_t,int_rule_t,integ_t> form_t;
+
+   form_t form;
+
+public:
+   TFormOperatorH1(const FiniteElementSpace &fes, const GridFunction &nodes,
+                   const coeff_t &coeff)
+      : TFormOperator(fes.GetVSize()),
+        form(integ_t(coeff), fes, nodes)
+   {
+      MFEM_ASSERT(mesh_t::MatchesGeometry(*fes.GetMesh()) &&
+                  mesh_fes_t::template VectorMatches<
+                  typename mesh_t::nodeLayout_type>(*nodes.FESpace()) &&
+                  sol_fes_t::Matches(fes), "invalid mesh or space");
+   }
+
+   // Factory function, see TFormRegistry::Factory.
+   static TFormOperator *New(const FiniteElementSpace &fes,
+                             const GridFunction &nodes, const Vector &coeff)
+   {
+      return new TFormOperatorH1(
+                fes, nodes,
+                internal::MakeTFormCoefficient(coeff, (const coeff_t *)NULL));
+   }
+
+   virtual void AssembleBilinearForm(BilinearForm &a) const
+   { form.AssembleBilinearForm(a); }
+
+   virtual void Assemble() { form.Assemble(); }
+
+   virtual void Mult(const Vector &x, Vector &y) const { form.Mult(x, y); }
+
+   virtual void AddMultElements(const Array<int> &elems, const Vector &x,
+                                Vector &y) const
+   { form.AddMultElements(elems, x, y); }
+
+   virtual bool IsSymmetric() const
+   { return kernel_t<mesh_t::dim,mesh_t::dim,double>::symmetric; }
+};
+
+
 } // namespace mfem
 
 #endif // MFEM_TEMPLATE_BILININTEG
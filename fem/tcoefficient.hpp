@@ -241,6 +241,71 @@ public:
 };
 
 
+// Constant vector coefficient with vdim components.
+template <int vdim, typename complex_t = double>
+class TConstantVectorCoefficient : public TCoefficient
+{
+public:
+   static const int rank = 1;
+   static const bool is_const = true;
+   static const int vec_dim = vdim;
+   typedef complex_t complex_type;
+
+   TVector<vdim,complex_t> value;
+
+   TConstantVectorCoefficient(const complex_t *val)
+   {
+      TAssign<AssignOp::Set>(value.layout, value, value.layout, val);
+   }
+   TConstantVectorCoefficient(const Vector &val)
+   {
+      MFEM_ASSERT(val.Size() == vdim, "invalid vector size");
+      TAssign<AssignOp::Set>(value.layout, value, value.layout, val.GetData());
+   }
+   // default copy constructor
+
+   // T_result_t is the transformation result type (not used here).
+   // c_layout_t is (qpts x vdim x NE).
+   template <typename T_result_t, typename c_layout_t, typename c_data_t>
+   inline MFEM_ALWAYS_INLINE
+   void Eval(const T_result_t &T, const c_layout_t &l, c_data_t &c) const
+   {
+      for (int j = 0; j < vdim; j++)
+      {
+         TAssign<AssignOp::Set>(l.ind2(j), c, value[j]);
+      }
+   }
+};
+
+
+// Pair of scalar coefficients, used by kernels that depend on two scalar
+// coefficients, e.g. the Lame parameters (lambda, mu) in TElasticityKernel.
+template <typename coeff1_t, typename coeff2_t = coeff1_t>
+class TCoefficientPair : public TCoefficient
+{
+public:
+   typedef coeff1_t first_type;
+   typedef coeff2_t second_type;
+   typedef typename coeff1_t::complex_type complex_type;
+
+   static const bool uses_coordinates =
+      coeff1_t::uses_coordinates || coeff2_t::uses_coordinates;
+   static const bool uses_Jacobians =
+      coeff1_t::uses_Jacobians || coeff2_t::uses_Jacobians;
+   static const bool uses_attributes =
+      coeff1_t::uses_attributes || coeff2_t::uses_attributes;
+   static const bool uses_element_idxs =
+      coeff1_t::uses_element_idxs || coeff2_t::uses_element_idxs;
+
+   coeff1_t first;
+   coeff2_t second;
+
+   TCoefficientPair(const coeff1_t &c1, const coeff2_t &c2)
+      : first(c1), second(c2) { }
+   // default copy constructor
+};
+
+
 /// Auxiliary class that is used to simplify the evaluation of a coefficient and
 /// scaling it by the weights of a quadrature rule.
 template <typename IR, typename coeff_t, int NE>
@@ -321,6 +386,118 @@ struct IntRuleCoefficient
    typedef Aux<coeff_t::is_const,true> Type;
 };
 
+
+/// Auxiliary class, similar to IntRuleCoefficient, for vector coefficients,
+/// e.g. TConstantVectorCoefficient. The weights of the quadrature rule are
+/// applied to all components.
+template <typename IR, typename coeff_t, int NE>
+struct IntRuleVectorCoefficient
+{
+   static const int qpts = IR::qpts;
+   static const int ne   = NE;
+   static const int vdim = coeff_t::vec_dim;
+   typedef typename coeff_t::complex_type complex_type;
+
+   template <bool is_const, bool dummy> struct Aux;
+
+   // constant coefficient
+   template <bool dummy> struct Aux<true,dummy>
+   {
+      typedef struct { } result_t;
+      TTensor3<qpts,vdim,1,complex_type> cw;
+
+      inline MFEM_ALWAYS_INLINE Aux(const IR &int_rule, const coeff_t &c)
+      {
+         c.Eval(true, cw.layout, cw);
+         int_rule.template AssignWeights<AssignOp::Mult>(cw.layout, cw);
+      }
+
+      template <typename T_result_t>
+      inline MFEM_ALWAYS_INLINE
+      void Eval(const T_result_t &F, result_t &res) { }
+
+      inline MFEM_ALWAYS_INLINE
+      const complex_type &get(const result_t &res, int i, int j, int k) const
+      {
+         return cw(i,j,0);
+      }
+   };
+   // non-constant coefficient
+   template <bool dummy> struct Aux<false,dummy>
+   {
+      typedef TTensor3<qpts,vdim,ne,complex_type> result_t;
+      IR int_rule;
+      coeff_t c;
+
+      inline MFEM_ALWAYS_INLINE Aux(const IR &int_rule, const coeff_t &c)
+         : int_rule(int_rule), c(c) { }
+
+      template <typename T_result_t>
+      inline MFEM_ALWAYS_INLINE
+      void Eval(const T_result_t &F, result_t &res)
+      {
+         c.Eval(F, res.layout, res);
+         int_rule.template AssignWeights<AssignOp::Mult>(res.layout, res);
+      }
+
+      inline MFEM_ALWAYS_INLINE
+      const complex_type &get(const result_t &res, int i, int j, int k) const
+      {
+         return res(i,j,k);
+      }
+   };
+
+   typedef Aux<coeff_t::is_const,true> Type;
+};
+
+
+/// Auxiliary class, similar to IntRuleCoefficient, for a TCoefficientPair. The
+/// weights of the quadrature rule are applied to both coefficients.
+template <typename IR, typename coeff_t, int NE>
+struct IntRuleCoefficientPair
+{
+   typedef typename coeff_t::complex_type complex_type;
+   typedef typename IntRuleCoefficient<
+   IR,typename coeff_t::first_type,NE>::Type first_eval_t;
+   typedef typename IntRuleCoefficient<
+   IR,typename coeff_t::second_type,NE>::Type second_eval_t;
+
+   struct Type
+   {
+      struct result_t
+      {
+         typename first_eval_t::result_t first;
+         typename second_eval_t::result_t second;
+      };
+
+      first_eval_t first;
+      second_eval_t second;
+
+      inline MFEM_ALWAYS_INLINE Type(const IR &int_rule, const coeff_t &c)
+         : first(int_rule, c.first), second(int_rule, c.second) { }
+
+      template <typename T_result_t>
+      inline MFEM_ALWAYS_INLINE
+      void Eval(const T_result_t &F, result_t &res)
+      {
+         first.Eval(F, res.first);
+         second.Eval(F, res.second);
+      }
+
+      inline MFEM_ALWAYS_INLINE
+      const complex_type &get_first(const result_t &res, int i, int k) const
+      {
+         return first.get(res.first, i, k);
+      }
+
+      inline MFEM_ALWAYS_INLINE
+      const complex_type &get_second(const result_t &res, int i, int k) const
+      {
+         return second.get(res.second, i, k);
+      }
+   };
+};
+
 } // namespace mfem
 
 #endif // MFEM_TEMPLATE_COEFFICIENT
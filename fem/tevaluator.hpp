@@ -16,6 +16,7 @@
 #include "../linalg/ttensor.hpp"
 #include "../general/error.hpp"
 #include "fespace.hpp"
+#include "tfe.hpp"
 
 namespace mfem
 {
@@ -935,6 +936,10 @@ public:
    typedef IR IR_type;
    typedef ShapeEvaluator_base<FE,IR,tensor_prod,real_t> base_class;
 
+   // number of components of the basis functions and of their gradients
+   static const int val_comp  = 1;
+   static const int grad_comp = dim;
+
    using base_class::Calc;
    using base_class::CalcT;
    using base_class::CalcGrad;
@@ -945,6 +950,225 @@ public:
    // default copy constructor
 };
 
+// ShapeEvaluator for vector FE types (ND and RT), without tensor-product
+// structure. The values of the basis functions have DIM components and their
+// "gradients" are the curls (ND) or the divergences (RT) on the reference
+// element, with DDIM = FE::deriv_dim components.
+template <class FE, class IR, typename real_t>
+class VectorShapeEvaluator
+{
+public:
+   static const int DOF  = FE::dofs;
+   static const int NIP  = IR::qpts;
+   static const int DIM  = FE::dim;
+   static const int DDIM = FE::deriv_dim;
+
+   typedef real_t real_type;
+   static const int dim  = DIM;
+   static const int qpts = NIP;
+   static const bool tensor_prod = false;
+   typedef FE FE_type;
+   typedef IR IR_type;
+
+   // number of components of the basis functions and of their derivatives
+   static const int val_comp  = DIM;
+   static const int grad_comp = DDIM;
+
+protected:
+   TTensor3<NIP,DIM,DOF,real_t,true> B;
+   TTensor3<DOF,NIP,DIM,real_t> Bt;
+   TTensor3<NIP,DDIM,DOF,real_t,true> G;
+   TTensor3<DOF,NIP,DDIM,real_t> Gt;
+
+public:
+   VectorShapeEvaluator(const FE &fe)
+   {
+      fe.CalcShapes(IR::GetIntRule(), B.data, G.data);
+      TAssign<AssignOp::Set>(Bt.layout.merge_23(), Bt,
+                             B.layout.merge_12().transpose_12(), B);
+      TAssign<AssignOp::Set>(Gt.layout.merge_23(), Gt,
+                             G.layout.merge_12().transpose_12(), G);
+   }
+
+   // default copy constructor
+
+   // Multi-component shape evaluation from DOFs to quadrature points.
+   // dof_layout is (DOF x NumComp) and qpt_layout is (NIP x DIM*NumComp).
+   template <typename dof_layout_t, typename dof_data_t,
+             typename qpt_layout_t, typename qpt_data_t>
+   MFEM_ALWAYS_INLINE
+   void Calc(const dof_layout_t &dof_layout, const dof_data_t &dof_data,
+             const qpt_layout_t &qpt_layout, qpt_data_t &qpt_data) const
+   {
+      const int NC = dof_layout_t::dim_2;
+      MFEM_STATIC_ASSERT(dof_layout_t::rank  == 2 &&
+                         dof_layout_t::dim_1 == DOF,
+                         "invalid dof_layout_t.");
+      MFEM_STATIC_ASSERT(qpt_layout_t::rank  == 2 &&
+                         qpt_layout_t::dim_1 == NIP &&
+                         qpt_layout_t::dim_2 == DIM*NC,
+                         "invalid qpt_layout_t.");
+
+      Mult_AB<false>(B.layout.merge_12(), B,
+                     dof_layout, dof_data,
+                     qpt_layout.template split_2<DIM,NC>().merge_12(),
+                     qpt_data);
+   }
+
+   // Multi-component shape evaluation transpose from quadrature points to DOFs.
+   // qpt_layout is (NIP x DIM*NumComp) and dof_layout is (DOF x NumComp).
+   template <bool Add,
+             typename qpt_layout_t, typename qpt_data_t,
+             typename dof_layout_t, typename dof_data_t>
+   MFEM_ALWAYS_INLINE
+   void CalcT(const qpt_layout_t &qpt_layout, const qpt_data_t &qpt_data,
+              const dof_layout_t &dof_layout, dof_data_t &dof_data) const
+   {
+      const int NC = dof_layout_t::dim_2;
+      MFEM_STATIC_ASSERT(dof_layout_t::rank  == 2 &&
+                         dof_layout_t::dim_1 == DOF,
+                         "invalid dof_layout_t.");
+      MFEM_STATIC_ASSERT(qpt_layout_t::rank  == 2 &&
+                         qpt_layout_t::dim_1 == NIP &&
+                         qpt_layout_t::dim_2 == DIM*NC,
+                         "invalid qpt_layout_t.");
+
+      Mult_AB<Add>(Bt.layout.merge_23(), Bt,
+                   qpt_layout.template split_2<DIM,NC>().merge_12(), qpt_data,
+                   dof_layout, dof_data);
+   }
+
+   // Multi-component curl/divergence evaluation from DOFs to quadrature points.
+   // dof_layout is (DOF x NumComp) and grad_layout is (NIP x DDIM x NumComp).
+   template <typename dof_layout_t, typename dof_data_t,
+             typename grad_layout_t, typename grad_data_t>
+   MFEM_ALWAYS_INLINE
+   void CalcGrad(const dof_layout_t  &dof_layout,
+                 const dof_data_t    &dof_data,
+                 const grad_layout_t &grad_layout,
+                 grad_data_t         &grad_data) const
+   {
+      MFEM_STATIC_ASSERT(dof_layout_t::rank  == 2 &&
+                         dof_layout_t::dim_1 == DOF,
+                         "invalid dof_layout_t.");
+      MFEM_STATIC_ASSERT(grad_layout_t::rank  == 3 &&
+                         grad_layout_t::dim_1 == NIP &&
+                         grad_layout_t::dim_2 == DDIM,
+                         "invalid grad_layout_t.");
+      MFEM_STATIC_ASSERT(dof_layout_t::dim_2 == grad_layout_t::dim_3,
+                         "incompatible dof- and grad- layouts.");
+
+      Mult_AB<false>(G.layout.merge_12(), G,
+                     dof_layout, dof_data,
+                     grad_layout.merge_12(), grad_data);
+   }
+
+   // Multi-component curl/divergence evaluation transpose from quadrature
+   // points to DOFs. grad_layout is (NIP x DDIM x NumComp), dof_layout is
+   // (DOF x NumComp).
+   template <bool Add,
+             typename grad_layout_t, typename grad_data_t,
+             typename dof_layout_t, typename dof_data_t>
+   MFEM_ALWAYS_INLINE
+   void CalcGradT(const grad_layout_t &grad_layout,
+                  const grad_data_t   &grad_data,
+                  const dof_layout_t  &dof_layout,
+                  dof_data_t          &dof_data) const
+   {
+      MFEM_STATIC_ASSERT(dof_layout_t::rank  == 2 &&
+                         dof_layout_t::dim_1 == DOF,
+                         "invalid dof_layout_t.");
+      MFEM_STATIC_ASSERT(grad_layout_t::rank  == 3 &&
+                         grad_layout_t::dim_1 == NIP &&
+                         grad_layout_t::dim_2 == DDIM,
+                         "invalid grad_layout_t.");
+      MFEM_STATIC_ASSERT(dof_layout_t::dim_2 == grad_layout_t::dim_3,
+                         "incompatible dof- and grad- layouts.");
+
+      Mult_AB<Add>(Gt.layout.merge_23(), Gt,
+                   grad_layout.merge_12(), grad_data,
+                   dof_layout, dof_data);
+   }
+
+   // Multi-component assemble of value-value element matrices.
+   // qpt_layout is (NIP x NumComp x DIM x DIM), and
+   // M_layout is (DOF x DOF x NumComp).
+   template <typename qpt_layout_t, typename qpt_data_t,
+             typename M_layout_t, typename M_data_t>
+   MFEM_ALWAYS_INLINE
+   void Assemble(const qpt_layout_t &qpt_layout, const qpt_data_t &qpt_data,
+                 const M_layout_t &M_layout, M_data_t &M_data) const
+   {
+      const int NC = qpt_layout_t::dim_2;
+      TTensor4<NIP,DIM,DOF,NC> F;
+      for (int k = 0; k < NC; k++)
+      {
+         // (DIM x DIM) x (DIM x DOF) --> (DIM x DOF) at every point
+         for (int j = 0; j < NIP; j++)
+         {
+            Mult_AB<false>(qpt_layout.ind12(j,k), qpt_data,
+                           B.layout.ind1(j), B,
+                           F.layout.ind14(j,k), F);
+         }
+      }
+      // (DOF x (NIP x DIM)) x ((NIP x DIM) x DOF x NC) --> (DOF x DOF x NC)
+      Mult_2_1<false>(Bt.layout.merge_23(), Bt,
+                      F.layout.merge_12(), F,
+                      M_layout, M_data);
+   }
+
+   // Multi-component assemble of curl-curl or div-div element matrices.
+   // qpt_layout is (NIP x DDIM x DDIM x NumComp), and
+   // D_layout is (DOF x DOF x NumComp).
+   template <typename qpt_layout_t, typename qpt_data_t,
+             typename D_layout_t, typename D_data_t>
+   MFEM_ALWAYS_INLINE
+   void AssembleGradGrad(const qpt_layout_t &qpt_layout,
+                         const qpt_data_t   &qpt_data,
+                         const D_layout_t   &D_layout,
+                         D_data_t           &D_data) const
+   {
+      const int NC = qpt_layout_t::dim_4;
+      TTensor4<NIP,DDIM,DOF,NC> F;
+      for (int k = 0; k < NC; k++)
+      {
+         for (int j = 0; j < NIP; j++)
+         {
+            Mult_AB<false>(qpt_layout.ind14(j,k), qpt_data,
+                           G.layout.ind1(j), G,
+                           F.layout.ind14(j,k), F);
+         }
+      }
+      Mult_2_1<false>(Gt.layout.merge_23(), Gt,
+                      F.layout.merge_12(), F,
+                      D_layout, D_data);
+   }
+};
+
+template <Geometry::Type G, int P, class IR, typename real_t>
+class ShapeEvaluator<ND_FiniteElement<G,P>,IR,real_t>
+   : public VectorShapeEvaluator<ND_FiniteElement<G,P>,IR,real_t>
+{
+public:
+   typedef VectorShapeEvaluator<ND_FiniteElement<G,P>,IR,real_t> base_class;
+
+   ShapeEvaluator(const ND_FiniteElement<G,P> &fe) : base_class(fe) { }
+
+   // default copy constructor
+};
+
+template <Geometry::Type G, int P, class IR, typename real_t>
+class ShapeEvaluator<RT_FiniteElement<G,P>,IR,real_t>
+   : public VectorShapeEvaluator<RT_FiniteElement<G,P>,IR,real_t>
+{
+public:
+   typedef VectorShapeEvaluator<RT_FiniteElement<G,P>,IR,real_t> base_class;
+
+   ShapeEvaluator(const RT_FiniteElement<G,P> &fe) : base_class(fe) { }
+
+   // default copy constructor
+};
+
 
 // Field evaluators -- values of a given global FE grid function
 
@@ -997,6 +1221,11 @@ public:
    static const int qpts = IR::qpts;
    static const int vdim = VecLayout_t::vec_dim;
 
+   // number of components of the basis functions and of their gradients, see
+   // ShapeEvaluator and VectorShapeEvaluator
+   static const int val_comp  = ShapeEval_type::val_comp;
+   static const int grad_comp = ShapeEval_type::grad_comp;
+
 protected:
 
    typedef FieldEvaluator_base<FESpace_t,VecLayout_t,IR,complex_t,real_t>
@@ -1147,6 +1376,8 @@ public:
       // Do we need this?
    };
 
+   // For vector FE types, the values of the vector components are stored
+   // consecutively in val_qpts, i.e. val_qpts is (qpts x val_comp*vdim x NE).
    template <int NE> struct AData<1,NE> // 1 = Values
    {
 #ifdef MFEM_TEMPLATE_FIELD_EVAL_DATA_HAS_DOFS
@@ -1155,7 +1386,7 @@ public:
 #else
       typedef TTensor3<dofs,vdim,NE,complex_t> val_dofs_t;
 #endif
-      TTensor3<qpts,vdim,NE,complex_t>      val_qpts;
+      TTensor3<qpts,val_comp*vdim,NE,complex_t> val_qpts;
    };
 
    template <int NE> struct AData<2,NE> // 2 = Gradients
@@ -1166,7 +1397,7 @@ public:
 #else
       typedef TTensor3<dofs,vdim,NE,complex_t> val_dofs_t;
 #endif
-      TTensor4<qpts,dim,vdim,NE,complex_t>      grad_qpts;
+      TTensor4<qpts,grad_comp,vdim,NE,complex_t> grad_qpts;
    };
 
    template <int NE> struct AData<3,NE> // 3 = Values+Gradients
@@ -1177,8 +1408,8 @@ public:
 #else
       typedef TTensor3<dofs,vdim,NE,complex_t> val_dofs_t;
 #endif
-      TTensor3<qpts,    vdim,NE,complex_t,true>  val_qpts;
-      TTensor4<qpts,dim,vdim,NE,complex_t>      grad_qpts;
+      TTensor3<qpts,val_comp*vdim,NE,complex_t,true> val_qpts;
+      TTensor4<qpts,grad_comp,vdim,NE,complex_t>     grad_qpts;
    };
 
    // This struct is similar to struct AData, adding separate static data
@@ -1377,7 +1608,8 @@ public:
 
    template <int NE> struct TElementMatrix<1,1,NE> // 1,1 = Values,Values
    {
-      // qpt_layout_t is (nip), M_layout_t is (dof x dof)
+      // qpt_layout_t is (nip), M_layout_t is (dof x dof); for vector FE types,
+      // qpt_layout_t is (nip x dim x dim)
       // NE = 1 is assumed
       template <typename qpt_layout_t, typename qpt_data_t,
                 typename M_layout_t, typename M_data_t>
@@ -1392,7 +1624,8 @@ public:
 
    template <int NE> struct TElementMatrix<2,2,NE> // 2,2 = Gradients,Gradients
    {
-      // qpt_layout_t is (nip x dim x dim), M_layout_t is (dof x dof)
+      // qpt_layout_t is (nip x grad_comp x grad_comp), M_layout_t is
+      // (dof x dof)
       // NE = 1 is assumed
       template <typename qpt_layout_t, typename qpt_data_t,
                 typename M_layout_t, typename M_data_t>
@@ -1400,11 +1633,47 @@ public:
       void Compute(const qpt_layout_t &a, const qpt_data_t &A,
                    const M_layout_t &m, M_data_t &M, ShapeEval_type &ev)
       {
-         ev.AssembleGradGrad(a.template split_3<dim,1>(), A,
+         ev.AssembleGradGrad(a.template split_3<grad_comp,1>(), A,
                              m.template split_2<dofs,1>(), M);
       }
    };
 
+   template <int NE> struct TElementMatrix<2,1,NE> // 2,1 = Gradients,Values
+   {
+      // qpt_layout_t is (nip x dim), M_layout_t is (dof x dof)
+      // NE = 1 is assumed
+      template <typename qpt_layout_t, typename qpt_data_t,
+                typename M_layout_t, typename M_data_t>
+      static inline MFEM_ALWAYS_INLINE
+      void Compute(const qpt_layout_t &a, const qpt_data_t &A,
+                   const M_layout_t &m, M_data_t &M, ShapeEval_type &ev)
+      {
+         // Evaluate the gradients of all basis functions, G, by applying
+         // CalcGrad() to the identity, then compute
+         // M_{i,j} = \sum_s B_{s,i} \sum_d A_{s,d} G_{s,d,j}.
+         TMatrix<dofs,dofs,real_t> I;
+         I.Set(real_t(0));
+         for (int j = 0; j < dofs; j++) { I(j,j) = real_t(1); }
+         TTensor3<qpts,dim,dofs,real_t> G;
+         ev.CalcGrad(I.layout, I, G.layout, G);
+         TMatrix<qpts,dofs,complex_t> W;
+         MFEM_FLOPS_ADD(2*qpts*dim*dofs);
+         for (int j = 0; j < dofs; j++)
+         {
+            for (int s = 0; s < qpts; s++)
+            {
+               complex_t w = complex_t(0);
+               for (int d = 0; d < dim; d++)
+               {
+                  w += A[a.ind(s,d)] * G(s,d,j);
+               }
+               W(s,j) = w;
+            }
+         }
+         ev.template CalcT<false>(W.layout, W, m, M);
+      }
+   };
+
    template <typename kernel_t, int NE> struct Spec
    {
       static const int InData =
@@ -74,6 +74,71 @@ void CalcShapes(const FiniteElement &fe, const IntegrationRule &ir,
    if (G) { mfem::CalcGradTensor(fe, ir, G, dof_map); }
 }
 
+template <typename real_t>
+void CalcVShapeTensor(const FiniteElement &fe, const IntegrationRule &ir,
+                      real_t *B)
+{
+   // - B must be (nip x dim x dof) with column major storage
+   int dim = fe.GetDim();
+   int nip = ir.GetNPoints();
+   int dof = fe.GetDof();
+   DenseMatrix vshape(dof, dim);
+
+   for (int ip = 0; ip < nip; ip++)
+   {
+      fe.CalcVShape(ir.IntPoint(ip), vshape);
+      for (int id = 0; id < dof; id++)
+      {
+         for (int d = 0; d < dim; d++)
+         {
+            B[ip+nip*(d+dim*id)] = vshape(id, d);
+         }
+      }
+   }
+}
+
+template <typename real_t>
+void CalcDerivTensor(const FiniteElement &fe, const IntegrationRule &ir,
+                     real_t *D)
+{
+   // - For H(curl) elements, D must be (nip x cdim x dof) with column major
+   //   storage, where cdim = 3 in 3D and cdim = 1 in 2D
+   // - For H(div) elements, D must be (nip x dof) with column major storage
+   int nip = ir.GetNPoints();
+   int dof = fe.GetDof();
+   int ddim = (fe.GetDerivType() == FiniteElement::CURL &&
+               fe.GetDim() == 3) ? 3 : 1;
+   DenseMatrix dshape(dof, ddim);
+   Vector divshape(dshape.Data(), dof);
+
+   for (int ip = 0; ip < nip; ip++)
+   {
+      if (fe.GetDerivType() == FiniteElement::CURL)
+      {
+         fe.CalcCurlShape(ir.IntPoint(ip), dshape);
+      }
+      else
+      {
+         fe.CalcDivShape(ir.IntPoint(ip), divshape);
+      }
+      for (int id = 0; id < dof; id++)
+      {
+         for (int d = 0; d < ddim; d++)
+         {
+            D[ip+nip*(d+ddim*id)] = dshape(id, d);
+         }
+      }
+   }
+}
+
+template <typename real_t>
+void CalcVShapes(const FiniteElement &fe, const IntegrationRule &ir,
+                 real_t *B, real_t *D)
+{
+   if (B) { mfem::CalcVShapeTensor(fe, ir, B); }
+   if (D) { mfem::CalcDerivTensor(fe, ir, D); }
+}
+
 // H1 finite elements
 
 template <Geometry::Type G, int P>
@@ -539,6 +604,176 @@ public:
       : base_class(fec) { }
 };
 
+
+// Vector (H(curl) and H(div)) finite elements
+
+// These elements do not use the tensor-product structure: the values and the
+// curls (H(curl)) or divergences (H(div)) of the basis functions on the
+// reference element are stored as full (nip x dim x dof) and (nip x deriv_dim x
+// dof) matrices, see the ShapeEvaluator specializations in tevaluator.hpp. When
+// constructed from a FiniteElementCollection, the element of the collection is
+// used, so its basis types always match the FiniteElementSpace.
+template <Geometry::Type G, int P, typename FE_type, typename FEColl_type,
+          int DEG, int DOFS, int DDIM>
+class VectorFiniteElement_base
+{
+public:
+   static const Geometry::Type geom = G;
+   static const int dim       = Geometry::Constants<G>::Dimension;
+   static const int degree    = DEG;
+   static const int dofs      = DOFS;
+   static const int deriv_dim = DDIM;
+
+   static const bool tensor_prod = false;
+
+protected:
+   const FiniteElement *my_fe;
+   bool own_fe;
+
+   VectorFiniteElement_base()
+      : my_fe(new FE_type(P)), own_fe(true) { }
+
+   VectorFiniteElement_base(const FiniteElementCollection &fec)
+   {
+      const FEColl_type *v_fec = dynamic_cast<const FEColl_type *>(&fec);
+      MFEM_ASSERT(v_fec, "invalid FiniteElementCollection");
+      my_fe = v_fec->FiniteElementForGeometry(G);
+      MFEM_ASSERT(my_fe && my_fe->GetDof() == DOFS,
+                  "the FiniteElementCollection does not match this FE!");
+      own_fe = false;
+   }
+
+   ~VectorFiniteElement_base() { if (own_fe) { delete my_fe; } }
+
+public:
+   // B is (nip x dim x dof), D is (nip x deriv_dim x dof)
+   template <typename real_t>
+   void CalcShapes(const IntegrationRule &ir, real_t *B, real_t *D) const
+   {
+      mfem::CalcVShapes(*my_fe, ir, B, D);
+   }
+   const Array<int> *GetDofMap() const { return NULL; }
+};
+
+
+// Nedelec (H(curl)) finite elements. P is the order of the ND_FECollection.
+
+template <Geometry::Type G, int P>
+class ND_FiniteElement;
+
+template <int P>
+class ND_FiniteElement<Geometry::TRIANGLE, P>
+   : public VectorFiniteElement_base<Geometry::TRIANGLE,P,ND_TriangleElement,
+     ND_FECollection,P,P*(P+2),1>
+{
+protected:
+   typedef VectorFiniteElement_base<Geometry::TRIANGLE,P,ND_TriangleElement,
+           ND_FECollection,P,P*(P+2),1> base_class;
+public:
+   ND_FiniteElement() { }
+   ND_FiniteElement(const FiniteElementCollection &fec) : base_class(fec) { }
+};
+
+template <int P>
+class ND_FiniteElement<Geometry::SQUARE, P>
+   : public VectorFiniteElement_base<Geometry::SQUARE,P,ND_QuadrilateralElement,
+     ND_FECollection,P,2*P*(P+1),1>
+{
+protected:
+   typedef VectorFiniteElement_base<Geometry::SQUARE,P,ND_QuadrilateralElement,
+           ND_FECollection,P,2*P*(P+1),1> base_class;
+public:
+   ND_FiniteElement() { }
+   ND_FiniteElement(const FiniteElementCollection &fec) : base_class(fec) { }
+};
+
+template <int P>
+class ND_FiniteElement<Geometry::TETRAHEDRON, P>
+   : public VectorFiniteElement_base<Geometry::TETRAHEDRON,P,
+     ND_TetrahedronElement,ND_FECollection,P,(P*(P+2)*(P+3))/2,3>
+{
+protected:
+   typedef VectorFiniteElement_base<Geometry::TETRAHEDRON,P,
+           ND_TetrahedronElement,ND_FECollection,P,(P*(P+2)*(P+3))/2,3>
+           base_class;
+public:
+   ND_FiniteElement() { }
+   ND_FiniteElement(const FiniteElementCollection &fec) : base_class(fec) { }
+};
+
+template <int P>
+class ND_FiniteElement<Geometry::CUBE, P>
+   : public VectorFiniteElement_base<Geometry::CUBE,P,ND_HexahedronElement,
+     ND_FECollection,P,3*P*(P+1)*(P+1),3>
+{
+protected:
+   typedef VectorFiniteElement_base<Geometry::CUBE,P,ND_HexahedronElement,
+           ND_FECollection,P,3*P*(P+1)*(P+1),3> base_class;
+public:
+   ND_FiniteElement() { }
+   ND_FiniteElement(const FiniteElementCollection &fec) : base_class(fec) { }
+};
+
+
+// Raviart-Thomas (H(div)) finite elements. P is the order of the
+// RT_FECollection; the polynomial degree of the basis functions is P+1.
+
+template <Geometry::Type G, int P>
+class RT_FiniteElement;
+
+template <int P>
+class RT_FiniteElement<Geometry::TRIANGLE, P>
+   : public VectorFiniteElement_base<Geometry::TRIANGLE,P,RT_TriangleElement,
+     RT_FECollection,P+1,(P+1)*(P+3),1>
+{
+protected:
+   typedef VectorFiniteElement_base<Geometry::TRIANGLE,P,RT_TriangleElement,
+           RT_FECollection,P+1,(P+1)*(P+3),1> base_class;
+public:
+   RT_FiniteElement() { }
+   RT_FiniteElement(const FiniteElementCollection &fec) : base_class(fec) { }
+};
+
+template <int P>
+class RT_FiniteElement<Geometry::SQUARE, P>
+   : public VectorFiniteElement_base<Geometry::SQUARE,P,RT_QuadrilateralElement,
+     RT_FECollection,P+1,2*(P+1)*(P+2),1>
+{
+protected:
+   typedef VectorFiniteElement_base<Geometry::SQUARE,P,RT_QuadrilateralElement,
+           RT_FECollection,P+1,2*(P+1)*(P+2),1> base_class;
+public:
+   RT_FiniteElement() { }
+   RT_FiniteElement(const FiniteElementCollection &fec) : base_class(fec) { }
+};
+
+template <int P>
+class RT_FiniteElement<Geometry::TETRAHEDRON, P>
+   : public VectorFiniteElement_base<Geometry::TETRAHEDRON,P,
+     RT_TetrahedronElement,RT_FECollection,P+1,((P+1)*(P+2)*(P+4))/2,1>
+{
+protected:
+   typedef VectorFiniteElement_base<Geometry::TETRAHEDRON,P,
+           RT_TetrahedronElement,RT_FECollection,P+1,((P+1)*(P+2)*(P+4))/2,1>
+           base_class;
+public:
+   RT_FiniteElement() { }
+   RT_FiniteElement(const FiniteElementCollection &fec) : base_class(fec) { }
+};
+
+template <int P>
+class RT_FiniteElement<Geometry::CUBE, P>
+   : public VectorFiniteElement_base<Geometry::CUBE,P,RT_HexahedronElement,
+     RT_FECollection,P+1,3*(P+1)*(P+1)*(P+2),1>
+{
+protected:
+   typedef VectorFiniteElement_base<Geometry::CUBE,P,RT_HexahedronElement,
+           RT_FECollection,P+1,3*(P+1)*(P+1)*(P+2),1> base_class;
+public:
+   RT_FiniteElement() { }
+   RT_FiniteElement(const FiniteElementCollection &fec) : base_class(fec) { }
+};
+
 } // namespace mfem
 
 #endif // MFEM_TEMPLATE_FINITE_ELEMENTS
@@ -470,6 +470,277 @@ public:
    }
 };
 
+
+// Index type for spaces with oriented dofs (ND and RT spaces), where the
+// element-to-dof Table stores the dofs with flipped orientation as -1-dof. The
+// map method returns the non-negative global dof index and the additional
+// method sign(int loc_dof_idx, int elem_offset) returns the orientation, +1 or
+// -1, of the local dof.
+template <typename FE>
+class OrientedElementDofIndexer
+{
+protected:
+   const int *el_dof_list, *loc_dof_list;
+
+public:
+   typedef FE FE_type;
+
+   OrientedElementDofIndexer(const FE &fe, const FiniteElementSpace &fes)
+   {
+      MFEM_ASSERT(fe.GetDofMap() == NULL, "local dof maps are not supported");
+      const Table &el_dof = fes.GetElementToDofTable();
+      MFEM_ASSERT(el_dof.Size_of_connections() == el_dof.Size() * FE::dofs,
+                  "the element-to-dof Table is not compatible with this FE!");
+      el_dof_list = el_dof.GetJ();
+      loc_dof_list = el_dof_list; // point to element 0
+   }
+
+   // default copy constructor
+
+   inline MFEM_ALWAYS_INLINE
+   void SetElement(int elem_idx)
+   {
+      loc_dof_list = el_dof_list + elem_idx * FE::dofs;
+   }
+
+   inline MFEM_ALWAYS_INLINE
+   int map(int loc_dof_idx, int elem_offset) const
+   {
+      const int j = loc_dof_list[loc_dof_idx + elem_offset * FE::dofs];
+      return (j >= 0) ? j : -1-j;
+   }
+
+   inline MFEM_ALWAYS_INLINE
+   double sign(int loc_dof_idx, int elem_offset) const
+   {
+      return (loc_dof_list[loc_dof_idx + elem_offset * FE::dofs] >= 0) ?
+             1.0 : -1.0;
+   }
+};
+
+
+// Template Finite Element Space with oriented dofs, built using an IndexType
+// that defines the sign method, see OrientedElementDofIndexer. The local dof
+// values are the global dof values multiplied by the orientation of the dofs.
+// Only scalar layouts (one component) are used with these spaces.
+template <typename FE, typename IndexType>
+class TFiniteElementSpace_oriented
+{
+public:
+   typedef FE        FE_type;
+   typedef IndexType index_type;
+
+protected:
+   index_type ind;
+
+public:
+   TFiniteElementSpace_oriented(const FE &fe, const FiniteElementSpace &fes)
+      : ind(fe, fes) { }
+
+   // default copy constructor
+
+   void SetElement(int el) { ind.SetElement(el); }
+
+   // Multi-element Extract: dof_layout is (DOFS x NumElems).
+   template <AssignOp::Type Op, typename glob_dof_data_t,
+             typename dof_layout_t, typename dof_data_t>
+   inline MFEM_ALWAYS_INLINE
+   void Extract(const glob_dof_data_t &glob_dof_data,
+                const dof_layout_t    &dof_layout,
+                dof_data_t            &dof_data) const
+   {
+      const int NE = dof_layout_t::dim_2;
+      MFEM_STATIC_ASSERT(FE::dofs == dof_layout_t::dim_1,
+                         "invalid number of dofs");
+      for (int j = 0; j < NE; j++)
+      {
+         for (int i = 0; i < FE::dofs; i++)
+         {
+            Assign<Op>(dof_data[dof_layout.ind(i,j)],
+                       ind.sign(i,j) * glob_dof_data[ind.map(i,j)]);
+         }
+      }
+   }
+
+   template <typename glob_dof_data_t,
+             typename dof_layout_t, typename dof_data_t>
+   inline MFEM_ALWAYS_INLINE
+   void Extract(const glob_dof_data_t &glob_dof_data,
+                const dof_layout_t    &dof_layout,
+                dof_data_t            &dof_data) const
+   {
+      Extract<AssignOp::Set>(glob_dof_data, dof_layout, dof_data);
+   }
+
+   // Multi-element assemble.
+   template <AssignOp::Type Op,
+             typename dof_layout_t, typename dof_data_t,
+             typename glob_dof_data_t>
+   inline MFEM_ALWAYS_INLINE
+   void Assemble(const dof_layout_t &dof_layout,
+                 const dof_data_t   &dof_data,
+                 glob_dof_data_t    &glob_dof_data) const
+   {
+      const int NE = dof_layout_t::dim_2;
+      MFEM_STATIC_ASSERT(FE::dofs == dof_layout_t::dim_1,
+                         "invalid number of dofs");
+      for (int j = 0; j < NE; j++)
+      {
+         for (int i = 0; i < FE::dofs; i++)
+         {
+            Assign<Op>(glob_dof_data[ind.map(i,j)],
+                       ind.sign(i,j) * dof_data[dof_layout.ind(i,j)]);
+         }
+      }
+   }
+
+   template <typename dof_layout_t, typename dof_data_t,
+             typename glob_dof_data_t>
+   inline MFEM_ALWAYS_INLINE
+   void Assemble(const dof_layout_t &dof_layout,
+                 const dof_data_t   &dof_data,
+                 glob_dof_data_t    &glob_dof_data) const
+   {
+      Assemble<AssignOp::Add>(dof_layout, dof_data, glob_dof_data);
+   }
+
+   // Multi-element VectorExtract: vdof_layout is (DOFS x 1 x NumElems).
+   template <AssignOp::Type Op,
+             typename vec_layout_t, typename glob_vdof_data_t,
+             typename vdof_layout_t, typename vdof_data_t>
+   inline MFEM_ALWAYS_INLINE
+   void VectorExtract(const vec_layout_t     &vl,
+                      const glob_vdof_data_t &glob_vdof_data,
+                      const vdof_layout_t    &vdof_layout,
+                      vdof_data_t            &vdof_data) const
+   {
+      MFEM_STATIC_ASSERT(vdof_layout_t::dim_2 == 1,
+                         "invalid number of components");
+      Extract<Op>(glob_vdof_data, vdof_layout.merge_23(), vdof_data);
+   }
+
+   template <typename vec_layout_t, typename glob_vdof_data_t,
+             typename vdof_layout_t, typename vdof_data_t>
+   inline MFEM_ALWAYS_INLINE
+   void VectorExtract(const vec_layout_t     &vl,
+                      const glob_vdof_data_t &glob_vdof_data,
+                      const vdof_layout_t    &vdof_layout,
+                      vdof_data_t            &vdof_data) const
+   {
+      VectorExtract<AssignOp::Set>(vl, glob_vdof_data, vdof_layout, vdof_data);
+   }
+
+   // Multi-element VectorAssemble: vdof_layout is (DOFS x 1 x NumElems).
+   template <AssignOp::Type Op,
+             typename vdof_layout_t, typename vdof_data_t,
+             typename vec_layout_t, typename glob_vdof_data_t>
+   inline MFEM_ALWAYS_INLINE
+   void VectorAssemble(const vdof_layout_t &vdof_layout,
+                       const vdof_data_t   &vdof_data,
+                       const vec_layout_t  &vl,
+                       glob_vdof_data_t    &glob_vdof_data) const
+   {
+      MFEM_STATIC_ASSERT(vdof_layout_t::dim_2 == 1,
+                         "invalid number of components");
+      Assemble<Op>(vdof_layout.merge_23(), vdof_data, glob_vdof_data);
+   }
+
+   template <typename vdof_layout_t, typename vdof_data_t,
+             typename vec_layout_t, typename glob_vdof_data_t>
+   inline MFEM_ALWAYS_INLINE
+   void VectorAssemble(const vdof_layout_t &vdof_layout,
+                       const vdof_data_t   &vdof_data,
+                       const vec_layout_t  &vl,
+                       glob_vdof_data_t    &glob_vdof_data) const
+   {
+      VectorAssemble<AssignOp::Add>(vdof_layout, vdof_data, vl, glob_vdof_data);
+   }
+
+   void Assemble(const TMatrix<FE::dofs,FE::dofs,double> &m,
+                 SparseMatrix &M) const
+   {
+      MFEM_FLOPS_ADD(2*FE::dofs*FE::dofs);
+      for (int i = 0; i < FE::dofs; i++)
+      {
+         M.SetColPtr(ind.map(i,0));
+         const double s_i = ind.sign(i,0);
+         for (int j = 0; j < FE::dofs; j++)
+         {
+            M._Add_(ind.map(j,0), s_i * ind.sign(j,0) * m(i,j));
+         }
+         M.ClearColPtr();
+      }
+   }
+
+   template <typename vec_layout_t>
+   void AssembleBlock(int block_i, int block_j, const vec_layout_t &vl,
+                      const TMatrix<FE::dofs,FE::dofs,double> &m,
+                      SparseMatrix &M) const
+   {
+      MFEM_ASSERT(block_i == 0 && block_j == 0, "invalid block");
+      Assemble(m, M);
+   }
+};
+
+// Nedelec (H(curl)) Finite Element Space
+
+template <typename FE>
+class ND_FiniteElementSpace
+   : public TFiniteElementSpace_oriented<FE,OrientedElementDofIndexer<FE> >
+{
+public:
+   typedef FE FE_type;
+   typedef TFiniteElementSpace_oriented<FE,OrientedElementDofIndexer<FE> >
+   base_class;
+
+   ND_FiniteElementSpace(const FE &fe, const FiniteElementSpace &fes)
+      : base_class(fe, fes)
+   { }
+
+   // default copy constructor
+
+   static bool Matches(const FiniteElementSpace &fes)
+   {
+      const FiniteElementCollection *fec = fes.FEColl();
+      const ND_FECollection *nd_fec =
+         dynamic_cast<const ND_FECollection *>(fec);
+      if (!nd_fec || fes.GetVDim() != 1) { return false; }
+      const FiniteElement *fe = nd_fec->FiniteElementForGeometry(FE_type::geom);
+      if (!fe || fe->GetOrder() != FE_type::degree) { return false; }
+      return true;
+   }
+};
+
+
+// Raviart-Thomas (H(div)) Finite Element Space
+
+template <typename FE>
+class RT_FiniteElementSpace
+   : public TFiniteElementSpace_oriented<FE,OrientedElementDofIndexer<FE> >
+{
+public:
+   typedef FE FE_type;
+   typedef TFiniteElementSpace_oriented<FE,OrientedElementDofIndexer<FE> >
+   base_class;
+
+   RT_FiniteElementSpace(const FE &fe, const FiniteElementSpace &fes)
+      : base_class(fe, fes)
+   { }
+
+   // default copy constructor
+
+   static bool Matches(const FiniteElementSpace &fes)
+   {
+      const FiniteElementCollection *fec = fes.FEColl();
+      const RT_FECollection *rt_fec =
+         dynamic_cast<const RT_FECollection *>(fec);
+      if (!rt_fec || fes.GetVDim() != 1) { return false; }
+      const FiniteElement *fe = rt_fec->FiniteElementForGeometry(FE_type::geom);
+      if (!fe || fe->GetOrder() != FE_type::degree) { return false; }
+      return true;
+   }
+};
+
 } // namespace mfem
 
 #endif // MFEM_TEMPLATE_FESPACE
@@ -0,0 +1,282 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "binaryio.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace mfem
+{
+
+namespace bin_io
+{
+
+// All sections start at multiples of this alignment in the file
+static const size_t section_alignment = 8;
+
+static inline size_t align_up(size_t pos)
+{
+   return (pos + section_alignment - 1)/section_alignment*section_alignment;
+}
+
+int SectionTable::Add(uint32_t id, size_t size)
+{
+   Entry e;
+   e.id = id;
+   e.reserved = 0;
+   e.offset = 0;
+   e.size = size;
+   return entries.Append(e) - 1;
+}
+
+void SectionTable::Write(std::ostream &os)
+{
+   MFEM_VERIFY(is_little_endian(), "the MFEM binary formats require a "
+               "little-endian host");
+
+   // Compute the offsets of the sections
+   size_t pos = HeaderSize();
+   for (int i = 0; i < entries.Size(); i++)
+   {
+      pos = align_up(base + pos) - base;
+      entries[i].offset = pos;
+      pos += entries[i].size;
+   }
+
+   write<uint32_t>(os, byte_order_mark);
+   write<uint32_t>(os, version);
+   write<uint32_t>(os, entries.Size());
+   write<uint32_t>(os, 0);
+   for (int i = 0; i < entries.Size(); i++)
+   {
+      write<uint32_t>(os, entries[i].id);
+      write<uint32_t>(os, entries[i].reserved);
+      write<uint64_t>(os, entries[i].offset);
+      write<uint64_t>(os, entries[i].size);
+   }
+   written = HeaderSize();
+}
+
+void SectionTable::WriteSection(std::ostream &os, int i, const void *data)
+{
+   const Entry &e = entries[i];
+   MFEM_VERIFY(written <= e.offset, "sections must be written in order");
+   for ( ; written < e.offset; written++) { os.put(0); }
+   os.write((const char *) data, e.size);
+   written += e.size;
+}
+
+void SectionTable::CheckEntries(size_t size) const
+{
+   for (int i = 0; i < entries.Size(); i++)
+   {
+      const Entry &e = entries[i];
+      MFEM_VERIFY(e.offset >= HeaderSize() && e.offset <= size &&
+                  e.size <= size - e.offset,
+                  "invalid binary file: section " << e.id << " is out of "
+                  "bounds");
+   }
+}
+
+void SectionTable::Load(const char *buf, size_t size)
+{
+   MFEM_VERIFY(is_little_endian(), "the MFEM binary formats require a "
+               "little-endian host");
+   MFEM_VERIFY(size >= 16, "invalid binary file: missing header");
+
+   uint32_t head[4];
+   std::memcpy(head, buf, sizeof(head));
+   MFEM_VERIFY(head[0] == byte_order_mark, "invalid binary file: wrong byte "
+               "order mark");
+   MFEM_VERIFY(head[1] == version, "unsupported binary file version: "
+               << head[1]);
+
+   entries.SetSize(head[2]);
+   MFEM_VERIFY(size >= HeaderSize(), "invalid binary file: truncated header");
+   const char *p = buf + 16;
+   for (int i = 0; i < entries.Size(); i++, p += 24)
+   {
+      std::memcpy(&entries[i].id, p, 4);
+      std::memcpy(&entries[i].reserved, p + 4, 4);
+      std::memcpy(&entries[i].offset, p + 8, 8);
+      std::memcpy(&entries[i].size, p + 16, 8);
+   }
+   CheckEntries(size);
+}
+
+void SectionTable::Load(std::istream &is)
+{
+   char head[16];
+   is.read(head, 16);
+   MFEM_VERIFY(is, "invalid binary file: missing header");
+   uint32_t nsections;
+   std::memcpy(&nsections, head + 8, 4);
+
+   const size_t header_size = 16 + 24*(size_t)nsections;
+   std::vector<char> hbuf(header_size);
+   std::memcpy(&hbuf[0], head, 16);
+   is.read(&hbuf[16], header_size - 16);
+   MFEM_VERIFY(is, "invalid binary file: truncated header");
+   // the size of the file is not known, the sections are checked when read
+   Load(&hbuf[0], (size_t) -1);
+}
+
+bool SectionTable::Find(uint32_t id, size_t &offset, size_t &size) const
+{
+   for (int i = 0; i < entries.Size(); i++)
+   {
+      if (entries[i].id == id)
+      {
+         offset = entries[i].offset;
+         size = entries[i].size;
+         return true;
+      }
+   }
+   offset = size = 0;
+   return false;
+}
+
+char *SectionTable::GetSection(char *buf, uint32_t id, size_t &size) const
+{
+   size_t offset;
+   return Find(id, offset, size) ? buf + offset : NULL;
+}
+
+size_t SectionTable::GetDataSize() const
+{
+   size_t size = HeaderSize();
+   for (int i = 0; i < entries.Size(); i++)
+   {
+      size = std::max(size, (size_t)(entries[i].offset + entries[i].size));
+   }
+   return size;
+}
+
+SectionReader::SectionReader(std::istream &input)
+   : buf(NULL), is(&input)
+{
+   table.Load(input);
+   pos = table.HeaderSize();
+}
+
+SectionReader::SectionReader(char *buf_, size_t size, size_t base)
+   : table(base), buf(buf_), is(NULL), pos(0)
+{
+   table.Load(buf, size);
+}
+
+bool SectionReader::Find(uint32_t id, size_t &size) const
+{
+   size_t offset;
+   return table.Find(id, offset, size);
+}
+
+char *SectionReader::GetData(uint32_t id) const
+{
+   MFEM_ASSERT(InMemory(), "the sections are not in memory");
+   size_t size;
+   return table.GetSection(buf, id, size);
+}
+
+void SectionReader::Read(uint32_t id, size_t offset, size_t size, void *data)
+{
+   size_t s_offset, s_size;
+   MFEM_VERIFY(table.Find(id, s_offset, s_size), "invalid binary file: "
+               "missing section " << id);
+   MFEM_VERIFY(offset <= s_size && size <= s_size - offset, "invalid binary "
+               "file: section " << id << " is too short");
+   if (buf)
+   {
+      std::memcpy(data, buf + s_offset + offset, size);
+      return;
+   }
+   const size_t start = s_offset + offset;
+   MFEM_VERIFY(start >= pos, "the sections of a stream must be read in order");
+   is->ignore(start - pos);
+   is->read((char *) data, size);
+   MFEM_VERIFY(*is, "invalid binary file: truncated section " << id);
+   pos = start + size;
+}
+
+void SectionReader::Finish()
+{
+   if (buf) { return; }
+   const size_t end = table.GetDataSize();
+   if (end > pos)
+   {
+      is->ignore(end - pos);
+      MFEM_VERIFY(*is, "invalid binary file: truncated data");
+   }
+   pos = end;
+}
+
+} // namespace mfem::bin_io
+
+
+MappedFile::MappedFile(const std::string &filename)
+   : data(NULL), size(0), mapped(false)
+{
+   MFEM_VERIFY(Open(filename), "unable to map file: " << filename);
+}
+
+bool MappedFile::Open(const std::string &filename)
+{
+   Close();
+#ifndef _WIN32
+   int fd = open(filename.c_str(), O_RDONLY);
+   if (fd < 0) { return false; }
+   struct stat st;
+   if (fstat(fd, &st) != 0) { close(fd); return false; }
+   size = st.st_size;
+   if (size > 0)
+   {
+      // Private writable mapping: modifications are not written to the file
+      void *addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+      if (addr == MAP_FAILED) { close(fd); size = 0; return false; }
+      data = (char *) addr;
+      mapped = true;
+   }
+   close(fd);
+   return true;
+#else
+   std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+   if (!file) { return false; }
+   file.seekg(0, std::ios::end);
+   size = file.tellg();
+   file.seekg(0, std::ios::beg);
+   data = new char[size];
+   file.read(data, size);
+   if (!file) { Close(); return false; }
+   return true;
+#endif
+}
+
+void MappedFile::Close()
+{
+#ifndef _WIN32
+   if (mapped) { munmap(data, size); }
+#endif
+   if (!mapped) { delete [] data; }
+   data = NULL;
+   size = 0;
+   mapped = false;
+}
+
+} // namespace mfem
@@ -13,8 +13,11 @@
 #define MFEM_BINARYIO
 
 #include "../config/config.hpp"
+#include "array.hpp"
 
 #include <iostream>
+#include <string>
+#include <stdint.h>
 
 namespace mfem
 {
@@ -38,8 +41,179 @@ inline T read(std::istream& is)
    return value;
 }
 
+/// Return true if the host stores integers in little-endian byte order.
+inline bool is_little_endian()
+{
+   const uint32_t one = 1;
+   return *(const unsigned char *) &one == 1;
+}
+
+/** @brief Header and table of sections of the MFEM binary file formats, see
+    Mesh::PrintBinary() and GridFunction::SaveBinary().
+
+    A binary file starts with a text line identifying its contents, e.g.
+    "MFEM binary mesh v1.0", followed by the header (all values are stored in
+    little-endian byte order):
+    - uint32: byte order mark 0x01020304,
+    - uint32: format version of the header, SectionTable::version,
+    - uint32: number of sections, n,
+    - uint32: reserved (zero),
+    - n entries of: uint32 section id, uint32 reserved, uint64 offset, uint64
+      size in bytes.
+
+    The offsets of the sections are relative to the beginning of the header.
+    Sections are aligned to 8 bytes with respect to the beginning of the file,
+    so that arrays of doubles can be used in place when the file is mapped
+    into memory, see MappedFile. */
+class SectionTable
+{
+public:
+   static const uint32_t byte_order_mark = 0x01020304;
+   static const uint32_t version = 1;
+
+protected:
+   struct Entry
+   {
+      uint32_t id, reserved;
+      uint64_t offset, size;
+   };
+
+   /// Position of the header in the file, used for the section alignment.
+   size_t base;
+   Array<Entry> entries;
+   /// Number of bytes written so far, relative to the header.
+   size_t written;
+
+   size_t HeaderSize() const { return 16 + 24*entries.Size(); }
+
+   /// Validate the entries read from a file of @a size bytes (from the header)
+   void CheckEntries(size_t size) const;
+
+   friend class SectionReader;
+
+public:
+   /** @brief Create an empty table for a header located at position @a base_
+       in the file, i.e. after the identification line. */
+   explicit SectionTable(size_t base_ = 0) : base(base_), written(0) { }
+
+   /// Add a section of @a size bytes, returning its index. Used for writing.
+   int Add(uint32_t id, size_t size);
+
+   /// Write the header, including the offsets of all added sections.
+   void Write(std::ostream &os);
+
+   /** @brief Write the data of the section with index @a i. The sections must
+       be written in the order in which they were added. */
+   void WriteSection(std::ostream &os, int i, const void *data);
+
+   /// Read the header, but not the sections, from the stream @a is.
+   void Load(std::istream &is);
+
+   /** @brief Read the header from the memory buffer @a buf of @a size bytes,
+       e.g. a mapped file. */
+   void Load(const char *buf, size_t size);
+
+   /** @brief Return true if there is a section with the given @a id and set
+       its @a offset, relative to the header, and @a size. */
+   bool Find(uint32_t id, size_t &offset, size_t &size) const;
+
+   /** @brief Return a pointer to the section with the given @a id in the
+       buffer @a buf, which starts with the header, and set @a size to its
+       size. Returns NULL, if there is no such section. */
+   char *GetSection(char *buf, uint32_t id, size_t &size) const;
+
+   /// Return the total size of the header and all sections.
+   size_t GetDataSize() const;
+};
+
+/** @brief Reader of the sections of a binary file, either from a memory buffer
+    (e.g. a MappedFile) or sequentially from a stream.
+
+    Stream input is read directly into the destination given to Read(),
+    without buffering the file, so compressed streams (see ifgzstream) can be
+    used. The sections, and the parts of a section, must then be read in
+    increasing order of their position in the file. */
+class SectionReader
+{
+protected:
+   SectionTable table;
+   char *buf;
+   std::istream *is;
+   /// Position of the stream relative to the header.
+   size_t pos;
+
+public:
+   /** @brief Read the header from the stream @a input, positioned after the
+       identification line. */
+   explicit SectionReader(std::istream &input);
+
+   /** @brief Use the header and the sections in the memory buffer @a buf_ of
+       @a size bytes, located at position @a base in the file. */
+   SectionReader(char *buf_, size_t size, size_t base);
+
+   /// Return true if the sections are in a memory buffer, see GetData().
+   bool InMemory() const { return buf != NULL; }
+
+   /** @brief Return true if there is a section with the given @a id and set
+       its @a size in bytes. */
+   bool Find(uint32_t id, size_t &size) const;
+
+   /** @brief Return a pointer to the section @a id in the memory buffer, or
+       NULL if there is no such section. Requires InMemory(). */
+   char *GetData(uint32_t id) const;
+
+   /** @brief Copy @a size bytes of the section @a id, starting at byte
+       @a offset of the section, to @a data. */
+   void Read(uint32_t id, size_t offset, size_t size, void *data);
+
+   /** @brief Move a stream to the end of the last section, e.g. before
+       reading more data from it; no-op for memory buffers. */
+   void Finish();
+};
+
 } // namespace mfem::bin_io
 
+/** @brief A file mapped into memory with mmap(), used for loading the MFEM
+    binary formats without copying, see Mesh::Mesh(MappedFile&, int, int, bool)
+    and GridFunction::GridFunction(Mesh*, MappedFile&).
+
+    The mapping is private (copy-on-write): the mapped data can be modified in
+    memory, e.g. by a GridFunction using it, without changing the file. Objects
+    that use the mapped data must be destroyed before the MappedFile. On
+    systems without mmap(), the file is read into memory instead. */
+class MappedFile
+{
+protected:
+   char *data;
+   size_t size;
+   bool mapped;
+
+public:
+   MappedFile() : data(NULL), size(0), mapped(false) { }
+
+   /// Map the given file, aborting on failure.
+   explicit MappedFile(const std::string &filename);
+
+   /** @brief Map the given file, replacing the current mapping. Returns false
+       on failure. */
+   bool Open(const std::string &filename);
+
+   /// Unmap the file.
+   void Close();
+
+   /// Return a pointer to the beginning of the mapped file.
+   char *GetData() const { return data; }
+
+   /// Return the size of the mapped file in bytes.
+   size_t Size() const { return size; }
+
+   ~MappedFile() { Close(); }
+
+private:
+   MappedFile(const MappedFile &);            // Prevent object copy
+   MappedFile &operator=(const MappedFile &); // Prevent object assignment
+};
+
 } // namespace mfem
 
 #endif
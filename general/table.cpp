@@ -553,6 +553,110 @@ Table * Mult (const Table &A, const Table &B)
    return C;
 }
 
+// Breadth-first search from 'root' over the unmarked nodes. Appends the
+// visited nodes to 'queue' (neighbors by increasing degree when 'sorted') and
+// marks them with 'mark'. Returns the number of levels; 'last' receives the
+// offset in 'queue' of the last level.
+static int RCMLevelSets(const Table &adj, int root, Array<int> &marker,
+                        int mark, Array<int> &queue, bool sorted, int &last)
+{
+   const int start = queue.Size();
+   int levels = 0;
+   queue.Append(root);
+   marker[root] = mark;
+   for (int begin = start, end = queue.Size(); begin < end;
+        begin = end, end = queue.Size())
+   {
+      levels++;
+      last = begin;
+      for (int q = begin; q < end; q++)
+      {
+         const int node = queue[q];
+         const int *row = adj.GetRow(node);
+         const int n = adj.RowSize(node);
+         const int first = queue.Size();
+         for (int j = 0; j < n; j++)
+         {
+            const int nb = row[j];
+            if (marker[nb] != mark && marker[nb] != -2)
+            {
+               marker[nb] = mark;
+               queue.Append(nb);
+            }
+         }
+         if (sorted)
+         {
+            // insertion sort by degree: the rows are short
+            for (int i = first + 1; i < queue.Size(); i++)
+            {
+               const int v = queue[i], d = adj.RowSize(v);
+               int k = i;
+               for ( ; k > first && adj.RowSize(queue[k-1]) > d; k--)
+               {
+                  queue[k] = queue[k-1];
+               }
+               queue[k] = v;
+            }
+         }
+      }
+   }
+   return levels;
+}
+
+void ReverseCuthillMcKee(const Table &adj, Array<int> &ordering)
+{
+   const int n = adj.Size();
+   // marker: -2 = numbered, -1 = not visited, >= 0 = id of the last search
+   Array<int> marker(n), queue, level;
+   marker = -1;
+   queue.Reserve(n);
+   ordering.SetSize(n);
+
+   int search = 0, numbered = 0;
+   for (int seed = 0; seed < n; seed++)
+   {
+      if (marker[seed] == -2) { continue; }
+
+      // Start from a node of minimum degree in the component of 'seed'.
+      level.SetSize(0);
+      int last, root = seed;
+      RCMLevelSets(adj, seed, marker, search++, level, false, last);
+      for (int i = 0; i < level.Size(); i++)
+      {
+         if (adj.RowSize(level[i]) < adj.RowSize(root)) { root = level[i]; }
+      }
+
+      // Pseudo-peripheral node: move to a node of minimum degree in the last
+      // level set while the number of levels increases.
+      level.SetSize(0);
+      int levels = RCMLevelSets(adj, root, marker, search++, level, false,
+                                last);
+      for (int it = 0; it < 8; it++)
+      {
+         int cand = level[last];
+         for (int i = last + 1; i < level.Size(); i++)
+         {
+            if (adj.RowSize(level[i]) < adj.RowSize(cand)) { cand = level[i]; }
+         }
+         level.SetSize(0);
+         const int cand_levels =
+            RCMLevelSets(adj, cand, marker, search++, level, false, last);
+         if (cand_levels <= levels) { break; }
+         root = cand;
+         levels = cand_levels;
+      }
+
+      // Cuthill-McKee numbering of the component, reversed at the end.
+      queue.SetSize(0);
+      RCMLevelSets(adj, root, marker, -2, queue, true, last);
+      for (int i = 0; i < queue.Size(); i++)
+      {
+         ordering[queue[i]] = n - 1 - (numbered + i);
+      }
+      numbered += queue.Size();
+   }
+}
+
 STable::STable (int dim, int connections_per_row) :
    Table(dim, connections_per_row)
 {}
@@ -181,6 +181,17 @@ void Transpose(const Array<int> &A, Table &At, int _ncols_A = -1);
 void Mult (const Table &A, const Table &B, Table &C);
 Table * Mult (const Table &A, const Table &B);
 
+/** @brief Compute the reverse Cuthill-McKee ordering of the symmetric graph
+    whose adjacency lists are the rows of @a adj.
+
+    On return, ordering[i] is the new number of node i. Each connected
+    component is numbered by a breadth-first search from a pseudo-peripheral
+    node, visiting the neighbors by increasing degree, and the resulting
+    sequence is reversed. Entries (i,i) of @a adj are ignored. The ordering
+    reduces the bandwidth and the profile of matrices with the sparsity of
+    @a adj. */
+void ReverseCuthillMcKee(const Table &adj, Array<int> &ordering);
+
 
 /** Data type STable. STable is similar to Table, but it's for symmetric
     connectivity, i.e. TYPE I is equivalent to TYPE II. In the first
@@ -0,0 +1,73 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "threads.hpp"
+
+#include <algorithm>
+
+#ifdef MFEM_USE_OPENMP
+#include <omp.h>
+#endif
+
+namespace mfem
+{
+
+int GetMaxThreads()
+{
+#ifdef MFEM_USE_OPENMP
+   return omp_get_max_threads();
+#else
+   return 1;
+#endif
+}
+
+void PartitionByWeight(const int *wsum, int n, int parts, int *offsets)
+{
+   const double total = wsum[n] - wsum[0];
+   offsets[0] = 0;
+   for (int t = 1; t < parts; t++)
+   {
+      const double target = wsum[0] + (total*t)/parts;
+      const int *p = std::lower_bound(wsum + offsets[t-1], wsum + n, target);
+      offsets[t] = p - wsum;
+   }
+   offsets[parts] = n;
+}
+
+template <typename T>
+static void FirstTouchT(T *p, int n)
+{
+#ifdef MFEM_USE_OPENMP
+   if (n >= ThreadsFirstTouchSize)
+   {
+      #pragma omp parallel for schedule(static)
+      for (int i = 0; i < n; i++)
+      {
+         p[i] = T(0);
+      }
+   }
+#else
+   (void) p;
+   (void) n;
+#endif
+}
+
+void FirstTouch(double *p, int n)
+{
+   FirstTouchT(p, n);
+}
+
+void FirstTouch(int *p, int n)
+{
+   FirstTouchT(p, n);
+}
+
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_THREADS
+#define MFEM_THREADS
+
+#include "../config/config.hpp"
+
+namespace mfem
+{
+
+/** @name Threading layer of the linear algebra kernels
+
+    With MFEM_USE_OPENMP, the Vector and SparseMatrix kernels split their work
+    with these functions, so that:
+    - loops over vector entries use the static partition of the entries into
+      equal contiguous ranges, one per thread, and the memory of large arrays
+      is first touched (see FirstTouch()) with the same partition, which places
+      its pages in the memory of the NUMA domain of the thread that uses them;
+      vectors with fewer than ThreadsFirstTouchSize entries are processed by
+      the calling thread, where a parallel region costs more than it saves;
+    - loops over the rows of a sparse matrix use a static partition balanced by
+      the number of nonzeros (see PartitionByWeight()), for matrices with at
+      least ThreadsFirstTouchSize nonzeros; the products with the transpose
+      scatter into one buffer per thread, added in thread order, so they are
+      reproducible for a given number of threads;
+    - reductions are split into blocks of ThreadsReductionBlock entries, which
+      do not depend on the number of threads, and the block results are
+      combined in a fixed order, so the results are reproducible.
+
+    Without OpenMP, the kernels run their original sequential loops. */
+///@{
+
+/// Length of the blocks of the deterministic threaded reductions.
+const int ThreadsReductionBlock = 2048;
+
+/** @brief Arrays with at least this many entries are first touched in
+    parallel, and the element-wise Vector loops are threaded. */
+const int ThreadsFirstTouchSize = 32768;
+
+/// Maximum number of threads of the kernels: 1 without OpenMP.
+int GetMaxThreads();
+
+/** @brief Split the range [0,n) into @a parts contiguous ranges
+    [offsets[t], offsets[t+1]) of about equal weight, where the weight of
+    entry i is wsum[i+1] - wsum[i]; @a offsets must have room for @a parts + 1
+    entries. */
+/** For example, with the row offsets I of a CSR matrix as @a wsum, the rows
+    are balanced by their number of nonzeros. */
+void PartitionByWeight(const int *wsum, int n, int parts, int *offsets);
+
+/** @brief Zero the @a n entries of the new array @a p in parallel, with the
+    static partition of the threaded loops, if @a n is at least
+    ThreadsFirstTouchSize. Does nothing without OpenMP. */
+void FirstTouch(double *p, int n);
+
+/// Same as FirstTouch(double *, int) for an int array.
+void FirstTouch(int *p, int n);
+
+///@}
+
+}
+
+#endif
@@ -0,0 +1,629 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of the serial smoothed aggregation AMG preconditioner
+
+#include "linalg.hpp"
+#include "../fem/fem.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace mfem
+{
+
+AMGSolver::AMGSolver()
+   : Solver()
+{
+   num_functions = 1;
+   ordering_bynodes = false;
+   theta = 0.08;
+   max_levels = 20;
+   coarse_size = 500;
+   sweeps = 1;
+   print_level = 0;
+   reuse_interp = false;
+}
+
+AMGSolver::AMGSolver(const SparseMatrix &A_)
+   : Solver()
+{
+   num_functions = 1;
+   ordering_bynodes = false;
+   theta = 0.08;
+   max_levels = 20;
+   coarse_size = 500;
+   sweeps = 1;
+   print_level = 0;
+   reuse_interp = false;
+
+   SetOperator(A_);
+}
+
+void AMGSolver::SetSystemsOptions(int dim, bool order_bynodes)
+{
+   MFEM_VERIFY(dim >= 1, "invalid number of functions: " << dim);
+   num_functions = dim;
+   ordering_bynodes = order_bynodes;
+}
+
+void AMGSolver::SetNearNullspace(const DenseMatrix &B)
+{
+   near_null = B;
+}
+
+static void AMGCoordinates(const Vector &x, Vector &y)
+{
+   y = x;
+}
+
+void AMGSolver::SetElasticityOptions(FiniteElementSpace *fespace)
+{
+   const int dim = fespace->GetMesh()->SpaceDimension();
+   const int ndofs = fespace->GetNDofs();
+   MFEM_VERIFY(fespace->GetVDim() == dim, "the vector dimension of the space "
+               "must be equal to the space dimension");
+   MFEM_VERIFY(dim == 2 || dim == 3, "invalid dimension: " << dim);
+
+   SetSystemsOptions(dim, fespace->GetOrdering() == Ordering::byNODES);
+
+   // The coordinates of the dofs: the interpolant of the identity
+   GridFunction coords(fespace);
+   VectorFunctionCoefficient identity(dim, AMGCoordinates);
+   coords.ProjectCoefficient(identity);
+
+   // Translations and rotations
+   const int nmodes = (dim == 2) ? 3 : 6;
+   near_null.SetSize(fespace->GetVSize(), nmodes);
+   near_null = 0.0;
+   for (int i = 0; i < ndofs; i++)
+   {
+      int vd[3];
+      double x[3];
+      for (int c = 0; c < dim; c++)
+      {
+         vd[c] = fespace->DofToVDof(i, c);
+         x[c] = coords(vd[c]);
+         near_null(vd[c], c) = 1.0;
+      }
+      if (dim == 2)
+      {
+         near_null(vd[0], 2) = -x[1];
+         near_null(vd[1], 2) = x[0];
+      }
+      else
+      {
+         near_null(vd[0], 3) = -x[1];
+         near_null(vd[1], 3) = x[0];
+         near_null(vd[1], 4) = -x[2];
+         near_null(vd[2], 4) = x[1];
+         near_null(vd[2], 5) = -x[0];
+         near_null(vd[0], 5) = x[2];
+      }
+   }
+}
+
+void AMGSolver::Clear(bool keep_interp)
+{
+   for (int l = 1; l < A.Size(); l++)
+   {
+      delete A[l];
+   }
+   A.SetSize(std::min(A.Size(), 1));
+   if (!keep_interp)
+   {
+      for (int l = 0; l < P.Size(); l++)
+      {
+         delete P[l];
+         delete R[l];
+      }
+      P.SetSize(0);
+      R.SetSize(0);
+      A.SetSize(0);
+   }
+   for (int l = 0; l < pre_smoother.Size(); l++)
+   {
+      delete pre_smoother[l];
+      delete post_smoother[l];
+   }
+   pre_smoother.SetSize(0);
+   post_smoother.SetSize(0);
+   for (int l = 0; l < res.Size(); l++)
+   {
+      delete res[l];
+      delete rhs[l];
+      delete sol[l];
+   }
+   res.SetSize(0);
+   rhs.SetSize(0);
+   sol.SetSize(0);
+   coarse_matrix.SetSize(0);
+}
+
+// Compute the node aggregates of the strength of connection graph of A, where
+// the dofs are grouped into nodes by the map node. Returns the number of
+// aggregates; nodes without strong connections get aggregate -1.
+static int AMGAggregate(const SparseMatrix &A, const Array<int> &node,
+                        int num_nodes, double theta, Array<int> &aggregate)
+{
+   const int *I = A.GetI(), *J = A.GetJ();
+   const double *V = A.GetData();
+
+   Table node_dofs;
+   Transpose(node, node_dofs, num_nodes);
+
+   // Squared Frobenius norms of the node blocks of A, in CSR format
+   Array<int> S_I(num_nodes+1), S_J;
+   Array<double> S_V;
+   Array<int> pos(num_nodes);
+   Vector diag(num_nodes);
+   pos = -1;
+   diag = 0.0;
+   S_I[0] = 0;
+   for (int n = 0; n < num_nodes; n++)
+   {
+      const int *dofs = node_dofs.GetRow(n);
+      for (int k = 0; k < node_dofs.RowSize(n); k++)
+      {
+         const int i = dofs[k];
+         for (int p = I[i]; p < I[i+1]; p++)
+         {
+            const int m = node[J[p]];
+            if (pos[m] < 0)
+            {
+               pos[m] = S_J.Size();
+               S_J.Append(m);
+               S_V.Append(0.0);
+            }
+            S_V[pos[m]] += V[p]*V[p];
+         }
+      }
+      S_I[n+1] = S_J.Size();
+      for (int p = S_I[n]; p < S_I[n+1]; p++)
+      {
+         if (S_J[p] == n) { diag(n) = S_V[p]; }
+         pos[S_J[p]] = -1;
+      }
+   }
+
+   // Strong connections: |A_nm| >= theta sqrt(|A_nn| |A_mm|)
+   Table strong;
+   strong.MakeI(num_nodes);
+   const double theta4 = theta*theta*theta*theta;
+   for (int n = 0; n < num_nodes; n++)
+   {
+      for (int p = S_I[n]; p < S_I[n+1]; p++)
+      {
+         const int m = S_J[p];
+         if (m != n && S_V[p]*S_V[p] >= theta4*diag(n)*diag(m))
+         {
+            strong.AddAColumnInRow(n);
+         }
+      }
+   }
+   strong.MakeJ();
+   for (int n = 0; n < num_nodes; n++)
+   {
+      for (int p = S_I[n]; p < S_I[n+1]; p++)
+      {
+         const int m = S_J[p];
+         if (m != n && S_V[p]*S_V[p] >= theta4*diag(n)*diag(m))
+         {
+            strong.AddConnection(n, m);
+         }
+      }
+   }
+   strong.ShiftUpI();
+
+   // Phase 1: aggregates of whole neighborhoods of unaggregated nodes
+   const int unassigned = -2;
+   int num_aggregates = 0;
+   aggregate.SetSize(num_nodes);
+   for (int n = 0; n < num_nodes; n++)
+   {
+      aggregate[n] = (strong.RowSize(n) == 0) ? -1 : unassigned;
+   }
+   for (int n = 0; n < num_nodes; n++)
+   {
+      if (aggregate[n] != unassigned) { continue; }
+      const int *nbr = strong.GetRow(n);
+      const int nsize = strong.RowSize(n);
+      bool free = true;
+      for (int k = 0; k < nsize && free; k++)
+      {
+         free = (aggregate[nbr[k]] == unassigned);
+      }
+      if (!free) { continue; }
+      aggregate[n] = num_aggregates;
+      for (int k = 0; k < nsize; k++)
+      {
+         aggregate[nbr[k]] = num_aggregates;
+      }
+      num_aggregates++;
+   }
+
+   // Phase 2: join the aggregate of a strongly connected phase 1 node
+   Array<int> phase1(aggregate);
+   for (int n = 0; n < num_nodes; n++)
+   {
+      if (aggregate[n] != unassigned) { continue; }
+      const int *nbr = strong.GetRow(n);
+      for (int k = 0; k < strong.RowSize(n); k++)
+      {
+         if (phase1[nbr[k]] >= 0)
+         {
+            aggregate[n] = phase1[nbr[k]];
+            break;
+         }
+      }
+   }
+
+   // Phase 3: aggregate the remaining nodes with their free neighbors
+   for (int n = 0; n < num_nodes; n++)
+   {
+      if (aggregate[n] != unassigned) { continue; }
+      aggregate[n] = num_aggregates;
+      const int *nbr = strong.GetRow(n);
+      for (int k = 0; k < strong.RowSize(n); k++)
+      {
+         if (aggregate[nbr[k]] == unassigned)
+         {
+            aggregate[nbr[k]] = num_aggregates;
+         }
+      }
+      num_aggregates++;
+   }
+
+   return num_aggregates;
+}
+
+void AMGSolver::BuildInterpolation(int l, const Array<int> &node,
+                                   int num_nodes, const DenseMatrix &B,
+                                   Array<int> &coarse_node,
+                                   int &num_coarse_nodes, DenseMatrix &coarse_B)
+{
+   const SparseMatrix &Af = *A[l];
+   const int n = Af.Height();
+   const int nb = B.Width();
+
+   Array<int> aggregate;
+   const int num_aggregates = AMGAggregate(Af, node, num_nodes, theta,
+                                           aggregate);
+
+   // The dofs of every aggregate
+   Array<int> dof_aggregate(n);
+   for (int i = 0; i < n; i++)
+   {
+      dof_aggregate[i] = aggregate[node[i]];
+   }
+   Table agg_dofs;
+   {
+      // Transpose() does not accept the -1 of the isolated dofs
+      Array<int> tmp(dof_aggregate);
+      for (int i = 0; i < n; i++)
+      {
+         if (tmp[i] < 0) { tmp[i] = num_aggregates; }
+      }
+      Transpose(tmp, agg_dofs, num_aggregates + 1);
+   }
+
+   // Tentative prolongator: the near-nullspace restricted to every aggregate
+   // is orthonormalized with modified Gram-Schmidt; its coefficients in the
+   // orthonormal basis give the coarse near-nullspace. Linearly dependent
+   // vectors are dropped, so the coarse nodes may have less than nb dofs.
+   Array<int> T_col(n*nb);
+   Array<double> T_val(n*nb);
+   Array<int> T_cnt(n);
+   T_cnt = 0;
+   Array<double> cB;
+   coarse_node.SetSize(0);
+   DenseMatrix Q;
+   int nc = 0;
+   for (int a = 0; a < num_aggregates; a++)
+   {
+      const int *dofs = agg_dofs.GetRow(a);
+      const int m = agg_dofs.RowSize(a);
+      Q.SetSize(m, nb);
+      for (int k = 0; k < m; k++)
+      {
+         for (int c = 0; c < nb; c++)
+         {
+            Q(k, c) = B(dofs[k], c);
+         }
+      }
+      int r = 0;
+      for (int c = 0; c < nb; c++)
+      {
+         double *v = Q.GetColumn(c);
+         double norm0 = 0.0;
+         for (int k = 0; k < m; k++) { norm0 += v[k]*v[k]; }
+         for (int t = 0; t < r; t++)
+         {
+            const double *q = Q.GetColumn(t);
+            double dot = 0.0;
+            for (int k = 0; k < m; k++) { dot += q[k]*v[k]; }
+            for (int k = 0; k < m; k++) { v[k] -= dot*q[k]; }
+         }
+         double norm = 0.0;
+         for (int k = 0; k < m; k++) { norm += v[k]*v[k]; }
+         if (norm <= 1e-20*norm0 || norm == 0.0) { continue; }
+         norm = std::sqrt(norm);
+         double *q = Q.GetColumn(r++);
+         for (int k = 0; k < m; k++) { q[k] = v[k]/norm; }
+      }
+      for (int t = 0; t < r; t++)
+      {
+         const double *q = Q.GetColumn(t);
+         for (int k = 0; k < m; k++)
+         {
+            const int i = dofs[k];
+            T_col[i*nb + T_cnt[i]] = nc + t;
+            T_val[i*nb + T_cnt[i]] = q[k];
+            T_cnt[i]++;
+         }
+         for (int c = 0; c < nb; c++)
+         {
+            double dot = 0.0;
+            for (int k = 0; k < m; k++) { dot += q[k]*B(dofs[k], c); }
+            cB.Append(dot);
+         }
+         coarse_node.Append(a);
+      }
+      nc += r;
+   }
+   num_coarse_nodes = num_aggregates;
+
+   if (nc == 0 || nc > 0.9*n)
+   {
+      // Not enough coarsening
+      P.Append(NULL);
+      return;
+   }
+
+   coarse_B.SetSize(nc, nb);
+   for (int i = 0; i < nc; i++)
+   {
+      for (int c = 0; c < nb; c++)
+      {
+         coarse_B(i, c) = cB[i*nb + c];
+      }
+   }
+
+   int *ti = new int[n+1];
+   ti[0] = 0;
+   for (int i = 0; i < n; i++) { ti[i+1] = ti[i] + T_cnt[i]; }
+   int *tj = new int[ti[n]];
+   double *tv = new double[ti[n]];
+   for (int i = 0; i < n; i++)
+   {
+      for (int k = 0; k < T_cnt[i]; k++)
+      {
+         tj[ti[i] + k] = T_col[i*nb + k];
+         tv[ti[i] + k] = T_val[i*nb + k];
+      }
+   }
+   SparseMatrix Ptent(ti, tj, tv, n, nc);
+
+   // Estimate the spectral radius of D^{-1} A with power iterations
+   Vector dinv(n);
+   Af.GetDiag(dinv);
+   for (int i = 0; i < n; i++)
+   {
+      MFEM_VERIFY(dinv(i) != 0.0, "zero diagonal entry in row " << i);
+      dinv(i) = 1.0/dinv(i);
+   }
+   Vector x(n), y(n);
+   x.Randomize(1);
+   double rho = 1.0;
+   for (int it = 0; it < 15; it++)
+   {
+      x /= x.Norml2();
+      Af.Mult(x, y);
+      for (int i = 0; i < n; i++) { y(i) *= dinv(i); }
+      rho = y.Norml2();
+      x.Swap(y);
+   }
+
+   // Smoothed prolongator P = (I - omega D^{-1} A) Ptent
+   const double omega = 4.0/(3.0*rho);
+   dinv *= omega;
+   SparseMatrix *AP = mfem::Mult(Af, Ptent);
+   AP->ScaleRows(dinv);
+   P.Append(Add(1.0, Ptent, -1.0, *AP));
+   delete AP;
+}
+
+// Galerkin product R A P
+static SparseMatrix *AMGGalerkin(const SparseMatrix &R, const SparseMatrix &A,
+                                 const SparseMatrix &P)
+{
+   SparseMatrix *AP = mfem::Mult(A, P);
+   SparseMatrix *RAP_ = mfem::Mult(R, *AP);
+   delete AP;
+   return RAP_;
+}
+
+void AMGSolver::SetupLevels()
+{
+   for (int l = A.Size()-1; l < P.Size(); l++)
+   {
+      A.Append(AMGGalerkin(*R[l], *A[l], *P[l]));
+   }
+
+   const int nl = A.Size();
+   pre_smoother.SetSize(nl);
+   post_smoother.SetSize(nl);
+   res.SetSize(nl);
+   rhs.SetSize(nl);
+   sol.SetSize(nl);
+   for (int l = 0; l < nl; l++)
+   {
+      const int n = A[l]->Height();
+      res[l] = new Vector(n);
+      rhs[l] = new Vector(n);
+      sol[l] = new Vector(n);
+      pre_smoother[l] = post_smoother[l] = NULL;
+      if (l < nl-1)
+      {
+         // Forward GS before and backward GS after the coarse grid
+         // correction give a symmetric V-cycle
+         pre_smoother[l] = new GSSmoother(*A[l], 1, sweeps);
+         pre_smoother[l]->iterative_mode = false;
+         post_smoother[l] = new GSSmoother(*A[l], 2, sweeps);
+         post_smoother[l]->iterative_mode = true;
+      }
+   }
+
+   // Coarsest level: dense LU if it is small enough, otherwise (when the
+   // coarsening stagnated) symmetric GS
+   const SparseMatrix &Ac = *A[nl-1];
+   if (Ac.Height() <= std::max(coarse_size, 2000))
+   {
+      Ac.ToDenseMatrix(coarse_matrix);
+      coarse_solver.Factor(coarse_matrix);
+   }
+   else
+   {
+      pre_smoother[nl-1] = new GSSmoother(Ac, 0, 4*sweeps);
+      pre_smoother[nl-1]->iterative_mode = false;
+   }
+
+   if (print_level > 0)
+   {
+      mfem::out << "\nAMGSolver hierarchy:\n"
+                << "   level         rows      nonzeros\n";
+      for (int l = 0; l < nl; l++)
+      {
+         mfem::out << std::setw(8) << l
+                   << std::setw(13) << A[l]->Height()
+                   << std::setw(14) << A[l]->NumNonZeroElems() << '\n';
+      }
+      mfem::out << "   operator complexity: " << GetOperatorComplexity()
+                << "\n\n";
+   }
+}
+
+double AMGSolver::GetOperatorComplexity() const
+{
+   if (A.Size() == 0) { return 0.0; }
+   double nnz = 0.0;
+   for (int l = 0; l < A.Size(); l++)
+   {
+      nnz += A[l]->NumNonZeroElems();
+   }
+   return nnz/A[0]->NumNonZeroElems();
+}
+
+void AMGSolver::SetOperator(const Operator &op)
+{
+   const SparseMatrix *mat = dynamic_cast<const SparseMatrix *>(&op);
+   MFEM_VERIFY(mat != NULL, "AMGSolver requires a SparseMatrix");
+   MFEM_VERIFY(mat->Finalized(), "the matrix must be finalized");
+   height = width = mat->Height();
+
+   if (reuse_interp && A.Size() > 0 && A[0]->Height() == height)
+   {
+      Clear(true);
+      A[0] = mat;
+      SetupLevels();
+      return;
+   }
+
+   Clear();
+   A.Append(mat);
+
+   // Dof to node map and near-nullspace of the finest level
+   const int n = height, nf = num_functions;
+   MFEM_VERIFY(n % nf == 0, "the matrix size is not a multiple of the number"
+               " of functions " << nf);
+   const int fine_nodes = n/nf;
+   Array<int> node(n);
+   for (int i = 0; i < n; i++)
+   {
+      node[i] = ordering_bynodes ? i % fine_nodes : i / nf;
+   }
+   DenseMatrix B;
+   if (near_null.Width() > 0)
+   {
+      MFEM_VERIFY(near_null.Height() == n, "invalid near-nullspace size");
+      B = near_null;
+   }
+   else
+   {
+      B.SetSize(n, nf);
+      B = 0.0;
+      for (int i = 0; i < n; i++)
+      {
+         B(i, ordering_bynodes ? i / fine_nodes : i % nf) = 1.0;
+      }
+   }
+
+   int num_nodes = fine_nodes;
+   Array<int> coarse_node;
+   int num_coarse_nodes;
+   DenseMatrix coarse_B;
+   while (A.Size() < max_levels && A.Last()->Height() > coarse_size)
+   {
+      const int l = A.Size()-1;
+      BuildInterpolation(l, node, num_nodes, B, coarse_node, num_coarse_nodes,
+                         coarse_B);
+      if (P[l] == NULL)
+      {
+         P.DeleteLast();
+         break;
+      }
+      R.Append(Transpose(*P[l]));
+      A.Append(AMGGalerkin(*R[l], *A[l], *P[l]));
+
+      Swap(node, coarse_node);
+      num_nodes = num_coarse_nodes;
+      B = coarse_B;
+   }
+
+   SetupLevels();
+}
+
+void AMGSolver::Cycle(int l, const Vector &b, Vector &x) const
+{
+   if (l == A.Size()-1)
+   {
+      if (pre_smoother[l]) { pre_smoother[l]->Mult(b, x); }
+      else { coarse_solver.Mult(b, x); }
+      return;
+   }
+
+   Vector &r = *res[l];
+   pre_smoother[l]->Mult(b, x);
+   A[l]->Mult(x, r);
+   subtract(b, r, r);
+   R[l]->Mult(r, *rhs[l+1]);
+   Cycle(l+1, *rhs[l+1], *sol[l+1]);
+   P[l]->AddMult(*sol[l+1], x);
+   post_smoother[l]->Mult(b, x);
+}
+
+void AMGSolver::Mult(const Vector &b, Vector &x) const
+{
+   MFEM_VERIFY(A.Size() > 0, "the operator is not set");
+   if (!iterative_mode)
+   {
+      Cycle(0, b, x);
+      return;
+   }
+   Vector &r = *rhs[0], &c = *sol[0];
+   A[0]->Mult(x, r);
+   subtract(b, r, r);
+   Cycle(0, r, c);
+   x += c;
+}
+
+}
@@ -0,0 +1,140 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_AMG
+#define MFEM_AMG
+
+#include "../config/config.hpp"
+#include "densemat.hpp"
+#include "sparsemat.hpp"
+#include "sparsesmoothers.hpp"
+
+namespace mfem
+{
+
+class FiniteElementSpace;
+
+/** @brief Serial smoothed aggregation algebraic multigrid (AMG) preconditioner
+    for a SparseMatrix, which does not require hypre.
+
+    The setup, performed by SetOperator(), builds a hierarchy of levels:
+    - the nodes of the matrix graph (blocks of num_functions dofs for systems,
+      see SetSystemsOptions()) are grouped into aggregates of strongly
+      connected nodes,
+    - the tentative prolongator interpolates the near-nullspace vectors
+      (constants for every component by default, or e.g. rigid-body modes, see
+      SetNearNullspace() and SetElasticityOptions()) exactly on each aggregate,
+    - the prolongator P is the tentative one smoothed by one damped Jacobi
+      step, and the coarse matrix is the Galerkin product P^t A P.
+
+    The action of the preconditioner, Mult(), is one V-cycle with forward
+    Gauss-Seidel pre-smoothing and backward Gauss-Seidel post-smoothing, so
+    that the preconditioner is symmetric and can be used with CGSolver. The
+    coarsest level is solved with a dense LU factorization.
+
+    The hierarchy is reused by all calls to Mult(). If the matrix values change
+    but not its size, SetReuseInterpolation() allows to recompute only the
+    coarse matrices and smoothers, keeping the prolongators. */
+class AMGSolver : public Solver
+{
+protected:
+   // Parameters
+   int num_functions;   ///< Number of dofs per node (systems), see SetSystemsOptions()
+   bool ordering_bynodes; ///< Ordering of the dofs of systems
+   double theta;        ///< Strength of connection threshold
+   int max_levels, coarse_size, sweeps, print_level;
+   bool reuse_interp;
+   DenseMatrix near_null; ///< Fine level near-nullspace, one vector per column
+
+   // Hierarchy: A[0] is the given matrix, P[l] interpolates from level l+1 to
+   // level l and R[l] is its transpose
+   Array<const SparseMatrix *> A;
+   Array<SparseMatrix *> P, R;
+   Array<GSSmoother *> pre_smoother, post_smoother;
+   DenseMatrix coarse_matrix;
+   DenseMatrixInverse coarse_solver;
+
+   mutable Array<Vector *> res, rhs, sol; ///< Work vectors of every level
+
+   /// Delete the hierarchy. If @a keep_interp is true, keep P and R.
+   void Clear(bool keep_interp = false);
+
+   /** @brief Build the prolongator from level @a l to level l+1 given the
+       dof-to-node map and the near-nullspace of level @a l, and return the
+       map and near-nullspace of the coarse level. */
+   void BuildInterpolation(int l, const Array<int> &node, int num_nodes,
+                           const DenseMatrix &B, Array<int> &coarse_node,
+                           int &num_coarse_nodes, DenseMatrix &coarse_B);
+
+   /// Setup the Galerkin coarse matrices, smoothers and work vectors.
+   void SetupLevels();
+
+   /// Approximately solve A[l] x = b with x = 0 initially (V-cycle).
+   void Cycle(int l, const Vector &b, Vector &x) const;
+
+public:
+   AMGSolver();
+
+   /// Create the preconditioner and perform the setup for @a A.
+   AMGSolver(const SparseMatrix &A);
+
+   /** @brief Treat the matrix as a system with @a dim unknowns per node; the
+       dofs of the components are ordered byVDIM (default) or byNODES. */
+   void SetSystemsOptions(int dim, bool order_bynodes = false);
+
+   /** @brief Set the near-nullspace vectors of the matrix (the columns of
+       @a B), e.g. the rigid-body modes of elasticity. */
+   void SetNearNullspace(const DenseMatrix &B);
+
+   /** @brief Use the rigid-body modes of the H1 vector space @a fespace as
+       the near-nullspace, and the systems options of its ordering. The matrix
+       must use the vdofs of @a fespace (conforming mesh). */
+   void SetElasticityOptions(FiniteElementSpace *fespace);
+
+   /// Threshold for strong connections, default 0.08.
+   void SetStrengthThreshold(double th) { theta = th; }
+
+   /// Maximum number of levels, default 20.
+   void SetMaxLevels(int levels) { max_levels = levels; }
+
+   /// Stop coarsening when a level has at most @a size rows, default 500.
+   void SetCoarseSize(int size) { coarse_size = size; }
+
+   /// Number of pre- and post-smoothing sweeps, default 1.
+   void SetSmootherSweeps(int s) { sweeps = s; }
+
+   /** @brief If @a reuse is true, a new matrix of the same size passed to
+       SetOperator() reuses the prolongators of the previous setup. */
+   void SetReuseInterpolation(bool reuse) { reuse_interp = reuse; }
+
+   /// Print the hierarchy after the setup if @a level > 0.
+   void SetPrintLevel(int level) { print_level = level; }
+
+   int GetNumLevels() const { return A.Size(); }
+
+   /// Return the matrix of level @a l, where level 0 is the finest.
+   const SparseMatrix &GetLevelMatrix(int l) const { return *A[l]; }
+
+   /// Total number of nonzeros of all levels relative to the finest level.
+   double GetOperatorComplexity() const;
+
+   /// Perform the setup; @a op must be a SparseMatrix.
+   virtual void SetOperator(const Operator &op);
+
+   /// Apply one V-cycle.
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   virtual ~AMGSolver() { Clear(); }
+};
+
+}
+
+#endif
@@ -0,0 +1,544 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class DenseBatch
+
+#include "densebatch.hpp"
+#include "densemat.hpp"
+#include "../general/array.hpp"
+#include "../general/sort_pairs.hpp"
+
+#include <cmath>
+
+namespace mfem
+{
+
+const int DenseBatch::batch_size;
+
+// Short name for the batch size, used in the packed (interleaved) indexing.
+static const int BS = DenseBatch::batch_size;
+
+// Sort the problems by the sizes (m[k], n[k]) and split them into batches of
+// at most BS problems of equal sizes: the problems of batch t are
+// order[offsets[t]], ..., order[offsets[t+1]-1].
+static void MakeBatches(int nmat, const int *m, const int *n,
+                        Array<int> &order, Array<int> &offsets)
+{
+   Array<Triple<int, int, int> > keys(nmat);
+   for (int k = 0; k < nmat; k++)
+   {
+      keys[k] = Triple<int, int, int>(m[k], n ? n[k] : 0, k);
+   }
+   SortTriple<int, int, int>(keys.GetData(), nmat);
+   order.SetSize(nmat);
+   offsets.SetSize(0);
+   offsets.Append(0);
+   for (int k = 0; k < nmat; k++)
+   {
+      const int s = offsets.Last();
+      if (k > s && (k - s == BS || keys[k].one != keys[s].one ||
+                    keys[k].two != keys[s].two))
+      {
+         offsets.Append(k);
+      }
+      order[k] = keys[k].three;
+   }
+   if (nmat > 0) { offsets.Append(nmat); }
+}
+
+// Interleave the @a sz entries of the arrays X[idx[b]], b < nb, in @a buf;
+// the unused lanes are set to the identity if @a identity is true (sz = m*m,
+// with m*m - 1 divisible by m + 1) and to zero otherwise.
+static void Pack(int sz, int m, const double *const *X, const int *idx,
+                 int nb, double *buf, bool identity)
+{
+   for (int b = 0; b < nb; b++)
+   {
+      const double *x = X[idx[b]];
+      for (int i = 0; i < sz; i++)
+      {
+         buf[i*BS+b] = x[i];
+      }
+   }
+   for (int b = nb; b < BS; b++)
+   {
+      for (int i = 0; i < sz; i++)
+      {
+         buf[i*BS+b] = (identity && i % (m+1) == 0) ? 1.0 : 0.0;
+      }
+   }
+}
+
+// The reverse of Pack().
+static void Unpack(int sz, const double *buf, double *const *X,
+                   const int *idx, int nb)
+{
+   for (int b = 0; b < nb; b++)
+   {
+      double *x = X[idx[b]];
+      for (int i = 0; i < sz; i++)
+      {
+         x[i] = buf[i*BS+b];
+      }
+   }
+}
+
+static void PackPivots(int m, const int *const *ipiv, const int *idx, int nb,
+                       int *piv)
+{
+   for (int b = 0; b < BS; b++)
+   {
+      const int *p = (b < nb) ? ipiv[idx[b]] : NULL;
+      for (int i = 0; i < m; i++)
+      {
+         piv[i*BS+b] = p ? p[i] - LUFactors::ipiv_base : i;
+      }
+   }
+}
+
+static void UnpackPivots(int m, const int *piv, int *const *ipiv,
+                         const int *idx, int nb)
+{
+   for (int b = 0; b < nb; b++)
+   {
+      int *p = ipiv[idx[b]];
+      for (int i = 0; i < m; i++)
+      {
+         p[i] = piv[i*BS+b] + LUFactors::ipiv_base;
+      }
+   }
+}
+
+// The kernels below work on one packed batch: entry (i,j) of the m x n
+// matrix of lane b is a[(i+j*m)*BS+b]. The values reused in the lane loops
+// are copied to local arrays, so that the loops have no dependencies.
+
+// Same as LUFactors::Factor() without LAPACK.
+static void BatchLUFactor(int m, double *a, int *piv)
+{
+   double a_ii_inv[BS], a_ik[BS];
+   for (int i = 0; i < m; i++)
+   {
+      double *col_i = a + i*m*BS;
+      // pivoting: the rows to swap differ between the lanes
+      for (int b = 0; b < BS; b++)
+      {
+         int p = i;
+         double amax = std::abs(col_i[i*BS+b]);
+         for (int j = i+1; j < m; j++)
+         {
+            const double v = std::abs(col_i[j*BS+b]);
+            if (v > amax)
+            {
+               amax = v;
+               p = j;
+            }
+         }
+         piv[i*BS+b] = p;
+         if (p != i)
+         {
+            for (int k = 0; k < m; k++)
+            {
+               Swap<double>(a[(i+k*m)*BS+b], a[(p+k*m)*BS+b]);
+            }
+         }
+         MFEM_ASSERT(col_i[i*BS+b] != 0.0, "division by zero");
+      }
+      for (int b = 0; b < BS; b++)
+      {
+         a_ii_inv[b] = 1.0/col_i[i*BS+b];
+      }
+      for (int j = i+1; j < m; j++)
+      {
+         for (int b = 0; b < BS; b++)
+         {
+            col_i[j*BS+b] *= a_ii_inv[b];
+         }
+      }
+      for (int k = i+1; k < m; k++)
+      {
+         double *col_k = a + k*m*BS;
+         for (int b = 0; b < BS; b++)
+         {
+            a_ik[b] = col_k[i*BS+b];
+         }
+         for (int j = i+1; j < m; j++)
+         {
+            for (int b = 0; b < BS; b++)
+            {
+               col_k[j*BS+b] -= a_ik[b] * col_i[j*BS+b];
+            }
+         }
+      }
+   }
+}
+
+// Same as LUFactors::LSolve(): X <- L^{-1} P X, X is m x r.
+static void BatchLSolve(int m, int r, const double *a, const int *piv,
+                        double *x)
+{
+   double x_j[BS];
+   for (int k = 0; k < r; k++, x += m*BS)
+   {
+      for (int i = 0; i < m; i++)
+      {
+         for (int b = 0; b < BS; b++)
+         {
+            Swap<double>(x[i*BS+b], x[piv[i*BS+b]*BS+b]);
+         }
+      }
+      for (int j = 0; j < m; j++)
+      {
+         const double *col_j = a + j*m*BS;
+         for (int b = 0; b < BS; b++)
+         {
+            x_j[b] = x[j*BS+b];
+         }
+         for (int i = j+1; i < m; i++)
+         {
+            for (int b = 0; b < BS; b++)
+            {
+               x[i*BS+b] -= col_j[i*BS+b] * x_j[b];
+            }
+         }
+      }
+   }
+}
+
+// Same as LUFactors::USolve(): X <- U^{-1} X, X is m x r.
+static void BatchUSolve(int m, int r, const double *a, double *x)
+{
+   double x_j[BS];
+   for (int k = 0; k < r; k++, x += m*BS)
+   {
+      for (int j = m-1; j >= 0; j--)
+      {
+         const double *col_j = a + j*m*BS;
+         for (int b = 0; b < BS; b++)
+         {
+            x_j[b] = ( x[j*BS+b] /= col_j[j*BS+b] );
+         }
+         for (int i = 0; i < j; i++)
+         {
+            for (int b = 0; b < BS; b++)
+            {
+               x[i*BS+b] -= col_j[i*BS+b] * x_j[b];
+            }
+         }
+      }
+   }
+}
+
+// Same as LUFactors::BlockFactor().
+static void BatchBlockFactor(int m, int n, const double *a, const int *piv,
+                             double *a12, double *a21, double *a22)
+{
+   double u[BS];
+   // A12 <- L^{-1} P A12
+   BatchLSolve(m, n, a, piv, a12);
+   // A21 <- A21 U^{-1}
+   for (int j = 0; j < m; j++)
+   {
+      double *a21_j = a21 + j*n*BS;
+      for (int b = 0; b < BS; b++)
+      {
+         u[b] = 1.0/a[(j+j*m)*BS+b];
+      }
+      for (int i = 0; i < n; i++)
+      {
+         for (int b = 0; b < BS; b++)
+         {
+            a21_j[i*BS+b] *= u[b];
+         }
+      }
+      for (int k = j+1; k < m; k++)
+      {
+         double *a21_k = a21 + k*n*BS;
+         for (int b = 0; b < BS; b++)
+         {
+            u[b] = a[(j+k*m)*BS+b];
+         }
+         for (int i = 0; i < n; i++)
+         {
+            for (int b = 0; b < BS; b++)
+            {
+               a21_k[i*BS+b] -= a21_j[i*BS+b] * u[b];
+            }
+         }
+      }
+   }
+   // A22 <- A22 - A21 A12
+   for (int k = 0; k < n; k++)
+   {
+      double *a22_k = a22 + k*n*BS;
+      for (int j = 0; j < m; j++)
+      {
+         const double *a21_j = a21 + j*n*BS;
+         for (int b = 0; b < BS; b++)
+         {
+            u[b] = a12[(j+k*m)*BS+b];
+         }
+         for (int i = 0; i < n; i++)
+         {
+            for (int b = 0; b < BS; b++)
+            {
+               a22_k[i*BS+b] -= a21_j[i*BS+b] * u[b];
+            }
+         }
+      }
+   }
+}
+
+static void BatchCholeskyFactor(int m, double *a)
+{
+   double d_inv[BS], l_kj[BS];
+   for (int j = 0; j < m; j++)
+   {
+      double *col_j = a + j*m*BS;
+      for (int b = 0; b < BS; b++)
+      {
+         MFEM_ASSERT(col_j[j*BS+b] > 0.0, "the matrix is not positive "
+                     "definite");
+         col_j[j*BS+b] = std::sqrt(col_j[j*BS+b]);
+         d_inv[b] = 1.0/col_j[j*BS+b];
+      }
+      for (int i = j+1; i < m; i++)
+      {
+         for (int b = 0; b < BS; b++)
+         {
+            col_j[i*BS+b] *= d_inv[b];
+         }
+      }
+      for (int k = j+1; k < m; k++)
+      {
+         double *col_k = a + k*m*BS;
+         for (int b = 0; b < BS; b++)
+         {
+            l_kj[b] = col_j[k*BS+b];
+         }
+         for (int i = k; i < m; i++)
+         {
+            for (int b = 0; b < BS; b++)
+            {
+               col_k[i*BS+b] -= col_j[i*BS+b] * l_kj[b];
+            }
+         }
+      }
+   }
+}
+
+// X <- L^{-t} L^{-1} X, X is m x r.
+static void BatchCholeskySolve(int m, int r, const double *l, double *x)
+{
+   double x_j[BS];
+   for (int k = 0; k < r; k++, x += m*BS)
+   {
+      for (int j = 0; j < m; j++)
+      {
+         const double *col_j = l + j*m*BS;
+         for (int b = 0; b < BS; b++)
+         {
+            x_j[b] = ( x[j*BS+b] /= col_j[j*BS+b] );
+         }
+         for (int i = j+1; i < m; i++)
+         {
+            for (int b = 0; b < BS; b++)
+            {
+               x[i*BS+b] -= col_j[i*BS+b] * x_j[b];
+            }
+         }
+      }
+      for (int j = m-1; j >= 0; j--)
+      {
+         const double *col_j = l + j*m*BS;
+         for (int b = 0; b < BS; b++)
+         {
+            x_j[b] = x[j*BS+b];
+         }
+         for (int i = j+1; i < m; i++)
+         {
+            for (int b = 0; b < BS; b++)
+            {
+               x_j[b] -= col_j[i*BS+b] * x[i*BS+b];
+            }
+         }
+         for (int b = 0; b < BS; b++)
+         {
+            x[j*BS+b] = x_j[b] / col_j[j*BS+b];
+         }
+      }
+   }
+}
+
+void DenseBatch::LUFactor(int nmat, const int *m, double *const *A,
+                          int *const *ipiv)
+{
+   Array<int> order, offsets;
+   MakeBatches(nmat, m, NULL, order, offsets);
+   const int nbatch = offsets.Size()-1;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      Array<double> buf;
+      Array<int> piv;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for schedule(dynamic)
+#endif
+      for (int t = 0; t < nbatch; t++)
+      {
+         const int *idx = order.GetData() + offsets[t];
+         const int nb = offsets[t+1] - offsets[t];
+         const int mt = m[idx[0]];
+         buf.SetSize(BS*mt*mt);
+         piv.SetSize(BS*mt);
+         Pack(mt*mt, mt, A, idx, nb, buf, true);
+         BatchLUFactor(mt, buf, piv);
+         Unpack(mt*mt, buf, A, idx, nb);
+         UnpackPivots(mt, piv, ipiv, idx, nb);
+      }
+   }
+}
+
+void DenseBatch::LUBlockFactor(int nmat, const int *m, const int *n,
+                               double *const *A, int *const *ipiv,
+                               double *const *A12, double *const *A21,
+                               double *const *A22, int *const *ipiv22)
+{
+   Array<int> order, offsets;
+   MakeBatches(nmat, m, n, order, offsets);
+   const int nbatch = offsets.Size()-1;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      Array<double> buf;
+      Array<int> piv;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for schedule(dynamic)
+#endif
+      for (int t = 0; t < nbatch; t++)
+      {
+         const int *idx = order.GetData() + offsets[t];
+         const int nb = offsets[t+1] - offsets[t];
+         const int mt = m[idx[0]], nt = n[idx[0]];
+         buf.SetSize(BS*(mt+nt)*(mt+nt));
+         piv.SetSize(BS*(mt+nt));
+         double *a = buf, *a12 = a + BS*mt*mt, *a21 = a12 + BS*mt*nt;
+         double *a22 = a21 + BS*nt*mt;
+         int *piv22 = piv + BS*mt;
+         Pack(mt*mt, mt, A, idx, nb, a, true);
+         Pack(mt*nt, mt, A12, idx, nb, a12, false);
+         Pack(nt*mt, nt, A21, idx, nb, a21, false);
+         Pack(nt*nt, nt, A22, idx, nb, a22, true);
+         BatchLUFactor(mt, a, piv);
+         BatchBlockFactor(mt, nt, a, piv, a12, a21, a22);
+         if (ipiv22) { BatchLUFactor(nt, a22, piv22); }
+         Unpack(mt*mt, a, A, idx, nb);
+         Unpack(mt*nt, a12, A12, idx, nb);
+         Unpack(nt*mt, a21, A21, idx, nb);
+         Unpack(nt*nt, a22, A22, idx, nb);
+         UnpackPivots(mt, piv, ipiv, idx, nb);
+         if (ipiv22) { UnpackPivots(nt, piv22, ipiv22, idx, nb); }
+      }
+   }
+}
+
+void DenseBatch::LUSolve(int nmat, const int *m, const int *r,
+                         const double *const *LU, const int *const *ipiv,
+                         double *const *X)
+{
+   Array<int> order, offsets;
+   MakeBatches(nmat, m, r, order, offsets);
+   const int nbatch = offsets.Size()-1;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      Array<double> buf;
+      Array<int> piv;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for schedule(dynamic)
+#endif
+      for (int t = 0; t < nbatch; t++)
+      {
+         const int *idx = order.GetData() + offsets[t];
+         const int nb = offsets[t+1] - offsets[t];
+         const int mt = m[idx[0]], rt = r[idx[0]];
+         buf.SetSize(BS*mt*(mt+rt));
+         piv.SetSize(BS*mt);
+         double *a = buf, *x = a + BS*mt*mt;
+         Pack(mt*mt, mt, LU, idx, nb, a, true);
+         Pack(mt*rt, mt, X, idx, nb, x, false);
+         PackPivots(mt, ipiv, idx, nb, piv);
+         BatchLSolve(mt, rt, a, piv, x);
+         BatchUSolve(mt, rt, a, x);
+         Unpack(mt*rt, x, X, idx, nb);
+      }
+   }
+}
+
+void DenseBatch::CholeskyFactor(int nmat, const int *m, double *const *A)
+{
+   Array<int> order, offsets;
+   MakeBatches(nmat, m, NULL, order, offsets);
+   const int nbatch = offsets.Size()-1;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      Array<double> buf;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for schedule(dynamic)
+#endif
+      for (int t = 0; t < nbatch; t++)
+      {
+         const int *idx = order.GetData() + offsets[t];
+         const int nb = offsets[t+1] - offsets[t];
+         const int mt = m[idx[0]];
+         buf.SetSize(BS*mt*mt);
+         Pack(mt*mt, mt, A, idx, nb, buf, true);
+         BatchCholeskyFactor(mt, buf);
+         Unpack(mt*mt, buf, A, idx, nb);
+      }
+   }
+}
+
+void DenseBatch::CholeskySolve(int nmat, const int *m, const int *r,
+                               const double *const *L, double *const *X)
+{
+   Array<int> order, offsets;
+   MakeBatches(nmat, m, r, order, offsets);
+   const int nbatch = offsets.Size()-1;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      Array<double> buf;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for schedule(dynamic)
+#endif
+      for (int t = 0; t < nbatch; t++)
+      {
+         const int *idx = order.GetData() + offsets[t];
+         const int nb = offsets[t+1] - offsets[t];
+         const int mt = m[idx[0]], rt = r[idx[0]];
+         buf.SetSize(BS*mt*(mt+rt));
+         double *l = buf, *x = l + BS*mt*mt;
+         Pack(mt*mt, mt, L, idx, nb, l, true);
+         Pack(mt*rt, mt, X, idx, nb, x, false);
+         BatchCholeskySolve(mt, rt, l, x);
+         Unpack(mt*rt, x, X, idx, nb);
+      }
+   }
+}
+
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_DENSEBATCH
+#define MFEM_DENSEBATCH
+
+#include "../config/config.hpp"
+#include <cstddef>
+
+namespace mfem
+{
+
+/** @brief Batched factorizations and solves of many small dense matrices,
+    e.g. the element blocks of static condensation and hybridization.
+
+    Every method takes @a nmat independent problems, where the k-th problem
+    uses the column-major arrays A[k], ipiv[k], etc. of sizes given by m[k]
+    (and n[k] or r[k]). The problems are sorted by size, and the problems of
+    equal size are processed in batches of batch_size matrices, interleaved
+    so that entry (i,j) of the b-th matrix of a batch is stored at
+    (i + j*m)*batch_size + b. The loops over the batch are innermost and have
+    a fixed length, so they are vectorized by the compiler. With OpenMP, the
+    batches are processed in parallel.
+
+    The results are the same as those of LUFactors (without LAPACK) applied to
+    each matrix, and the LU factors and pivots can be used with LUFactors. */
+class DenseBatch
+{
+public:
+   /// Number of matrices in a batch.
+   static const int batch_size = 8;
+
+   /** @brief LU factorization with partial pivoting, as in
+       LUFactors::Factor(), of the m[k] x m[k] matrices A[k] with the pivots
+       ipiv[k]. */
+   static void LUFactor(int nmat, const int *m, double *const *A,
+                        int *const *ipiv);
+
+   /** @brief LU factorization of the matrices A[k] followed by
+       LUFactors::BlockFactor() with the blocks A12[k] (m[k] x n[k]), A21[k]
+       (n[k] x m[k]) and A22[k] (n[k] x n[k]), which is overwritten with the
+       Schur complement A22 - A21 A^{-1} A12. If @a ipiv22 is not NULL, the
+       Schur complements are also LU factored, with the pivots ipiv22[k]. */
+   static void LUBlockFactor(int nmat, const int *m, const int *n,
+                             double *const *A, int *const *ipiv,
+                             double *const *A12, double *const *A21,
+                             double *const *A22, int *const *ipiv22 = NULL);
+
+   /** @brief Solve A[k] X[k] = B[k] where A[k] is given by its LU factors and
+       pivots from LUFactor() and the m[k] x r[k] matrix X[k] contains B[k] on
+       input. */
+   static void LUSolve(int nmat, const int *m, const int *r,
+                       const double *const *LU, const int *const *ipiv,
+                       double *const *X);
+
+   /** @brief Cholesky factorization A = L L^t of the symmetric positive
+       definite m[k] x m[k] matrices A[k]; L is stored in the lower triangular
+       part of A[k], the strictly upper triangular part is not used. */
+   static void CholeskyFactor(int nmat, const int *m, double *const *A);
+
+   /** @brief Solve A[k] X[k] = B[k] where A[k] is given by its Cholesky factor
+       from CholeskyFactor() and the m[k] x r[k] matrix X[k] contains B[k] on
+       input. */
+   static void CholeskySolve(int nmat, const int *m, const int *r,
+                             const double *const *L, double *const *X);
+};
+
+}
+
+#endif
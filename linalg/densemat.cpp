@@ -196,6 +196,32 @@ void DenseMatrix::Mult(const double *x, double *y) const
    }
 }
 
+void DenseMatrix::ArrayMult(const Array<const Vector *> &X,
+                            Array<Vector *> &Y) const
+{
+   MFEM_ASSERT(X.Size() == Y.Size(), "incompatible numbers of vectors");
+   const int nv = X.Size();
+   for (int c = 0; c < nv; c++)
+   {
+      MFEM_ASSERT(X[c]->Size() == width && Y[c]->Size() == height,
+                  "incompatible size of vector " << c);
+      *Y[c] = 0.0;
+   }
+   const double *d_col = data;
+   for (int col = 0; col < width; col++, d_col += height)
+   {
+      for (int c = 0; c < nv; c++)
+      {
+         const double x_col = (*X[c])(col);
+         double *y = Y[c]->GetData();
+         for (int row = 0; row < height; row++)
+         {
+            y[row] += x_col*d_col[row];
+         }
+      }
+   }
+}
+
 void DenseMatrix::Mult(const Vector &x, Vector &y) const
 {
    MFEM_ASSERT(height == y.Size() && width == x.Size(),
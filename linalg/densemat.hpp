@@ -121,6 +121,11 @@ public:
    /// Matrix vector multiplication.
    virtual void Mult(const Vector &x, Vector &y) const;
 
+   /** @brief Matrix multiplication of a set of vectors, `Y[i] = A * X[i]`,
+       reading every column of the matrix once for all vectors. */
+   virtual void ArrayMult(const Array<const Vector *> &X,
+                          Array<Vector *> &Y) const;
+
    /// Multiply a vector with the transpose matrix.
    void MultTranspose(const double *x, double *y) const;
 
@@ -18,14 +18,17 @@
 #include "operator.hpp"
 #include "matrix.hpp"
 #include "sparsemat.hpp"
+#include "sparseformats.hpp"
 #include "complex_operator.hpp"
 #include "blockvector.hpp"
 #include "blockmatrix.hpp"
 #include "blockoperator.hpp"
 #include "sparsesmoothers.hpp"
 #include "densemat.hpp"
+#include "densebatch.hpp"
 #include "ode.hpp"
 #include "solvers.hpp"
+#include "amg.hpp"
 #include "handle.hpp"
 #include "invariants.hpp"
 
@@ -12,6 +12,9 @@
 #include "operator.hpp"
 #include "ode.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 namespace mfem
 {
 
@@ -337,6 +340,162 @@ const double RK8Solver::c[] =
    1.,
 };
 
+LowStorageRKSolver::LowStorageRKSolver(int _s, const double *_A,
+                                       const double *_B, const double *_c)
+{
+   s = _s;
+   A = _A;
+   B = _B;
+   c = _c;
+}
+
+void LowStorageRKSolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   int n = f->Width();
+   dx.SetSize(n);
+   k.SetSize(n);
+}
+
+void LowStorageRKSolver::Step(Vector &x, double &t, double &dt)
+{
+   for (int i = 0; i < s; i++)
+   {
+      f->SetTime(t + c[i]*dt);
+      f->Mult(x, k);
+      if (i == 0)
+      {
+         dx.Set(dt, k);
+      }
+      else
+      {
+         add(A[i], dx, dt, k, dx);
+      }
+      x.Add(B[i], dx);
+   }
+   t += dt;
+}
+
+const double LowStorageRK4Solver::A[] =
+{
+   0.,
+   -567301805773./1357537059087.,
+   -2404267990393./2016746695238.,
+   -3550918686646./2091501179385.,
+   -1275806237668./842570457699.
+};
+const double LowStorageRK4Solver::B[] =
+{
+   1432997174477./9575080441755.,
+   5161836677717./13612068292357.,
+   1720146321549./2090206949498.,
+   3134564353537./4481467310338.,
+   2277821191437./14882151754819.
+};
+const double LowStorageRK4Solver::c[] =
+{
+   0.,
+   1432997174477./9575080441755.,
+   2526269341429./6820363962896.,
+   2006345519317./3224310063776.,
+   2802321613138./2924317926251.
+};
+
+
+void RK4SSPSolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   int n = f->Width();
+   y.SetSize(n);
+   k.SetSize(n);
+}
+
+void RK4SSPSolver::Step(Vector &x, double &t, double &dt)
+{
+   // y = x; five forward Euler stages of size dt/6 on x
+   y = x;
+   for (int i = 0; i < 5; i++)
+   {
+      f->SetTime(t + i*dt/6);
+      f->Mult(x, k);
+      x.Add(dt/6, k);
+   }
+   // y = 1/25*y + 9/25*x, x = 15*y - 5*x; x is now at time t + dt/3
+   add(1./25, y, 9./25, x, y);
+   add(15., y, -5., x, x);
+   for (int i = 0; i < 4; i++)
+   {
+      f->SetTime(t + (2 + i)*dt/6);
+      f->Mult(x, k);
+      x.Add(dt/6, k);
+   }
+   // x = y + 3/5*x + dt/10*f(x)
+   f->SetTime(t + dt);
+   f->Mult(x, k);
+   add(y, 3./5, x, x);
+   x.Add(dt/10, k);
+   t += dt;
+}
+
+
+static const double AdamsBashforthCoeffs[5][5] =
+{
+   { 1. },
+   { 3./2., -1./2. },
+   { 23./12., -16./12., 5./12. },
+   { 55./24., -59./24., 37./24., -9./24. },
+   { 1901./720., -2774./720., 2616./720., -1274./720., 251./720. }
+};
+
+AdamsBashforthSolver::AdamsBashforthSolver(int order)
+{
+   MFEM_VERIFY(1 <= order && order <= 5, "invalid order: " << order);
+   s = order;
+   b = AdamsBashforthCoeffs[s-1];
+   k = new Vector[s];
+   newest = num_hist = 0;
+   dt_prev = 0.0;
+}
+
+void AdamsBashforthSolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   for (int i = 0; i < s; i++)
+   {
+      k[i].SetSize(f->Width());
+   }
+   start_solver.Init(_f);
+   newest = num_hist = 0;
+}
+
+void AdamsBashforthSolver::Step(Vector &x, double &t, double &dt)
+{
+   // the coefficients assume a constant step size: restart if it changes
+   if (std::abs(dt - dt_prev) > 1e-12*std::abs(dt)) { num_hist = 0; }
+   dt_prev = dt;
+
+   newest = (newest + 1) % s;
+   f->SetTime(t);
+   f->Mult(x, k[newest]);
+   num_hist = std::min(num_hist + 1, s);
+   if (num_hist < s)
+   {
+      start_solver.Step(x, t, dt);
+      return;
+   }
+
+   for (int i = 0; i < s; i++)
+   {
+      x.Add(b[i]*dt, k[(newest + s - i) % s]);
+   }
+   t += dt;
+}
+
+AdamsBashforthSolver::~AdamsBashforthSolver()
+{
+   delete [] k;
+}
+
 
 void BackwardEulerSolver::Init(TimeDependentOperator &_f)
 {
@@ -485,6 +644,422 @@ void SDIRK33Solver::Step(Vector &x, double &t, double &dt)
    t += dt;
 }
 
+// x_{n+1} = sum_j alpha_j x_{n-j} + beta dt f(x_{n+1}, t_{n+1})
+static const double BDFAlpha[4][4] =
+{
+   { 1. },
+   { 4./3., -1./3. },
+   { 18./11., -9./11., 2./11. },
+   { 48./25., -36./25., 16./25., -3./25. }
+};
+static const double BDFBeta[4] = { 1., 2./3., 6./11., 12./25. };
+
+BDFSolver::BDFSolver(int order)
+{
+   MFEM_VERIFY(1 <= order && order <= 4, "invalid order: " << order);
+   s = order;
+   alpha = BDFAlpha[s-1];
+   beta = BDFBeta[s-1];
+   // x holds the newest solution, only the s-1 previous ones are stored
+   xh = new Vector[s-1];
+   newest = num_hist = 0;
+   dt_prev = 0.0;
+   if (s < 4)
+   {
+      start_solver = new SDIRK33Solver;
+   }
+   else
+   {
+      start_solver = new SDIRK34Solver;
+   }
+}
+
+void BDFSolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   int n = f->Width();
+   for (int i = 0; i < s-1; i++)
+   {
+      xh[i].SetSize(n);
+   }
+   k.SetSize(n);
+   y.SetSize(n);
+   start_solver->Init(_f);
+   newest = num_hist = 0;
+}
+
+void BDFSolver::Step(Vector &x, double &t, double &dt)
+{
+   const int m = s-1;
+
+   // the coefficients assume a constant step size: restart if it changes
+   if (std::abs(dt - dt_prev) > 1e-12*std::abs(dt)) { num_hist = 0; }
+   dt_prev = dt;
+
+   if (num_hist < m)
+   {
+      newest = (newest + 1) % m;
+      xh[newest] = x;
+      num_hist++;
+      start_solver->Step(x, t, dt);
+      return;
+   }
+
+   y.Set(alpha[0], x);
+   for (int j = 1; j < s; j++)
+   {
+      y.Add(alpha[j], xh[(newest + m - (j-1)) % m]);
+   }
+   if (m > 0)
+   {
+      newest = (newest + 1) % m;
+      xh[newest] = x;
+   }
+
+   f->SetTime(t + dt);
+   f->ImplicitSolve(beta*dt, y, k);
+   add(y, beta*dt, k, x);
+   t += dt;
+}
+
+BDFSolver::~BDFSolver()
+{
+   delete start_solver;
+   delete [] xh;
+}
+
+
+ODEWeightedRMSNorm::ODEWeightedRMSNorm(double rtol_, double atol_)
+   : rtol(rtol_), atol(atol_)
+{
+#ifdef MFEM_USE_MPI
+   comm = MPI_COMM_NULL;
+#endif
+}
+
+#ifdef MFEM_USE_MPI
+ODEWeightedRMSNorm::ODEWeightedRMSNorm(MPI_Comm comm_, double rtol_,
+                                       double atol_)
+   : rtol(rtol_), atol(atol_), comm(comm_) { }
+#endif
+
+double ODEWeightedRMSNorm::Eval(const Vector &err, const Vector &x_old,
+                                const Vector &x_new)
+{
+   double loc[2] = { 0.0, double(err.Size()) };
+   for (int i = 0; i < err.Size(); i++)
+   {
+      const double w =
+         atol + rtol*std::max(std::abs(x_old(i)), std::abs(x_new(i)));
+      loc[0] += (err(i)/w)*(err(i)/w);
+   }
+#ifdef MFEM_USE_MPI
+   if (comm != MPI_COMM_NULL)
+   {
+      double glob[2];
+      MPI_Allreduce(loc, glob, 2, MPI_DOUBLE, MPI_SUM, comm);
+      loc[0] = glob[0];
+      loc[1] = glob[1];
+   }
+#endif
+   return (loc[1] > 0.0) ? std::sqrt(loc[0]/loc[1]) : 0.0;
+}
+
+
+double ODEStepController::Update(double err, int p, bool &accept)
+{
+   const double e = std::max(err, 1e-10);
+   double factor;
+   accept = (err <= 1.0);
+   if (accept)
+   {
+      factor = safety*std::pow(e, -k1/p);
+      if (err1 > 0.0) { factor *= std::pow(err1, k2/p); }
+      if (err2 > 0.0) { factor *= std::pow(err2, -k3/p); }
+      // do not grow the step right after a rejection
+      if (rejected) { factor = std::min(factor, 1.0); }
+      err2 = err1;
+      err1 = e;
+      rejected = false;
+   }
+   else
+   {
+      factor = safety*std::pow(e, -1.0/p);
+      rejected = true;
+   }
+   // the negated test also catches a NaN error
+   if (!(factor >= min_factor)) { factor = min_factor; }
+   return std::min(factor, max_factor);
+}
+
+
+AdaptiveODESolver::AdaptiveODESolver(int est_order_)
+   : est_order(est_order_), norm(new ODEWeightedRMSNorm), own_norm(true),
+     dt_next(-1.0), dt_min(0.0), max_rejections(50), num_steps(0),
+     num_rejected(0) { }
+
+void AdaptiveODESolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   x_new.SetSize(f->Width());
+   err.SetSize(f->Width());
+   controller.Reset();
+   dt_next = -1.0;
+   num_steps = num_rejected = 0;
+}
+
+void AdaptiveODESolver::SetTolerances(double rtol, double atol)
+{
+   if (!own_norm)
+   {
+      norm = new ODEWeightedRMSNorm;
+      own_norm = true;
+   }
+   static_cast<ODEWeightedRMSNorm*>(norm)->SetTolerances(rtol, atol);
+}
+
+void AdaptiveODESolver::SetErrorNorm(ODEErrorNorm &norm_)
+{
+   if (own_norm) { delete norm; }
+   norm = &norm_;
+   own_norm = false;
+}
+
+void AdaptiveODESolver::Step(Vector &x, double &t, double &dt)
+{
+   double h = (dt_next > 0.0) ? std::min(dt, dt_next) : dt;
+   for (int rejections = 0; true; rejections++)
+   {
+      MFEM_VERIFY(h > dt_min && rejections <= max_rejections,
+                  "time step size " << h << " at t = " << t
+                  << " is too small");
+      TryStep(x, t, h, x_new, err);
+
+      bool accept;
+      const double factor =
+         controller.Update(norm->Eval(err, x, x_new), est_order + 1, accept);
+      dt_next = h*factor;
+      if (accept) { break; }
+      num_rejected++;
+      h = dt_next;
+   }
+   x = x_new;
+   t += h;
+   dt = h;
+   num_steps++;
+   StepAccepted();
+}
+
+void AdaptiveODESolver::Run(Vector &x, double &t, double &dt, double tf)
+{
+   const double dt_max = dt;
+   while (t < tf)
+   {
+      dt = std::min(dt_max, tf - t);
+      Step(x, t, dt);
+   }
+}
+
+AdaptiveODESolver::~AdaptiveODESolver()
+{
+   if (own_norm) { delete norm; }
+}
+
+
+EmbeddedRKSolver::EmbeddedRKSolver(int _s, const double *_a, const double *_b,
+                                   const double *_bh, const double *_c,
+                                   int est_order_)
+   : AdaptiveODESolver(est_order_)
+{
+   s = _s;
+   a = _a;
+   b = _b;
+   bh = _bh;
+   c = _c;
+   k = new Vector[s];
+   k0_valid = false;
+
+   // FSAL: the last stage is evaluated at the new solution
+   fsal = (c[s-2] == 1.0 && b[s-1] == 0.0);
+   for (int j = 0, l = (s-1)*(s-2)/2; fsal && j < s-1; j++)
+   {
+      fsal = (a[l+j] == b[j]);
+   }
+}
+
+void EmbeddedRKSolver::Init(TimeDependentOperator &_f)
+{
+   AdaptiveODESolver::Init(_f);
+   int n = f->Width();
+   y.SetSize(n);
+   for (int i = 0; i < s; i++)
+   {
+      k[i].SetSize(n);
+   }
+   k0_valid = false;
+}
+
+void EmbeddedRKSolver::TryStep(const Vector &x, double t, double dt,
+                               Vector &x_new, Vector &err)
+{
+   // the first stage does not depend on dt: it is reused by retried steps
+   if (!k0_valid)
+   {
+      f->SetTime(t);
+      f->Mult(x, k[0]);
+      k0_valid = true;
+   }
+   for (int l = 0, i = 1; i < s; i++)
+   {
+      add(x, a[l++]*dt, k[0], y);
+      for (int j = 1; j < i; j++)
+      {
+         y.Add(a[l++]*dt, k[j]);
+      }
+
+      f->SetTime(t + c[i-1]*dt);
+      f->Mult(y, k[i]);
+   }
+   if (fsal)
+   {
+      x_new = y;
+   }
+   else
+   {
+      x_new = x;
+      for (int i = 0; i < s; i++)
+      {
+         x_new.Add(b[i]*dt, k[i]);
+      }
+   }
+   err = 0.0;
+   for (int i = 0; i < s; i++)
+   {
+      err.Add((b[i] - bh[i])*dt, k[i]);
+   }
+}
+
+void EmbeddedRKSolver::StepAccepted()
+{
+   if (fsal)
+   {
+      k[0].Swap(k[s-1]);
+   }
+   else
+   {
+      k0_valid = false;
+   }
+}
+
+EmbeddedRKSolver::~EmbeddedRKSolver()
+{
+   delete [] k;
+}
+
+const double BogackiShampineSolver::a[] =
+{
+   1./2.,
+   0., 3./4.,
+   2./9., 1./3., 4./9.
+};
+const double BogackiShampineSolver::b[] = { 2./9., 1./3., 4./9., 0. };
+const double BogackiShampineSolver::bh[] = { 7./24., 1./4., 1./3., 1./8. };
+const double BogackiShampineSolver::c[] = { 1./2., 3./4., 1. };
+
+const double DormandPrinceSolver::a[] =
+{
+   1./5.,
+   3./40., 9./40.,
+   44./45., -56./15., 32./9.,
+   19372./6561., -25360./2187., 64448./6561., -212./729.,
+   9017./3168., -355./33., 46732./5247., 49./176., -5103./18656.,
+   35./384., 0., 500./1113., 125./192., -2187./6784., 11./84.
+};
+const double DormandPrinceSolver::b[] =
+{
+   35./384., 0., 500./1113., 125./192., -2187./6784., 11./84., 0.
+};
+const double DormandPrinceSolver::bh[] =
+{
+   5179./57600., 0., 7571./16695., 393./640., -92097./339200., 187./2100.,
+   1./40.
+};
+const double DormandPrinceSolver::c[] =
+{
+   1./5., 3./10., 4./5., 8./9., 1., 1.
+};
+
+
+EmbeddedSDIRKSolver::EmbeddedSDIRKSolver(int _s, const double *_a,
+                                         const double *_b, const double *_bh,
+                                         const double *_c, int est_order_)
+   : AdaptiveODESolver(est_order_)
+{
+   s = _s;
+   a = _a;
+   b = _b;
+   bh = _bh;
+   c = _c;
+   k = new Vector[s];
+}
+
+void EmbeddedSDIRKSolver::Init(TimeDependentOperator &_f)
+{
+   AdaptiveODESolver::Init(_f);
+   int n = f->Width();
+   y.SetSize(n);
+   for (int i = 0; i < s; i++)
+   {
+      k[i].SetSize(n);
+   }
+}
+
+void EmbeddedSDIRKSolver::TryStep(const Vector &x, double t, double dt,
+                                  Vector &x_new, Vector &err)
+{
+   for (int l = 0, i = 0; i < s; i++)
+   {
+      y = x;
+      for (int j = 0; j < i; j++)
+      {
+         y.Add(a[l++]*dt, k[j]);
+      }
+
+      f->SetTime(t + c[i]*dt);
+      f->ImplicitSolve(a[l++]*dt, y, k[i]);
+   }
+   x_new = x;
+   err = 0.0;
+   for (int i = 0; i < s; i++)
+   {
+      x_new.Add(b[i]*dt, k[i]);
+      err.Add((b[i] - bh[i])*dt, k[i]);
+   }
+}
+
+EmbeddedSDIRKSolver::~EmbeddedSDIRKSolver()
+{
+   delete [] k;
+}
+
+const double SDIRK54Solver::a[] =
+{
+   1./4.,
+   1./2., 1./4.,
+   17./50., -1./25., 1./4.,
+   371./1360., -137./2720., 15./544., 1./4.,
+   25./24., -49./48., 125./16., -85./12., 1./4.
+};
+const double SDIRK54Solver::b[] =
+{
+   25./24., -49./48., 125./16., -85./12., 1./4.
+};
+const double SDIRK54Solver::bh[] =
+{
+   59./48., -17./96., 225./32., -85./12., 0.
+};
+const double SDIRK54Solver::c[] = { 1./4., 3./4., 11./20., 1./2., 1. };
+
 
 void GeneralizedAlphaSolver::Init(TimeDependentOperator &_f)
 {
@@ -14,6 +14,9 @@
 
 #include "../config/config.hpp"
 #include "operator.hpp"
+#ifdef MFEM_USE_MPI
+#include <mpi.h>
+#endif
 
 namespace mfem
 {
@@ -208,6 +211,87 @@ public:
 };
 
 
+/** @brief A low-storage explicit Runge-Kutta method in the 2N form of
+    Williamson.
+
+    Stage i, i = 0,...,s-1, computes
+       dx = A[i]*dx + dt*f(x, t + c[i]*dt),   x = x + B[i]*dx,
+    with A[0] = 0, so the method needs only two vectors of the size of the
+    solution, independently of the number of stages. */
+class LowStorageRKSolver : public ODESolver
+{
+private:
+   int s;
+   const double *A, *B, *c;
+   Vector dx, k;
+
+public:
+   LowStorageRKSolver(int _s, const double *_A, const double *_B,
+                      const double *_c);
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual void Step(Vector &x, double &t, double &dt);
+};
+
+
+/** The five-stage, fourth-order low-storage Runge-Kutta method of Carpenter
+    and Kennedy, "Fourth-order 2N-storage Runge-Kutta schemes", NASA TM-109112
+    (1994). Its stability region is larger than that of RK4Solver, which it
+    can replace with one fewer solution-size vector. */
+class LowStorageRK4Solver : public LowStorageRKSolver
+{
+private:
+   static const double A[5], B[5], c[5];
+
+public:
+   LowStorageRK4Solver() : LowStorageRKSolver(5, A, B, c) { }
+};
+
+
+/** Ten-stage, fourth-order strong stability preserving (SSP) Runge-Kutta
+    method with SSP coefficient 6, in the low-storage form of Ketcheson,
+    "Highly efficient strong stability preserving Runge-Kutta methods with
+    low-storage implementations", SIAM J. Sci. Comput. 30(4) (2008). Needs two
+    solution-size vectors. */
+class RK4SSPSolver : public ODESolver
+{
+private:
+   Vector y, k;
+
+public:
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual void Step(Vector &x, double &t, double &dt);
+};
+
+
+/** @brief Adams-Bashforth multistep method of order 1 to 5.
+
+    Each step evaluates the operator once and reuses the results of the
+    previous @a order - 1 steps; the first steps (and the steps after a
+    change of the step size, which restart the method) are made with
+    RK4Solver. */
+class AdamsBashforthSolver : public ODESolver
+{
+private:
+   int s, newest, num_hist;
+   double dt_prev;
+   const double *b;
+   Vector *k; // previous operator values, newest at k[newest]
+   RK4Solver start_solver;
+
+public:
+   AdamsBashforthSolver(int order = 4);
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual void Step(Vector &x, double &t, double &dt);
+
+   virtual ~AdamsBashforthSolver();
+};
+
+
 /// Backward Euler ODE solver. L-stable.
 class BackwardEulerSolver : public ODESolver
 {
@@ -283,6 +367,302 @@ public:
 };
 
 
+/** @brief Backward differentiation formula (BDF) of order 1 to 4; order 1 is
+    the backward Euler method, orders 1 and 2 are L-stable.
+
+    Each step makes one call to TimeDependentOperator::ImplicitSolve() and
+    reuses the solutions of the previous @a order - 1 steps; the first steps
+    (and the steps after a change of the step size, which restart the method)
+    are made with SDIRK33Solver, or SDIRK34Solver for order 4. */
+class BDFSolver : public ODESolver
+{
+private:
+   int s, newest, num_hist;
+   double dt_prev;
+   const double *alpha;
+   double beta;
+   Vector *xh; // previous solutions, newest at xh[newest]
+   Vector k, y;
+   ODESolver *start_solver;
+
+public:
+   BDFSolver(int order = 2);
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual void Step(Vector &x, double &t, double &dt);
+
+   virtual ~BDFSolver();
+};
+
+
+/// Abstract norm of the local error estimate of an AdaptiveODESolver.
+class ODEErrorNorm
+{
+public:
+   /** @brief Return the norm of the error estimate @a err of the step from
+       @a x_old to @a x_new, scaled so that the step is accepted when the
+       result is at most 1. */
+   virtual double Eval(const Vector &err, const Vector &x_old,
+                       const Vector &x_new) = 0;
+
+   virtual ~ODEErrorNorm() { }
+};
+
+
+/** @brief Weighted root-mean-square norm of the error estimate: the entry
+    err_i is scaled by 1/(atol + rtol*max(|x_old_i|, |x_new_i|)).
+
+    With MPI, the norm constructed with a communicator is global, so that all
+    ranks accept or reject the same steps. */
+class ODEWeightedRMSNorm : public ODEErrorNorm
+{
+protected:
+   double rtol, atol;
+#ifdef MFEM_USE_MPI
+   MPI_Comm comm;
+#endif
+
+public:
+   ODEWeightedRMSNorm(double rtol_ = 1e-4, double atol_ = 1e-8);
+
+#ifdef MFEM_USE_MPI
+   ODEWeightedRMSNorm(MPI_Comm comm_, double rtol_ = 1e-4,
+                      double atol_ = 1e-8);
+#endif
+
+   void SetTolerances(double rtol_, double atol_)
+   { rtol = rtol_; atol = atol_; }
+
+   virtual double Eval(const Vector &err, const Vector &x_old,
+                       const Vector &x_new);
+};
+
+
+/** @brief Time step size controller of an AdaptiveODESolver.
+
+    After a step of size dt with scaled error estimate e_n (see ODEErrorNorm),
+    the next step size is
+       dt * safety * e_n^(-k1/p) * e_{n-1}^(k2/p) * e_{n-2}^(-k3/p),
+    where p is the order of the error estimate plus one and e_{n-1}, e_{n-2}
+    are the errors of the previous accepted steps. The step is accepted when
+    e_n <= 1; a rejected step is retried with the factor safety * e_n^(-1/p),
+    and the step after a rejection is not allowed to grow. All factors are
+    limited to [min_factor, max_factor]. */
+class ODEStepController
+{
+protected:
+   double k1, k2, k3;
+   double safety, min_factor, max_factor;
+   double err1, err2; // errors of the previous accepted steps
+   bool rejected;
+
+public:
+   /// Construct a PI controller with the default gains.
+   ODEStepController()
+   { SetPI(); SetSafetyFactor(); SetFactorBounds(); Reset(); }
+
+   /// Elementary controller: k1 = 1, k2 = k3 = 0.
+   void SetI() { k1 = 1.0; k2 = k3 = 0.0; }
+
+   /// PI controller; the default gains are those of Hairer and Wanner.
+   void SetPI(double k1_ = 0.7, double k2_ = 0.4)
+   { k1 = k1_; k2 = k2_; k3 = 0.0; }
+
+   /// PID controller; the default gains are those of Soderlind.
+   void SetPID(double k1_ = 0.58, double k2_ = 0.21, double k3_ = 0.10)
+   { k1 = k1_; k2 = k2_; k3 = k3_; }
+
+   void SetSafetyFactor(double safety_ = 0.9) { safety = safety_; }
+
+   void SetFactorBounds(double min_f = 0.2, double max_f = 5.0)
+   { min_factor = min_f; max_factor = max_f; }
+
+   /// Forget the error history, e.g. when the time stepping is restarted.
+   void Reset() { err1 = err2 = -1.0; rejected = false; }
+
+   /** @brief Decide whether the step with scaled error @a err is accepted and
+       return the factor of the size of the next (or retried) step; @a p is
+       the order of the error estimate plus one. */
+   double Update(double err, int p, bool &accept);
+};
+
+
+/** @brief Base class of the ODE solvers with an embedded error estimate and
+    an automatic choice of the time step size.
+
+    A call to Step() performs one accepted step. Its size is the step proposed
+    by the controller after the previous step, but not larger than the input
+    @a dt, which is the size of the first step and an upper bound for the
+    others. This fits the usual loop
+       dt_real = min(dt_max, t_final - t); ode_solver->Step(x, t, dt_real);
+    where the output @a dt is the size of the step taken. Rejected steps are
+    retried with smaller sizes. The number of steps and rejections and the
+    proposed next step size can be queried.
+
+    In parallel, the error norm must be global (see ODEWeightedRMSNorm), so
+    that all ranks take the same steps. */
+class AdaptiveODESolver : public ODESolver
+{
+protected:
+   /// Order of the error estimate.
+   int est_order;
+   ODEStepController controller;
+   ODEErrorNorm *norm;
+   bool own_norm;
+   Vector x_new, err;
+   double dt_next, dt_min;
+   int max_rejections, num_steps, num_rejected;
+
+   /** @brief Compute the solution @a x_new at @a t + @a dt and the local error
+       estimate @a err, starting from @a x at @a t. */
+   virtual void TryStep(const Vector &x, double t, double dt,
+                        Vector &x_new, Vector &err) = 0;
+
+   /// Called after an accepted step, e.g. to reuse the last stage.
+   virtual void StepAccepted() { }
+
+public:
+   AdaptiveODESolver(int est_order_);
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   /// Use the default weighted RMS error norm with the given tolerances.
+   void SetTolerances(double rtol, double atol);
+
+   /// Use the given norm of the error estimate; it is not owned.
+   void SetErrorNorm(ODEErrorNorm &norm_);
+
+   ODEStepController &GetController() { return controller; }
+
+   /// Abort when a step of size below @a dt_min_ would be needed.
+   void SetMinTimeStep(double dt_min_) { dt_min = dt_min_; }
+
+   void SetMaxRejections(int max_rej) { max_rejections = max_rej; }
+
+   /// The step size proposed by the controller for the next step.
+   double GetProposedTimeStep() const { return dt_next; }
+
+   int GetNumSteps() const { return num_steps; }
+   int GetNumRejectedSteps() const { return num_rejected; }
+
+   virtual void Step(Vector &x, double &t, double &dt);
+
+   /** @brief Integrate up to @a tf exactly, with the input @a dt as the
+       maximum step size. */
+   virtual void Run(Vector &x, double &t, double &dt, double tf);
+
+   virtual ~AdaptiveODESolver();
+};
+
+
+/** An explicit embedded Runge-Kutta pair with the tableau
+    +--------+-------------------------+
+    | c[0]   | a[0]                    |
+    | c[1]   | a[1] a[2]               |
+    | ...    |    ...                  |
+    | c[s-2] | ...   a[s(s-1)/2-1]     |
+    +--------+-------------------------+
+    |        | b[0] b[1] ... b[s-1]    |
+    |        | bh[0] bh[1] ... bh[s-1] |
+    +--------+-------------------------+
+    where b gives the solution and bh the embedded solution of order
+    @a est_order used for the error estimate. For First Same As Last (FSAL)
+    pairs, detected from the tableau, the last stage of an accepted step is
+    the first stage of the next one; the solution @a x must then not be
+    changed between the calls to Step(), unless Init() is called. */
+class EmbeddedRKSolver : public AdaptiveODESolver
+{
+private:
+   int s;
+   const double *a, *b, *bh, *c;
+   bool fsal, k0_valid;
+   Vector y, *k;
+
+protected:
+   virtual void TryStep(const Vector &x, double t, double dt,
+                        Vector &x_new, Vector &err);
+   virtual void StepAccepted();
+
+public:
+   EmbeddedRKSolver(int _s, const double *_a, const double *_b,
+                    const double *_bh, const double *_c, int est_order_);
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual ~EmbeddedRKSolver();
+};
+
+
+/// The Bogacki-Shampine 3(2) pair: 4 stages (3 per step with FSAL).
+class BogackiShampineSolver : public EmbeddedRKSolver
+{
+private:
+   static const double a[6], b[4], bh[4], c[3];
+
+public:
+   BogackiShampineSolver() : EmbeddedRKSolver(4, a, b, bh, c, 2) { }
+};
+
+
+/// The Dormand-Prince 5(4) pair: 7 stages (6 per step with FSAL).
+class DormandPrinceSolver : public EmbeddedRKSolver
+{
+private:
+   static const double a[21], b[7], bh[7], c[6];
+
+public:
+   DormandPrinceSolver() : EmbeddedRKSolver(7, a, b, bh, c, 4) { }
+};
+
+
+/** A singly diagonal implicit Runge-Kutta (SDIRK) method with an embedded
+    error estimate, with the tableau
+    +--------+-----------------------------+
+    | c[0]   | a[0]                        |
+    | c[1]   | a[1] a[2]                   |
+    | ...    |    ...                      |
+    | c[s-1] | ...        a[s(s+1)/2-1]    |
+    +--------+-----------------------------+
+    |        | b[0] b[1] ... b[s-1]        |
+    |        | bh[0] bh[1] ... bh[s-1]     |
+    +--------+-----------------------------+
+    whose rows include the diagonal entry. The stages are computed with
+    TimeDependentOperator::ImplicitSolve(). */
+class EmbeddedSDIRKSolver : public AdaptiveODESolver
+{
+private:
+   int s;
+   const double *a, *b, *bh, *c;
+   Vector y, *k;
+
+protected:
+   virtual void TryStep(const Vector &x, double t, double dt,
+                        Vector &x_new, Vector &err);
+
+public:
+   EmbeddedSDIRKSolver(int _s, const double *_a, const double *_b,
+                       const double *_bh, const double *_c, int est_order_);
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual ~EmbeddedSDIRKSolver();
+};
+
+
+/** Five stage SDIRK method of order 4, L-stable, with an embedded method of
+    order 3. From Hairer and Wanner, "Solving Ordinary Differential Equations
+    II", Table 6.5. */
+class SDIRK54Solver : public EmbeddedSDIRKSolver
+{
+private:
+   static const double a[15], b[5], bh[5], c[5];
+
+public:
+   SDIRK54Solver() : EmbeddedSDIRKSolver(5, a, b, bh, c, 3) { }
+};
+
+
 /// Generalized-alpha ODE solver from "A generalized-α method for integrating
 /// the filtered Navier–Stokes equations with a stabilized finite element
 /// method" by K.E. Jansen, C.H. Whiting and G.M. Hulbert.
@@ -47,6 +47,13 @@ public:
    /// Operator application: `y=A(x)`.
    virtual void Mult(const Vector &x, Vector &y) const = 0;
 
+   /** @brief Operator application to a set of vectors: `Y[i]=A(X[i])`. The
+       default behavior in class Operator is to call Mult() for every vector;
+       derived classes can process the vectors together, e.g. to read the
+       matrix entries once for all of them. */
+   virtual void ArrayMult(const Array<const Vector *> &X,
+                          Array<Vector *> &Y) const;
+
    /** @brief Action of the transpose operator: `y=A^t(x)`. The default behavior
        in class Operator is to generate an error. */
    virtual void MultTranspose(const Vector &x, Vector &y) const
@@ -31,6 +31,7 @@ IterativeSolver::IterativeSolver()
    rel_tol = abs_tol = 0.0;
 #ifdef MFEM_USE_MPI
    dot_prod_type = 0;
+   sums_request = MPI_REQUEST_NULL;
 #endif
 }
 
@@ -45,6 +46,7 @@ IterativeSolver::IterativeSolver(MPI_Comm _comm)
    rel_tol = abs_tol = 0.0;
    dot_prod_type = 1;
    comm = _comm;
+   sums_request = MPI_REQUEST_NULL;
 }
 #endif
 
@@ -69,6 +71,48 @@ double IterativeSolver::Dot(const Vector &x, const Vector &y) const
 #endif
 }
 
+void IterativeSolver::StartSums(double *sums, int n) const
+{
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type != 0)
+   {
+#if MPI_VERSION >= 3
+      MPI_Iallreduce(MPI_IN_PLACE, sums, n, MPI_DOUBLE, MPI_SUM, comm,
+                     &sums_request);
+#else
+      MPI_Allreduce(MPI_IN_PLACE, sums, n, MPI_DOUBLE, MPI_SUM, comm);
+#endif
+   }
+#endif
+}
+
+void IterativeSolver::FinishSums() const
+{
+#if defined(MFEM_USE_MPI) && MPI_VERSION >= 3
+   if (dot_prod_type != 0)
+   {
+      MPI_Wait(&sums_request, MPI_STATUS_IGNORE);
+   }
+#endif
+}
+
+void IterativeSolver::ArrayDot(const Array<Vector *> &X,
+                               const Array<Vector *> &Y,
+                               const Array<int> &idx, Vector &dots) const
+{
+   Vector sums(idx.Size());
+   for (int k = 0; k < idx.Size(); k++)
+   {
+      sums(k) = (*X[idx[k]]) * (*Y[idx[k]]);
+   }
+   StartSums(sums.GetData(), sums.Size());
+   FinishSums();
+   for (int k = 0; k < idx.Size(); k++)
+   {
+      dots(idx[k]) = sums(k);
+   }
+}
+
 void IterativeSolver::SetPrintLevel(int print_lvl)
 {
 #ifndef MFEM_USE_MPI
@@ -441,6 +485,450 @@ void CGSolver::Mult(const Vector &b, Vector &x) const
    final_norm = sqrt(betanom);
 }
 
+// Select the entries of 'all' with indices 'idx'
+template <typename T, typename S>
+static inline void SelectEntries(const Array<T> &all, const Array<int> &idx,
+                                 Array<S> &sel)
+{
+   sel.SetSize(idx.Size());
+   for (int i = 0; i < idx.Size(); i++) { sel[i] = all[idx[i]]; }
+}
+
+void CGSolver::ArrayMult(const Array<const Vector *> &B,
+                         Array<Vector *> &X) const
+{
+   MFEM_VERIFY(B.Size() == X.Size(), "incompatible numbers of vectors");
+   const int nsys = B.Size();
+   if (nsys == 0) { return; }
+
+   Array<Vector *> R(nsys), D(nsys), Z(nsys);
+   for (int c = 0; c < nsys; c++)
+   {
+      R[c] = new Vector(width);
+      D[c] = new Vector(width);
+      Z[c] = new Vector(width);
+   }
+   Vector nom(nsys), den(nsys), betanom(nsys), r0(nsys);
+   Array<int> act(nsys), iters(nsys);
+   Array<const Vector *> in;
+   Array<Vector *> out;
+   for (int c = 0; c < nsys; c++) { act[c] = c; }
+
+   if (iterative_mode)
+   {
+      in = X;
+      oper->ArrayMult(in, R);
+   }
+   for (int c = 0; c < nsys; c++)
+   {
+      if (iterative_mode)
+      {
+         subtract(*B[c], *R[c], *R[c]); // r = b - A x
+      }
+      else
+      {
+         *R[c] = *B[c];
+         *X[c] = 0.0;
+      }
+   }
+   if (prec)
+   {
+      in = R;
+      prec->ArrayMult(in, Z); // z = B r
+   }
+   for (int c = 0; c < nsys; c++) { *D[c] = prec ? *Z[c] : *R[c]; }
+   ArrayDot(D, R, act, nom);
+
+   int i = 0, na = 0;
+   for (int c = 0; c < nsys; c++)
+   {
+      MFEM_ASSERT(IsFinite(nom(c)), "nom = " << nom(c));
+      r0(c) = std::max(nom(c)*rel_tol*rel_tol, abs_tol*abs_tol);
+      betanom(c) = nom(c);
+      iters[c] = 0;
+      if (nom(c) > r0(c)) { act[na++] = c; }
+   }
+   act.SetSize(na);
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Iteration : " << setw(3) << 0 << "  max (B r, r) = "
+                << betanom.Max() << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   if (act.Size() > 0)
+   {
+      SelectEntries(D, act, in);
+      SelectEntries(Z, act, out);
+      oper->ArrayMult(in, out); // z = A d
+      ArrayDot(Z, D, act, den);
+   }
+   for (i = 1; act.Size() > 0; )
+   {
+      for (int k = 0; k < act.Size(); k++)
+      {
+         const int c = act[k];
+         const double alpha = nom(c)/den(c);
+         X[c]->Add(alpha, *D[c]);    //  x = x + alpha d
+         R[c]->Add(-alpha, *Z[c]);   //  r = r - alpha A d
+      }
+      if (prec)
+      {
+         SelectEntries(R, act, in);
+         SelectEntries(Z, act, out);
+         prec->ArrayMult(in, out);   //  z = B r
+         ArrayDot(R, Z, act, betanom);
+      }
+      else
+      {
+         ArrayDot(R, R, act, betanom);
+      }
+
+      double max_betanom = 0.0;
+      na = 0;
+      for (int k = 0; k < act.Size(); k++)
+      {
+         const int c = act[k];
+         MFEM_ASSERT(IsFinite(betanom(c)), "betanom = " << betanom(c));
+         max_betanom = std::max(max_betanom, betanom(c));
+         iters[c] = i;
+         if (betanom(c) >= r0(c)) { act[na++] = c; }
+      }
+      act.SetSize(na);
+      if (print_level == 1)
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  max (B r, r) = "
+                   << max_betanom << '\n';
+      }
+
+      if (act.Size() == 0 || ++i > max_iter)
+      {
+         break;
+      }
+
+      for (int k = 0; k < act.Size(); k++)
+      {
+         const int c = act[k];
+         const double beta = betanom(c)/nom(c);
+         //  d = z + beta d
+         add(prec ? *Z[c] : *R[c], beta, *D[c], *D[c]);
+         nom(c) = betanom(c);
+      }
+      SelectEntries(D, act, in);
+      SelectEntries(Z, act, out);
+      oper->ArrayMult(in, out);      //  z = A d
+      ArrayDot(D, Z, act, den);
+      for (int k = 0; k < act.Size(); k++)
+      {
+         MFEM_ASSERT(IsFinite(den(act[k])), "den = " << den(act[k]));
+         if (den(act[k]) <= 0.0 && print_level >= 0)
+         {
+            mfem::out << "PCG: The operator is not positive definite. (Ad, d) = "
+                      << den(act[k]) << '\n';
+         }
+      }
+   }
+
+   converged = (act.Size() == 0);
+   final_iter = converged ? iters.Max() : max_iter;
+   final_norm = sqrt(betanom.Max());
+   if (print_level == 2)
+   {
+      mfem::out << "Number of PCG iterations: " << final_iter << '\n';
+   }
+   else if (print_level == 3)
+   {
+      mfem::out << "   Iteration : " << setw(3) << final_iter
+                << "  max (B r, r) = " << betanom.Max() << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "PCG: No convergence! (" << act.Size() << " of " << nsys
+                << " systems)\n";
+   }
+   for (int c = 0; c < nsys; c++)
+   {
+      delete Z[c];
+      delete D[c];
+      delete R[c];
+   }
+}
+
+void PipelinedCGSolver::UpdateVectors()
+{
+   r.SetSize(width);
+   w.SetSize(width);
+   n.SetSize(width);
+   p.SetSize(width);
+   s.SetSize(width);
+   z.SetSize(width);
+   u.SetSize(width);
+   m.SetSize(width);
+   q.SetSize(width);
+}
+
+void PipelinedCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   double sums[2], gamma = 0.0, gamma_old = 0.0, nom0 = 0.0, r0 = 0.0;
+   double alpha = 0.0, beta, den;
+
+   // without a preconditioner u = r and m = w, q = s
+   Vector &uu = prec ? u : r;
+   const Vector &mm = prec ? m : w;
+   const Vector &qq = prec ? q : s;
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+   if (prec) { prec->Mult(r, u); } // u = B r
+   oper->Mult(uu, w);              // w = A u
+
+   converged = 0;
+   final_iter = max_iter;
+   for (int i = 0; true; i++)
+   {
+      sums[0] = r*uu;
+      sums[1] = w*uu;
+      StartSums(sums, 2);
+      // overlap the reduction with m = B w, n = A m
+      if (prec) { prec->Mult(w, m); }
+      oper->Mult(mm, n);
+      FinishSums();
+      gamma = sums[0];
+      MFEM_ASSERT(IsFinite(gamma), "gamma = " << gamma);
+
+      if (i == 0)
+      {
+         nom0 = gamma;
+         r0 = std::max(gamma*rel_tol*rel_tol, abs_tol*abs_tol);
+      }
+      if (print_level == 1 || (print_level == 3 && i == 0))
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                   << gamma << (print_level == 3 ? " ...\n" : "\n");
+      }
+      if (gamma <= r0)
+      {
+         if (print_level == 2)
+         {
+            mfem::out << "Number of PCG iterations: " << i << '\n';
+         }
+         else if (print_level == 3 && i > 0)
+         {
+            mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                      << gamma << '\n';
+         }
+         converged = 1;
+         final_iter = i;
+         break;
+      }
+      if (i == max_iter)
+      {
+         break;
+      }
+
+      beta = (i > 0) ? gamma/gamma_old : 0.0;
+      den = (i > 0) ? sums[1] - beta*gamma/alpha : sums[1];
+      MFEM_ASSERT(IsFinite(den), "den = " << den);
+      if (den <= 0.0)
+      {
+         if (print_level >= 0)
+         {
+            mfem::out << "PipelinedCG: The operator is not positive definite."
+                      << " (A d, d) = " << den << '\n';
+         }
+         if (den == 0.0)
+         {
+            final_iter = i;
+            break;
+         }
+      }
+      alpha = gamma/den;
+      gamma_old = gamma;
+
+      if (i > 0)
+      {
+         add(n, beta, z, z);    // z = n + beta z
+         add(w, beta, s, s);    // s = w + beta s
+         add(uu, beta, p, p);   // p = u + beta p
+         if (prec) { add(m, beta, q, q); } // q = m + beta q
+      }
+      else
+      {
+         z = n;
+         s = w;
+         p = uu;
+         if (prec) { q = m; }
+      }
+      x.Add(alpha, p);          // x = x + alpha p
+      r.Add(-alpha, s);         // r = r - alpha s
+      if (prec) { u.Add(-alpha, q); } // u = u - alpha q
+      w.Add(-alpha, z);         // w = w - alpha z
+
+      if (replace_period > 0 && (i + 1) % replace_period == 0)
+      {
+         // replace the recurrences by the true residual and products
+         oper->Mult(x, r);
+         subtract(b, r, r);     // r = b - A x
+         if (prec) { prec->Mult(r, u); }
+         oper->Mult(uu, w);     // w = A u
+         oper->Mult(p, s);      // s = A p
+         if (prec) { prec->Mult(s, q); }
+         oper->Mult(qq, z);     // z = A q
+      }
+   }
+   if (print_level >= 0 && !converged)
+   {
+      if (print_level != 1)
+      {
+         if (print_level != 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                      << nom0 << " ...\n";
+         }
+         mfem::out << "   Iteration : " << setw(3) << final_iter
+                   << "  (B r, r) = " << gamma << '\n';
+      }
+      mfem::out << "PipelinedCG: No convergence!" << '\n';
+   }
+   if (print_level >= 1 || (print_level >= 0 && !converged))
+   {
+      mfem::out << "Average reduction factor = "
+                << pow (gamma/nom0, 0.5/final_iter) << '\n';
+   }
+   final_norm = sqrt(gamma);
+}
+
+void ChronopoulosGearCGSolver::UpdateVectors()
+{
+   r.SetSize(width);
+   w.SetSize(width);
+   p.SetSize(width);
+   s.SetSize(width);
+   u.SetSize(width);
+}
+
+void ChronopoulosGearCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   double sums[2], gamma = 0.0, gamma_old = 0.0, nom0 = 0.0, r0 = 0.0;
+   double alpha = 0.0, beta, den;
+
+   Vector &uu = prec ? u : r; // without a preconditioner u = r
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+
+   converged = 0;
+   final_iter = max_iter;
+   for (int i = 0; true; i++)
+   {
+      if (prec) { prec->Mult(r, u); } // u = B r
+      oper->Mult(uu, w);              // w = A u
+      sums[0] = r*uu;
+      sums[1] = w*uu;
+      StartSums(sums, 2);
+      FinishSums();
+      gamma = sums[0];
+      MFEM_ASSERT(IsFinite(gamma), "gamma = " << gamma);
+
+      if (i == 0)
+      {
+         nom0 = gamma;
+         r0 = std::max(gamma*rel_tol*rel_tol, abs_tol*abs_tol);
+      }
+      if (print_level == 1 || (print_level == 3 && i == 0))
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                   << gamma << (print_level == 3 ? " ...\n" : "\n");
+      }
+      if (gamma <= r0)
+      {
+         if (print_level == 2)
+         {
+            mfem::out << "Number of PCG iterations: " << i << '\n';
+         }
+         else if (print_level == 3 && i > 0)
+         {
+            mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                      << gamma << '\n';
+         }
+         converged = 1;
+         final_iter = i;
+         break;
+      }
+      if (i == max_iter)
+      {
+         break;
+      }
+
+      beta = (i > 0) ? gamma/gamma_old : 0.0;
+      den = (i > 0) ? sums[1] - beta*gamma/alpha : sums[1];
+      MFEM_ASSERT(IsFinite(den), "den = " << den);
+      if (den <= 0.0)
+      {
+         if (print_level >= 0)
+         {
+            mfem::out << "ChronopoulosGearCG: The operator is not positive "
+                      << "definite. (A d, d) = " << den << '\n';
+         }
+         if (den == 0.0)
+         {
+            final_iter = i;
+            break;
+         }
+      }
+      alpha = gamma/den;
+      gamma_old = gamma;
+
+      if (i > 0)
+      {
+         add(uu, beta, p, p);   // p = u + beta p
+         add(w, beta, s, s);    // s = w + beta s
+      }
+      else
+      {
+         p = uu;
+         s = w;
+      }
+      x.Add(alpha, p);          // x = x + alpha p
+      r.Add(-alpha, s);         // r = r - alpha A p
+   }
+   if (print_level >= 0 && !converged)
+   {
+      if (print_level != 1)
+      {
+         if (print_level != 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                      << nom0 << " ...\n";
+         }
+         mfem::out << "   Iteration : " << setw(3) << final_iter
+                   << "  (B r, r) = " << gamma << '\n';
+      }
+      mfem::out << "ChronopoulosGearCG: No convergence!" << '\n';
+   }
+   if (print_level >= 1 || (print_level >= 0 && !converged))
+   {
+      mfem::out << "Average reduction factor = "
+                << pow (gamma/nom0, 0.5/final_iter) << '\n';
+   }
+   final_norm = sqrt(gamma);
+}
+
 void CG(const Operator &A, const Vector &b, Vector &x,
         int print_iter, int max_num_iter,
         double RTOLERANCE, double ATOLERANCE)
@@ -699,6 +1187,241 @@ finish:
    }
 }
 
+// Compute the (preconditioned) residuals R[c] = M (B[c] - A X[c]) of the
+// systems c in 'act', using W as temporary storage. If 'zero_x' is true, the
+// solutions are assumed to be zero.
+static void GMRESArrayResiduals(const Operator *oper, const Solver *prec,
+                                const Array<const Vector *> &B,
+                                const Array<Vector *> &X,
+                                const Array<int> &act, bool zero_x,
+                                Array<Vector *> &R, Array<Vector *> &W)
+{
+   Array<const Vector *> in;
+   Array<Vector *> out;
+   if (zero_x)
+   {
+      SelectEntries(B, act, in);
+      SelectEntries(R, act, out);
+      if (prec) { prec->ArrayMult(in, out); }
+      else { for (int k = 0; k < act.Size(); k++) { *out[k] = *in[k]; } }
+      return;
+   }
+   SelectEntries(X, act, in);
+   SelectEntries(R, act, out);
+   oper->ArrayMult(in, out);
+   for (int k = 0; k < act.Size(); k++)
+   {
+      const int c = act[k];
+      subtract(*B[c], *R[c], prec ? *W[c] : *R[c]);
+   }
+   if (prec)
+   {
+      SelectEntries(W, act, in);
+      prec->ArrayMult(in, out);
+   }
+}
+
+void GMRESSolver::ArrayMult(const Array<const Vector *> &B,
+                            Array<Vector *> &X) const
+{
+   MFEM_VERIFY(B.Size() == X.Size(), "incompatible numbers of vectors");
+   const int nsys = B.Size(), n = width;
+   if (nsys == 0) { return; }
+
+   // Krylov vectors and Hessenberg matrices of every system
+   Array<DenseMatrix *> H(nsys);
+   DenseMatrix S(m+1, nsys), CS(m+1, nsys), SN(m+1, nsys);
+   Array<Vector *> R(nsys), W(nsys), V((m+1)*nsys);
+   Vector beta(nsys), target(nsys), resid(nsys);
+   Array<int> act(nsys), iters(nsys);
+   Array<const Vector *> in;
+   Array<Vector *> out, vk;
+   V = NULL;
+   for (int c = 0; c < nsys; c++)
+   {
+      H[c] = new DenseMatrix(m+1, m);
+      R[c] = new Vector(n);
+      W[c] = new Vector(n);
+      act[c] = c;
+      if (!iterative_mode) { *X[c] = 0.0; }
+   }
+
+   GMRESArrayResiduals(oper, prec, B, X, act, !iterative_mode, R, W);
+   ArrayDot(R, R, act, beta);
+   int na = 0;
+   for (int c = 0; c < nsys; c++)
+   {
+      beta(c) = sqrt(beta(c));   // beta = ||r||
+      MFEM_ASSERT(IsFinite(beta(c)), "beta = " << beta(c));
+      target(c) = std::max(rel_tol*beta(c), abs_tol);
+      resid(c) = beta(c);
+      iters[c] = 0;
+      if (beta(c) > target(c)) { act[na++] = c; }
+   }
+   act.SetSize(na);
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << 1
+                << "   Iteration : " << setw(3) << 0
+                << "  max ||B r|| = " << resid.Max()
+                << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   int i = 0, j = 1;
+   Vector h(nsys);
+   Array<Vector *> vl(nsys);
+   while (act.Size() > 0 && j <= max_iter)
+   {
+      for (int k = 0; k < act.Size(); k++)
+      {
+         const int c = act[k];
+         Vector *&v0 = V[c*(m+1)];
+         if (v0 == NULL) { v0 = new Vector(n); }
+         v0->Set(1.0/beta(c), *R[c]);
+         for (int l = 0; l <= m; l++) { S(l,c) = 0.0; }
+         S(0,c) = beta(c);
+      }
+
+      for (i = 0; i < m && j <= max_iter && act.Size() > 0; i++, j++)
+      {
+         vk.SetSize(act.Size());
+         for (int k = 0; k < act.Size(); k++) { vk[k] = V[act[k]*(m+1)+i]; }
+         in = vk;
+         if (prec)
+         {
+            SelectEntries(R, act, out);
+            oper->ArrayMult(in, out);
+            in = out;
+            SelectEntries(W, act, out);
+            prec->ArrayMult(in, out);   // w = M A v[i]
+         }
+         else
+         {
+            SelectEntries(W, act, out);
+            oper->ArrayMult(in, out);   // w = A v[i]
+         }
+
+         // Modified Gram-Schmidt, with one reduction per step for all systems
+         for (int l = 0; l <= i; l++)
+         {
+            for (int k = 0; k < act.Size(); k++)
+            {
+               vl[act[k]] = V[act[k]*(m+1)+l];
+            }
+            ArrayDot(W, vl, act, h);
+            for (int k = 0; k < act.Size(); k++)
+            {
+               const int c = act[k];
+               (*H[c])(l,i) = h(c);        // H(l,i) = w * v[l]
+               W[c]->Add(-h(c), *vl[c]);   // w -= H(l,i) * v[l]
+            }
+         }
+         ArrayDot(W, W, act, h);
+
+         na = 0;
+         double max_resid = 0.0;
+         for (int k = 0; k < act.Size(); k++)
+         {
+            const int c = act[k];
+            DenseMatrix &Hc = *H[c];
+            Hc(i+1,i) = sqrt(h(c));         // H(i+1,i) = ||w||
+            MFEM_ASSERT(IsFinite(Hc(i+1,i)), "Norm(w) = " << Hc(i+1,i));
+            Vector *&vn = V[c*(m+1)+i+1];
+            if (vn == NULL) { vn = new Vector(n); }
+            vn->Set(1.0/Hc(i+1,i), *W[c]);  // v[i+1] = w / H(i+1,i)
+
+            for (int l = 0; l < i; l++)
+            {
+               ApplyPlaneRotation(Hc(l,i), Hc(l+1,i), CS(l,c), SN(l,c));
+            }
+            GeneratePlaneRotation(Hc(i,i), Hc(i+1,i), CS(i,c), SN(i,c));
+            ApplyPlaneRotation(Hc(i,i), Hc(i+1,i), CS(i,c), SN(i,c));
+            ApplyPlaneRotation(S(i,c), S(i+1,c), CS(i,c), SN(i,c));
+
+            resid(c) = fabs(S(i+1,c));
+            MFEM_ASSERT(IsFinite(resid(c)), "resid = " << resid(c));
+            max_resid = std::max(max_resid, resid(c));
+            iters[c] = j;
+            if (resid(c) <= target(c))
+            {
+               Vector sc(S.GetColumn(c), m+1);
+               Array<Vector *> vc(V.GetData() + c*(m+1), m+1);
+               Update(*X[c], i, Hc, sc, vc);
+            }
+            else
+            {
+               act[na++] = c;
+            }
+         }
+         act.SetSize(na);
+
+         if (print_level == 1)
+         {
+            mfem::out << "   Pass : " << setw(2) << (j-1)/m+1
+                      << "   Iteration : " << setw(3) << j
+                      << "  max ||B r|| = " << max_resid << '\n';
+         }
+      }
+      if (act.Size() == 0) { break; }
+
+      if (print_level == 1 && j <= max_iter)
+      {
+         mfem::out << "Restarting..." << '\n';
+      }
+
+      for (int k = 0; k < act.Size(); k++)
+      {
+         const int c = act[k];
+         Vector sc(S.GetColumn(c), m+1);
+         Array<Vector *> vc(V.GetData() + c*(m+1), m+1);
+         Update(*X[c], i-1, *H[c], sc, vc);
+      }
+
+      GMRESArrayResiduals(oper, prec, B, X, act, false, R, W);
+      ArrayDot(R, R, act, beta);
+      na = 0;
+      for (int k = 0; k < act.Size(); k++)
+      {
+         const int c = act[k];
+         beta(c) = sqrt(beta(c));       // beta = ||r||
+         MFEM_ASSERT(IsFinite(beta(c)), "beta = " << beta(c));
+         resid(c) = beta(c);
+         if (beta(c) > target(c)) { act[na++] = c; }
+      }
+      act.SetSize(na);
+   }
+
+   converged = (act.Size() == 0);
+   final_iter = converged ? iters.Max() : max_iter;
+   final_norm = resid.Max();
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << (final_iter-1)/m+1
+                << "   Iteration : " << setw(3) << final_iter
+                << "  max ||B r|| = " << final_norm << '\n';
+   }
+   else if (print_level == 2)
+   {
+      mfem::out << "GMRES: Number of iterations: " << final_iter << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "GMRES: No convergence! (" << act.Size() << " of " << nsys
+                << " systems)\n";
+   }
+   for (int c = 0; c < nsys; c++)
+   {
+      delete W[c];
+      delete R[c];
+      delete H[c];
+   }
+   for (int k = 0; k < V.Size(); k++)
+   {
+      delete V[k];
+   }
+}
+
 void FGMRESSolver::Mult(const Vector &b, Vector &x) const
 {
    DenseMatrix H(m+1,m);
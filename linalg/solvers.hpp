@@ -35,6 +35,7 @@ class IterativeSolver : public Solver
 private:
    int dot_prod_type; // 0 - local, 1 - global over 'comm'
    MPI_Comm comm;
+   mutable MPI_Request sums_request; // see StartSums()
 #endif
 
 protected:
@@ -51,6 +52,20 @@ protected:
    double Dot(const Vector &x, const Vector &y) const;
    double Norm(const Vector &x) const { return sqrt(Dot(x, x)); }
 
+   /** @brief Start the global sum of the @a n local values in @a sums, e.g.
+       local dot products, combining them into a single reduction. */
+   /** With MPI-3, the reduction is non-blocking and can overlap the work done
+       before the matching call to FinishSums(); @a sums must not be accessed
+       in between. */
+   void StartSums(double *sums, int n) const;
+   /// Complete the reduction started by StartSums().
+   void FinishSums() const;
+
+   /** @brief Compute the dot products `dots(i) = (X[i], Y[i])` for all i in
+       @a idx with a single global reduction. */
+   void ArrayDot(const Array<Vector *> &X, const Array<Vector *> &Y,
+                 const Array<int> &idx, Vector &dots) const;
+
 public:
    IterativeSolver();
 
@@ -126,6 +141,84 @@ public:
    { IterativeSolver::SetOperator(op); UpdateVectors(); }
 
    virtual void Mult(const Vector &b, Vector &x) const;
+
+   /** @brief Solve the systems with right-hand sides @a B simultaneously
+       (batched CG). */
+   /** The iterations of all systems are carried out together: the operator
+       and the preconditioner are applied to all unconverged systems at once,
+       through Operator::ArrayMult(), and all their dot products are combined
+       into one global reduction. Every system is stopped as soon as it
+       converges; the statistics (GetNumIterations(), ...) refer to the
+       slowest system. */
+   virtual void ArrayMult(const Array<const Vector *> &B,
+                          Array<Vector *> &X) const;
+};
+
+/** @brief Pipelined conjugate gradient method of Ghysels and Vanroose.
+
+    The two dot products of every iteration are combined into a single global
+    reduction, which is started before and completed after the application
+    of the preconditioner and the operator, so that with MPI-3 its latency is
+    hidden by the computation. This requires six more vectors than CGSolver
+    and the recurrences are somewhat less stable in finite precision, so the
+    method pays off when the reductions dominate the iteration time, e.g. on
+    a large number of MPI ranks. The convergence test uses (B r, r), as in
+    CGSolver.
+
+    The accuracy attainable with the recurrences is limited by the rounding
+    errors accumulated in the residual; for tight tolerances, the residual
+    can be periodically recomputed, see SetResidualReplacement(). */
+class PipelinedCGSolver : public IterativeSolver
+{
+protected:
+   mutable Vector r, u, w, m, n, p, q, s, z;
+   int replace_period;
+
+   void UpdateVectors();
+
+public:
+   PipelinedCGSolver() : replace_period(0) { }
+
+#ifdef MFEM_USE_MPI
+   PipelinedCGSolver(MPI_Comm _comm)
+      : IterativeSolver(_comm), replace_period(0) { }
+#endif
+
+   /** @brief Recompute the residual and the auxiliary vectors from their
+       definitions every @a period iterations, at the cost of three operator
+       and two preconditioner applications. Disabled by default (0). */
+   void SetResidualReplacement(int period) { replace_period = period; }
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); UpdateVectors(); }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+/** @brief Conjugate gradient method of Chronopoulos and Gear, which needs a
+    single global reduction per iteration (instead of two in CGSolver).
+
+    The iterates are the same as in CGSolver in exact arithmetic. Compared to
+    PipelinedCGSolver, the reduction is not overlapped with the computation,
+    and only two more vectors than CGSolver are needed. */
+class ChronopoulosGearCGSolver : public IterativeSolver
+{
+protected:
+   mutable Vector r, u, w, p, s;
+
+   void UpdateVectors();
+
+public:
+   ChronopoulosGearCGSolver() { }
+
+#ifdef MFEM_USE_MPI
+   ChronopoulosGearCGSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); UpdateVectors(); }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
 };
 
 /// Conjugate gradient method. (tolerances are squared)
@@ -156,6 +249,11 @@ public:
    void SetKDim(int dim) { m = dim; }
 
    virtual void Mult(const Vector &b, Vector &x) const;
+
+   /** @brief Solve the systems with right-hand sides @a B simultaneously
+       (batched GMRES), see CGSolver::ArrayMult(). */
+   virtual void ArrayMult(const Array<const Vector *> &B,
+                          Array<Vector *> &X) const;
 };
 
 /// FGMRES method
@@ -0,0 +1,391 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of the SELL-C-sigma and block CSR sparse matrix formats
+
+#include "sparseformats.hpp"
+
+#include <algorithm>
+
+namespace mfem
+{
+
+// Largest chunk size of SellCSigmaMatrix
+static const int sell_max_chunk = 64;
+
+// Order rows by decreasing length
+class SellRowLonger
+{
+   const int *I;
+public:
+   SellRowLonger(const int *I_) : I(I_) { }
+   bool operator()(int a, int b) const
+   { return (I[a+1] - I[a]) > (I[b+1] - I[b]); }
+};
+
+SellCSigmaMatrix::SellCSigmaMatrix(const SparseMatrix &A, int chunk_size,
+                                   int s)
+   : Operator(A.Height(), A.Width())
+{
+   MFEM_VERIFY(A.Finalized(), "the matrix is not finalized");
+   MFEM_VERIFY(chunk_size >= 1 && chunk_size <= sell_max_chunk,
+               "invalid chunk size: " << chunk_size);
+   C = chunk_size;
+   sigma = std::max(s, 1);
+
+   const int n = height;
+   const int *Ai = A.GetI(), *Aj = A.GetJ();
+   const double *Av = A.GetData();
+
+   // Sort the rows by length within each window of sigma rows
+   perm.SetSize(n);
+   for (int i = 0; i < n; i++) { perm[i] = i; }
+   for (int w = 0; w < n; w += sigma)
+   {
+      std::stable_sort(perm.GetData() + w,
+                       perm.GetData() + std::min(w + sigma, n),
+                       SellRowLonger(Ai));
+   }
+
+   num_chunks = (n + C - 1)/C;
+   chunk_ptr.SetSize(num_chunks + 1);
+   chunk_ptr[0] = 0;
+   for (int c = 0; c < num_chunks; c++)
+   {
+      int width_c = 0;
+      for (int r = 0; r < C && c*C + r < n; r++)
+      {
+         const int i = perm[c*C + r];
+         width_c = std::max(width_c, Ai[i+1] - Ai[i]);
+      }
+      chunk_ptr[c+1] = chunk_ptr[c] + width_c*C;
+   }
+
+   // Pad the rows with zeros in the column of their last entry, which is
+   // already read for the row
+   col.SetSize(chunk_ptr[num_chunks]);
+   val.SetSize(chunk_ptr[num_chunks]);
+   for (int c = 0; c < num_chunks; c++)
+   {
+      const int width_c = (chunk_ptr[c+1] - chunk_ptr[c])/C;
+      int *cc = col.GetData() + chunk_ptr[c];
+      double *vv = val.GetData() + chunk_ptr[c];
+      for (int r = 0; r < C; r++)
+      {
+         const int i = (c*C + r < n) ? perm[c*C + r] : -1;
+         const int len = (i >= 0) ? Ai[i+1] - Ai[i] : 0;
+         for (int k = 0; k < width_c; k++)
+         {
+            if (k < len)
+            {
+               cc[k*C + r] = Aj[Ai[i] + k];
+               vv[k*C + r] = Av[Ai[i] + k];
+            }
+            else
+            {
+               cc[k*C + r] = (len > 0) ? Aj[Ai[i] + len-1] : 0;
+               vv[k*C + r] = 0.0;
+            }
+         }
+      }
+   }
+}
+
+// y = (add ? y : 0) + a * A * x for a SELL-C-sigma matrix with chunk size CC,
+// or the run-time chunk size C_rt if CC is 0.
+template <int CC>
+static void SellMult(int C_rt, int n, int num_chunks, const int *chunk_ptr,
+                     const int *col, const double *val, const int *perm,
+                     const double *x, double *y, double a, bool add)
+{
+   const int C = CC ? CC : C_rt;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int c = 0; c < num_chunks; c++)
+   {
+      double d[CC ? CC : sell_max_chunk];
+      for (int r = 0; r < C; r++) { d[r] = 0.0; }
+      const int *cc = col + chunk_ptr[c];
+      const double *vv = val + chunk_ptr[c];
+      const int width_c = (chunk_ptr[c+1] - chunk_ptr[c])/C;
+      for (int k = 0; k < width_c; k++)
+      {
+         for (int r = 0; r < C; r++)
+         {
+            d[r] += vv[k*C + r] * x[cc[k*C + r]];
+         }
+      }
+      const int rows = std::min(C, n - c*C);
+      for (int r = 0; r < rows; r++)
+      {
+         const int i = perm[c*C + r];
+         y[i] = add ? y[i] + a * d[r] : a * d[r];
+      }
+   }
+}
+
+static void SellMult(int C, int n, int num_chunks, const int *chunk_ptr,
+                     const int *col, const double *val, const int *perm,
+                     const double *x, double *y, double a, bool add)
+{
+   switch (C)
+   {
+      case 4:
+         SellMult<4>(C, n, num_chunks, chunk_ptr, col, val, perm, x, y, a,
+                     add);
+         break;
+      case 8:
+         SellMult<8>(C, n, num_chunks, chunk_ptr, col, val, perm, x, y, a,
+                     add);
+         break;
+      case 16:
+         SellMult<16>(C, n, num_chunks, chunk_ptr, col, val, perm, x, y, a,
+                      add);
+         break;
+      default:
+         SellMult<0>(C, n, num_chunks, chunk_ptr, col, val, perm, x, y, a,
+                     add);
+         break;
+   }
+}
+
+void SellCSigmaMatrix::Mult(const Vector &x, Vector &y) const
+{
+   MFEM_ASSERT(x.Size() == width, "input vector size (" << x.Size()
+               << ") must match the matrix width (" << width << ")");
+   MFEM_ASSERT(y.Size() == height, "output vector size (" << y.Size()
+               << ") must match the matrix height (" << height << ")");
+   SellMult(C, height, num_chunks, chunk_ptr.GetData(), col.GetData(),
+            val.GetData(), perm.GetData(), x.GetData(), y.GetData(), 1.0,
+            false);
+}
+
+void SellCSigmaMatrix::AddMult(const Vector &x, Vector &y,
+                               const double a) const
+{
+   MFEM_ASSERT(x.Size() == width, "input vector size (" << x.Size()
+               << ") must match the matrix width (" << width << ")");
+   MFEM_ASSERT(y.Size() == height, "output vector size (" << y.Size()
+               << ") must match the matrix height (" << height << ")");
+   SellMult(C, height, num_chunks, chunk_ptr.GetData(), col.GetData(),
+            val.GetData(), perm.GetData(), x.GetData(), y.GetData(), a, true);
+}
+
+void SellCSigmaMatrix::MultTranspose(const Vector &x, Vector &y) const
+{
+   y = 0.0;
+   AddMultTranspose(x, y);
+}
+
+void SellCSigmaMatrix::AddMultTranspose(const Vector &x, Vector &y,
+                                        const double a) const
+{
+   MFEM_ASSERT(x.Size() == height, "input vector size (" << x.Size()
+               << ") must match the matrix height (" << height << ")");
+   MFEM_ASSERT(y.Size() == width, "output vector size (" << y.Size()
+               << ") must match the matrix width (" << width << ")");
+   for (int c = 0; c < num_chunks; c++)
+   {
+      const int *cc = col.GetData() + chunk_ptr[c];
+      const double *vv = val.GetData() + chunk_ptr[c];
+      const int width_c = (chunk_ptr[c+1] - chunk_ptr[c])/C;
+      const int rows = std::min(C, height - c*C);
+      for (int r = 0; r < rows; r++)
+      {
+         const double xi = a * x(perm[c*C + r]);
+         for (int k = 0; k < width_c; k++)
+         {
+            y(cc[k*C + r]) += vv[k*C + r] * xi;
+         }
+      }
+   }
+}
+
+
+BlockCSRMatrix::BlockCSRMatrix(const SparseMatrix &A, int block_size)
+   : Operator(A.Height(), A.Width())
+{
+   MFEM_VERIFY(A.Finalized(), "the matrix is not finalized");
+   MFEM_VERIFY(block_size >= 1 && height % block_size == 0 &&
+               width % block_size == 0, "invalid block size: " << block_size);
+   bs = block_size;
+
+   const int nbr = height/bs, nbc = width/bs, bs2 = bs*bs;
+   const int *Ai = A.GetI(), *Aj = A.GetJ();
+   const double *Av = A.GetData();
+
+   // Block sparsity pattern
+   Array<int> mark(nbc), cols;
+   mark = -1;
+   I.SetSize(nbr+1);
+   I[0] = 0;
+   J.SetSize(0);
+   for (int ib = 0; ib < nbr; ib++)
+   {
+      cols.SetSize(0);
+      for (int i = ib*bs; i < (ib+1)*bs; i++)
+      {
+         for (int p = Ai[i]; p < Ai[i+1]; p++)
+         {
+            const int jb = Aj[p]/bs;
+            if (mark[jb] != ib)
+            {
+               mark[jb] = ib;
+               cols.Append(jb);
+            }
+         }
+      }
+      cols.Sort();
+      J.Append(cols);
+      I[ib+1] = J.Size();
+   }
+
+   // Block entries; mark is reused for the position of the blocks of a row
+   val.SetSize(J.Size()*bs2);
+   val = 0.0;
+   for (int ib = 0; ib < nbr; ib++)
+   {
+      for (int q = I[ib]; q < I[ib+1]; q++) { mark[J[q]] = q; }
+      for (int r = 0; r < bs; r++)
+      {
+         const int i = ib*bs + r;
+         for (int p = Ai[i]; p < Ai[i+1]; p++)
+         {
+            const int j = Aj[p];
+            val[mark[j/bs]*bs2 + r*bs + j%bs] = Av[p];
+         }
+      }
+   }
+}
+
+// y = (add ? y : 0) + a * A * x for a BSR matrix with block size B
+template <int B>
+static void BlockCSRMult(int nbr, const int *I, const int *J,
+                         const double *val, const double *x, double *y,
+                         double a, bool add)
+{
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int ib = 0; ib < nbr; ib++)
+   {
+      double d[B];
+      for (int r = 0; r < B; r++) { d[r] = 0.0; }
+      for (int q = I[ib], end = I[ib+1]; q < end; q++)
+      {
+         const double *v = val + q*B*B;
+         const double *xb = x + J[q]*B;
+         for (int r = 0; r < B; r++)
+         {
+            for (int c = 0; c < B; c++)
+            {
+               d[r] += v[r*B + c] * xb[c];
+            }
+         }
+      }
+      double *yb = y + ib*B;
+      for (int r = 0; r < B; r++)
+      {
+         yb[r] = add ? yb[r] + a * d[r] : a * d[r];
+      }
+   }
+}
+
+static void BlockCSRMult(int bs, int nbr, const int *I, const int *J,
+                         const double *val, const double *x, double *y,
+                         double a, bool add)
+{
+   switch (bs)
+   {
+      case 1: BlockCSRMult<1>(nbr, I, J, val, x, y, a, add); return;
+      case 2: BlockCSRMult<2>(nbr, I, J, val, x, y, a, add); return;
+      case 3: BlockCSRMult<3>(nbr, I, J, val, x, y, a, add); return;
+      case 4: BlockCSRMult<4>(nbr, I, J, val, x, y, a, add); return;
+   }
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int ib = 0; ib < nbr; ib++)
+   {
+      for (int r = 0; r < bs; r++)
+      {
+         double d = 0.0;
+         for (int q = I[ib], end = I[ib+1]; q < end; q++)
+         {
+            const double *v = val + (q*bs + r)*bs;
+            const double *xb = x + J[q]*bs;
+            for (int c = 0; c < bs; c++)
+            {
+               d += v[c] * xb[c];
+            }
+         }
+         double &yi = y[ib*bs + r];
+         yi = add ? yi + a * d : a * d;
+      }
+   }
+}
+
+void BlockCSRMatrix::Mult(const Vector &x, Vector &y) const
+{
+   MFEM_ASSERT(x.Size() == width, "input vector size (" << x.Size()
+               << ") must match the matrix width (" << width << ")");
+   MFEM_ASSERT(y.Size() == height, "output vector size (" << y.Size()
+               << ") must match the matrix height (" << height << ")");
+   BlockCSRMult(bs, height/bs, I.GetData(), J.GetData(), val.GetData(),
+                x.GetData(), y.GetData(), 1.0, false);
+}
+
+void BlockCSRMatrix::AddMult(const Vector &x, Vector &y, const double a) const
+{
+   MFEM_ASSERT(x.Size() == width, "input vector size (" << x.Size()
+               << ") must match the matrix width (" << width << ")");
+   MFEM_ASSERT(y.Size() == height, "output vector size (" << y.Size()
+               << ") must match the matrix height (" << height << ")");
+   BlockCSRMult(bs, height/bs, I.GetData(), J.GetData(), val.GetData(),
+                x.GetData(), y.GetData(), a, true);
+}
+
+void BlockCSRMatrix::MultTranspose(const Vector &x, Vector &y) const
+{
+   y = 0.0;
+   AddMultTranspose(x, y);
+}
+
+void BlockCSRMatrix::AddMultTranspose(const Vector &x, Vector &y,
+                                      const double a) const
+{
+   MFEM_ASSERT(x.Size() == height, "input vector size (" << x.Size()
+               << ") must match the matrix height (" << height << ")");
+   MFEM_ASSERT(y.Size() == width, "output vector size (" << y.Size()
+               << ") must match the matrix width (" << width << ")");
+   const int nbr = height/bs;
+   for (int ib = 0; ib < nbr; ib++)
+   {
+      const double *xb = x.GetData() + ib*bs;
+      for (int q = I[ib]; q < I[ib+1]; q++)
+      {
+         const double *v = val.GetData() + q*bs*bs;
+         double *yb = y.GetData() + J[q]*bs;
+         for (int r = 0; r < bs; r++)
+         {
+            const double xr = a * xb[r];
+            for (int c = 0; c < bs; c++)
+            {
+               yb[c] += v[r*bs + c] * xr;
+            }
+         }
+      }
+   }
+}
+
+}
@@ -0,0 +1,112 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_SPARSEFORMATS
+#define MFEM_SPARSEFORMATS
+
+#include "../config/config.hpp"
+#include "sparsemat.hpp"
+
+namespace mfem
+{
+
+/** @brief Copy of a finalized SparseMatrix in the SELL-C-sigma format, with
+    a matrix-vector product that vectorizes over the rows.
+
+    The rows are sorted by decreasing length within windows of sigma rows and
+    grouped into chunks of C consecutive sorted rows. Each chunk is stored
+    column by column (the k-th entries of its C rows are contiguous), padded
+    with zeros to the length of its longest row. The product then processes
+    the C rows of a chunk together, in SIMD lanes, and the sorting keeps the
+    padding small.
+
+    The object can be used wherever an Operator is expected, e.g. as the
+    operator of the Krylov solvers. Since it is a copy, it must be recreated
+    when the SparseMatrix changes. */
+class SellCSigmaMatrix : public Operator
+{
+protected:
+   int C, sigma, num_chunks;
+   Array<int> perm; ///< Original row of each sorted row
+   Array<int> chunk_ptr; ///< Offset of each chunk in col and val
+   Array<int> col;
+   Array<double> val;
+
+public:
+   /// Convert @a A, with chunks of @a chunk_size rows and sorting window @a s.
+   SellCSigmaMatrix(const SparseMatrix &A, int chunk_size = 8, int s = 256);
+
+   int GetChunkSize() const { return C; }
+
+   /// Number of stored entries, including the zero padding.
+   int NumStoredElems() const { return val.Size(); }
+
+   /// y = A x
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// y += a A x
+   void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
+
+   /// y = A^t x
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /// y += a A^t x
+   void AddMultTranspose(const Vector &x, Vector &y,
+                         const double a = 1.0) const;
+};
+
+/** @brief Copy of a finalized SparseMatrix in the block compressed sparse row
+    (BSR) format, with dense square blocks of a given size.
+
+    This suits the matrices of vector problems, e.g. ElasticityIntegrator or
+    VectorDiffusionIntegrator, with the dofs ordered byVDIM and block size
+    vdim: one column index per block instead of one per entry reduces the
+    memory traffic of the product, and the block products are unrolled for
+    block sizes up to 4. Entries of a block missing from the SparseMatrix are
+    stored as zeros.
+
+    The object can be used wherever an Operator is expected, e.g. as the
+    operator of the Krylov solvers. Since it is a copy, it must be recreated
+    when the SparseMatrix changes. */
+class BlockCSRMatrix : public Operator
+{
+protected:
+   int bs; ///< Block size
+   Array<int> I, J; ///< Block CSR structure
+   Array<double> val; ///< Blocks of size bs x bs, stored row by row
+
+public:
+   /** @brief Convert @a A, whose height and width must be multiples of
+       @a block_size. */
+   BlockCSRMatrix(const SparseMatrix &A, int block_size);
+
+   int GetBlockSize() const { return bs; }
+
+   /// Number of nonzero blocks.
+   int NumBlocks() const { return J.Size(); }
+
+   /// y = A x
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// y += a A x
+   void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
+
+   /// y = A^t x
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /// y += a A^t x
+   void AddMultTranspose(const Vector &x, Vector &y,
+                         const double a = 1.0) const;
+};
+
+}
+
+#endif
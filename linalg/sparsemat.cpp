@@ -14,6 +14,7 @@
 #include "linalg.hpp"
 #include "../general/table.hpp"
 #include "../general/sort_pairs.hpp"
+#include "../general/threads.hpp"
 
 #include <iostream>
 #include <iomanip>
@@ -21,6 +22,7 @@
 #include <algorithm>
 #include <limits>
 #include <cstring>
+#include <vector>
 
 namespace mfem
 {
@@ -139,6 +141,7 @@ SparseMatrix::SparseMatrix(const SparseMatrix &mat, bool copy_graph)
          ownGraph = false;
       }
       A = new double[nnz];
+      FirstTouch(A, nnz);
       memcpy(A, mat.A, sizeof(double)*nnz);
       ownData = true;
 
@@ -542,8 +545,99 @@ void SparseMatrix::ToDenseMatrix(DenseMatrix & B) const
    }
 }
 
+#ifdef MFEM_USE_OPENMP
+// Number of threads of the products with a matrix with @a nnz nonzeros: the
+// calling thread alone below ThreadsFirstTouchSize nonzeros.
+static inline int CSRThreads(int nnz)
+{
+   return (nnz >= ThreadsFirstTouchSize) ? GetMaxThreads() : 1;
+}
+
+// y = (add ? y : 0) + a * A * x with the rows split into one range per thread,
+// balanced by the number of nonzeros
+static void ThreadedCSRMult(int height, const int *I, const int *J,
+                            const double *A, const double *x, double *y,
+                            double a, bool add)
+{
+   const int nt = CSRThreads(I[height]);
+   Array<int> offsets(nt+1);
+   PartitionByWeight(I, height, nt, offsets.GetData());
+   #pragma omp parallel for schedule(static,1) if(nt > 1)
+   for (int t = 0; t < nt; t++)
+   {
+      for (int i = offsets[t]; i < offsets[t+1]; i++)
+      {
+         double d = 0.0;
+         for (int j = I[i], end = I[i+1]; j < end; j++)
+         {
+            d += A[j] * x[J[j]];
+         }
+         y[i] = add ? y[i] + a * d : a * d;
+      }
+   }
+}
+
+// y += a * A^T * x with the rows split as in ThreadedCSRMult(). Every thread
+// scatters its rows into a private buffer covering the columns they use, then
+// the entries of y add the buffers in thread order, so the result is the same
+// in every run with the same number of threads. Returns false, doing nothing,
+// if the matrix is too small to be threaded.
+static bool ThreadedCSRMultTranspose(int height, int width, const int *I,
+                                     const int *J, const double *A,
+                                     const double *x, double *y, double a)
+{
+   const int nt = CSRThreads(I[height]);
+   if (nt == 1) { return false; }
+   Array<int> offsets(nt+1), first(nt), last(nt);
+   PartitionByWeight(I, height, nt, offsets.GetData());
+   std::vector<std::vector<double> > buf(nt);
+   #pragma omp parallel for schedule(static,1)
+   for (int t = 0; t < nt; t++)
+   {
+      int lo = width, hi = 0;
+      for (int j = I[offsets[t]], end = I[offsets[t+1]]; j < end; j++)
+      {
+         lo = std::min(lo, J[j]);
+         hi = std::max(hi, J[j] + 1);
+      }
+      if (lo >= hi) { lo = hi = 0; }
+      first[t] = lo;
+      last[t] = hi;
+      std::vector<double> &b = buf[t];
+      b.assign(hi - lo, 0.0);
+      for (int i = offsets[t]; i < offsets[t+1]; i++)
+      {
+         const double xi = a * x[i];
+         for (int j = I[i], end = I[i+1]; j < end; j++)
+         {
+            b[J[j] - lo] += A[j] * xi;
+         }
+      }
+   }
+   #pragma omp parallel for
+   for (int c = 0; c < width; c++)
+   {
+      double d = 0.0;
+      for (int t = 0; t < nt; t++)
+      {
+         if (first[t] <= c && c < last[t]) { d += buf[t][c - first[t]]; }
+      }
+      y[c] += d;
+   }
+   return true;
+}
+#endif
+
 void SparseMatrix::Mult(const Vector &x, Vector &y) const
 {
+#ifdef MFEM_USE_OPENMP
+   if (A != NULL)
+   {
+      MFEM_ASSERT(width == x.Size() && height == y.Size(), "");
+      ThreadedCSRMult(height, I, J, A, x.GetData(), y.GetData(), 1.0, false);
+      return;
+   }
+#endif
    y = 0.0;
    AddMult(x, y);
 }
@@ -557,7 +651,7 @@ void SparseMatrix::AddMult(const Vector &x, Vector &y, const double a) const
                "Output vector size (" << y.Size() << ") must match matrix height (" << height
                << ")");
 
-   int i, j, end;
+   int i;
    double *Ap = A, *yp = y.GetData();
    const double *xp = x.GetData();
 
@@ -580,9 +674,12 @@ void SparseMatrix::AddMult(const Vector &x, Vector &y, const double a) const
 
    int *Jp = J, *Ip = I;
 
+#ifdef MFEM_USE_OPENMP
+   ThreadedCSRMult(height, Ip, Jp, Ap, xp, yp, a, true);
+#else
+   int j, end;
    if (a == 1.0)
    {
-#ifndef MFEM_USE_OPENMP
       for (i = j = 0; i < height; i++)
       {
          double d = 0.0;
@@ -592,18 +689,6 @@ void SparseMatrix::AddMult(const Vector &x, Vector &y, const double a) const
          }
          yp[i] += d;
       }
-#else
-      #pragma omp parallel for private(j,end)
-      for (i = 0; i < height; i++)
-      {
-         double d = 0.0;
-         for (j = Ip[i], end = Ip[i+1]; j < end; j++)
-         {
-            d += Ap[j] * xp[Jp[j]];
-         }
-         yp[i] += d;
-      }
-#endif
    }
    else
    {
@@ -617,6 +702,101 @@ void SparseMatrix::AddMult(const Vector &x, Vector &y, const double a) const
          yp[i] += a * d;
       }
    }
+#endif
+}
+
+// y[c] = (add ? y[c] : 0) + a * A * x[c], c = 0,...,NV-1, reading the entries
+// of the CSR matrix A once for all NV vectors. The input vectors are given
+// interleaved, xi[NV*j+c] = x[c][j], so that all values needed for an entry
+// a_ij are in the same cache line.
+template <int NV>
+static void SparseArrayMult(int height, const int *I, const int *J,
+                            const double *A, const double *xi,
+                            double *const *y, double a, bool add)
+{
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for if(I[height] >= ThreadsFirstTouchSize)
+#endif
+   for (int i = 0; i < height; i++)
+   {
+      double d[NV];
+      for (int c = 0; c < NV; c++) { d[c] = 0.0; }
+      for (int j = I[i], end = I[i+1]; j < end; j++)
+      {
+         const double a_ij = A[j];
+         const double *x_j = xi + NV*J[j];
+         for (int c = 0; c < NV; c++) { d[c] += a_ij * x_j[c]; }
+      }
+      for (int c = 0; c < NV; c++)
+      {
+         y[c][i] = add ? y[c][i] + a * d[c] : a * d[c];
+      }
+   }
+}
+
+static void SparseArrayMult(int height, int width, const int *I, const int *J,
+                            const double *A, const Array<const Vector *> &X,
+                            Array<Vector *> &Y, double a, bool add)
+{
+   const int max_nv = 8;
+   Vector xi(std::min(max_nv, X.Size())*width);
+   double *y[max_nv];
+   for (int k = 0; k < X.Size(); k += max_nv)
+   {
+      const int nv = std::min(max_nv, X.Size() - k);
+      for (int c = 0; c < nv; c++)
+      {
+         const double *x = X[k+c]->GetData();
+         for (int j = 0; j < width; j++) { xi(nv*j+c) = x[j]; }
+         y[c] = Y[k+c]->GetData();
+      }
+      const double *xp = xi.GetData();
+      switch (nv)
+      {
+         case 1: SparseArrayMult<1>(height, I, J, A, xp, y, a, add); break;
+         case 2: SparseArrayMult<2>(height, I, J, A, xp, y, a, add); break;
+         case 3: SparseArrayMult<3>(height, I, J, A, xp, y, a, add); break;
+         case 4: SparseArrayMult<4>(height, I, J, A, xp, y, a, add); break;
+         case 5: SparseArrayMult<5>(height, I, J, A, xp, y, a, add); break;
+         case 6: SparseArrayMult<6>(height, I, J, A, xp, y, a, add); break;
+         case 7: SparseArrayMult<7>(height, I, J, A, xp, y, a, add); break;
+         case 8: SparseArrayMult<8>(height, I, J, A, xp, y, a, add); break;
+      }
+   }
+}
+
+void SparseMatrix::ArrayMult(const Array<const Vector *> &X,
+                             Array<Vector *> &Y) const
+{
+   MFEM_ASSERT(X.Size() == Y.Size(), "incompatible numbers of vectors");
+   if (A == NULL)
+   {
+      Operator::ArrayMult(X, Y);
+      return;
+   }
+   for (int c = 0; c < X.Size(); c++)
+   {
+      MFEM_ASSERT(X[c]->Size() == width && Y[c]->Size() == height,
+                  "incompatible size of vector " << c);
+   }
+   SparseArrayMult(height, width, I, J, A, X, Y, 1.0, false);
+}
+
+void SparseMatrix::ArrayAddMult(const Array<const Vector *> &X,
+                                Array<Vector *> &Y, const double a) const
+{
+   MFEM_ASSERT(X.Size() == Y.Size(), "incompatible numbers of vectors");
+   if (A == NULL)
+   {
+      for (int c = 0; c < X.Size(); c++) { AddMult(*X[c], *Y[c], a); }
+      return;
+   }
+   for (int c = 0; c < X.Size(); c++)
+   {
+      MFEM_ASSERT(X[c]->Size() == width && Y[c]->Size() == height,
+                  "incompatible size of vector " << c);
+   }
+   SparseArrayMult(height, width, I, J, A, X, Y, a, true);
 }
 
 void SparseMatrix::MultTranspose(const Vector &x, Vector &y) const
@@ -653,6 +833,12 @@ void SparseMatrix::AddMultTranspose(const Vector &x, Vector &y,
       return;
    }
 
+#ifdef MFEM_USE_OPENMP
+   if (ThreadedCSRMultTranspose(height, width, I, J, A, x.GetData(), yp, a))
+   {
+      return;
+   }
+#endif
    for (i = 0; i < height; i++)
    {
       double xi = a * x(i);
@@ -841,6 +1027,8 @@ void SparseMatrix::Finalize(int skip_zeros, bool fix_empty_rows)
    nz = I[height];
    J = new int[nz];
    A = new double[nz];
+   FirstTouch(J, nz);
+   FirstTouch(A, nz);
    // Assume we're sorted until we find out otherwise
    isSorted = true;
    for (j = i = 0; i < height; i++)
@@ -3482,4 +3670,85 @@ void SparseMatrix::Swap(SparseMatrix &other)
    mfem::Swap(isSorted, other.isSorted);
 }
 
+
+void SparseScatterMap::Reset()
+{
+   map.SetSize(0);
+   offsets.SetSize(1);
+   offsets[0] = 0;
+   call = 0;
+   frozen = false;
+}
+
+void SparseScatterMap::End()
+{
+   if (!frozen)
+   {
+      frozen = true;
+      return;
+   }
+   MFEM_VERIFY(call == NumCalls(), "the sequence of AddSubMatrix() calls has "
+               "changed: " << call << " calls instead of " << NumCalls());
+}
+
+void SparseScatterMap::AddSubMatrix(SparseMatrix &A, const Array<int> &rows,
+                                    const Array<int> &cols,
+                                    const DenseMatrix &subm)
+{
+   const int nr = rows.Size(), nc = cols.Size();
+   if (frozen)
+   {
+      MFEM_VERIFY(call < NumCalls() &&
+                  offsets[call+1] - offsets[call] == nr*nc,
+                  "the sequence of AddSubMatrix() calls has changed");
+      AddSubMatrix(A, call++, subm);
+      return;
+   }
+
+   MFEM_VERIFY(A.Finalized(), "the matrix must be finalized");
+   const int *I = A.GetI(), *J = A.GetJ();
+   const bool sorted = A.areColumnsSorted();
+   double *data = A.GetData();
+   map.Reserve(map.Size() + nr*nc);
+   for (int c = 0; c < nc; c++)
+   {
+      int col = cols[c];
+      const bool neg_c = (col < 0);
+      if (neg_c) { col = -1-col; }
+      for (int r = 0; r < nr; r++)
+      {
+         int row = rows[r];
+         const bool neg = (row < 0) != neg_c;
+         if (row < 0) { row = -1-row; }
+         const int *row_J = J + I[row], *row_end = J + I[row+1];
+         const int *p = sorted ? std::lower_bound(row_J, row_end, col) :
+                        std::find(row_J, row_end, col);
+         MFEM_VERIFY(p != row_end && *p == col,
+                     "entry (" << row << ',' << col << ") is not in the "
+                     "sparsity pattern");
+         const int pos = p - J;
+         map.Append(neg ? -1-pos : pos);
+         data[pos] += neg ? -subm(r,c) : subm(r,c);
+      }
+   }
+   offsets.Append(map.Size());
+   call++;
+}
+
+void SparseScatterMap::AddSubMatrix(SparseMatrix &A, int c,
+                                    const DenseMatrix &subm) const
+{
+   const int *m = map.GetData() + offsets[c];
+   const int n = offsets[c+1] - offsets[c];
+   const double *v = subm.Data();
+   double *data = A.GetData();
+   MFEM_ASSERT(subm.Height()*subm.Width() == n, "invalid matrix size");
+   for (int k = 0; k < n; k++)
+   {
+      const int pos = m[k];
+      if (pos >= 0) { data[pos] += v[k]; }
+      else { data[-1-pos] -= v[k]; }
+   }
+}
+
 }
@@ -199,6 +199,18 @@ public:
    /// y += A * x (default)  or  y += a * A * x
    void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
 
+   /** @brief Matrix multiplication of a set of vectors, `Y[i] = A * X[i]`. The
+       matrix entries are read only once for every group of up to 8 vectors
+       (when the matrix is finalized); the input vectors of a group are copied
+       into one interleaved array, so that the values multiplied by an entry
+       share a cache line. */
+   virtual void ArrayMult(const Array<const Vector *> &X,
+                          Array<Vector *> &Y) const;
+
+   /// `Y[i] += a * A * X[i]`, see ArrayMult().
+   void ArrayAddMult(const Array<const Vector *> &X, Array<Vector *> &Y,
+                     const double a = 1.0) const;
+
    /// Multiply a vector with the transposed matrix. y = At * x
    void MultTranspose(const Vector &x, Vector &y) const;
 
@@ -515,6 +527,61 @@ SparseMatrix *OuterProduct(const SparseMatrix &A, const DenseMatrix &B);
 SparseMatrix *OuterProduct(const SparseMatrix &A, const SparseMatrix &B);
 
 
+/** @brief Positions in the data array of a finalized SparseMatrix of the
+    entries updated by a sequence of AddSubMatrix() calls.
+
+    The first pass over the sequence (between Begin() and End()) searches the
+    sparsity pattern of the matrix and records the positions; the map is then
+    frozen. Later passes over the same sequence, into the same matrix or into
+    a matrix with the same I and J arrays, add the values directly at the
+    recorded positions, with no searches and no allocation. */
+class SparseScatterMap
+{
+protected:
+   /// Positions of the entries, -1-pos for the entries added with a - sign.
+   Array<int> map;
+   /// Offsets of the recorded calls in the array map.
+   Array<int> offsets;
+   /// The next call in the current pass.
+   int call;
+   bool frozen;
+
+public:
+   SparseScatterMap() : call(0), frozen(false) { offsets.Append(0); }
+
+   /// Forget the recorded map.
+   void Reset();
+
+   /// Return true if the map is recorded and frozen.
+   bool IsFrozen() const { return frozen; }
+
+   /// Return the number of AddSubMatrix() calls in a pass.
+   int NumCalls() const { return offsets.Size() - 1; }
+
+   /// Start a pass over the sequence of AddSubMatrix() calls.
+   void Begin() { call = 0; }
+
+   /** @brief End the pass; the first pass freezes the map, the later ones
+       must have the same number of calls. */
+   void End();
+
+   /** @brief Add the matrix @a subm to the entries ( @a rows, @a cols ) of
+       the finalized matrix @a A, where negative indices -1-i mean row or
+       column i with a - sign. In a frozen map, @a rows and @a cols are only
+       used to check the sizes. */
+   void AddSubMatrix(SparseMatrix &A, const Array<int> &rows,
+                     const Array<int> &cols, const DenseMatrix &subm);
+
+   /** @brief Replay the call number @a c of the frozen map. Concurrent calls
+       are safe as long as they update disjoint sets of entries. */
+   void AddSubMatrix(SparseMatrix &A, int c, const DenseMatrix &subm) const;
+
+   /** @brief Continue the current pass at call number @a c, e.g. after
+       replaying the calls before @a c with the const AddSubMatrix(). */
+   void SetCall(int c) { call = c; }
+};
+
+
 // Inline methods
 
 inline void SparseMatrix::SetColPtr(const int row) const
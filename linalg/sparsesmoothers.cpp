@@ -15,7 +15,13 @@
 #include "matrix.hpp"
 #include "sparsemat.hpp"
 #include "sparsesmoothers.hpp"
+#include "densebatch.hpp"
 #include <iostream>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <vector>
+#include <cmath>
 
 namespace mfem
 {
@@ -108,4 +114,611 @@ void DSmoother::Mult(const Vector &x, Vector &y) const
    }
 }
 
+/// Create and factor the ILU(k) smoother.
+ILUSmoother::ILUSmoother(const SparseMatrix &a, int k)
+{
+   type = 0;
+   levels = k;
+   droptol = 0.0;
+   max_fill = 0;
+   SetOperator(a);
+}
+
+void ILUSmoother::SetLevelOfFill(int k)
+{
+   MFEM_VERIFY(k >= 0, "invalid level of fill: " << k);
+   type = 0;
+   levels = k;
+   A_I.SetSize(0);
+}
+
+void ILUSmoother::SetThreshold(double tol, int p)
+{
+   MFEM_VERIFY(tol >= 0.0 && p > 0, "invalid ILUT parameters");
+   type = 1;
+   droptol = tol;
+   max_fill = p;
+   A_I.SetSize(0);
+}
+
+void ILUSmoother::SetOperator(const Operator &a)
+{
+   SparseSmoother::SetOperator(a);
+   MFEM_VERIFY(height == width, "the matrix is not square");
+   MFEM_VERIFY(oper->Finalized(), "the matrix is not finalized");
+   Factor();
+}
+
+bool ILUSmoother::SamePattern(const SparseMatrix &a) const
+{
+   const int n = a.Height();
+   if (A_I.Size() != n+1 || A_J.Size() != a.NumNonZeroElems())
+   {
+      return false;
+   }
+   return (std::equal(A_I.GetData(), A_I.GetData() + n+1, a.GetI()) &&
+           std::equal(A_J.GetData(), A_J.GetData() + A_J.Size(), a.GetJ()));
+}
+
+void ILUSmoother::Factor()
+{
+   if (type == 1)
+   {
+      A_I.SetSize(0);
+      FactorILUT(*oper);
+      BuildSchedules();
+      return;
+   }
+   if (!SamePattern(*oper))
+   {
+      SymbolicILUK(*oper);
+      BuildSchedules();
+   }
+   NumericILU(*oper);
+}
+
+void ILUSmoother::SymbolicILUK(const SparseMatrix &a)
+{
+   const int n = a.Height();
+   const int *ai = a.GetI(), *aj = a.GetJ();
+
+   A_I.SetSize(n+1);
+   A_I.Assign(ai);
+   A_J.SetSize(ai[n]);
+   A_J.Assign(aj);
+   A_map.SetSize(ai[n]);
+
+   // The columns of row i are kept in a sorted linked list, where next[j] is
+   // the column after j and n ends the list; lev_i[j] is the level of fill
+   // of entry (i,j) and lev that of the entries of the previous rows.
+   Array<int> lev, next(n), lev_i(n), mark(n), pos(n), row;
+   mark = -1;
+   I.SetSize(n+1);
+   J.SetSize(0);
+   diag.SetSize(n);
+   I[0] = 0;
+   for (int i = 0; i < n; i++)
+   {
+      row.SetSize(0);
+      for (int p = ai[i]; p < ai[i+1]; p++)
+      {
+         row.Append(aj[p]);
+      }
+      row.Append(i);
+      row.Sort();
+      row.Unique();
+      for (int t = 0; t < row.Size(); t++)
+      {
+         const int j = row[t];
+         next[j] = (t+1 < row.Size()) ? row[t+1] : n;
+         lev_i[j] = 0;
+         mark[j] = i;
+      }
+
+      // Fill from the rows k < i, in increasing order
+      for (int k = row[0]; k < i; k = next[k])
+      {
+         int prev = k;
+         for (int q = diag[k]+1; q < I[k+1]; q++)
+         {
+            const int j = J[q], lj = lev_i[k] + lev[q] + 1;
+            if (lj > levels) { continue; }
+            if (mark[j] == i)
+            {
+               lev_i[j] = std::min(lev_i[j], lj);
+            }
+            else
+            {
+               while (next[prev] < j) { prev = next[prev]; }
+               next[j] = next[prev];
+               next[prev] = j;
+               lev_i[j] = lj;
+               mark[j] = i;
+            }
+            prev = j;
+         }
+      }
+
+      for (int j = row[0]; j < n; j = next[j])
+      {
+         if (j == i) { diag[i] = J.Size(); }
+         pos[j] = J.Size();
+         J.Append(j);
+         lev.Append(lev_i[j]);
+      }
+      I[i+1] = J.Size();
+      for (int p = ai[i]; p < ai[i+1]; p++)
+      {
+         A_map[p] = pos[aj[p]];
+      }
+   }
+   V.SetSize(J.Size());
+   dinv.SetSize(n);
+}
+
+void ILUSmoother::NumericILU(const SparseMatrix &a)
+{
+   const int n = a.Height();
+   const double *av = a.GetData();
+
+   V = 0.0;
+   for (int p = 0; p < A_map.Size(); p++)
+   {
+      V[A_map[p]] = av[p];
+   }
+
+   Array<int> pos(n);
+   pos = -1;
+   for (int i = 0; i < n; i++)
+   {
+      for (int q = I[i]; q < I[i+1]; q++)
+      {
+         pos[J[q]] = q;
+      }
+      for (int q = I[i]; q < diag[i]; q++)
+      {
+         const int k = J[q];
+         const double l = (V[q] *= dinv(k));
+         for (int p = diag[k]+1; p < I[k+1]; p++)
+         {
+            const int t = pos[J[p]];
+            if (t >= 0) { V[t] -= l*V[p]; }
+         }
+      }
+      MFEM_VERIFY(V[diag[i]] != 0.0, "zero pivot in row " << i);
+      dinv(i) = 1.0/V[diag[i]];
+      for (int q = I[i]; q < I[i+1]; q++)
+      {
+         pos[J[q]] = -1;
+      }
+   }
+}
+
+// Compare columns by decreasing magnitude of the entries of a work vector
+class ILUMagnitudeGreater
+{
+   const Vector &w;
+public:
+   ILUMagnitudeGreater(const Vector &w_) : w(w_) { }
+   bool operator()(int a, int b) const
+   { return std::abs(w(a)) > std::abs(w(b)); }
+};
+
+void ILUSmoother::FactorILUT(const SparseMatrix &a)
+{
+   const int n = a.Height();
+   const int *ai = a.GetI(), *aj = a.GetJ();
+   const double *av = a.GetData();
+
+   I.SetSize(n+1);
+   J.SetSize(0);
+   V.SetSize(0);
+   diag.SetSize(n);
+   dinv.SetSize(n);
+
+   Vector w(n);
+   Array<int> mark(n), row, lcols, ucols;
+   std::priority_queue<int, std::vector<int>, std::greater<int> > lower;
+   ILUMagnitudeGreater by_magnitude(w);
+   w = 0.0;
+   mark = -1;
+   I[0] = 0;
+   for (int i = 0; i < n; i++)
+   {
+      // Scatter row i into w
+      double norm = 0.0;
+      row.SetSize(0);
+      for (int p = ai[i]; p < ai[i+1]; p++)
+      {
+         const int j = aj[p];
+         w(j) = av[p];
+         mark[j] = i;
+         row.Append(j);
+         norm += av[p]*av[p];
+         if (j < i) { lower.push(j); }
+      }
+      if (mark[i] != i)
+      {
+         mark[i] = i;
+         row.Append(i);
+      }
+      const double tau = droptol*std::sqrt(norm);
+
+      // Eliminate the lower part in increasing column order, dropping small
+      // multipliers
+      while (!lower.empty())
+      {
+         const int k = lower.top();
+         lower.pop();
+         const double l = w(k)*dinv(k);
+         if (std::abs(l) < tau)
+         {
+            w(k) = 0.0;
+            continue;
+         }
+         w(k) = l;
+         for (int q = diag[k]+1; q < I[k+1]; q++)
+         {
+            const int j = J[q];
+            if (mark[j] != i)
+            {
+               mark[j] = i;
+               row.Append(j);
+               w(j) = 0.0;
+               if (j < i) { lower.push(j); }
+            }
+            w(j) -= l*V[q];
+         }
+      }
+
+      // Keep the max_fill largest entries above the threshold in L and U
+      lcols.SetSize(0);
+      ucols.SetSize(0);
+      for (int t = 0; t < row.Size(); t++)
+      {
+         const int j = row[t];
+         if (j == i || w(j) == 0.0 || std::abs(w(j)) < tau) { continue; }
+         (j < i ? lcols : ucols).Append(j);
+      }
+      Array<int> *parts[2] = { &lcols, &ucols };
+      for (int s = 0; s < 2; s++)
+      {
+         Array<int> &cols = *parts[s];
+         if (cols.Size() > max_fill)
+         {
+            std::nth_element(cols.GetData(), cols.GetData() + max_fill,
+                             cols.GetData() + cols.Size(), by_magnitude);
+            cols.SetSize(max_fill);
+         }
+         cols.Sort();
+      }
+
+      for (int t = 0; t < lcols.Size(); t++)
+      {
+         J.Append(lcols[t]);
+         V.Append(w(lcols[t]));
+      }
+      double d = w(i);
+      if (d == 0.0)
+      {
+         d = (norm > 0.0) ? (1e-4 + droptol)*std::sqrt(norm) : 1.0;
+      }
+      diag[i] = J.Size();
+      J.Append(i);
+      V.Append(d);
+      dinv(i) = 1.0/d;
+      for (int t = 0; t < ucols.Size(); t++)
+      {
+         J.Append(ucols[t]);
+         V.Append(w(ucols[t]));
+      }
+      I[i+1] = J.Size();
+
+      for (int t = 0; t < row.Size(); t++)
+      {
+         w(row[t]) = 0.0;
+      }
+   }
+}
+
+void ILUSmoother::BuildSchedules()
+{
+#ifdef MFEM_USE_OPENMP
+   const int n = height;
+   Array<int> level(n);
+   Array<int> *lev_ptr[2] = { &lower_lev, &upper_lev };
+   Array<int> *lev_rows[2] = { &lower_rows, &upper_rows };
+   for (int s = 0; s < 2; s++)
+   {
+      // The level of a row is one more than the largest level of the rows it
+      // depends on
+      int num_levels = 0;
+      for (int t = 0; t < n; t++)
+      {
+         const int i = (s == 0) ? t : n-1-t;
+         const int begin = (s == 0) ? I[i] : diag[i]+1;
+         const int end = (s == 0) ? diag[i] : I[i+1];
+         int l = 0;
+         for (int q = begin; q < end; q++)
+         {
+            l = std::max(l, level[J[q]] + 1);
+         }
+         level[i] = l;
+         num_levels = std::max(num_levels, l + 1);
+      }
+      Array<int> &ptr = *lev_ptr[s], &rows = *lev_rows[s];
+      ptr.SetSize(num_levels + 1);
+      ptr = 0;
+      for (int i = 0; i < n; i++)
+      {
+         ptr[level[i]+1]++;
+      }
+      ptr.PartialSum();
+      rows.SetSize(n);
+      for (int t = 0; t < n; t++)
+      {
+         const int i = (s == 0) ? t : n-1-t;
+         rows[ptr[level[i]]++] = i;
+      }
+      for (int l = num_levels; l > 0; l--)
+      {
+         ptr[l] = ptr[l-1];
+      }
+      ptr[0] = 0;
+   }
+#endif
+}
+
+void ILUSmoother::Solve(const Vector &b, Vector &x) const
+{
+   const int *Ip = I.GetData(), *Jp = J.GetData(), *Dp = diag.GetData();
+   const double *Vp = V.GetData();
+
+#ifndef MFEM_USE_OPENMP
+   const int n = height;
+   for (int i = 0; i < n; i++)
+   {
+      double s = b(i);
+      for (int q = Ip[i]; q < Dp[i]; q++)
+      {
+         s -= Vp[q]*x(Jp[q]);
+      }
+      x(i) = s;
+   }
+   for (int i = n-1; i >= 0; i--)
+   {
+      double s = x(i);
+      for (int q = Dp[i]+1; q < Ip[i+1]; q++)
+      {
+         s -= Vp[q]*x(Jp[q]);
+      }
+      x(i) = s*dinv(i);
+   }
+#else
+   // One parallel region; the implicit barrier of each omp for separates the
+   // levels
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      for (int l = 0; l+1 < lower_lev.Size(); l++)
+      {
+#ifdef MFEM_USE_OPENMP
+         #pragma omp for
+#endif
+         for (int t = lower_lev[l]; t < lower_lev[l+1]; t++)
+         {
+            const int i = lower_rows[t];
+            double s = b(i);
+            for (int q = Ip[i]; q < Dp[i]; q++)
+            {
+               s -= Vp[q]*x(Jp[q]);
+            }
+            x(i) = s;
+         }
+      }
+      for (int l = 0; l+1 < upper_lev.Size(); l++)
+      {
+#ifdef MFEM_USE_OPENMP
+         #pragma omp for
+#endif
+         for (int t = upper_lev[l]; t < upper_lev[l+1]; t++)
+         {
+            const int i = upper_rows[t];
+            double s = x(i);
+            for (int q = Dp[i]+1; q < Ip[i+1]; q++)
+            {
+               s -= Vp[q]*x(Jp[q]);
+            }
+            x(i) = s*dinv(i);
+         }
+      }
+   }
+#endif
+}
+
+/// Matrix vector multiplication with ILU smoother.
+void ILUSmoother::Mult(const Vector &x, Vector &y) const
+{
+   if (!iterative_mode)
+   {
+      Solve(x, y);
+      return;
+   }
+   r.SetSize(height);
+   z.SetSize(height);
+   oper->Mult(y, r);
+   subtract(x, r, r);
+   Solve(r, z);
+   y += z;
+}
+
+/// Create and factor the IC(k) smoother.
+ICSmoother::ICSmoother(const SparseMatrix &a, int k)
+   : ILUSmoother(k)
+{
+   shift = 0.0;
+   SetOperator(a);
+}
+
+void ICSmoother::Factor()
+{
+   MFEM_VERIFY(type == 0, "ICSmoother does not support ILUT");
+   const SparseMatrix &a = *oper;
+   const int n = a.Height();
+
+   if (!SamePattern(a))
+   {
+      SymbolicILUK(a);
+      BuildSchedules();
+
+      // The lower part of row j is the transpose of column j of the upper part
+      mirror.SetSize(J.Size());
+      for (int k = 0; k < n; k++)
+      {
+         for (int p = diag[k]+1; p < I[k+1]; p++)
+         {
+            const int j = J[p];
+            const int *begin = J.GetData() + I[j], *end = J.GetData() + diag[j];
+            const int *m = std::lower_bound(begin, end, k);
+            MFEM_VERIFY(m != end && *m == k,
+                        "the sparsity pattern is not symmetric");
+            mirror[p] = m - J.GetData();
+         }
+      }
+   }
+
+   // Right-looking elimination restricted to the upper part of the pattern:
+   // row k of U updates the rows j > k with U_kj != 0
+   const double *av = a.GetData();
+   shift = 0.0;
+   for (bool done = false; !done; )
+   {
+      V = 0.0;
+      for (int p = 0; p < A_map.Size(); p++)
+      {
+         V[A_map[p]] = av[p];
+      }
+      if (shift > 0.0)
+      {
+         for (int i = 0; i < n; i++)
+         {
+            V[diag[i]] *= 1.0 + shift;
+         }
+      }
+
+      done = true;
+      for (int k = 0; k < n; k++)
+      {
+         const double d = V[diag[k]];
+         if (!(d > 0.0))
+         {
+            done = false;
+            shift = (shift > 0.0) ? 2.0*shift : 1e-3;
+            break;
+         }
+         dinv(k) = 1.0/d;
+         for (int p = diag[k]+1; p < I[k+1]; p++)
+         {
+            const int j = J[p];
+            const double l = V[p]*dinv(k);
+            int t = diag[j];
+            for (int q = p; q < I[k+1]; q++)
+            {
+               while (t < I[j+1] && J[t] < J[q]) { t++; }
+               if (t == I[j+1]) { break; }
+               if (J[t] == J[q]) { V[t] -= l*V[q]; }
+            }
+            V[mirror[p]] = l;
+         }
+      }
+   }
+}
+
+/// Create the block Jacobi smoother.
+BlockJacobiSmoother::BlockJacobiSmoother(const SparseMatrix &a, int bs)
+{
+   block_size = bs;
+   SetOperator(a);
+}
+
+void BlockJacobiSmoother::SetOperator(const Operator &a)
+{
+   SparseSmoother::SetOperator(a);
+   MFEM_VERIFY(height == width, "the matrix is not square");
+   MFEM_VERIFY(oper->Finalized(), "the matrix is not finalized");
+   MFEM_VERIFY(block_size > 0 && height % block_size == 0,
+               "the matrix size is not a multiple of the block size");
+   const int bs = block_size, nb = height/bs;
+   const int *I = oper->GetI(), *J = oper->GetJ();
+   const double *A = oper->GetData();
+
+   // Extract the diagonal blocks
+   Vector blocks(nb*bs*bs);
+   blocks = 0.0;
+   for (int i = 0; i < height; i++)
+   {
+      const int k = i/bs, i0 = k*bs;
+      double *block = blocks.GetData() + k*bs*bs;
+      for (int p = I[i]; p < I[i+1]; p++)
+      {
+         const int j = J[p] - i0;
+         if (0 <= j && j < bs) { block[i-i0+j*bs] = A[p]; }
+      }
+   }
+
+   // Factor the blocks and solve with identity right-hand sides
+   blocks_inv.SetSize(nb*bs*bs);
+   blocks_inv = 0.0;
+   Array<int> sizes(nb), piv(nb*bs);
+   Array<double*> B(nb), B_inv(nb);
+   Array<int*> ipiv(nb);
+   sizes = bs;
+   for (int k = 0; k < nb; k++)
+   {
+      B[k] = blocks.GetData() + k*bs*bs;
+      B_inv[k] = blocks_inv.GetData() + k*bs*bs;
+      ipiv[k] = piv.GetData() + k*bs;
+      for (int i = 0; i < bs; i++) { B_inv[k][i+i*bs] = 1.0; }
+   }
+   DenseBatch::LUFactor(nb, sizes, B, ipiv);
+   DenseBatch::LUSolve(nb, sizes, sizes, B, ipiv, B_inv);
+}
+
+void BlockJacobiSmoother::Mult(const Vector &x, Vector &y) const
+{
+   const double *b = x.GetData();
+   if (iterative_mode)
+   {
+      r.SetSize(height);
+      oper->Mult(y, r);
+      subtract(x, r, r);
+      b = r.GetData();
+   }
+   const int bs = block_size, nb = height/bs;
+   const double *D_inv = blocks_inv.GetData();
+   double *yp = y.GetData();
+   const bool add = iterative_mode;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int k = 0; k < nb; k++)
+   {
+      const double *D = D_inv + k*bs*bs, *b_k = b + k*bs;
+      double *y_k = yp + k*bs;
+      if (!add)
+      {
+         for (int i = 0; i < bs; i++) { y_k[i] = 0.0; }
+      }
+      for (int j = 0; j < bs; j++)
+      {
+         const double b_j = b_k[j];
+         for (int i = 0; i < bs; i++)
+         {
+            y_k[i] += D[i+j*bs] * b_j;
+         }
+      }
+   }
+}
+
 }
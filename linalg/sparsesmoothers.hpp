@@ -73,6 +73,150 @@ public:
    virtual void Mult(const Vector &x, Vector &y) const;
 };
 
+/** @brief Incomplete LU factorization smoother of sparse matrix, A ~ L U,
+    with level of fill k, ILU(k), or with dual threshold dropping, ILUT.
+
+    The symbolic factorization of ILU(k) is kept: when SetOperator() is called
+    with a matrix with the same sparsity pattern, e.g. in time-dependent
+    problems, only the numeric factorization is recomputed. With OpenMP, the
+    triangular solves process the rows in parallel, level by level, where the
+    rows of one level depend only on rows of the previous levels.
+
+    If iterative_mode is true, Mult() performs one step of the iteration
+    y += (LU)^{-1} (x - A y). */
+class ILUSmoother : public SparseSmoother
+{
+protected:
+   int type; // 0, 1 - ILU(k), ILUT
+   int levels; // level of fill for ILU(k)
+   double droptol; // relative drop tolerance for ILUT
+   int max_fill; // maximum number of entries in each row of L and U for ILUT
+
+   /** The factors in CSR format with sorted rows: the entries of row i before
+       diag[i] are the strictly lower part of L (which has unit diagonal),
+       the entries starting at diag[i] are the upper part of U. */
+   Array<int> I, J, diag;
+   Array<double> V; ///< Entries of the factors
+   Vector dinv; ///< Inverse of the diagonal of U
+
+   /** Sparsity pattern of the last factored matrix and the position in the
+       factors of each of its entries, used to reuse the symbolic
+       factorization of ILU(k). */
+   Array<int> A_I, A_J, A_map;
+
+#ifdef MFEM_USE_OPENMP
+   /** Level schedules of the triangular solves: the rows of level l of L are
+       lower_rows[lower_lev[l]], ..., lower_rows[lower_lev[l+1]-1], and
+       similarly for U. */
+   Array<int> lower_lev, lower_rows, upper_lev, upper_rows;
+#endif
+
+   mutable Vector r, z;
+
+   /// Check if @a a has the sparsity pattern of the last factored matrix.
+   bool SamePattern(const SparseMatrix &a) const;
+
+   /// Compute the sparsity pattern of ILU(k) and A_I, A_J, A_map.
+   void SymbolicILUK(const SparseMatrix &a);
+
+   /// Compute the entries of the factors for the pattern of ILU(k).
+   void NumericILU(const SparseMatrix &a);
+
+   /// Compute the pattern and the entries of the factors of ILUT.
+   void FactorILUT(const SparseMatrix &a);
+
+   /// Compute the level schedules of the triangular solves.
+   void BuildSchedules();
+
+   /// Factor the operator, reusing the symbolic factorization if possible.
+   virtual void Factor();
+
+   /// Solve L U x = b.
+   void Solve(const Vector &b, Vector &x) const;
+
+public:
+   /// Create ILU(k) smoother.
+   ILUSmoother(int k = 0)
+   { type = 0; levels = k; droptol = 0.0; max_fill = 0; }
+
+   /// Create and factor ILU(k) smoother.
+   ILUSmoother(const SparseMatrix &a, int k = 0);
+
+   /// Use ILU(k); the factorization is updated by the next SetOperator().
+   void SetLevelOfFill(int k);
+
+   /** @brief Use ILUT: entries smaller than @a tol times the norm of the
+       matrix row are dropped, and at most @a p entries are kept in each row of
+       L and U. The factorization is updated by the next SetOperator(). */
+   void SetThreshold(double tol, int p);
+
+   /// Factor the SparseMatrix @a a.
+   virtual void SetOperator(const Operator &a);
+
+   /// Number of nonzeros of the factors L and U.
+   int NumNonZeroElems() const { return J.Size(); }
+
+   /// Matrix vector multiplication with ILU smoother.
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
+/** @brief Incomplete Cholesky smoother of symmetric positive definite sparse
+    matrix, IC(k), which uses the pattern of ILU(k), default k = 0.
+
+    The factorization A ~ L D L^t is computed from the upper triangular part
+    of the matrix only, using half the work of ILU(k); the symbolic
+    factorization is reused as in ILUSmoother. If the factorization breaks
+    down with a non-positive pivot, it is restarted with a shifted diagonal,
+    (1 + alpha) diag(A), doubling alpha starting from 0.001. */
+class ICSmoother : public ILUSmoother
+{
+protected:
+   /// Position of the transpose of each entry of the factors.
+   Array<int> mirror;
+   double shift;
+
+   virtual void Factor();
+
+public:
+   /// Create IC(k) smoother.
+   ICSmoother(int k = 0) : ILUSmoother(k) { shift = 0.0; }
+
+   /// Create and factor IC(k) smoother.
+   ICSmoother(const SparseMatrix &a, int k = 0);
+
+   /// The diagonal shift alpha used by the last factorization.
+   double GetShift() const { return shift; }
+};
+
+/** @brief Block Jacobi smoother of sparse matrix, whose diagonal blocks are
+    the rows and columns [k*block_size, (k+1)*block_size), e.g. the element
+    blocks of a scalar DG space on a mesh with one element type.
+
+    SetOperator() extracts the diagonal blocks and inverts them with batched
+    LU factorizations (see DenseBatch); Mult() multiplies by the inverse
+    blocks. If iterative_mode is true, Mult() performs one step of the
+    iteration y += D^{-1} (x - A y). */
+class BlockJacobiSmoother : public SparseSmoother
+{
+protected:
+   int block_size;
+   Vector blocks_inv; ///< The inverse diagonal blocks, column-major
+   mutable Vector r;
+
+public:
+   /// Create block Jacobi smoother with blocks of size @a bs.
+   BlockJacobiSmoother(int bs) { block_size = bs; }
+
+   /// Create block Jacobi smoother of @a a with blocks of size @a bs.
+   BlockJacobiSmoother(const SparseMatrix &a, int bs);
+
+   /// Extract and invert the diagonal blocks of the SparseMatrix @a a.
+   virtual void SetOperator(const Operator &a);
+
+   /// Matrix vector multiplication with block Jacobi smoother.
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
 }
 
 #endif
@@ -396,6 +396,10 @@ struct StridedLayout4D
    {
       return S1*i1+S2*i2+S3*i3+S4*i4;
    }
+   static OffsetStridedLayout2D<N3,S3,N4,S4> ind12(int i1, int i2)
+   {
+      return OffsetStridedLayout2D<N3,S3,N4,S4>(S1*i1+S2*i2);
+   }
    static OffsetStridedLayout2D<N1,S1,N4,S4> ind23(int i2, int i3)
    {
       return OffsetStridedLayout2D<N1,S1,N4,S4>(S2*i2+S3*i3);
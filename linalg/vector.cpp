@@ -24,6 +24,7 @@
 #include <cstdlib>
 #include <ctime>
 #include <limits>
+#include <algorithm>
 
 namespace mfem
 {
@@ -37,6 +38,7 @@ Vector::Vector(const Vector &v)
       MFEM_ASSERT(v.data, "invalid source vector");
       allocsize = size = s;
       data = new double[s];
+      FirstTouch(data, s);
       std::memcpy(data, v.data, sizeof(double)*s);
    }
    else
@@ -86,14 +88,74 @@ const double &Vector::Elem(int i) const
    return operator()(i);
 }
 
+#ifdef MFEM_USE_OPENMP
+// Deterministic threaded reduction: the partial results of the blocks of
+// ThreadsReductionBlock entries, Op()(begin, end), are summed in order.
+template <typename Op>
+static double BlockReduce(int n, const Op &op)
+{
+   const int nb = (n + ThreadsReductionBlock - 1)/ThreadsReductionBlock;
+   Array<double> partial(nb);
+   #pragma omp parallel for
+   for (int b = 0; b < nb; b++)
+   {
+      partial[b] = op(b*ThreadsReductionBlock,
+                      std::min(n, (b+1)*ThreadsReductionBlock));
+   }
+   double sum = 0.0;
+   for (int b = 0; b < nb; b++)
+   {
+      sum += partial[b];
+   }
+   return sum;
+}
+
+struct DotOp
+{
+   const double *x, *y;
+   double operator()(int begin, int end) const
+   {
+      double prod = 0.0;
+      for (int i = begin; i < end; i++) { prod += x[i] * y[i]; }
+      return prod;
+   }
+};
+
+struct AbsSumOp
+{
+   const double *x;
+   double operator()(int begin, int end) const
+   {
+      double sum = 0.0;
+      for (int i = begin; i < end; i++) { sum += std::abs(x[i]); }
+      return sum;
+   }
+};
+
+struct SumOp
+{
+   const double *x;
+   double operator()(int begin, int end) const
+   {
+      double sum = 0.0;
+      for (int i = begin; i < end; i++) { sum += x[i]; }
+      return sum;
+   }
+};
+#endif
+
 double Vector::operator*(const double *v) const
 {
    int s = size;
    const double *d = data;
-   double prod = 0.0;
 #ifdef MFEM_USE_OPENMP
-   #pragma omp parallel for reduction(+:prod)
+   if (s > ThreadsReductionBlock)
+   {
+      DotOp op = { d, v };
+      return BlockReduce(s, op);
+   }
 #endif
+   double prod = 0.0;
    for (int i = 0; i < s; i++)
    {
       prod += d[i] * v[i];
@@ -131,17 +193,23 @@ Vector &Vector::operator=(const Vector &v)
 
 Vector &Vector::operator=(double value)
 {
-   int i, s = size;
+   const int s = size;
    double *p = data, v = value;
-   for (i = 0; i < s; i++)
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for if(s >= ThreadsFirstTouchSize)
+#endif
+   for (int i = 0; i < s; i++)
    {
-      *(p++) = v;
+      p[i] = v;
    }
    return *this;
 }
 
 Vector &Vector::operator*=(double c)
 {
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for if(size >= ThreadsFirstTouchSize)
+#endif
    for (int i = 0; i < size; i++)
    {
       data[i] *= c;
@@ -152,6 +220,9 @@ Vector &Vector::operator*=(double c)
 Vector &Vector::operator/=(double c)
 {
    double m = 1.0/c;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for if(size >= ThreadsFirstTouchSize)
+#endif
    for (int i = 0; i < size; i++)
    {
       data[i] *= m;
@@ -161,6 +232,9 @@ Vector &Vector::operator/=(double c)
 
 Vector &Vector::operator-=(double c)
 {
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for if(size >= ThreadsFirstTouchSize)
+#endif
    for (int i = 0; i < size; i++)
    {
       data[i] -= c;
@@ -175,6 +249,9 @@ Vector &Vector::operator-=(const Vector &v)
    {
       mfem_error("Vector::operator-=(const Vector &)");
    }
+#endif
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for if(size >= ThreadsFirstTouchSize)
 #endif
    for (int i = 0; i < size; i++)
    {
@@ -190,6 +267,9 @@ Vector &Vector::operator+=(const Vector &v)
    {
       mfem_error("Vector::operator+=(const Vector &)");
    }
+#endif
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for if(size >= ThreadsFirstTouchSize)
 #endif
    for (int i = 0; i < size; i++)
    {
@@ -208,6 +288,9 @@ Vector &Vector::Add(const double a, const Vector &Va)
 #endif
    if (a != 0.0)
    {
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for if(size >= ThreadsFirstTouchSize)
+#endif
       for (int i = 0; i < size; i++)
       {
          data[i] += a * Va(i);
@@ -223,6 +306,9 @@ Vector &Vector::Set(const double a, const Vector &Va)
    {
       mfem_error("Vector::Set(const double, const Vector &)");
    }
+#endif
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for if(size >= ThreadsFirstTouchSize)
 #endif
    for (int i = 0; i < size; i++)
    {
@@ -251,6 +337,9 @@ void Vector::SetVector(const Vector &v, int offset)
 
 void Vector::Neg()
 {
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for if(size >= ThreadsFirstTouchSize)
+#endif
    for (int i = 0; i < size; i++)
    {
       data[i] = -data[i];
@@ -267,7 +356,7 @@ void add(const Vector &v1, const Vector &v2, Vector &v)
 #endif
 
 #ifdef MFEM_USE_OPENMP
-   #pragma omp parallel for
+   #pragma omp parallel for if(v.size >= ThreadsFirstTouchSize)
 #endif
    for (int i = 0; i < v.size; i++)
    {
@@ -297,7 +386,7 @@ void add(const Vector &v1, double alpha, const Vector &v2, Vector &v)
       double *vp = v.data;
       int s = v.size;
 #ifdef MFEM_USE_OPENMP
-      #pragma omp parallel for
+      #pragma omp parallel for if(s >= ThreadsFirstTouchSize)
 #endif
       for (int i = 0; i < s; i++)
       {
@@ -329,7 +418,7 @@ void add(const double a, const Vector &x, const Vector &y, Vector &z)
       int            s = x.size;
 
 #ifdef MFEM_USE_OPENMP
-      #pragma omp parallel for
+      #pragma omp parallel for if(s >= ThreadsFirstTouchSize)
 #endif
       for (int i = 0; i < s; i++)
       {
@@ -374,7 +463,7 @@ void add(const double a, const Vector &x,
       int            s = x.size;
 
 #ifdef MFEM_USE_OPENMP
-      #pragma omp parallel for
+      #pragma omp parallel for if(s >= ThreadsFirstTouchSize)
 #endif
       for (int i = 0; i < s; i++)
       {
@@ -397,7 +486,7 @@ void subtract(const Vector &x, const Vector &y, Vector &z)
    int            s = x.size;
 
 #ifdef MFEM_USE_OPENMP
-   #pragma omp parallel for
+   #pragma omp parallel for if(s >= ThreadsFirstTouchSize)
 #endif
    for (int i = 0; i < s; i++)
    {
@@ -429,7 +518,7 @@ void subtract(const double a, const Vector &x, const Vector &y, Vector &z)
       int            s = x.size;
 
 #ifdef MFEM_USE_OPENMP
-      #pragma omp parallel for
+      #pragma omp parallel for if(s >= ThreadsFirstTouchSize)
 #endif
       for (int i = 0; i < s; i++)
       {
@@ -665,25 +754,17 @@ void Vector::Randomize(int seed)
    }
 }
 
-double Vector::Norml2() const
+// Compute the 2-norm of data[begin,end) as scale * sqrt(sum)
+static void ScaledSquareSum(const double *data, int begin, int end,
+                            double &scale, double &sum)
 {
    // Scale entries of Vector on the fly, using algorithms from
    // std::hypot() and LAPACK's drm2. This scaling ensures that the
    // argument of each call to std::pow is <= 1 to avoid overflow.
-   if (0 == size)
-   {
-      return 0.0;
-   } // end if 0 == size
-
-   if (1 == size)
-   {
-      return std::abs(data[0]);
-   } // end if 1 == size
+   scale = 0.0;
+   sum = 0.0;
 
-   double scale = 0.0;
-   double sum = 0.0;
-
-   for (int i = 0; i < size; i++)
+   for (int i = begin; i < end; i++)
    {
       if (data[i] != 0.0)
       {
@@ -699,12 +780,62 @@ double Vector::Norml2() const
          sum += (sqr_arg * sqr_arg); // else scale > absdata
       } // end if data[i] != 0
    }
+}
+
+double Vector::Norml2() const
+{
+   if (0 == size)
+   {
+      return 0.0;
+   } // end if 0 == size
+
+   if (1 == size)
+   {
+      return std::abs(data[0]);
+   } // end if 1 == size
+
+   double scale, sum;
+#ifdef MFEM_USE_OPENMP
+   if (size > ThreadsReductionBlock)
+   {
+      // Combine the scaled sums of the blocks in order, as in the sequential
+      // loop
+      const int nb = (size + ThreadsReductionBlock - 1)/ThreadsReductionBlock;
+      Array<double> bscale(nb), bsum(nb);
+      #pragma omp parallel for
+      for (int b = 0; b < nb; b++)
+      {
+         ScaledSquareSum(data, b*ThreadsReductionBlock,
+                         std::min(size, (b+1)*ThreadsReductionBlock),
+                         bscale[b], bsum[b]);
+      }
+      scale = sum = 0.0;
+      for (int b = 0; b < nb; b++)
+      {
+         if (bscale[b] == 0.0) { continue; }
+         if (scale <= bscale[b])
+         {
+            const double sqr_arg = scale / bscale[b];
+            sum = bsum[b] + sum * (sqr_arg * sqr_arg);
+            scale = bscale[b];
+            continue;
+         }
+         const double sqr_arg = bscale[b] / scale;
+         sum += bsum[b] * (sqr_arg * sqr_arg);
+      }
+      return scale * std::sqrt(sum);
+   }
+#endif
+   ScaledSquareSum(data, 0, size, scale, sum);
    return scale * std::sqrt(sum);
 }
 
 double Vector::Normlinf() const
 {
    double max = 0.0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for reduction(max:max) if(size > ThreadsReductionBlock)
+#endif
    for (int i = 0; i < size; i++)
    {
       max = std::max(std::abs(data[i]), max);
@@ -714,6 +845,13 @@ double Vector::Normlinf() const
 
 double Vector::Norml1() const
 {
+#ifdef MFEM_USE_OPENMP
+   if (size > ThreadsReductionBlock)
+   {
+      AbsSumOp op = { data };
+      return BlockReduce(size, op);
+   }
+#endif
    double sum = 0.0;
    for (int i = 0; i < size; i++)
    {
@@ -799,6 +937,13 @@ double Vector::Min() const
 
 double Vector::Sum() const
 {
+#ifdef MFEM_USE_OPENMP
+   if (size > ThreadsReductionBlock)
+   {
+      SumOp op = { data };
+      return BlockReduce(size, op);
+   }
+#endif
    double sum = 0.0;
 
    for (int i = 0; i < size; i++)
@@ -16,6 +16,7 @@
 
 #include "../general/array.hpp"
 #include "../general/globals.hpp"
+#include "../general/threads.hpp"
 #ifdef MFEM_USE_SUNDIALS
 #include <nvector/nvector_serial.h>
 #endif
@@ -317,6 +318,7 @@ inline Vector::Vector (int s)
    {
       allocsize = size = s;
       data = new double[s];
+      FirstTouch(data, s);
    }
    else
    {
@@ -342,6 +344,7 @@ inline void Vector::SetSize(int s)
    }
    allocsize = size = s;
    data = new double[s];
+   FirstTouch(data, s);
 }
 
 inline void Vector::Destroy()
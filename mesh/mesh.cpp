@@ -48,6 +48,10 @@ extern "C" {
 #include "graph.h"
 #endif
 
+#ifdef MFEM_USE_OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 
 namespace mfem
@@ -335,6 +339,7 @@ void Mesh::GetElementTransformation(int i, IsoparametricTransformation *ElTr)
 {
    ElTr->Attribute = GetAttribute(i);
    ElTr->ElementNo = i;
+   ElTr->mesh = this;
    if (Nodes == NULL)
    {
       GetPointMatrix(i, ElTr->GetPointMat());
@@ -365,6 +370,7 @@ void Mesh::GetElementTransformation(int i, const Vector &nodes,
 {
    ElTr->Attribute = GetAttribute(i);
    ElTr->ElementNo = i;
+   ElTr->mesh = NULL;
    DenseMatrix &pm = ElTr->GetPointMat();
    if (Nodes == NULL)
    {
@@ -418,6 +424,7 @@ void Mesh::GetBdrElementTransformation(int i, IsoparametricTransformation* ElTr)
 {
    ElTr->Attribute = GetBdrAttribute(i);
    ElTr->ElementNo = i; // boundary element number
+   ElTr->mesh = NULL;
    if (Nodes == NULL)
    {
       GetBdrPointMatrix(i, ElTr->GetPointMat());
@@ -447,6 +454,7 @@ void Mesh::GetFaceTransformation(int FaceNo, IsoparametricTransformation *FTr)
 {
    FTr->Attribute = (Dim == 1) ? 1 : faces[FaceNo]->GetAttribute();
    FTr->ElementNo = FaceNo;
+   FTr->mesh = NULL;
    DenseMatrix &pm = FTr->GetPointMat();
    if (Nodes == NULL)
    {
@@ -526,6 +534,7 @@ void Mesh::GetEdgeTransformation(int EdgeNo, IsoparametricTransformation *EdTr)
 
    EdTr->Attribute = 1;
    EdTr->ElementNo = EdgeNo;
+   EdTr->mesh = NULL;
    DenseMatrix &pm = EdTr->GetPointMat();
    if (Nodes == NULL)
    {
@@ -919,6 +928,8 @@ void Mesh::Init()
    NURBSext = NULL;
    ncmesh = NULL;
    last_operation = Mesh::NONE;
+   elem_box_index = NULL;
+   cache_geom_factors = true;
 }
 
 void Mesh::InitTables()
@@ -952,6 +963,9 @@ void Mesh::DestroyPointers()
 {
    if (own_nodes) { delete Nodes; }
 
+   delete elem_box_index;
+   DeleteGeometricFactors();
+
    delete ncmesh;
 
    delete NURBSext;
@@ -1328,6 +1342,111 @@ void Mesh::GetGeckoElementReordering(Array<int> &ordering)
 }
 #endif
 
+void Mesh::GetRCMElementReordering(Array<int> &ordering)
+{
+   ReverseCuthillMcKee(ElementToElementTable(), ordering);
+}
+
+// Position of the point with integer coordinates X[0..n-1], of b bits each,
+// along the Hilbert curve (hilbert = true) or the Morton curve. The Hilbert
+// index uses the transpose algorithm of J. Skilling, "Programming the Hilbert
+// curve", AIP Conf. Proc. 707 (2004). Overwrites X.
+static unsigned SpaceFillingCurveKey(unsigned *X, int n, int b, bool hilbert)
+{
+   if (hilbert)
+   {
+      const unsigned M = 1u << (b-1);
+      // inverse undo of the excess work
+      for (unsigned Q = M; Q > 1; Q >>= 1)
+      {
+         const unsigned P = Q - 1;
+         for (int i = 0; i < n; i++)
+         {
+            if (X[i] & Q) { X[0] ^= P; }
+            else
+            {
+               const unsigned t = (X[0] ^ X[i]) & P;
+               X[0] ^= t;
+               X[i] ^= t;
+            }
+         }
+      }
+      // Gray encode
+      for (int i = 1; i < n; i++) { X[i] ^= X[i-1]; }
+      unsigned t = 0;
+      for (unsigned Q = M; Q > 1; Q >>= 1)
+      {
+         if (X[n-1] & Q) { t ^= Q - 1; }
+      }
+      for (int i = 0; i < n; i++) { X[i] ^= t; }
+   }
+   // interleave the bits, from the most significant
+   unsigned key = 0;
+   for (int j = b-1; j >= 0; j--)
+   {
+      for (int i = 0; i < n; i++)
+      {
+         key = (key << 1) | ((X[i] >> j) & 1u);
+      }
+   }
+   return key;
+}
+
+void Mesh::GetSpaceFillingCurveElementReordering(bool hilbert,
+                                                 Array<int> &ordering)
+{
+   const int NE = GetNE(), sdim = spaceDim;
+   const int bits = 30/sdim; // the key fits in 30 bits
+
+   DenseMatrix centers(sdim, NE);
+   Vector center, cmin(sdim), cmax(sdim);
+   cmin = infinity();
+   cmax = -infinity();
+   for (int i = 0; i < NE; i++)
+   {
+      center.SetDataAndSize(centers.GetColumn(i), sdim);
+      GetElementCenter(i, center);
+      for (int d = 0; d < sdim; d++)
+      {
+         cmin(d) = std::min(cmin(d), center(d));
+         cmax(d) = std::max(cmax(d), center(d));
+      }
+   }
+
+   const double cells = double((1u << bits) - 1);
+   Array<Pair<unsigned, int> > key_el;
+   key_el.Reserve(NE);
+   unsigned X[3];
+   for (int i = 0; i < NE; i++)
+   {
+      for (int d = 0; d < sdim; d++)
+      {
+         const double len = cmax(d) - cmin(d);
+         const double x = (len > 0.0) ? (centers(d,i) - cmin(d))/len : 0.0;
+         X[d] = unsigned(x*cells + 0.5);
+      }
+      key_el.Append(Pair<unsigned, int>(
+                       SpaceFillingCurveKey(X, sdim, bits, hilbert), i));
+   }
+   std::stable_sort(key_el.GetData(), key_el.GetData() + NE);
+
+   ordering.SetSize(NE);
+   for (int i = 0; i < NE; i++)
+   {
+      ordering[key_el[i].two] = i;
+   }
+}
+
+void Mesh::GetHilbertElementReordering(Array<int> &ordering)
+{
+   GetSpaceFillingCurveElementReordering(true, ordering);
+}
+
+void Mesh::GetMortonElementReordering(Array<int> &ordering)
+{
+   GetSpaceFillingCurveElementReordering(false, ordering);
+}
+
 
 void Mesh::ReorderElements(const Array<int> &ordering, bool reorder_vertices)
 {
@@ -2525,6 +2644,8 @@ Mesh::Mesh(const Mesh &mesh, bool copy_nodes)
    // Create the new Mesh instance without a record of its refinement history
    sequence = 0;
    last_operation = Mesh::NONE;
+   elem_box_index = NULL;
+   cache_geom_factors = mesh.cache_geom_factors;
 
    // Duplicate the elements
    elements.SetSize(NumOfElements);
@@ -2654,6 +2775,21 @@ Mesh::Mesh(std::istream &input, int generate_edges, int refine,
    Load(input, generate_edges, refine, fix_orientation);
 }
 
+Mesh::Mesh(MappedFile &file, int generate_edges, int refine,
+           bool fix_orientation)
+{
+   SetEmpty();
+
+   const std::string id = "MFEM binary mesh v1.0\n";
+   MFEM_VERIFY(file.Size() >= id.size() &&
+               id.compare(0, id.size(), file.GetData(), id.size()) == 0,
+               "the mapped file is not an MFEM binary mesh");
+   bin_io::SectionReader sections(file.GetData() + id.size(),
+                                  file.Size() - id.size(), id.size());
+   LoadBinarySections(sections, true);
+   Finalize(refine, fix_orientation);
+}
+
 void Mesh::ChangeVertexDataOwnership(double *vertex_data, int len_vertex_data,
                                      bool zerocopy)
 {
@@ -2898,6 +3034,11 @@ void Mesh::Loader(std::istream &input, int generate_edges,
    {
       ReadNURBSMesh(input, curved, read_gf);
    }
+   else if (mesh_type == "MFEM binary mesh v1.0")
+   {
+      ReadMFEMBinaryMesh(input); // also sets up the topology and the nodes
+      finalize_topo = false;
+   }
    else if (mesh_type == "MFEM INLINE mesh v1.0")
    {
       ReadInlineMesh(input, generate_edges);
@@ -5579,6 +5720,7 @@ void Mesh::MoveVertices(const Vector &displacements)
       {
          vertices[i](j) += displacements(j*nv+i);
       }
+   NodesUpdated();
 }
 
 void Mesh::GetVertices(Vector &vert_coord) const
@@ -5599,6 +5741,7 @@ void Mesh::SetVertices(const Vector &vert_coord)
       {
          vertices[i](j) = vert_coord(j*nv+i);
       }
+   NodesUpdated();
 }
 
 void Mesh::GetNode(int i, double *coord)
@@ -5638,6 +5781,7 @@ void Mesh::SetNode(int i, const double *coord)
       }
 
    }
+   NodesUpdated();
 }
 
 void Mesh::MoveNodes(const Vector &displacements)
@@ -5645,6 +5789,7 @@ void Mesh::MoveNodes(const Vector &displacements)
    if (Nodes)
    {
       (*Nodes) += displacements;
+      NodesUpdated();
    }
    else
    {
@@ -5669,6 +5814,7 @@ void Mesh::SetNodes(const Vector &node_coord)
    if (Nodes)
    {
       (*Nodes) = node_coord;
+      NodesUpdated();
    }
    else
    {
@@ -5688,18 +5834,111 @@ void Mesh::NewNodes(GridFunction &nodes, bool make_owner)
       delete NURBSext;
       NURBSext = nodes.FESpace()->StealNURBSext();
    }
+   NodesUpdated();
 }
 
 void Mesh::SwapNodes(GridFunction *&nodes, int &own_nodes_)
 {
    mfem::Swap<GridFunction*>(Nodes, nodes);
    mfem::Swap<int>(own_nodes, own_nodes_);
+   NodesUpdated();
    // TODO:
    // if (nodes)
    //    nodes->FESpace()->MakeNURBSextOwner();
    // NURBSext = (Nodes) ? Nodes->FESpace()->StealNURBSext() : NULL;
 }
 
+void Mesh::NodesUpdated()
+{
+   delete elem_box_index;
+   elem_box_index = NULL;
+   DeleteGeometricFactors();
+}
+
+const GeometricFactors *Mesh::FindGeometricFactors(const IntegrationRule &ir,
+                                                   bool faces, int flags,
+                                                   int elem,
+                                                   const DenseMatrix *pm)
+{
+   if (!cache_geom_factors) { return NULL; }
+
+   // The factors are cached per geometry: the one of the element, or the
+   // single geometry of the mesh for the requests of all elements.
+   Geometry::Type geom;
+   if (elem >= 0) { geom = GetElementBaseGeometry(elem); }
+   else if (GetNumGeometries(Dim - (faces ? 1 : 0)) == 1 &&
+            (faces ? GetNumFaces() : GetNE()) > 0)
+   {
+      geom = faces ? GetFaceBaseGeometry(0) : GetElementBaseGeometry(0);
+   }
+   else { return NULL; }
+
+   // Look for current factors without modifying the cache. Hashing the point
+   // matrix of one element is cheap enough to be done on every lookup of the
+   // element loops.
+   uint64_t hash = pm ? 0 : GeometricFactors::CoordinatesHash(*this);
+   int all_flags = flags;
+   for (int i = 0; i < geom_factors.Size(); i++)
+   {
+      GeometricFactors *f = geom_factors[i];
+      if (f->faces != faces || f->geom != geom || f->GetRule() != &ir ||
+          !f->IsCurrent(*this) || !f->HasRule(ir) ||
+          !(pm ? f->HasElement(elem, *pm) : f->HasCoordinates(hash)))
+      {
+         continue;
+      }
+      if ((f->flags & flags) == flags) { return f; }
+      all_flags |= f->flags;
+   }
+#ifdef MFEM_USE_OPENMP
+   if (omp_in_parallel()) { return NULL; }
+#endif
+
+   // Drop the factors of previous versions of the mesh, of its coordinates or
+   // of the rule; if the rule has factors with other flags, compute them all
+   // again.
+   if (pm) { hash = GeometricFactors::CoordinatesHash(*this); }
+   for (int i = 0; i < geom_factors.Size(); )
+   {
+      GeometricFactors *f = geom_factors[i];
+      if (!f->IsCurrent(*this) || !f->HasCoordinates(hash) ||
+          (f->GetRule() == &ir && (!f->HasRule(ir) ||
+                                   (f->faces == faces && f->geom == geom))))
+      {
+         delete f;
+         geom_factors.DeleteFirst(f);
+         continue;
+      }
+      i++;
+   }
+   if (geom_factors.Size() == max_geom_factors)
+   {
+      GeometricFactors *oldest = geom_factors[0];
+      delete oldest;
+      geom_factors.DeleteFirst(oldest);
+   }
+   GeometricFactors *gf =
+      new GeometricFactors(*this, ir, faces, all_flags, geom);
+   geom_factors.Append(gf);
+   // A point matrix that does not match the mesh, e.g. modified by the caller
+   return (pm && !gf->HasElement(elem, *pm)) ? NULL : gf;
+}
+
+void Mesh::DeleteGeometricFactors()
+{
+   for (int i = 0; i < geom_factors.Size(); i++)
+   {
+      delete geom_factors[i];
+   }
+   geom_factors.SetSize(0);
+}
+
+void Mesh::EnableGeometricFactorsCache(bool enable)
+{
+   cache_geom_factors = enable;
+   if (!enable) { DeleteGeometricFactors(); }
+}
+
 void Mesh::AverageVertices(const int *indexes, int n, int result)
 {
    int j, k;
@@ -6928,6 +7167,10 @@ void Mesh::Swap(Mesh& other, bool non_geometry)
       mfem::Swap(Nodes, other.Nodes);
       mfem::Swap(own_nodes, other.own_nodes);
    }
+
+   // the spatial indices refer to their mesh objects: rebuild on demand
+   NodesUpdated();
+   other.NodesUpdated();
 }
 
 void Mesh::GetElementData(const Array<Element*> &elem_array, int geom,
@@ -7831,6 +8074,66 @@ void Mesh::Printer(std::ostream &out, std::string section_delimiter) const
    }
 }
 
+// Element data in the MFEM binary mesh format: attribute, geometry and vertex
+// indices of each element, see Mesh::ReadBinaryElements().
+static void GetBinaryElementData(const Array<Element*> &elems, int num_elems,
+                                 Array<int> &data)
+{
+   data.SetSize(0);
+   for (int i = 0; i < num_elems; i++)
+   {
+      const Element *el = elems[i];
+      data.Append(el->GetAttribute());
+      data.Append(el->GetGeometryType());
+      data.Append(el->GetVertices(), el->GetNVertices());
+   }
+}
+
+void Mesh::PrintBinary(std::ostream &out) const
+{
+   MFEM_VERIFY(!NURBSext && !ncmesh, "the binary format does not support "
+               "NURBS and non-conforming meshes");
+
+   const std::string id = "MFEM binary mesh v1.0\n";
+   int info[6] = { Dim, spaceDim, NumOfVertices, NumOfElements,
+                   NumOfBdrElements, Nodes ? 1 : 0
+                 };
+   Array<int> elem_data, bdr_data;
+   GetBinaryElementData(elements, NumOfElements, elem_data);
+   GetBinaryElementData(boundary, NumOfBdrElements, bdr_data);
+   std::string nodes_space;
+   if (Nodes)
+   {
+      std::ostringstream os;
+      Nodes->FESpace()->Save(os);
+      nodes_space = os.str();
+   }
+
+   bin_io::SectionTable sections(id.size());
+   sections.Add(BIN_INFO, sizeof(info));
+   sections.Add(BIN_VERTICES, NumOfVertices*sizeof(Vertex));
+   sections.Add(BIN_ELEMENTS, elem_data.Size()*sizeof(int));
+   sections.Add(BIN_BOUNDARY, bdr_data.Size()*sizeof(int));
+   if (Nodes)
+   {
+      sections.Add(BIN_NODES_SPACE, nodes_space.size());
+      sections.Add(BIN_NODES, Nodes->Size()*sizeof(double));
+   }
+
+   out << id;
+   sections.Write(out);
+   sections.WriteSection(out, 0, info);
+   sections.WriteSection(out, 1, vertices.GetData());
+   sections.WriteSection(out, 2, elem_data.GetData());
+   sections.WriteSection(out, 3, bdr_data.GetData());
+   if (Nodes)
+   {
+      sections.WriteSection(out, 4, nodes_space.data());
+      sections.WriteSection(out, 5, Nodes->GetData());
+   }
+   out.flush();
+}
+
 void Mesh::PrintTopo(std::ostream &out,const Array<int> &e_to_k) const
 {
    int i;
@@ -9016,6 +9319,7 @@ void Mesh::Transform(void (*f)(const Vector&, Vector&))
       xnew.ProjectCoefficient(f_pert);
       *Nodes = xnew;
    }
+   NodesUpdated();
 }
 
 void Mesh::Transform(VectorCoefficient &deformation)
@@ -9040,6 +9344,7 @@ void Mesh::Transform(VectorCoefficient &deformation)
       xnew.ProjectCoefficient(deformation);
       *Nodes = xnew;
    }
+   NodesUpdated();
 }
 
 void Mesh::RemoveUnusedVertices()
@@ -9274,77 +9579,33 @@ int Mesh::FindPoints(DenseMatrix &point_mat, Array<int>& elem_ids,
    elem_ids = -1;
    if (!GetNE()) { return 0; }
 
+   if (!elem_box_index) { elem_box_index = new ElementBoxIndex(*this); }
+   else { elem_box_index->Update(); }
+
    double *data = point_mat.GetData();
    InverseElementTransformation *inv_tr = inv_trans;
    inv_tr = inv_tr ? inv_tr : new InverseElementTransformation;
 
-   // For each point in 'point_mat', find the element whose center is closest.
-   Vector min_dist(npts);
-   Array<int> e_idx(npts);
-   min_dist = std::numeric_limits<double>::max();
-   e_idx = -1;
-
-   Vector pt(spaceDim);
-   for (int i = 0; i < GetNE(); i++)
-   {
-      GetElementTransformation(i)->Transform(
-         Geometries.GetCenter(GetElementBaseGeometry(i)), pt);
-      for (int k = 0; k < npts; k++)
-      {
-         double dist = pt.DistanceTo(data+k*spaceDim);
-         if (dist < min_dist(k))
-         {
-            min_dist(k) = dist;
-            e_idx[k] = i;
-         }
-      }
-   }
-
-   // Checks if the points lie in the closest element
+   // For each point in 'point_mat', try the elements whose bounding box
+   // contains the point, until one of them is found to contain it.
    int pts_found = 0;
-   pt.NewDataAndSize(NULL, spaceDim);
+   Array<int> candidates;
+   Vector pt(NULL, spaceDim);
    for (int k = 0; k < npts; k++)
    {
       pt.SetData(data+k*spaceDim);
-      inv_tr->SetTransformation(*GetElementTransformation(e_idx[k]));
-      int res = inv_tr->Transform(pt, ips[k]);
-      if (res == InverseElementTransformation::Inside)
-      {
-         elem_ids[k] = e_idx[k];
-         pts_found++;
-      }
-   }
-   if (pts_found != npts)
-   {
-      Array<int> vertices;
-      Table *vtoel = GetVertexToElementTable();
-      for (int k = 0; k < npts; k++)
+      elem_box_index->FindCandidates(pt.GetData(), candidates);
+      for (int i = 0; i < candidates.Size(); i++)
       {
-         if (elem_ids[k] != -1) { continue; }
-         // Try all vertex-neighbors of element e_idx[k]
-         pt.SetData(data+k*spaceDim);
-         GetElementVertices(e_idx[k], vertices);
-         for (int v = 0; v < vertices.Size(); v++)
+         inv_tr->SetTransformation(*GetElementTransformation(candidates[i]));
+         int res = inv_tr->Transform(pt, ips[k]);
+         if (res == InverseElementTransformation::Inside)
          {
-            int vv = vertices[v];
-            int ne = vtoel->RowSize(vv);
-            const int* els = vtoel->GetRow(vv);
-            for (int e = 0; e < ne; e++)
-            {
-               if (els[e] == e_idx[k]) { continue; }
-               inv_tr->SetTransformation(*GetElementTransformation(els[e]));
-               int res = inv_tr->Transform(pt, ips[k]);
-               if (res == InverseElementTransformation::Inside)
-               {
-                  elem_ids[k] = els[e];
-                  pts_found++;
-                  goto next_point;
-               }
-            }
+            elem_ids[k] = candidates[i];
+            pts_found++;
+            break;
          }
-      next_point: ;
       }
-      delete vtoel;
    }
    if (inv_trans == NULL) { delete inv_tr; }
 
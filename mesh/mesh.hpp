@@ -19,9 +19,11 @@
 #include "tetrahedron.hpp"
 #include "vertex.hpp"
 #include "ncmesh.hpp"
+#include "mesh_geom.hpp"
 #include "../fem/eltrans.hpp"
 #include "../fem/coefficient.hpp"
 #include "../general/gzstream.hpp"
+#include "../general/binaryio.hpp"
 #include <iostream>
 
 namespace mfem
@@ -33,6 +35,7 @@ class KnotVector;
 class NURBSExtension;
 class FiniteElementSpace;
 class GridFunction;
+class ElementBoxIndex;
 struct Refinement;
 
 #ifdef MFEM_USE_MPI
@@ -46,8 +49,10 @@ class Mesh
 #ifdef MFEM_USE_MPI
    friend class ParMesh;
    friend class ParNCMesh;
+   friend class ParCheckpoint;
 #endif
    friend class NURBSExtension;
+   friend class ElementTransformation;
 
 protected:
    int Dim;
@@ -150,6 +155,13 @@ protected:
    GridFunction *Nodes;
    int own_nodes;
 
+   // Spatial index of the elements used by FindPoints(), built on first use.
+   ElementBoxIndex *elem_box_index;
+
+   // Cached geometric factors, see GetGeometricFactors().
+   Array<GeometricFactors*> geom_factors;
+   bool cache_geom_factors;
+
    static const int vtk_quadratic_tet[10];
    static const int vtk_quadratic_wedge[18];
    static const int vtk_quadratic_hex[27];
@@ -212,6 +224,7 @@ protected:
    void ReadNURBSMesh(std::istream &input, int &curved, int &read_gf);
    void ReadInlineMesh(std::istream &input, int generate_edges = 0);
    void ReadGmshMesh(std::istream &input);
+   void ReadMFEMBinaryMesh(std::istream &input);
    /* Note NetCDF (optional library) is used for reading cubit files */
 #ifdef MFEM_USE_NETCDF
    void ReadCubit(const char *filename, int &curved, int &read_gf);
@@ -230,6 +243,10 @@ protected:
 
    void GetElementCenter(int i, Vector &c);
 
+   /// Element ordering along the Hilbert or the Morton curve.
+   void GetSpaceFillingCurveElementReordering(bool hilbert,
+                                              Array<int> &ordering);
+
    void MarkForRefinement();
    void MarkTriMeshForRefinement();
    void GetEdgeOrdering(DSTable &v_to_v, Array<int> &order);
@@ -391,6 +408,20 @@ protected:
    void GenerateFaces();
    void GenerateNCFaceInfo();
 
+   /// Section ids of the MFEM binary mesh format, see PrintBinary().
+   enum BinarySection
+   {
+      BIN_INFO = 1, BIN_VERTICES, BIN_ELEMENTS, BIN_BOUNDARY, BIN_NODES_SPACE,
+      BIN_NODES
+   };
+
+   /** @brief Setup the mesh from the sections of a binary mesh file, see
+       PrintBinary(). With @a zerocopy, the vertices and the nodes use the
+       data of the sections directly, which requires sections in memory. */
+   void LoadBinarySections(bin_io::SectionReader &sections, bool zerocopy);
+   void ReadBinaryElements(bin_io::SectionReader &sections, uint32_t id,
+                           Array<Element*> &elems, int num_elems);
+
    /// Begin construction of a mesh
    void InitMesh(int _Dim, int _spaceDim, int NVert, int NElem, int NBdrElem);
 
@@ -437,6 +468,19 @@ protected:
    void GetElementData(const Array<Element*> &elem_array, int geom,
                        Array<int> &elem_vtx, Array<int> &attr) const;
 
+   /** @brief Find or compute the cached geometric factors of the elements or
+       faces of the geometry of element @a elem or, if @a elem < 0, of the
+       single geometry of the mesh. If @a pm is not NULL, the factors are
+       checked against the point matrix @a pm of element @a elem instead of
+       all the coordinates. */
+   const GeometricFactors *FindGeometricFactors(const IntegrationRule &ir,
+                                                bool faces, int flags,
+                                                int elem = -1,
+                                                const DenseMatrix *pm = NULL);
+
+   /// Delete the cached geometric factors.
+   void DeleteGeometricFactors();
+
 public:
 
    Mesh() { SetEmpty(); }
@@ -559,6 +603,22 @@ public:
    void GetGeckoElementReordering(Array<int> &ordering);
 #endif
 
+   /** @brief Compute the reverse Cuthill-McKee ordering of the elements,
+       based on their face-neighbor connectivity, see ElementToElementTable().
+       This reduces the bandwidth of the element connectivity and does not
+       require the Gecko library. */
+   void GetRCMElementReordering(Array<int> &ordering);
+
+   /** @brief Compute an element ordering along the Hilbert space-filling curve
+       through the element centers. Consecutive elements are always physically
+       close, which improves the memory locality of element-wise loops. */
+   void GetHilbertElementReordering(Array<int> &ordering);
+
+   /** @brief Compute an element ordering along the Morton (Z-order)
+       space-filling curve through the element centers. It is cheaper than the
+       Hilbert ordering but has jumps between the quadrants. */
+   void GetMortonElementReordering(Array<int> &ordering);
+
    /** Rebuilds the mesh with a different order of elements.  The ordering
        vector maps the old element number to the new element number.  This also
        reorders the vertices and nodes edges and faces along with the elements.  */
@@ -605,6 +665,13 @@ public:
    explicit Mesh(std::istream &input, int generate_edges = 0, int refine = 1,
                  bool fix_orientation = true);
 
+   /** @brief Creates mesh from a file in the MFEM binary mesh format (see
+       PrintBinary()) mapped into memory. The vertex coordinates and the nodes
+       of the mesh use the mapped data directly, without copying, so @a file
+       must not be closed before the mesh is destroyed. */
+   explicit Mesh(MappedFile &file, int generate_edges = 0, int refine = 1,
+                 bool fix_orientation = true);
+
    /// Create a disjoint mesh from the given mesh array
    Mesh(Mesh *mesh_array[], int num_pieces);
 
@@ -1007,6 +1074,56 @@ public:
        with the given ones. */
    void SwapNodes(GridFunction *&nodes, int &own_nodes_);
 
+   /** @brief Notify the mesh that its vertices or nodes were modified directly,
+       e.g. through GetNodes(), to invalidate the cached geometric data such as
+       the spatial index used by FindPoints().
+
+       The Mesh methods that modify the vertices or nodes, e.g. MoveNodes() or
+       Transform(), call this method automatically. */
+   void NodesUpdated();
+
+   /** @brief Return the geometric factors selected by @a flags (see
+       GeometricFactors::FactorFlags) of all elements at the points of @a ir,
+       or NULL if the elements have different geometries or the cache is
+       disabled.
+
+       The factors are cached per geometry, so on meshes with mixed element
+       types the element transformations still get the factors of the
+       elements of their geometry, see
+       ElementTransformation::GetGeometricFactors(); only this request of all
+       the elements returns NULL.
+
+       The factors are computed on the first request and cached; they are
+       recomputed when the mesh is refined or its vertex or node coordinates
+       change, which is detected with a hash of the coordinates, even if
+       NodesUpdated() was not called. The rule is identified by its address
+       and its points, so it should live as long as the mesh, e.g. a rule of
+       IntRules. At most max_geom_factors sets of factors are cached, the
+       oldest set is dropped first.
+
+       The cache is only modified outside of OpenMP parallel regions, so that
+       the lookups need no locking: inside a parallel region, the method
+       returns NULL if the factors are not already cached. The callers then
+       fall back to computing the factors from the element transformation,
+       which gives the same results, only slower; the parallel element loops
+       should request the factors of every geometry and rule they use before
+       the loop, see BilinearForm::BuildElementCaches(). */
+   const GeometricFactors *GetGeometricFactors(const IntegrationRule &ir,
+                                               int flags)
+   { return FindGeometricFactors(ir, false, flags); }
+
+   /// Same as GetGeometricFactors() for all the faces of the mesh.
+   const GeometricFactors *GetFaceGeometricFactors(const IntegrationRule &ir,
+                                                   int flags)
+   { return FindGeometricFactors(ir, true, flags); }
+
+   /// Maximum number of sets of factors cached by GetGeometricFactors().
+   static const int max_geom_factors = 8;
+
+   /** @brief Enable (the default) or disable the cache of geometric factors;
+       disabling the cache deletes the cached factors. */
+   void EnableGeometricFactorsCache(bool enable);
+
    /// Return the mesh nodes/vertices projected on the given GridFunction.
    void GetNodes(GridFunction &nodes) const;
    /** Replace the internal node GridFunction with a new GridFunction defined
@@ -1121,6 +1238,18 @@ public:
    /// \see mfem::ogzstream() for on-the-fly compression of ascii outputs
    virtual void Print(std::ostream &out = mfem::out) const { Printer(out); }
 
+   /** @brief Print the mesh in the MFEM binary mesh format.
+
+       The format stores the vertex coordinates (three doubles per vertex), the
+       elements and boundary elements (attribute, geometry and vertex indices)
+       and the optional mesh nodes as raw little-endian arrays in separate
+       sections, see bin_io::SectionTable. It can be read by all Mesh
+       constructors and Load(), including through compressed streams, and
+       without copying with a MappedFile. NURBS and non-conforming meshes are
+       not supported. For a ParMesh, only the local elements are written. */
+   /// \see mfem::ogzstream() for on-the-fly compression of binary outputs
+   void PrintBinary(std::ostream &out) const;
+
    /// Print the mesh in VTK format (linear and quadratic meshes only).
    /// \see mfem::ogzstream() for on-the-fly compression of ascii outputs
    void PrintVTK(std::ostream &out);
@@ -1220,6 +1349,15 @@ public:
 
        If no element is found for the i-th point, elem_ids[i] is set to -1.
 
+       The candidate elements for each point are obtained from a spatial index
+       of the element bounding boxes (see ElementBoxIndex), which is built on
+       the first call and updated incrementally after mesh refinement. If the
+       mesh nodes are modified directly, NodesUpdated() must be called before
+       the next call to this method. If several elements contain the point,
+       the one with the smallest index is returned. For meshes embedded in a
+       higher dimensional space, points away from the mesh surface (outside
+       the element bounding boxes) are not found.
+
        In the ParMesh implementation, the @a point_mat is expected to be the
        same on all ranks. If the i-th point is found by multiple ranks, only one
        of them will mark that point as found, i.e. set its elem_ids[i] to a
@@ -1229,7 +1367,8 @@ public:
        @returns The total number of points that were found.
 
        @note This method is not 100 percent reliable, i.e. it is not guaranteed
-       to find a point, even if it lies inside a mesh element. */
+       to find a point, even if it lies inside a mesh element: the inversion of
+       the element transformation may fail for strongly curved elements. */
    virtual int FindPoints(DenseMatrix& point_mat, Array<int>& elem_ids,
                           Array<IntegrationPoint>& ips, bool warn = true,
                           InverseElementTransformation *inv_trans = NULL);
@@ -0,0 +1,199 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mesh_headers.hpp"
+#include "../fem/fem.hpp"
+#include <cstring>
+
+namespace mfem
+{
+
+GeometricFactors::GeometricFactors(Mesh &mesh, const IntegrationRule &ir,
+                                   bool faces_, int flags_,
+                                   Geometry::Type geom_)
+   : sequence(mesh.GetSequence()), nodes(mesh.GetNodes()),
+     coords_hash(CoordinatesHash(mesh)), IntRule(&ir), faces(faces_),
+     flags(flags_), geom(geom_)
+{
+   nq = ir.GetNPoints();
+   sdim = mesh.SpaceDimension();
+   dim = mesh.Dimension() - (faces ? 1 : 0);
+   MFEM_VERIFY(!(faces && (flags & ADJUGATES)) &&
+               !(!faces && (flags & NORMALS)), "invalid flags: " << flags);
+
+   // The elements (or faces) of the geometry, in the order of the mesh
+   const int num_all = faces ? mesh.GetNumFaces() : mesh.GetNE();
+   Array<int> ents;
+   index.SetSize(num_all);
+   for (int i = 0; i < num_all; i++)
+   {
+      const Geometry::Type g = faces ? mesh.GetFaceBaseGeometry(i) :
+                               mesh.GetElementBaseGeometry(i);
+      index[i] = (g == geom) ? ents.Size() : -1;
+      if (g == geom) { ents.Append(i); }
+   }
+   num = ents.Size();
+   if (num == num_all) { index.DeleteAll(); }
+
+   points.SetSize(4*nq);
+   for (int q = 0; q < nq; q++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(q);
+      points(4*q+0) = ip.x;
+      points(4*q+1) = ip.y;
+      points(4*q+2) = ip.z;
+      points(4*q+3) = ip.weight;
+   }
+
+   const bool normals = (flags & NORMALS) && sdim == dim+1 && sdim > 1;
+   if (flags & JACOBIANS) { J.SetSize(nq*sdim*dim*num); }
+   if (flags & DETERMINANTS) { detJ.SetSize(nq*num); }
+   if (flags & ADJUGATES) { adjJ.SetSize(nq*dim*sdim*num); }
+   if (normals) { normal.SetSize(nq*sdim*num); }
+   if (!faces) { elem_hash.SetSize(num); }
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      IsoparametricTransformation T;
+      Vector nor(sdim);
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int e = 0; e < num; e++)
+      {
+         const int i = index.Size() ? ents[e] : e;
+         if (faces) { mesh.GetFaceTransformation(i, &T); }
+         else
+         {
+            mesh.GetElementTransformation(i, &T);
+            const DenseMatrix &pm = T.GetPointMat();
+            elem_hash[e] = Hash(pm.Data(), pm.Height()*pm.Width());
+         }
+         for (int q = 0; q < nq; q++)
+         {
+            T.SetIntPoint(&ir.IntPoint(q));
+            const DenseMatrix &Jq = T.Jacobian();
+            if (flags & JACOBIANS)
+            {
+               for (int j = 0; j < dim; j++)
+               {
+                  for (int i = 0; i < sdim; i++)
+                  {
+                     J(q + nq*(i + sdim*(j + dim*e))) = Jq(i,j);
+                  }
+               }
+            }
+            if (flags & DETERMINANTS) { detJ(q + nq*e) = T.Weight(); }
+            if (flags & ADJUGATES)
+            {
+               const DenseMatrix &adj = T.AdjugateJacobian();
+               for (int j = 0; j < sdim; j++)
+               {
+                  for (int i = 0; i < dim; i++)
+                  {
+                     adjJ(q + nq*(i + dim*(j + sdim*e))) = adj(i,j);
+                  }
+               }
+            }
+            if (normals)
+            {
+               CalcOrtho(Jq, nor);
+               for (int i = 0; i < sdim; i++)
+               {
+                  normal(q + nq*(i + sdim*e)) = nor(i);
+               }
+            }
+         }
+      }
+   }
+}
+
+bool GeometricFactors::IsCurrent(const Mesh &mesh) const
+{
+   return (sequence == mesh.GetSequence() && nodes == mesh.GetNodes());
+}
+
+bool GeometricFactors::HasRule(const IntegrationRule &ir) const
+{
+   if (&ir != IntRule || ir.GetNPoints() != nq) { return false; }
+   for (int q = 0; q < nq; q++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(q);
+      if (ip.x != points(4*q+0) || ip.y != points(4*q+1) ||
+          ip.z != points(4*q+2) || ip.weight != points(4*q+3))
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+void GeometricFactors::GetJacobian(int e, int q, DenseMatrix &M) const
+{
+   MFEM_ASSERT(flags & JACOBIANS, "the Jacobians were not computed");
+   M.SetSize(sdim, dim);
+   e = Index(e);
+   for (int j = 0; j < dim; j++)
+   {
+      for (int i = 0; i < sdim; i++)
+      {
+         M(i,j) = J(q + nq*(i + sdim*(j + dim*e)));
+      }
+   }
+}
+
+void GeometricFactors::GetAdjugateJacobian(int e, int q, DenseMatrix &M) const
+{
+   MFEM_ASSERT(flags & ADJUGATES, "the adjugates were not computed");
+   M.SetSize(dim, sdim);
+   e = Index(e);
+   for (int j = 0; j < sdim; j++)
+   {
+      for (int i = 0; i < dim; i++)
+      {
+         M(i,j) = adjJ(q + nq*(i + dim*(j + sdim*e)));
+      }
+   }
+}
+
+long GeometricFactors::MemoryUsage() const
+{
+   return (points.Size() + J.Size() + detJ.Size() + adjJ.Size() +
+           normal.Size())*sizeof(double) + elem_hash.Size()*sizeof(uint64_t) +
+          index.Size()*sizeof(int);
+}
+
+uint64_t GeometricFactors::Hash(const double *data, int n, uint64_t hash)
+{
+   for (int i = 0; i < n; i++)
+   {
+      uint64_t bits;
+      std::memcpy(&bits, data + i, sizeof(bits));
+      hash = (hash ^ bits)*1099511628211ULL;
+   }
+   return hash;
+}
+
+uint64_t GeometricFactors::CoordinatesHash(const Mesh &mesh)
+{
+   const GridFunction *mesh_nodes = mesh.GetNodes();
+   if (mesh_nodes) { return Hash(mesh_nodes->GetData(), mesh_nodes->Size()); }
+   uint64_t hash = Hash(NULL, 0);
+   for (int i = 0; i < mesh.GetNV(); i++)
+   {
+      hash = Hash(mesh.GetVertex(i), mesh.SpaceDimension(), hash);
+   }
+   return hash;
+}
+
+}
@@ -0,0 +1,141 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_MESH_GEOM
+#define MFEM_MESH_GEOM
+
+#include "../config/config.hpp"
+#include "../linalg/densemat.hpp"
+#include "../fem/intrules.hpp"
+#include <cstdint>
+
+namespace mfem
+{
+
+class Mesh;
+class GridFunction;
+
+/** @brief Geometric factors of the elements, or the faces, of one geometry
+    of a Mesh at the points of an IntegrationRule, see
+    Mesh::GetGeometricFactors() and Mesh::GetFaceGeometricFactors().
+
+    The factors are stored in structure-of-arrays layout, with the point index
+    fastest. The element (or face) k of the mesh is stored at the position
+    e = Index(k), in the order of the mesh; e = k if all the elements have the
+    same geometry. The accessors below take k. With nq points, reference
+    dimension dim (the face dimension for faces) and space dimension sdim, for
+    the point q of the element (or face) at position e:
+    - entry (i,j) of the sdim x dim Jacobian J is
+      J(q + nq*(i + sdim*(j + dim*e))),
+    - det(J), or the measure T.Weight() if sdim > dim, is detJ(q + nq*e),
+    - entry (i,j) of the dim x sdim adjugate adj(J) (elements only) is
+      adjJ(q + nq*(i + dim*(j + sdim*e))),
+    - component i of the normal from CalcOrtho() (faces only, when
+      sdim = dim + 1 > 1) is normal(q + nq*(i + sdim*e)).
+
+    Only the arrays selected by the flags of the constructor are computed.
+    Changes of the vertex or node coordinates are detected with hashes of the
+    coordinates, see HasCoordinates() and HasElement(). */
+class GeometricFactors
+{
+public:
+   enum FactorFlags
+   {
+      JACOBIANS    = 1,
+      DETERMINANTS = 2,
+      ADJUGATES    = 4, ///< Elements only
+      NORMALS      = 8  ///< Faces only
+   };
+
+protected:
+   /// Mesh sequence and nodes the factors were computed for.
+   long sequence;
+   const GridFunction *nodes;
+
+   /// Hash of the coordinates of the mesh, see CoordinatesHash().
+   uint64_t coords_hash;
+
+   /// Hashes of the point matrices of the elements (elements only).
+   Array<uint64_t> elem_hash;
+
+   /** Position of each element (or face) of the mesh in the arrays, -1 for
+       the other geometries; empty if all of them have the geometry. */
+   Array<int> index;
+
+   /// The rule and a copy of its points, to detect a modified rule.
+   const IntegrationRule *IntRule;
+   Vector points;
+
+public:
+   const bool faces;
+   const int flags;
+   const Geometry::Type geom;
+   /// The dimensions, and the number of elements (or faces) of the geometry.
+   int dim, sdim, nq, num;
+
+   Vector J, detJ, adjJ, normal;
+
+   /** @brief Compute the factors selected by @a flags_ (see FactorFlags) of
+       the elements, or the faces, of geometry @a geom_ of @a mesh at the
+       points of @a ir. */
+   GeometricFactors(Mesh &mesh, const IntegrationRule &ir, bool faces_,
+                    int flags_, Geometry::Type geom_);
+
+   /** @brief Return true if the factors were computed for the current
+       sequence and nodes of @a mesh. */
+   bool IsCurrent(const Mesh &mesh) const;
+
+   /** @brief Return true if @a hash is the CoordinatesHash() of the mesh the
+       factors were computed for. */
+   bool HasCoordinates(uint64_t hash) const { return hash == coords_hash; }
+
+   /** @brief Return the position of the element (or face) @a e of the mesh
+       in the arrays, or -1 if its geometry is not geom. */
+   int Index(int e) const { return index.Size() ? index[e] : e; }
+
+   /** @brief Return true if @a pm is the point matrix the factors of element
+       @a e were computed for. */
+   bool HasElement(int e, const DenseMatrix &pm) const
+   {
+      return !faces && Index(e) >= 0 &&
+             Hash(pm.Data(), pm.Height()*pm.Width()) == elem_hash[Index(e)];
+   }
+
+   /// Return true if @a ir is the rule the factors were computed for.
+   bool HasRule(const IntegrationRule &ir) const;
+
+   /// Return the rule the factors were computed for.
+   const IntegrationRule *GetRule() const { return IntRule; }
+
+   /// Return det(J) at the point @a q of element (or face) @a e.
+   double GetDetJ(int e, int q) const { return detJ(q + nq*Index(e)); }
+
+   /// Copy J at the point @a q of element (or face) @a e to @a M.
+   void GetJacobian(int e, int q, DenseMatrix &M) const;
+
+   /// Copy adj(J) at the point @a q of element @a e to @a M.
+   void GetAdjugateJacobian(int e, int q, DenseMatrix &M) const;
+
+   long MemoryUsage() const;
+
+   /// Return the FNV-1a hash of the bits of the @a n values in @a data, taken
+   /// 64 bits at a time, continuing from @a hash.
+   static uint64_t Hash(const double *data, int n,
+                        uint64_t hash = 14695981039346656037ULL);
+
+   /// Return the hash of the node coordinates of @a mesh, or of its vertex
+   /// coordinates if it has no nodes.
+   static uint64_t CoordinatesHash(const Mesh &mesh);
+};
+
+}
+
+#endif
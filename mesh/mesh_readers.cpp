@@ -14,7 +14,9 @@
 #include "../general/text.hpp"
 
 #include <iostream>
+#include <sstream>
 #include <cstdio>
+#include <cstring>
 
 #ifdef MFEM_USE_NETCDF
 #include "netcdf.h"
@@ -113,6 +115,121 @@ void Mesh::ReadMFEMMesh(std::istream &input, bool mfem_v11, int &curved)
    if (remove_unused_vertices) { RemoveUnusedVertices(); }
 }
 
+void Mesh::ReadMFEMBinaryMesh(std::istream &input)
+{
+   // Read MFEM binary mesh v1.0 format: the identification line was read by
+   // the caller, the sections are read directly into the mesh data
+   bin_io::SectionReader sections(input);
+   LoadBinarySections(sections, false);
+   sections.Finish();
+}
+
+void Mesh::ReadBinaryElements(bin_io::SectionReader &sections, uint32_t id,
+                              Array<Element*> &elems, int num_elems)
+{
+   size_t size, pos = 0;
+   MFEM_VERIFY(sections.Find(id, size), "invalid binary mesh: missing "
+               "element section " << id);
+
+   elems.SetSize(num_elems);
+   // attribute, geometry and at most 8 vertices (hexahedron)
+   int ints[2 + 8];
+   for (int i = 0; i < num_elems; i++)
+   {
+      sections.Read(id, pos, 2*sizeof(int), ints);
+      pos += 2*sizeof(int);
+      const int attr = ints[0], geom = ints[1];
+      MFEM_VERIFY(geom >= 0 && geom < Geometry::NumGeom,
+                  "invalid binary mesh: unknown geometry " << geom);
+      Element *el = NewElement(geom);
+      const int nv = el->GetNVertices();
+      sections.Read(id, pos, nv*sizeof(int), ints + 2);
+      pos += nv*sizeof(int);
+      el->SetVertices(ints + 2);
+      el->SetAttribute(attr);
+      elems[i] = el;
+   }
+}
+
+void Mesh::LoadBinarySections(bin_io::SectionReader &sections, bool zerocopy)
+{
+   MFEM_ASSERT(!zerocopy || sections.InMemory(), "zero-copy loading requires "
+               "the sections in memory");
+   size_t size;
+   int info[6];
+   MFEM_VERIFY(sections.Find(BIN_INFO, size) && size == sizeof(info),
+               "invalid binary mesh: missing info section");
+   sections.Read(BIN_INFO, 0, sizeof(info), info);
+   Dim = info[0];
+   spaceDim = info[1];
+   NumOfVertices = info[2];
+   NumOfElements = info[3];
+   NumOfBdrElements = info[4];
+
+   MFEM_VERIFY(sections.Find(BIN_VERTICES, size) &&
+               size == (size_t)NumOfVertices*sizeof(Vertex),
+               "invalid binary mesh: missing or wrong vertices section");
+   if (zerocopy)
+   {
+      vertices.MakeRef(reinterpret_cast<Vertex*>(
+                          sections.GetData(BIN_VERTICES)), NumOfVertices);
+   }
+   else
+   {
+      // Read the coordinates in chunks of vertices
+      vertices.SetSize(NumOfVertices);
+      const int chunk = 1024;
+      double coord[3*chunk];
+      for (int i = 0; i < NumOfVertices; i += chunk)
+      {
+         const int n = std::min(chunk, NumOfVertices - i);
+         sections.Read(BIN_VERTICES, (size_t)i*sizeof(Vertex),
+                       n*sizeof(Vertex), coord);
+         for (int j = 0; j < n; j++)
+         {
+            for (int d = 0; d < 3; d++)
+            {
+               vertices[i + j](d) = coord[3*j + d];
+            }
+         }
+      }
+   }
+
+   ReadBinaryElements(sections, BIN_ELEMENTS, elements, NumOfElements);
+   ReadBinaryElements(sections, BIN_BOUNDARY, boundary, NumOfBdrElements);
+
+   // The nodes require the mesh topology
+   FinalizeTopology();
+
+   if (info[5])
+   {
+      MFEM_VERIFY(sections.Find(BIN_NODES_SPACE, size), "invalid binary mesh: "
+                  "missing nodes space section");
+      std::string fes_data(size, '\0');
+      sections.Read(BIN_NODES_SPACE, 0, size, &fes_data[0]);
+      std::istringstream fes_input(fes_data);
+      FiniteElementSpace *nfes = new FiniteElementSpace;
+      FiniteElementCollection *nfec = nfes->Load(this, fes_input);
+
+      MFEM_VERIFY(sections.Find(BIN_NODES, size) &&
+                  size == (size_t)nfes->GetVSize()*sizeof(double),
+                  "invalid binary mesh: missing or wrong nodes section");
+      if (zerocopy)
+      {
+         Nodes = new GridFunction(
+            nfes, reinterpret_cast<double*>(sections.GetData(BIN_NODES)));
+      }
+      else
+      {
+         // read in place into the nodes
+         Nodes = new GridFunction(nfes);
+         sections.Read(BIN_NODES, 0, size, Nodes->GetData());
+      }
+      Nodes->MakeOwner(nfec);
+      own_nodes = 1;
+   }
+}
+
 void Mesh::ReadLineMesh(std::istream &input)
 {
    int j,p1,p2,a;
@@ -0,0 +1,269 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mesh_headers.hpp"
+#include "../fem/fem.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace mfem
+{
+
+// High-order elements may bulge out of the bounding box of their nodes; the
+// margin is relative to the largest extent of the element box.
+const double ElementBoxIndex::margin = 0.1;
+
+ElementBoxIndex::ElementBoxIndex(Mesh &mesh_)
+   : mesh(mesh_), sdim(mesh_.SpaceDimension()), sequence(-1), nodes(NULL),
+     coords_hash(0)
+{
+   MFEM_VERIFY(sdim >= 1 && sdim <= 3, "invalid space dimension: " << sdim);
+   Rebuild();
+}
+
+void ElementBoxIndex::ComputeBox(int i, double *box) const
+{
+   double *bmin = box, *bmax = box + sdim;
+   for (int d = 0; d < sdim; d++)
+   {
+      bmin[d] = std::numeric_limits<double>::infinity();
+      bmax[d] = -bmin[d];
+   }
+
+   bool curved = false;
+   if (nodes)
+   {
+      const FiniteElementSpace *fes = nodes->FESpace();
+      Array<int> vdofs;
+      Vector vals;
+      fes->GetElementVDofs(i, vdofs);
+      nodes->GetSubVector(vdofs, vals);
+      // GetElementVDofs() groups the vdofs by vector component
+      const int nd = vdofs.Size()/sdim;
+      for (int d = 0; d < sdim; d++)
+      {
+         for (int j = 0; j < nd; j++)
+         {
+            bmin[d] = std::min(bmin[d], vals(d*nd + j));
+            bmax[d] = std::max(bmax[d], vals(d*nd + j));
+         }
+      }
+      curved = (fes->GetOrder(i) > 1 || fes->GetNURBSext());
+   }
+   else
+   {
+      Array<int> v;
+      mesh.GetElementVertices(i, v);
+      for (int j = 0; j < v.Size(); j++)
+      {
+         const double *x = mesh.GetVertex(v[j]);
+         for (int d = 0; d < sdim; d++)
+         {
+            bmin[d] = std::min(bmin[d], x[d]);
+            bmax[d] = std::max(bmax[d], x[d]);
+         }
+      }
+   }
+
+   double h = 0.0;
+   for (int d = 0; d < sdim; d++) { h = std::max(h, bmax[d] - bmin[d]); }
+   // Straight-sided elements only need a small tolerance, so that points on
+   // the element boundary (up to round-off) are not missed.
+   h *= curved ? margin : 1e-8;
+   for (int d = 0; d < sdim; d++)
+   {
+      bmin[d] -= h;
+      bmax[d] += h;
+   }
+}
+
+int ElementBoxIndex::BinIndex(int d, double x) const
+{
+   int k = (int) std::floor((x - gmin[d])*inv_h[d]);
+   return std::min(std::max(k, 0), nbins[d]-1);
+}
+
+void ElementBoxIndex::BuildBins()
+{
+   const int ne = boxes.Width();
+
+   for (int d = 0; d < 3; d++)
+   {
+      gmin[d] = gmax[d] = inv_h[d] = 0.0;
+      nbins[d] = 1;
+   }
+   for (int d = 0; d < sdim; d++)
+   {
+      gmin[d] = std::numeric_limits<double>::infinity();
+      gmax[d] = -gmin[d];
+      for (int i = 0; i < ne; i++)
+      {
+         gmin[d] = std::min(gmin[d], boxes(d, i));
+         gmax[d] = std::max(gmax[d], boxes(sdim + d, i));
+      }
+   }
+
+   // Choose the bin size h such that there is about one bin per element,
+   // ignoring the degenerate (flat) dimensions of the global box.
+   double vol = 1.0;
+   int nd = 0;
+   for (int d = 0; d < sdim; d++)
+   {
+      if (gmax[d] > gmin[d]) { vol *= gmax[d] - gmin[d]; nd++; }
+   }
+   if (ne > 0 && nd > 0)
+   {
+      const double h = std::pow(vol/ne, 1.0/nd);
+      for (int d = 0; d < sdim; d++)
+      {
+         const double len = gmax[d] - gmin[d];
+         if (len <= 0.0) { continue; }
+         nbins[d] = (int) std::min(std::ceil(len/h), (double) ne);
+         nbins[d] = std::max(nbins[d], 1);
+         inv_h[d] = nbins[d]/len;
+      }
+   }
+
+   const int nb = nbins[0]*nbins[1]*nbins[2];
+   int lo[3] = { 0, 0, 0 }, hi[3] = { 0, 0, 0 };
+
+   bin_elements.Clear();
+   bin_elements.MakeI(nb);
+   for (int pass = 0; pass < 2; pass++)
+   {
+      for (int i = 0; i < ne; i++)
+      {
+         for (int d = 0; d < sdim; d++)
+         {
+            lo[d] = BinIndex(d, boxes(d, i));
+            hi[d] = BinIndex(d, boxes(sdim + d, i));
+         }
+         for (int k = lo[2]; k <= hi[2]; k++)
+         {
+            for (int j = lo[1]; j <= hi[1]; j++)
+            {
+               for (int l = lo[0]; l <= hi[0]; l++)
+               {
+                  const int b = l + nbins[0]*(j + nbins[1]*k);
+                  if (pass == 0) { bin_elements.AddAColumnInRow(b); }
+                  else { bin_elements.AddConnection(b, i); }
+               }
+            }
+         }
+      }
+      if (pass == 0) { bin_elements.MakeJ(); }
+   }
+   bin_elements.ShiftUpI();
+}
+
+void ElementBoxIndex::Rebuild()
+{
+   const int ne = mesh.GetNE();
+   nodes = mesh.GetNodes();
+   boxes.SetSize(2*sdim, ne);
+   for (int i = 0; i < ne; i++)
+   {
+      ComputeBox(i, boxes.GetColumn(i));
+   }
+   BuildBins();
+   sequence = mesh.GetSequence();
+   coords_hash = GeometricFactors::CoordinatesHash(mesh);
+}
+
+void ElementBoxIndex::Update()
+{
+   const uint64_t hash = GeometricFactors::CoordinatesHash(mesh);
+   if (sequence == mesh.GetSequence() && nodes == mesh.GetNodes())
+   {
+      // same topology: rebuild only if the coordinates were moved in place
+      if (hash != coords_hash) { Rebuild(); }
+      return;
+   }
+
+   if (sequence + 1 != mesh.GetSequence() || nodes != mesh.GetNodes() ||
+       mesh.GetLastOperation() != Mesh::REFINE)
+   {
+      Rebuild();
+      return;
+   }
+
+   // Only the children of the refined elements need new boxes; elements that
+   // were not refined (the single child of their parent) keep theirs.
+   const CoarseFineTransformations &cf = mesh.GetRefinementTransforms();
+   const int ne = mesh.GetNE(), old_ne = boxes.Width();
+   if (cf.embeddings.Size() != ne)
+   {
+      Rebuild();
+      return;
+   }
+
+   Array<int> num_children(old_ne);
+   num_children = 0;
+   for (int i = 0; i < ne; i++)
+   {
+      const int parent = cf.embeddings[i].parent;
+      if (parent < 0 || parent >= old_ne)
+      {
+         Rebuild();
+         return;
+      }
+      num_children[parent]++;
+   }
+
+   DenseMatrix new_boxes(2*sdim, ne);
+   for (int i = 0; i < ne; i++)
+   {
+      const int parent = cf.embeddings[i].parent;
+      if (num_children[parent] == 1)
+      {
+         const double *old_box = boxes.GetColumn(parent);
+         std::copy(old_box, old_box + 2*sdim, new_boxes.GetColumn(i));
+      }
+      else
+      {
+         ComputeBox(i, new_boxes.GetColumn(i));
+      }
+   }
+   boxes = new_boxes;
+   BuildBins();
+   sequence = mesh.GetSequence();
+   coords_hash = hash;
+}
+
+void ElementBoxIndex::FindCandidates(const double *x, Array<int> &elems) const
+{
+   elems.SetSize(0);
+   int idx[3] = { 0, 0, 0 };
+   for (int d = 0; d < sdim; d++)
+   {
+      if (!(x[d] >= gmin[d] && x[d] <= gmax[d])) { return; }
+      idx[d] = BinIndex(d, x[d]);
+   }
+
+   const int b = idx[0] + nbins[0]*(idx[1] + nbins[1]*idx[2]);
+   const int n = bin_elements.RowSize(b);
+   const int *row = bin_elements.GetRow(b);
+   for (int j = 0; j < n; j++)
+   {
+      const double *box = boxes.GetColumn(row[j]);
+      int d = 0;
+      while (d < sdim && x[d] >= box[d] && x[d] <= box[sdim + d]) { d++; }
+      if (d == sdim) { elems.Append(row[j]); }
+   }
+}
+
+long ElementBoxIndex::MemoryUsage() const
+{
+   return boxes.MemoryUsage() + bin_elements.MemoryUsage();
+}
+
+}
@@ -0,0 +1,100 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_MESH_SEARCH
+#define MFEM_MESH_SEARCH
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "../general/table.hpp"
+#include "../linalg/densemat.hpp"
+#include <cstdint>
+
+namespace mfem
+{
+
+class Mesh;
+class GridFunction;
+
+/** @brief Spatial index of the elements of a Mesh, used by Mesh::FindPoints()
+    to locate the elements that may contain a given physical point.
+
+    The index stores an axis-aligned bounding box for every element, computed
+    from the element nodes (or vertices) and enlarged by a relative margin to
+    account for the curvature of high-order elements. The boxes are binned in
+    a uniform Cartesian grid covering the whole mesh, with about one bin per
+    element, so a query only visits the elements whose box overlaps the bin of
+    the point.
+
+    After a refinement of the mesh, Update() reuses the boxes of all elements
+    that were not refined; any other change of the mesh topology triggers a
+    complete rebuild. In-place changes of the vertex or node coordinates are
+    detected through GeometricFactors::CoordinatesHash() and also trigger a
+    complete rebuild. */
+class ElementBoxIndex
+{
+protected:
+   Mesh &mesh;
+   int sdim;
+
+   /// Mesh sequence, nodes and coordinates hash the index was built for.
+   long sequence;
+   const GridFunction *nodes;
+   uint64_t coords_hash;
+
+   /// Element bounding boxes: column i is (min_0,...,min_{d-1},max_0,...).
+   DenseMatrix boxes;
+
+   /// Bin grid: global box, number of bins and inverse bin size per dimension.
+   double gmin[3], gmax[3], inv_h[3];
+   int nbins[3];
+
+   /// Bin -> elements whose bounding box overlaps the bin.
+   Table bin_elements;
+
+   /// Relative margin added to the element bounding boxes.
+   static const double margin;
+
+   /// Compute the enlarged bounding box of element @a i into @a box.
+   void ComputeBox(int i, double *box) const;
+
+   /// Setup the bin grid and the bin -> elements table from the boxes.
+   void BuildBins();
+
+   /// Return the index of the bin in dimension @a d containing @a x.
+   int BinIndex(int d, double x) const;
+
+public:
+   /// Build the index for the current state of the @a mesh.
+   ElementBoxIndex(Mesh &mesh);
+
+   /// Rebuild all element bounding boxes and the bin grid.
+   void Rebuild();
+
+   /** @brief Bring the index up to date with the mesh: incrementally after a
+       single refinement, with a complete rebuild otherwise. Does nothing if
+       the mesh did not change. The coordinates are hashed on every call, which
+       costs O(number of nodes). */
+   void Update();
+
+   /** @brief Return the elements whose (enlarged) bounding box contains the
+       point @a x of size SpaceDimension(). */
+   void FindCandidates(const double *x, Array<int> &elems) const;
+
+   /// Return the bounding box of element @a i, see class description.
+   const double *GetElementBox(int i) const { return boxes.GetColumn(i); }
+
+   long MemoryUsage() const;
+};
+
+}
+
+#endif
@@ -740,6 +740,7 @@ public:
 #endif
 
    friend class ParNCMesh; // for ParNCMesh::ElementSet
+   friend class ParCheckpoint; // for the coarse mesh of checkpoints
    friend struct CompareRanks;
 };
 
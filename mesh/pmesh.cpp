@@ -1586,6 +1586,7 @@ void ParMesh::GetFaceNbrElementTransformation(
 
    ElTr->Attribute = elem->GetAttribute();
    ElTr->ElementNo = NumOfElements + i;
+   ElTr->mesh = NULL;
 
    if (Nodes == NULL)
    {
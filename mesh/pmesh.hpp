@@ -326,6 +326,7 @@ public:
    virtual ~ParMesh();
 
    friend class ParNCMesh;
+   friend class ParCheckpoint;
 #ifdef MFEM_USE_PUMI
    friend class ParPumiMesh;
 #endif
@@ -1920,7 +1920,10 @@ void ParNCMesh::RecvRebalanceDofs(Array<int> &elements, Array<long> &dofs)
       }
       for (unsigned i = 0; i < msg.dofs.size(); i++)
       {
-         dofs[nd++] = msg.dof_offset + msg.dofs[i];
+         // keep the sign of the DOF, encoded as -1-dof
+         const long dof = msg.dofs[i];
+         if (dof >= 0) { dofs[nd++] = msg.dof_offset + dof; }
+         else { dofs[nd++] = -1 - (msg.dof_offset - 1 - dof); }
       }
    }
 
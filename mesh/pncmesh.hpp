@@ -192,7 +192,8 @@ public:
    void SendRebalanceDofs(int old_ndofs, const Table &old_element_dofs,
                           long old_global_offset, FiniteElementSpace* space);
 
-   /// Receive element DOFs sent by SendRebalanceDofs().
+   /** Receive element DOFs sent by SendRebalanceDofs(), as global vector
+       DOFs; the negative DOFs of the sender are returned as -1-dof. */
    void RecvRebalanceDofs(Array<int> &elements, Array<long> &dofs);
 
    /** Get previous indices (pre-Rebalance) of current elements. Index of -1
@@ -231,6 +232,7 @@ public:
 protected: // interface for ParMesh
 
    friend class ParMesh;
+   friend class ParCheckpoint;
 
    /** For compatibility with conforming code in ParMesh and ParFESpace.
        Initializes shared structures in ParMesh: gtopo, shared_*, group_s*, s*_l*.
@@ -50,6 +50,14 @@ public:
       MFEM_STATIC_ASSERT(space_dim != 0, "dynamic space dim is not allowed");
    }
 
+   // Construct a TMesh using the given nodes instead of the nodes of 'mesh'.
+   TMesh(const Mesh &mesh, const GridFunction &nodes)
+      : m_mesh(mesh), fes(*nodes.FESpace()), Nodes(nodes),
+        fe(*fes.FEColl()), t_fes(fe, fes), node_layout(fes)
+   {
+      MFEM_STATIC_ASSERT(space_dim != 0, "dynamic space dim is not allowed");
+   }
+
    int GetNE() const { return m_mesh.GetNE(); }
 
    static bool MatchesGeometry(const Mesh &mesh)
@@ -30,6 +30,7 @@
 #include "general/gzstream.hpp"
 #include "general/version.hpp"
 #include "general/globals.hpp"
+#include "general/threads.hpp"
 #ifdef MFEM_USE_MPI
 #include "general/communication.hpp"
 #endif
@@ -331,6 +331,7 @@ int main (int argc, char *argv[])
          {
             *nodes *= factor;
          }
+         mesh->NodesUpdated();
 
          print_char = 1;
       }
@@ -405,6 +406,7 @@ int main (int argc, char *argv[])
             }
 
             *nodes += rdm;
+            mesh->NodesUpdated();
          }
 
          print_char = 1;
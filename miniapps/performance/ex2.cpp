@@ -0,0 +1,296 @@
+//                    MFEM Example 2 - High-Performance Version
+//
+// Compile with: make ex2
+//
+// Sample runs:  ex2 -m ../../data/beam-hex.mesh -perf -mf
+//               ex2 -m ../../data/beam-hex.mesh -perf -asm
+//               ex2 -m ../../data/beam-hex.mesh -std  -asm
+//               ex2 -m ../../data/beam-hex.mesh -perf -asm -sc
+//               ex2 -m ../../data/beam-hex.mesh -std  -asm -sc
+//
+// Description:  This example code solves a simple linear elasticity problem
+//               describing a cantilever beam, cf. Example 2.
+//               Unlike Example 2, the Lame parameters are constant
+//               (lambda = mu = 1).
+//
+//               The example highlights the use of the templated elasticity
+//               kernel (TElasticityKernel) on a vector finite element space,
+//               with either matrix-free evaluation or efficient assembly of the
+//               coupled element matrices. The high-performance version can be
+//               compared with the standard ElasticityIntegrator with -std.
+
+#include "mfem-performance.hpp"
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+using namespace mfem;
+
+// Define template parameters for optimized build.
+const Geometry::Type geom     = Geometry::CUBE; // mesh elements  (default: hex)
+const int            mesh_p   = 1;              // mesh curvature (default: 1)
+const int            sol_p    = 2;              // solution order (default: 2)
+const int            rdim     = Geometry::Constants<geom>::Dimension;
+const int            ir_order = 2*sol_p+rdim-1;
+
+// Static mesh type
+typedef H1_FiniteElement<geom,mesh_p>         mesh_fe_t;
+typedef H1_FiniteElementSpace<mesh_fe_t>      mesh_fes_t;
+typedef TMesh<mesh_fes_t>                     mesh_t;
+
+// Static solution finite element space type, with rdim components ordered
+// byNODES
+typedef H1_FiniteElement<geom,sol_p>          sol_fe_t;
+typedef H1_FiniteElementSpace<sol_fe_t>       sol_fes_t;
+typedef VectorLayout<Ordering::byNODES,rdim>  sol_layout_t;
+
+// Static quadrature, coefficient and integrator types
+typedef TIntegrationRule<geom,ir_order>       int_rule_t;
+typedef TConstantCoefficient<>                lame_coeff_t;
+typedef TCoefficientPair<lame_coeff_t,lame_coeff_t> coeff_t;
+typedef TIntegrator<coeff_t,TElasticityKernel> integ_t;
+
+// Static bilinear form type, combining the above types
+typedef TBilinearForm<mesh_t,sol_fes_t,int_rule_t,integ_t,sol_layout_t>
+HPCBilinearForm;
+
+int main(int argc, char *argv[])
+{
+   // 1. Parse command-line options.
+   const char *mesh_file = "../../data/beam-hex.mesh";
+   int ref_levels = -1;
+   int order = sol_p;
+   bool static_cond = false;
+   bool perf = true;
+   bool matrix_free = true;
+   bool visualization = 1;
+
+   OptionsParser args(argc, argv);
+   args.AddOption(&mesh_file, "-m", "--mesh",
+                  "Mesh file to use.");
+   args.AddOption(&ref_levels, "-r", "--refine",
+                  "Number of times to refine the mesh uniformly;"
+                  " -1 = auto: <= 5,000 elements.");
+   args.AddOption(&order, "-o", "--order",
+                  "Finite element order (polynomial degree).");
+   args.AddOption(&perf, "-perf", "--hpc-version", "-std", "--standard-version",
+                  "Enable high-performance, tensor-based, assembly/evaluation.");
+   args.AddOption(&matrix_free, "-mf", "--matrix-free", "-asm", "--assembly",
+                  "Use matrix-free evaluation or efficient matrix assembly in "
+                  "the high-performance version.");
+   args.AddOption(&static_cond, "-sc", "--static-condensation", "-no-sc",
+                  "--no-static-condensation", "Enable static condensation.");
+   args.AddOption(&visualization, "-vis", "--visualization", "-no-vis",
+                  "--no-visualization",
+                  "Enable or disable GLVis visualization.");
+   args.Parse();
+   if (!args.Good())
+   {
+      args.PrintUsage(cout);
+      return 1;
+   }
+   if (static_cond && perf && matrix_free)
+   {
+      cout << "\nStatic condensation can not be used with matrix-free"
+           " evaluation!\n" << endl;
+      return 2;
+   }
+   MFEM_VERIFY(perf || !matrix_free,
+               "--standard-version is not compatible with --matrix-free");
+   args.PrintOptions(cout);
+
+   // 2. Read the mesh from the given mesh file.
+   Mesh *mesh = new Mesh(mesh_file, 1, 1);
+   int dim = mesh->Dimension();
+
+   if (mesh->bdr_attributes.Max() < 2)
+   {
+      cerr << "\nInput mesh should have at least two boundary attributes!"
+           << " (See schematic in ../../examples/ex2.cpp)\n" << endl;
+      return 3;
+   }
+
+   // 3. Check if the optimized version matches the given mesh
+   if (perf)
+   {
+      cout << "High-performance version using integration rule with "
+           << int_rule_t::qpts << " points ..." << endl;
+      if (!mesh_t::MatchesGeometry(*mesh))
+      {
+         cout << "The given mesh does not match the optimized 'geom' parameter.\n"
+              << "Recompile with suitable 'geom' value." << endl;
+         delete mesh;
+         return 4;
+      }
+      else if (!mesh_t::MatchesNodes(*mesh))
+      {
+         cout << "Switching the mesh curvature to match the "
+              << "optimized value (order " << mesh_p << ") ..." << endl;
+         mesh->SetCurvature(mesh_p, false, -1, Ordering::byNODES);
+      }
+   }
+
+   // 4. Refine the mesh to increase the resolution. In this example we do
+   //    'ref_levels' of uniform refinement. We choose 'ref_levels' to be the
+   //    largest number that gives a final mesh with no more than 5,000
+   //    elements, or as specified on the command line with the option
+   //    '--refine'.
+   {
+      ref_levels = (ref_levels != -1) ? ref_levels :
+                   (int)floor(log(5000./mesh->GetNE())/log(2.)/dim);
+      for (int l = 0; l < ref_levels; l++)
+      {
+         mesh->UniformRefinement();
+      }
+   }
+
+   // 5. Define a vector finite element space on the mesh, i.e. dim copies of a
+   //    scalar H1 space of the specified order, ordered byNODES.
+   FiniteElementCollection *fec = new H1_FECollection(order, dim);
+   FiniteElementSpace *fespace = new FiniteElementSpace(mesh, fec, dim);
+   cout << "Number of finite element unknowns: "
+        << fespace->GetTrueVSize() << endl;
+
+   // 6. Check if the optimized version matches the given space
+   if (perf && (!sol_fes_t::Matches(*fespace) ||
+                !sol_layout_t::Matches(*fespace)))
+   {
+      cout << "The given order does not match the optimized parameter.\n"
+           << "Recompile with suitable 'sol_p' value." << endl;
+      delete fespace;
+      delete fec;
+      delete mesh;
+      return 5;
+   }
+
+   // 7. Determine the list of true essential boundary dofs: the beam is fixed
+   //    on boundary attribute 1.
+   Array<int> ess_tdof_list, ess_bdr(mesh->bdr_attributes.Max());
+   ess_bdr = 0;
+   ess_bdr[0] = 1;
+   fespace->GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+   // 8. Set up the linear form b(.) with a "pull down" force on boundary
+   //    attribute 2, cf. Example 2.
+   VectorArrayCoefficient f(dim);
+   for (int i = 0; i < dim-1; i++)
+   {
+      f.Set(i, new ConstantCoefficient(0.0));
+   }
+   {
+      Vector pull_force(mesh->bdr_attributes.Max());
+      pull_force = 0.0;
+      pull_force(1) = -1.0e-2;
+      f.Set(dim-1, new PWConstCoefficient(pull_force));
+   }
+   LinearForm *b = new LinearForm(fespace);
+   b->AddBoundaryIntegrator(new VectorBoundaryLFIntegrator(f));
+   b->Assemble();
+
+   // 9. Define the solution vector x as a finite element grid function
+   //    corresponding to fespace. Initialize x with initial guess of zero,
+   //    which satisfies the boundary conditions.
+   GridFunction x(fespace);
+   x = 0.0;
+
+   // 10. Set up the bilinear form a(.,.) corresponding to the linear elasticity
+   //     operator with constant Lame parameters.
+   const double lambda = 1.0, mu = 1.0;
+   ConstantCoefficient lambda_func(lambda), mu_func(mu);
+   BilinearForm *a = new BilinearForm(fespace);
+
+   // 11. Assemble the bilinear form and the corresponding linear system.
+   if (static_cond) { a->EnableStaticCondensation(); }
+
+   cout << "Assembling the bilinear form ..." << flush;
+   tic_toc.Clear();
+   tic_toc.Start();
+   // Pre-allocate sparsity assuming dense element matrices
+   a->UsePrecomputedSparsity();
+
+   HPCBilinearForm *a_hpc = NULL;
+   Operator *a_oper = NULL;
+
+   if (!perf)
+   {
+      // Standard assembly using the elasticity domain integrator
+      a->AddDomainIntegrator(new ElasticityIntegrator(lambda_func, mu_func));
+      a->Assemble();
+   }
+   else
+   {
+      // High-performance assembly/evaluation using the templated operator type
+      const coeff_t lame = coeff_t(lame_coeff_t(lambda), lame_coeff_t(mu));
+      a_hpc = new HPCBilinearForm(integ_t(lame), *fespace);
+      if (matrix_free)
+      {
+         a_hpc->Assemble(); // partial assembly
+      }
+      else
+      {
+         a_hpc->AssembleBilinearForm(*a); // full matrix assembly
+      }
+   }
+   tic_toc.Stop();
+   cout << " done, " << tic_toc.RealTime() << "s." << endl;
+
+   // 12. Solve the system A X = B with CG, preconditioned with symmetric
+   //     Gauss-Seidel when the matrix is assembled.
+   SparseMatrix A;
+   Vector B, X;
+   if (perf && matrix_free)
+   {
+      a_hpc->FormLinearSystem(ess_tdof_list, x, *b, a_oper, X, B);
+      cout << "Size of linear system: " << a_hpc->Height() << endl;
+      CG(*a_oper, B, X, 1, 2000, 1e-12, 0.0);
+   }
+   else
+   {
+      a->FormLinearSystem(ess_tdof_list, x, *b, A, X, B);
+      cout << "Size of linear system: " << A.Height() << endl;
+      a_oper = &A;
+      GSSmoother M(A);
+      PCG(A, M, B, X, 1, 2000, 1e-12, 0.0);
+   }
+
+   // 13. Recover the solution as a finite element grid function.
+   if (perf && matrix_free)
+   {
+      a_hpc->RecoverFEMSolution(X, *b, x);
+   }
+   else
+   {
+      a->RecoverFEMSolution(X, *b, x);
+   }
+   cout << "Solution norm: " << x.Norml2() << endl;
+
+   // 14. Save the mesh and the displacement. This output can be viewed later
+   //     using GLVis: "glvis -m refined.mesh -g sol.gf".
+   ofstream mesh_ofs("refined.mesh");
+   mesh_ofs.precision(8);
+   mesh->Print(mesh_ofs);
+   ofstream sol_ofs("sol.gf");
+   sol_ofs.precision(8);
+   x.Save(sol_ofs);
+
+   // 15. Send the solution by socket to a GLVis server.
+   if (visualization)
+   {
+      char vishost[] = "localhost";
+      int  visport   = 19916;
+      socketstream sol_sock(vishost, visport);
+      sol_sock.precision(8);
+      sol_sock << "solution\n" << *mesh << x << flush;
+   }
+
+   // 16. Free the used memory.
+   delete a;
+   delete a_hpc;
+   if (a_oper != &A) { delete a_oper; }
+   delete b;
+   delete fespace;
+   delete fec;
+   delete mesh;
+
+   return 0;
+}
@@ -0,0 +1,357 @@
+//                    MFEM Example 3 - High-Performance Version
+//
+// Compile with: make ex3
+//
+// Sample runs:  ex3 -m ../../data/beam-hex.mesh -perf -mf
+//               ex3 -m ../../data/beam-hex.mesh -perf -asm
+//               ex3 -m ../../data/beam-hex.mesh -std  -asm
+//               ex3 -m ../../data/fichera.mesh -perf -asm
+//
+// Description:  This example code solves a simple electromagnetic diffusion
+//               problem corresponding to the second order definite Maxwell
+//               equation curl curl E + E = f with boundary condition
+//               E x n = <given tangential field>, cf. Example 3.
+//
+//               The example highlights the use of the templated curl-curl and
+//               H(curl) mass kernels (TCurlCurlKernel and TNDMassKernel) on a
+//               Nedelec finite element space, with either matrix-free
+//               evaluation or efficient assembly of the element matrices. The
+//               high-performance version can be compared with the standard
+//               CurlCurlIntegrator and VectorFEMassIntegrator with -std.
+
+#include "mfem-performance.hpp"
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+using namespace mfem;
+
+// Define template parameters for optimized build.
+const Geometry::Type geom     = Geometry::CUBE; // mesh elements  (default: hex)
+const int            mesh_p   = 1;              // mesh curvature (default: 1)
+const int            sol_p    = 2;              // solution order (default: 2)
+const int            rdim     = Geometry::Constants<geom>::Dimension;
+const int            ir_order = 2*sol_p+rdim-1;
+
+// Static mesh type
+typedef H1_FiniteElement<geom,mesh_p>         mesh_fe_t;
+typedef H1_FiniteElementSpace<mesh_fe_t>      mesh_fes_t;
+typedef TMesh<mesh_fes_t>                     mesh_t;
+
+// Static solution finite element space type
+typedef ND_FiniteElement<geom,sol_p>          sol_fe_t;
+typedef ND_FiniteElementSpace<sol_fe_t>       sol_fes_t;
+
+// Static quadrature, coefficient and integrator types
+typedef TIntegrationRule<geom,ir_order>       int_rule_t;
+typedef TConstantCoefficient<>                coeff_t;
+typedef TIntegrator<coeff_t,TCurlCurlKernel>  curl_integ_t;
+typedef TIntegrator<coeff_t,TNDMassKernel>    mass_integ_t;
+
+// Static bilinear form types, combining the above types
+typedef TBilinearForm<mesh_t,sol_fes_t,int_rule_t,curl_integ_t>
+HPCCurlCurlForm;
+typedef TBilinearForm<mesh_t,sol_fes_t,int_rule_t,mass_integ_t>
+HPCMassForm;
+
+// Sum of two operators on the same finite element space: used to combine the
+// matrix-free curl-curl and mass forms.
+class SumOperator : public Operator
+{
+protected:
+   const Operator &A, &B;
+   mutable Vector z;
+
+public:
+   SumOperator(const Operator &A_, const Operator &B_)
+      : Operator(A_.Height(), A_.Width()), A(A_), B(B_), z(A_.Height()) { }
+
+   virtual const Operator *GetProlongation() const
+   { return A.GetProlongation(); }
+   virtual const Operator *GetRestriction() const
+   { return A.GetRestriction(); }
+
+   virtual void Mult(const Vector &x, Vector &y) const
+   {
+      A.Mult(x, y);
+      B.Mult(x, z);
+      y += z;
+   }
+};
+
+// Exact solution, E, and r.h.s., f. See below for implementation.
+void E_exact(const Vector &, Vector &);
+void f_exact(const Vector &, Vector &);
+double freq = 1.0, kappa;
+int dim;
+
+int main(int argc, char *argv[])
+{
+   // 1. Parse command-line options.
+   const char *mesh_file = "../../data/beam-hex.mesh";
+   int ref_levels = -1;
+   int order = sol_p;
+   bool perf = true;
+   bool matrix_free = true;
+   bool visualization = 1;
+
+   OptionsParser args(argc, argv);
+   args.AddOption(&mesh_file, "-m", "--mesh",
+                  "Mesh file to use.");
+   args.AddOption(&ref_levels, "-r", "--refine",
+                  "Number of times to refine the mesh uniformly;"
+                  " -1 = auto: <= 5,000 elements.");
+   args.AddOption(&order, "-o", "--order",
+                  "Finite element order (polynomial degree).");
+   args.AddOption(&freq, "-f", "--frequency", "Set the frequency for the exact"
+                  " solution.");
+   args.AddOption(&perf, "-perf", "--hpc-version", "-std", "--standard-version",
+                  "Enable high-performance, tensor-based, assembly/evaluation.");
+   args.AddOption(&matrix_free, "-mf", "--matrix-free", "-asm", "--assembly",
+                  "Use matrix-free evaluation or efficient matrix assembly in "
+                  "the high-performance version.");
+   args.AddOption(&visualization, "-vis", "--visualization", "-no-vis",
+                  "--no-visualization",
+                  "Enable or disable GLVis visualization.");
+   args.Parse();
+   if (!args.Good())
+   {
+      args.PrintUsage(cout);
+      return 1;
+   }
+   MFEM_VERIFY(perf || !matrix_free,
+               "--standard-version is not compatible with --matrix-free");
+   args.PrintOptions(cout);
+   kappa = freq * M_PI;
+
+   // 2. Read the mesh from the given mesh file.
+   Mesh *mesh = new Mesh(mesh_file, 1, 1);
+   dim = mesh->Dimension();
+   int sdim = mesh->SpaceDimension();
+
+   // 3. Check if the optimized version matches the given mesh
+   if (perf)
+   {
+      cout << "High-performance version using integration rule with "
+           << int_rule_t::qpts << " points ..." << endl;
+      if (!mesh_t::MatchesGeometry(*mesh))
+      {
+         cout << "The given mesh does not match the optimized 'geom' parameter.\n"
+              << "Recompile with suitable 'geom' value." << endl;
+         delete mesh;
+         return 4;
+      }
+      else if (!mesh_t::MatchesNodes(*mesh))
+      {
+         cout << "Switching the mesh curvature to match the "
+              << "optimized value (order " << mesh_p << ") ..." << endl;
+         mesh->SetCurvature(mesh_p, false, -1, Ordering::byNODES);
+      }
+   }
+
+   // 4. Refine the mesh to increase the resolution. In this example we do
+   //    'ref_levels' of uniform refinement. We choose 'ref_levels' to be the
+   //    largest number that gives a final mesh with no more than 5,000
+   //    elements, or as specified on the command line with the option
+   //    '--refine'.
+   {
+      ref_levels = (ref_levels != -1) ? ref_levels :
+                   (int)floor(log(5000./mesh->GetNE())/log(2.)/dim);
+      for (int l = 0; l < ref_levels; l++)
+      {
+         mesh->UniformRefinement();
+      }
+   }
+   mesh->ReorientTetMesh();
+
+   // 5. Define a finite element space on the mesh. Here we use the Nedelec
+   //    finite elements of the specified order.
+   FiniteElementCollection *fec = new ND_FECollection(order, dim);
+   FiniteElementSpace *fespace = new FiniteElementSpace(mesh, fec);
+   cout << "Number of finite element unknowns: "
+        << fespace->GetTrueVSize() << endl;
+
+   // 6. Check if the optimized version matches the given space
+   if (perf && !sol_fes_t::Matches(*fespace))
+   {
+      cout << "The given order does not match the optimized parameter.\n"
+           << "Recompile with suitable 'sol_p' value." << endl;
+      delete fespace;
+      delete fec;
+      delete mesh;
+      return 5;
+   }
+
+   // 7. Determine the list of true (i.e. conforming) essential boundary dofs.
+   //    In this example, the boundary conditions are defined by marking all
+   //    the boundary attributes from the mesh as essential (Dirichlet) and
+   //    converting them to a list of true dofs.
+   Array<int> ess_tdof_list;
+   if (mesh->bdr_attributes.Size())
+   {
+      Array<int> ess_bdr(mesh->bdr_attributes.Max());
+      ess_bdr = 1;
+      fespace->GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+   }
+
+   // 8. Set up the linear form b(.) which corresponds to the right-hand side
+   //    of the FEM linear system, which in this case is (f,phi_i) where f is
+   //    given by the function f_exact and phi_i are the basis functions in the
+   //    finite element fespace.
+   VectorFunctionCoefficient f(sdim, f_exact);
+   LinearForm *b = new LinearForm(fespace);
+   b->AddDomainIntegrator(new VectorFEDomainLFIntegrator(f));
+   b->Assemble();
+
+   // 9. Define the solution vector x as a finite element grid function
+   //    corresponding to fespace. Initialize x by projecting the exact
+   //    solution. Note that only values from the boundary edges will be used
+   //    when eliminating the non-homogeneous boundary condition to modify the
+   //    r.h.s. vector b.
+   GridFunction x(fespace);
+   VectorFunctionCoefficient E(sdim, E_exact);
+   x.ProjectCoefficient(E);
+
+   // 10. Set up the bilinear form corresponding to the EM diffusion operator
+   //     curl curl + I, by adding the curl-curl and the mass domain
+   //     integrators.
+   ConstantCoefficient one(1.0);
+   BilinearForm *a = new BilinearForm(fespace);
+
+   // 11. Assemble the bilinear form and the corresponding linear system.
+   cout << "Assembling the bilinear form ..." << flush;
+   tic_toc.Clear();
+   tic_toc.Start();
+   // Pre-allocate sparsity assuming dense element matrices
+   a->UsePrecomputedSparsity();
+
+   HPCCurlCurlForm *a_curl = NULL;
+   HPCMassForm *a_mass = NULL;
+   SumOperator *a_sum = NULL;
+   Operator *a_oper = NULL;
+
+   if (!perf)
+   {
+      // Standard assembly using the curl-curl and mass domain integrators
+      a->AddDomainIntegrator(new CurlCurlIntegrator(one));
+      a->AddDomainIntegrator(new VectorFEMassIntegrator(one));
+      a->Assemble();
+   }
+   else
+   {
+      // High-performance assembly/evaluation using the templated operator types
+      a_curl = new HPCCurlCurlForm(curl_integ_t(coeff_t(1.0)), *fespace);
+      a_mass = new HPCMassForm(mass_integ_t(coeff_t(1.0)), *fespace);
+      if (matrix_free)
+      {
+         a_curl->Assemble(); // partial assembly
+         a_mass->Assemble(); // partial assembly
+         a_sum = new SumOperator(*a_curl, *a_mass);
+      }
+      else
+      {
+         // full matrix assembly: the element matrices of both forms are added
+         a_curl->AssembleBilinearForm(*a);
+         a_mass->AssembleBilinearForm(*a);
+      }
+   }
+   tic_toc.Stop();
+   cout << " done, " << tic_toc.RealTime() << "s." << endl;
+
+   // 12. Solve the system A X = B with CG, preconditioned with symmetric
+   //     Gauss-Seidel when the matrix is assembled.
+   SparseMatrix A;
+   Vector B, X;
+   if (perf && matrix_free)
+   {
+      a_sum->FormLinearSystem(ess_tdof_list, x, *b, a_oper, X, B);
+      cout << "Size of linear system: " << a_sum->Height() << endl;
+      CG(*a_oper, B, X, 1, 2000, 1e-12, 0.0);
+   }
+   else
+   {
+      a->FormLinearSystem(ess_tdof_list, x, *b, A, X, B);
+      cout << "Size of linear system: " << A.Height() << endl;
+      a_oper = &A;
+      GSSmoother M(A);
+      PCG(A, M, B, X, 1, 500, 1e-12, 0.0);
+   }
+
+   // 13. Recover the solution as a finite element grid function.
+   if (perf && matrix_free)
+   {
+      a_sum->RecoverFEMSolution(X, *b, x);
+   }
+   else
+   {
+      a->RecoverFEMSolution(X, *b, x);
+   }
+
+   // 14. Compute and print the L^2 norm of the error.
+   cout << "\n|| E_h - E ||_{L^2} = " << x.ComputeL2Error(E) << '\n' << endl;
+
+   // 15. Save the refined mesh and the solution. This output can be viewed
+   //     later using GLVis: "glvis -m refined.mesh -g sol.gf".
+   ofstream mesh_ofs("refined.mesh");
+   mesh_ofs.precision(8);
+   mesh->Print(mesh_ofs);
+   ofstream sol_ofs("sol.gf");
+   sol_ofs.precision(8);
+   x.Save(sol_ofs);
+
+   // 16. Send the solution by socket to a GLVis server.
+   if (visualization)
+   {
+      char vishost[] = "localhost";
+      int  visport   = 19916;
+      socketstream sol_sock(vishost, visport);
+      sol_sock.precision(8);
+      sol_sock << "solution\n" << *mesh << x << flush;
+   }
+
+   // 17. Free the used memory.
+   delete a;
+   if (a_oper != &A) { delete a_oper; }
+   delete a_sum;
+   delete a_mass;
+   delete a_curl;
+   delete b;
+   delete fespace;
+   delete fec;
+   delete mesh;
+
+   return 0;
+}
+
+
+void E_exact(const Vector &x, Vector &E)
+{
+   if (dim == 3)
+   {
+      E(0) = sin(kappa * x(1));
+      E(1) = sin(kappa * x(2));
+      E(2) = sin(kappa * x(0));
+   }
+   else
+   {
+      E(0) = sin(kappa * x(1));
+      E(1) = sin(kappa * x(0));
+      if (x.Size() == 3) { E(2) = 0.0; }
+   }
+}
+
+void f_exact(const Vector &x, Vector &f)
+{
+   if (dim == 3)
+   {
+      f(0) = (1. + kappa * kappa) * sin(kappa * x(1));
+      f(1) = (1. + kappa * kappa) * sin(kappa * x(2));
+      f(2) = (1. + kappa * kappa) * sin(kappa * x(0));
+   }
+   else
+   {
+      f(0) = (1. + kappa * kappa) * sin(kappa * x(1));
+      f(1) = (1. + kappa * kappa) * sin(kappa * x(0));
+      if (x.Size() == 3) { f(2) = 0.0; }
+   }
+}
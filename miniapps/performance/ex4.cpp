@@ -0,0 +1,349 @@
+//                    MFEM Example 4 - High-Performance Version
+//
+// Compile with: make ex4
+//
+// Sample runs:  ex4 -m ../../data/star.mesh -perf -mf
+//               ex4 -m ../../data/star.mesh -perf -asm
+//               ex4 -m ../../data/star.mesh -std  -asm
+//               ex4 -m ../../data/square-disc.mesh -perf -asm
+//
+// Description:  This example code solves a simple 2D H(div) diffusion problem
+//               corresponding to the second order definite equation
+//               -grad(div F) + F = f with boundary condition F dot n = <given
+//               normal field>, cf. Example 4.
+//
+//               The example highlights the use of the templated div-div and
+//               H(div) mass kernels (TDivDivKernel and TRTMassKernel) on a
+//               Raviart-Thomas finite element space, with either matrix-free
+//               evaluation or efficient assembly of the element matrices. The
+//               high-performance version can be compared with the standard
+//               DivDivIntegrator and VectorFEMassIntegrator with -std.
+
+#include "mfem-performance.hpp"
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+using namespace mfem;
+
+// Define template parameters for optimized build.
+const Geometry::Type geom     = Geometry::SQUARE; // mesh elements (default: quad)
+const int            mesh_p   = 1;                // mesh curvature (default: 1)
+const int            sol_p    = 1;                // solution order (default: 1)
+const int            rdim     = Geometry::Constants<geom>::Dimension;
+const int            ir_order = 2*sol_p+rdim-1;
+
+// Static mesh type
+typedef H1_FiniteElement<geom,mesh_p>         mesh_fe_t;
+typedef H1_FiniteElementSpace<mesh_fe_t>      mesh_fes_t;
+typedef TMesh<mesh_fes_t>                     mesh_t;
+
+// Static solution finite element space type: with order = sol_p, the space is
+// defined by RT_FECollection(sol_p-1, dim), cf. Example 4
+typedef RT_FiniteElement<geom,sol_p-1>        sol_fe_t;
+typedef RT_FiniteElementSpace<sol_fe_t>       sol_fes_t;
+
+// Static quadrature, coefficient and integrator types
+typedef TIntegrationRule<geom,ir_order>       int_rule_t;
+typedef TConstantCoefficient<>                coeff_t;
+typedef TIntegrator<coeff_t,TDivDivKernel>    div_integ_t;
+typedef TIntegrator<coeff_t,TRTMassKernel>    mass_integ_t;
+
+// Static bilinear form types, combining the above types
+typedef TBilinearForm<mesh_t,sol_fes_t,int_rule_t,div_integ_t>
+HPCDivDivForm;
+typedef TBilinearForm<mesh_t,sol_fes_t,int_rule_t,mass_integ_t>
+HPCMassForm;
+
+// Sum of two operators on the same finite element space: used to combine the
+// matrix-free div-div and mass forms.
+class SumOperator : public Operator
+{
+protected:
+   const Operator &A, &B;
+   mutable Vector z;
+
+public:
+   SumOperator(const Operator &A_, const Operator &B_)
+      : Operator(A_.Height(), A_.Width()), A(A_), B(B_), z(A_.Height()) { }
+
+   virtual const Operator *GetProlongation() const
+   { return A.GetProlongation(); }
+   virtual const Operator *GetRestriction() const
+   { return A.GetRestriction(); }
+
+   virtual void Mult(const Vector &x, Vector &y) const
+   {
+      A.Mult(x, y);
+      B.Mult(x, z);
+      y += z;
+   }
+};
+
+// Exact solution, F, and r.h.s., f. See below for implementation.
+void F_exact(const Vector &, Vector &);
+void f_exact(const Vector &, Vector &);
+double freq = 1.0, kappa;
+
+int main(int argc, char *argv[])
+{
+   // 1. Parse command-line options.
+   const char *mesh_file = "../../data/star.mesh";
+   int ref_levels = -1;
+   int order = sol_p;
+   bool set_bc = true;
+   bool perf = true;
+   bool matrix_free = true;
+   bool visualization = 1;
+
+   OptionsParser args(argc, argv);
+   args.AddOption(&mesh_file, "-m", "--mesh",
+                  "Mesh file to use.");
+   args.AddOption(&ref_levels, "-r", "--refine",
+                  "Number of times to refine the mesh uniformly;"
+                  " -1 = auto: <= 5,000 elements.");
+   args.AddOption(&order, "-o", "--order",
+                  "Finite element order (polynomial degree).");
+   args.AddOption(&set_bc, "-bc", "--impose-bc", "-no-bc", "--dont-impose-bc",
+                  "Impose or not essential boundary conditions.");
+   args.AddOption(&freq, "-f", "--frequency", "Set the frequency for the exact"
+                  " solution.");
+   args.AddOption(&perf, "-perf", "--hpc-version", "-std", "--standard-version",
+                  "Enable high-performance, tensor-based, assembly/evaluation.");
+   args.AddOption(&matrix_free, "-mf", "--matrix-free", "-asm", "--assembly",
+                  "Use matrix-free evaluation or efficient matrix assembly in "
+                  "the high-performance version.");
+   args.AddOption(&visualization, "-vis", "--visualization", "-no-vis",
+                  "--no-visualization",
+                  "Enable or disable GLVis visualization.");
+   args.Parse();
+   if (!args.Good())
+   {
+      args.PrintUsage(cout);
+      return 1;
+   }
+   MFEM_VERIFY(perf || !matrix_free,
+               "--standard-version is not compatible with --matrix-free");
+   args.PrintOptions(cout);
+   kappa = freq * M_PI;
+
+   // 2. Read the mesh from the given mesh file.
+   Mesh *mesh = new Mesh(mesh_file, 1, 1);
+   int dim = mesh->Dimension();
+   int sdim = mesh->SpaceDimension();
+
+   // 3. Check if the optimized version matches the given mesh
+   if (perf)
+   {
+      cout << "High-performance version using integration rule with "
+           << int_rule_t::qpts << " points ..." << endl;
+      if (!mesh_t::MatchesGeometry(*mesh))
+      {
+         cout << "The given mesh does not match the optimized 'geom' parameter.\n"
+              << "Recompile with suitable 'geom' value." << endl;
+         delete mesh;
+         return 4;
+      }
+      else if (!mesh_t::MatchesNodes(*mesh))
+      {
+         cout << "Switching the mesh curvature to match the "
+              << "optimized value (order " << mesh_p << ") ..." << endl;
+         mesh->SetCurvature(mesh_p, false, -1, Ordering::byNODES);
+      }
+   }
+
+   // 4. Refine the mesh to increase the resolution. In this example we do
+   //    'ref_levels' of uniform refinement. We choose 'ref_levels' to be the
+   //    largest number that gives a final mesh with no more than 5,000
+   //    elements, or as specified on the command line with the option
+   //    '--refine'.
+   {
+      ref_levels = (ref_levels != -1) ? ref_levels :
+                   (int)floor(log(5000./mesh->GetNE())/log(2.)/dim);
+      for (int l = 0; l < ref_levels; l++)
+      {
+         mesh->UniformRefinement();
+      }
+   }
+
+   // 5. Define a finite element space on the mesh. Here we use the
+   //    Raviart-Thomas finite elements of the specified order.
+   FiniteElementCollection *fec = new RT_FECollection(order-1, dim);
+   FiniteElementSpace *fespace = new FiniteElementSpace(mesh, fec);
+   cout << "Number of finite element unknowns: "
+        << fespace->GetTrueVSize() << endl;
+
+   // 6. Check if the optimized version matches the given space
+   if (perf && !sol_fes_t::Matches(*fespace))
+   {
+      cout << "The given order does not match the optimized parameter.\n"
+           << "Recompile with suitable 'sol_p' value." << endl;
+      delete fespace;
+      delete fec;
+      delete mesh;
+      return 5;
+   }
+
+   // 7. Determine the list of true (i.e. conforming) essential boundary dofs.
+   //    In this example, the boundary conditions are defined by marking all
+   //    the boundary attributes from the mesh as essential (Dirichlet) and
+   //    converting them to a list of true dofs.
+   Array<int> ess_tdof_list;
+   if (mesh->bdr_attributes.Size())
+   {
+      Array<int> ess_bdr(mesh->bdr_attributes.Max());
+      ess_bdr = set_bc ? 1 : 0;
+      fespace->GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+   }
+
+   // 8. Set up the linear form b(.) which corresponds to the right-hand side
+   //    of the FEM linear system, which in this case is (f,phi_i) where f is
+   //    given by the function f_exact and phi_i are the basis functions in the
+   //    finite element fespace.
+   VectorFunctionCoefficient f(sdim, f_exact);
+   LinearForm *b = new LinearForm(fespace);
+   b->AddDomainIntegrator(new VectorFEDomainLFIntegrator(f));
+   b->Assemble();
+
+   // 9. Define the solution vector x as a finite element grid function
+   //    corresponding to fespace. Initialize x by projecting the exact
+   //    solution. Note that only values from the boundary faces will be used
+   //    when eliminating the non-homogeneous boundary condition to modify the
+   //    r.h.s. vector b.
+   GridFunction x(fespace);
+   VectorFunctionCoefficient F(sdim, F_exact);
+   x.ProjectCoefficient(F);
+
+   // 10. Set up the bilinear form corresponding to the H(div) diffusion
+   //     operator grad div + I, by adding the div-div and the mass domain
+   //     integrators.
+   ConstantCoefficient one(1.0);
+   BilinearForm *a = new BilinearForm(fespace);
+
+   // 11. Assemble the bilinear form and the corresponding linear system.
+   cout << "Assembling the bilinear form ..." << flush;
+   tic_toc.Clear();
+   tic_toc.Start();
+   // Pre-allocate sparsity assuming dense element matrices
+   a->UsePrecomputedSparsity();
+
+   HPCDivDivForm *a_div = NULL;
+   HPCMassForm *a_mass = NULL;
+   SumOperator *a_sum = NULL;
+   Operator *a_oper = NULL;
+
+   if (!perf)
+   {
+      // Standard assembly using the div-div and mass domain integrators
+      a->AddDomainIntegrator(new DivDivIntegrator(one));
+      a->AddDomainIntegrator(new VectorFEMassIntegrator(one));
+      a->Assemble();
+   }
+   else
+   {
+      // High-performance assembly/evaluation using the templated operator types
+      a_div = new HPCDivDivForm(div_integ_t(coeff_t(1.0)), *fespace);
+      a_mass = new HPCMassForm(mass_integ_t(coeff_t(1.0)), *fespace);
+      if (matrix_free)
+      {
+         a_div->Assemble(); // partial assembly
+         a_mass->Assemble(); // partial assembly
+         a_sum = new SumOperator(*a_div, *a_mass);
+      }
+      else
+      {
+         // full matrix assembly: the element matrices of both forms are added
+         a_div->AssembleBilinearForm(*a);
+         a_mass->AssembleBilinearForm(*a);
+      }
+   }
+   tic_toc.Stop();
+   cout << " done, " << tic_toc.RealTime() << "s." << endl;
+
+   // 12. Solve the system A X = B with CG, preconditioned with symmetric
+   //     Gauss-Seidel when the matrix is assembled.
+   SparseMatrix A;
+   Vector B, X;
+   if (perf && matrix_free)
+   {
+      a_sum->FormLinearSystem(ess_tdof_list, x, *b, a_oper, X, B);
+      cout << "Size of linear system: " << a_sum->Height() << endl;
+      CG(*a_oper, B, X, 1, 2000, 1e-12, 0.0);
+   }
+   else
+   {
+      a->FormLinearSystem(ess_tdof_list, x, *b, A, X, B);
+      cout << "Size of linear system: " << A.Height() << endl;
+      a_oper = &A;
+      GSSmoother M(A);
+      PCG(A, M, B, X, 1, 500, 1e-12, 0.0);
+   }
+
+   // 13. Recover the solution as a finite element grid function.
+   if (perf && matrix_free)
+   {
+      a_sum->RecoverFEMSolution(X, *b, x);
+   }
+   else
+   {
+      a->RecoverFEMSolution(X, *b, x);
+   }
+
+   // 14. Compute and print the L^2 norm of the error.
+   cout << "\n|| F_h - F ||_{L^2} = " << x.ComputeL2Error(F) << '\n' << endl;
+
+   // 15. Save the refined mesh and the solution. This output can be viewed
+   //     later using GLVis: "glvis -m refined.mesh -g sol.gf".
+   ofstream mesh_ofs("refined.mesh");
+   mesh_ofs.precision(8);
+   mesh->Print(mesh_ofs);
+   ofstream sol_ofs("sol.gf");
+   sol_ofs.precision(8);
+   x.Save(sol_ofs);
+
+   // 16. Send the solution by socket to a GLVis server.
+   if (visualization)
+   {
+      char vishost[] = "localhost";
+      int  visport   = 19916;
+      socketstream sol_sock(vishost, visport);
+      sol_sock.precision(8);
+      sol_sock << "solution\n" << *mesh << x << flush;
+   }
+
+   // 17. Free the used memory.
+   delete a;
+   if (a_oper != &A) { delete a_oper; }
+   delete a_sum;
+   delete a_mass;
+   delete a_div;
+   delete b;
+   delete fespace;
+   delete fec;
+   delete mesh;
+
+   return 0;
+}
+
+
+// The exact solution
+void F_exact(const Vector &p, Vector &F)
+{
+   double x = p(0);
+   double y = p(1);
+
+   F(0) = cos(kappa*x)*sin(kappa*y);
+   F(1) = cos(kappa*y)*sin(kappa*x);
+}
+
+// The right hand side
+void f_exact(const Vector &p, Vector &f)
+{
+   double x = p(0);
+   double y = p(1);
+
+   double temp = 1 + 2*kappa*kappa;
+
+   f(0) = temp*cos(kappa*x)*sin(kappa*y);
+   f(1) = temp*cos(kappa*y)*sin(kappa*x);
+}
@@ -0,0 +1,278 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+//
+//    -----------------------------------------------------------------
+//    Checkpoint Miniapp:  Save and reload a parallel mesh with fields
+//    -----------------------------------------------------------------
+//
+// This miniapp writes a ParMesh and two ParGridFunctions (an H1 and a Nedelec
+// field) to a single file with ParCheckpoint::Save and reads them back with
+// ParCheckpoint::Load, on all ranks and on the first half of the ranks. The
+// checkpoint is also written from the first half of the ranks and read on all
+// ranks. Every reloaded mesh and field is compared with the saved one: the
+// global numbers of elements, boundary elements per attribute and true dofs,
+// and the L2 errors of the fields with respect to the functions they
+// interpolate. With -nc, the mesh is non-conforming, refined around its center
+// after the distribution, so the refinement trees are part of the checkpoint.
+//
+// Compile with: make checkpoint
+//
+// Sample runs:
+//   mpirun -np 4 checkpoint
+//   mpirun -np 4 checkpoint -m ../../data/beam-tet.mesh -o 2
+//   mpirun -np 4 checkpoint -m ../../data/star.mesh -nc
+//   mpirun -np 3 checkpoint -m ../../data/fichera.mesh -nc -rp 2
+
+#include "mfem.hpp"
+#include <cstdio>
+#include <iostream>
+
+using namespace std;
+using namespace mfem;
+
+double u_exact(const Vector &x);
+void E_exact(const Vector &x, Vector &E);
+
+// Global quantities compared after the reload.
+struct Summary
+{
+   long ne;
+   Array<long> bdr_counts;
+   HYPRE_Int u_size, E_size;
+   double u_err, E_err;
+
+   void Compute(ParMesh &pmesh, ParGridFunction &u, ParGridFunction &E);
+   bool Matches(const Summary &saved) const;
+};
+
+// Save on 'save_comm' and reload on 'load_comm' (ranks that are not in a
+// communicator pass MPI_COMM_NULL). Returns false if a reloaded quantity
+// differs from the saved one.
+bool RoundTrip(MPI_Comm save_comm, MPI_Comm load_comm, Mesh &mesh, bool nc,
+               int par_ref_levels, int order, const char *file);
+
+int main(int argc, char *argv[])
+{
+   MPI_Session mpi;
+   if (!mpi.Root()) { mfem::out.Disable(); mfem::err.Disable(); }
+
+   // Parse command-line options.
+   const char *mesh_file = "../../data/star.mesh";
+   const char *file = "checkpoint.chk";
+   int ser_ref_levels = 1;
+   int par_ref_levels = 1;
+   int order = 2;
+   bool nc = false;
+   bool visualization = false;
+
+   OptionsParser args(argc, argv);
+   args.AddOption(&mesh_file, "-m", "--mesh",
+                  "Mesh file to use.");
+   args.AddOption(&file, "-f", "--file",
+                  "Name of the checkpoint file.");
+   args.AddOption(&ser_ref_levels, "-rs", "--refine-serial",
+                  "Number of times to refine the mesh uniformly in serial.");
+   args.AddOption(&par_ref_levels, "-rp", "--refine-parallel",
+                  "Number of times to refine the mesh in parallel, locally "
+                  "around a point with -nc.");
+   args.AddOption(&order, "-o", "--order",
+                  "Finite element order (polynomial degree).");
+   args.AddOption(&nc, "-nc", "--nonconforming", "-c", "--conforming",
+                  "Use a non-conforming mesh.");
+   args.AddOption(&visualization, "-vis", "--visualization", "-no-vis",
+                  "--no-visualization",
+                  "Enable or disable GLVis visualization (not used).");
+   args.Parse();
+   if (!args.Good())
+   {
+      args.PrintUsage(mfem::out);
+      return 1;
+   }
+   args.PrintOptions(mfem::out);
+
+   Mesh mesh(mesh_file, 1, 1);
+   for (int l = 0; l < ser_ref_levels; l++)
+   {
+      mesh.UniformRefinement();
+   }
+   if (nc) { mesh.EnsureNCMesh(); }
+
+   // The first half of the ranks, at least one
+   const int half = max(mpi.WorldSize()/2, 1);
+   MPI_Comm half_comm;
+   MPI_Comm_split(MPI_COMM_WORLD, mpi.WorldRank() < half ? 0 : MPI_UNDEFINED,
+                  mpi.WorldRank(), &half_comm);
+
+   bool ok = true;
+   ok = RoundTrip(MPI_COMM_WORLD, MPI_COMM_WORLD, mesh, nc, par_ref_levels,
+                  order, file) && ok;
+   ok = RoundTrip(MPI_COMM_WORLD, half_comm, mesh, nc, par_ref_levels,
+                  order, file) && ok;
+   ok = RoundTrip(half_comm, MPI_COMM_WORLD, mesh, nc, par_ref_levels,
+                  order, file) && ok;
+
+   if (half_comm != MPI_COMM_NULL) { MPI_Comm_free(&half_comm); }
+   if (mpi.Root()) { remove(file); }
+
+   int my_ok = ok, all_ok;
+   MPI_Allreduce(&my_ok, &all_ok, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+   mfem::out << (all_ok ? "All checkpoints match." : "Checkpoint mismatch!")
+             << endl;
+   return all_ok ? 0 : 1;
+}
+
+bool RoundTrip(MPI_Comm save_comm, MPI_Comm load_comm, Mesh &mesh, bool nc,
+               int par_ref_levels, int order, const char *file)
+{
+   int save_size = 0, load_size = 0, my_ok = 1, ok;
+   Summary saved;
+   if (save_comm != MPI_COMM_NULL)
+   {
+      MPI_Comm_size(save_comm, &save_size);
+      ParMesh pmesh(save_comm, mesh);
+      for (int l = 0; l < par_ref_levels; l++)
+      {
+         if (!nc) { pmesh.UniformRefinement(); continue; }
+
+         // Refine the elements with a vertex near the center of the bounding
+         // box (the reentrant corner of fichera.mesh), to get hanging nodes
+         // across the rank boundaries
+         Vector bb_min, bb_max;
+         pmesh.GetBoundingBox(bb_min, bb_max);
+         Array<int> refs;
+         for (int i = 0; i < pmesh.GetNE(); i++)
+         {
+            Array<int> v;
+            pmesh.GetElementVertices(i, v);
+            for (int j = 0; j < v.Size(); j++)
+            {
+               const double *x = pmesh.GetVertex(v[j]);
+               double dist = 0.0;
+               for (int d = 0; d < pmesh.SpaceDimension(); d++)
+               {
+                  const double c = 0.5*(bb_min(d) + bb_max(d));
+                  dist = std::max(dist, fabs(x[d] - c)/(bb_max(d) - bb_min(d)));
+               }
+               if (dist < 0.2) { refs.Append(i); break; }
+            }
+         }
+         pmesh.GeneralRefinement(refs);
+      }
+      // The Nedelec spaces on tetrahedra need consistent orientations
+      if (!nc) { pmesh.ReorientTetMesh(); }
+
+      H1_FECollection h1_fec(order, pmesh.Dimension());
+      ND_FECollection nd_fec(order, pmesh.Dimension());
+      ParFiniteElementSpace h1_fes(&pmesh, &h1_fec);
+      ParFiniteElementSpace nd_fes(&pmesh, &nd_fec);
+      ParGridFunction u(&h1_fes), E(&nd_fes);
+      FunctionCoefficient u_coeff(u_exact);
+      VectorFunctionCoefficient E_coeff(pmesh.SpaceDimension(), E_exact);
+      u.ProjectCoefficient(u_coeff);
+      E.ProjectCoefficient(E_coeff);
+      saved.Compute(pmesh, u, E);
+
+      Array<ParGridFunction*> fields(2);
+      fields[0] = &u;
+      fields[1] = &E;
+      ParCheckpoint::Save(file, pmesh, fields);
+   }
+   // The file is complete when all ranks of 'save_comm' are done. The summary
+   // of the saved mesh is only known on rank 0, which is in all communicators.
+   MPI_Bcast(&save_size, 1, MPI_INT, 0, MPI_COMM_WORLD);
+   MPI_Barrier(MPI_COMM_WORLD);
+
+   if (load_comm != MPI_COMM_NULL)
+   {
+      MPI_Comm_size(load_comm, &load_size);
+      Array<ParGridFunction*> fields;
+      ParMesh *pmesh = ParCheckpoint::Load(load_comm, file, fields);
+      Summary loaded;
+      loaded.Compute(*pmesh, *fields[0], *fields[1]);
+      my_ok = loaded.Matches(saved);
+
+      for (int k = 0; k < fields.Size(); k++) { delete fields[k]; }
+      delete pmesh;
+   }
+   MPI_Bcast(&load_size, 1, MPI_INT, 0, MPI_COMM_WORLD);
+   MPI_Allreduce(&my_ok, &ok, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+   mfem::out << "save on " << save_size << " ranks, load on " << load_size
+             << " ranks: " << (ok ? "OK" : "MISMATCH") << endl;
+   return ok;
+}
+
+void Summary::Compute(ParMesh &pmesh, ParGridFunction &u, ParGridFunction &E)
+{
+   MPI_Comm comm = pmesh.GetComm();
+   long my_ne = pmesh.GetNE();
+   MPI_Allreduce(&my_ne, &ne, 1, MPI_LONG, MPI_SUM, comm);
+
+   const int nattr = pmesh.bdr_attributes.Size() ?
+                     pmesh.bdr_attributes.Max() : 0;
+   Array<long> my_counts(nattr);
+   my_counts = 0;
+   for (int i = 0; i < pmesh.GetNBE(); i++)
+   {
+      my_counts[pmesh.GetBdrAttribute(i) - 1]++;
+   }
+   bdr_counts.SetSize(nattr);
+   MPI_Allreduce(my_counts.GetData(), bdr_counts.GetData(), nattr, MPI_LONG,
+                 MPI_SUM, comm);
+
+   u_size = u.ParFESpace()->GlobalTrueVSize();
+   E_size = E.ParFESpace()->GlobalTrueVSize();
+   FunctionCoefficient u_coeff(u_exact);
+   VectorFunctionCoefficient E_coeff(pmesh.SpaceDimension(), E_exact);
+   u_err = u.ComputeL2Error(u_coeff);
+   E_err = E.ComputeL2Error(E_coeff);
+}
+
+bool Summary::Matches(const Summary &saved) const
+{
+   // Only rank 0 has the saved summary
+   int myrank;
+   MPI_Comm_rank(MPI_COMM_WORLD, &myrank);
+   if (myrank != 0) { return true; }
+
+   bool ok = (ne == saved.ne && u_size == saved.u_size &&
+              E_size == saved.E_size &&
+              bdr_counts.Size() == saved.bdr_counts.Size());
+   for (int a = 0; ok && a < bdr_counts.Size(); a++)
+   {
+      ok = (bdr_counts[a] == saved.bdr_counts[a]);
+   }
+   ok = ok && fabs(u_err - saved.u_err) <= 1e-12*(1.0 + saved.u_err);
+   ok = ok && fabs(E_err - saved.E_err) <= 1e-12*(1.0 + saved.E_err);
+   if (!ok)
+   {
+      mfem::err << "elements: " << saved.ne << " -> " << ne
+                << ", H1 true dofs: " << saved.u_size << " -> " << u_size
+                << ", ND true dofs: " << saved.E_size << " -> " << E_size
+                << ", H1 error: " << saved.u_err << " -> " << u_err
+                << ", ND error: " << saved.E_err << " -> " << E_err << endl;
+   }
+   return ok;
+}
+
+double u_exact(const Vector &x)
+{
+   double r = 0.0;
+   for (int d = 0; d < x.Size(); d++) { r += (d + 1)*x(d); }
+   return sin(3.0*r);
+}
+
+void E_exact(const Vector &x, Vector &E)
+{
+   for (int d = 0; d < x.Size(); d++)
+   {
+      E(d) = cos(2.0*x((d + 1) % x.Size()) + d);
+   }
+}